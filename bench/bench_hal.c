@@ -0,0 +1,145 @@
+/**
+ * @file bench_hal.c
+ * @brief Per-instance UART HAL trampolines for the benchmarks.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "bench_hal.h"
+#include "port.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define BENCH_HAL_WRITE_WAIT_MS 1000    // Longest wait for a full pty to drain before a write fails
+
+static BenchUart_t benchUarts[BENCH_HAL_MAX_SLOTS] = {
+    [0 ... BENCH_HAL_MAX_SLOTS - 1] = { .fd = -1 }
+};
+
+static int benchUartInit(BenchUart_t* uart, void* device) {
+    struct termios options;
+
+    uart->fd = open((const char*)device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (uart->fd < 0) return UART_INIT_FAILED;
+
+    tcgetattr(uart->fd, &options);
+    cfmakeraw(&options);
+    tcsetattr(uart->fd, TCSANOW, &options);
+    uart->bytesRead = 0;
+    uart->bytesWritten = 0;
+    return UART_SUCCESS;
+}
+
+static int benchUartRead(BenchUart_t* uart, uint8_t* buffer, int length) {
+    int n = read(uart->fd, buffer, length);
+    if (n < 0) return -1;
+    uart->bytesRead += n;
+    return n;
+}
+
+/**
+ * @brief Writes all of `buf`, waiting for room while the non-blocking pty is full.
+ *
+ * Under load the simulator drains the pty later than the host fills it;
+ * that is backpressure, not a UART error, so it is not counted as one.
+ */
+static int benchUartWrite(BenchUart_t* uart, const uint8_t* buf, uint16_t len) {
+    uint16_t total = 0;
+    while (total < len) {
+        int n = write(uart->fd, buf + total, len - total);
+        if (n > 0) {
+            total += n;
+        } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            return UART_ERROR_UNKNOWN;
+        } else {
+            struct pollfd pfd = { .fd = uart->fd, .events = POLLOUT };
+            int rc = poll(&pfd, 1, BENCH_HAL_WRITE_WAIT_MS);
+            if (rc == 0 || (rc < 0 && errno != EINTR)) return UART_ERROR_UNKNOWN;
+        }
+    }
+    uart->bytesWritten += total;
+    return total;
+}
+
+static void benchUartFlush(BenchUart_t* uart) {
+    tcflush(uart->fd, TCIFLUSH);
+}
+
+#define BENCH_HAL_SLOT(n) \
+    static int benchInit##n(uint32_t baud, void* dev) { (void)baud; return benchUartInit(&benchUarts[n], dev); } \
+    static int benchRead##n(uint8_t* b, int l) { return benchUartRead(&benchUarts[n], b, l); } \
+    static int benchWrite##n(const uint8_t* b, uint16_t l) { return benchUartWrite(&benchUarts[n], b, l); } \
+    static void benchFlush##n(void) { benchUartFlush(&benchUarts[n]); }
+
+#define BENCH_HAL_TABLE(n) { \
+    .PortUartRead = benchRead##n, \
+    .PortUartWrite = benchWrite##n, \
+    .PortMillis = portMillis, \
+    .PortFlushRx = benchFlush##n, \
+    .PortUartInit = benchInit##n, \
+    .PortDelay = portDelay, \
+}
+
+BENCH_HAL_SLOT(0)
+BENCH_HAL_SLOT(1)
+BENCH_HAL_SLOT(2)
+BENCH_HAL_SLOT(3)
+BENCH_HAL_SLOT(4)
+BENCH_HAL_SLOT(5)
+BENCH_HAL_SLOT(6)
+BENCH_HAL_SLOT(7)
+
+static const XBeeHTable benchTables[BENCH_HAL_MAX_SLOTS] = {
+    BENCH_HAL_TABLE(0), BENCH_HAL_TABLE(1), BENCH_HAL_TABLE(2), BENCH_HAL_TABLE(3),
+    BENCH_HAL_TABLE(4), BENCH_HAL_TABLE(5), BENCH_HAL_TABLE(6), BENCH_HAL_TABLE(7),
+};
+
+/**
+ * @brief Returns the HAL table bound to a slot.
+ */
+const XBeeHTable* BenchHalTable(uint8_t slot) {
+    return slot < BENCH_HAL_MAX_SLOTS ? &benchTables[slot] : NULL;
+}
+
+/**
+ * @brief Returns the UART state (fd and byte counters) of a slot.
+ */
+BenchUart_t* BenchHalUart(uint8_t slot) {
+    return slot < BENCH_HAL_MAX_SLOTS ? &benchUarts[slot] : NULL;
+}
+
+/**
+ * @brief Closes the file descriptor of a slot.
+ */
+void BenchHalClose(uint8_t slot) {
+    if (slot < BENCH_HAL_MAX_SLOTS && benchUarts[slot].fd >= 0) {
+        close(benchUarts[slot].fd);
+        benchUarts[slot].fd = -1;
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * @file bench_hal.h
+ * @brief Per-instance UART HAL used by the benchmarks to drive several XBee
+ *        instances, each attached to its own simulated module.
+ *
+ * XBeeHTable entries take no context argument, so each slot gets its own set
+ * of trampolines bound to a private file descriptor. Byte counters are kept
+ * per slot for throughput reporting.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef BENCH_HAL_H
+#define BENCH_HAL_H
+
+#include "xbee.h"
+#include <stdint.h>
+
+#define BENCH_HAL_MAX_SLOTS 8
+
+/**
+ * @struct BenchUart_t
+ * @brief State of one benchmark UART slot.
+ */
+typedef struct {
+    int fd;
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+} BenchUart_t;
+
+const XBeeHTable* BenchHalTable(uint8_t slot);
+BenchUart_t* BenchHalUart(uint8_t slot);
+void BenchHalClose(uint8_t slot);
+
+#endif // BENCH_HAL_H
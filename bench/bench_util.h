@@ -0,0 +1,142 @@
+/**
+ * @file bench_util.h
+ * @brief Timing, statistics and JSON reporting helpers shared by the benchmarks.
+ *
+ * Results are collected as named metrics on a BenchResult_t and written as one
+ * JSON document per run so they can be diffed or fed to CI dashboards.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_METRICS 16
+#define BENCH_MAX_RESULTS 32
+
+/**
+ * @struct BenchMetric_t
+ * @brief One named numeric value of a benchmark result.
+ */
+typedef struct {
+    const char* key;
+    double value;
+} BenchMetric_t;
+
+/**
+ * @struct BenchResult_t
+ * @brief Metrics reported for one workload.
+ */
+typedef struct {
+    char name[48];
+    BenchMetric_t metrics[BENCH_MAX_METRICS];
+    uint8_t metricCount;
+} BenchResult_t;
+
+/**
+ * @struct BenchReport_t
+ * @brief All results of one benchmark run.
+ */
+typedef struct {
+    const char* suite;
+    BenchResult_t results[BENCH_MAX_RESULTS];
+    uint8_t resultCount;
+} BenchReport_t;
+
+static inline uint64_t benchClockNs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t benchNowNs(void) { return benchClockNs(CLOCK_MONOTONIC); }
+static inline uint64_t benchThreadCpuNs(void) { return benchClockNs(CLOCK_THREAD_CPUTIME_ID); }
+static inline uint64_t benchProcessCpuNs(void) { return benchClockNs(CLOCK_PROCESS_CPUTIME_ID); }
+
+static inline int benchCompareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the given percentile (0-100) of a sample set, sorting it in place.
+ */
+static inline uint64_t benchPercentile(uint64_t* samples, size_t count, double pct) {
+    if (count == 0) return 0;
+    qsort(samples, count, sizeof(uint64_t), benchCompareU64);
+    size_t idx = (size_t)((pct / 100.0) * (double)(count - 1) + 0.5);
+    return samples[idx];
+}
+
+static inline BenchResult_t* benchResultNew(BenchReport_t* report, const char* name) {
+    if (report->resultCount >= BENCH_MAX_RESULTS) return NULL;
+    BenchResult_t* r = &report->results[report->resultCount++];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    return r;
+}
+
+static inline void benchResultAdd(BenchResult_t* r, const char* key, double value) {
+    if (!r || r->metricCount >= BENCH_MAX_METRICS) return;
+    r->metrics[r->metricCount].key = key;
+    r->metrics[r->metricCount].value = value;
+    r->metricCount++;
+}
+
+/**
+ * @brief Adds p50/p99/max latency metrics (in microseconds) from nanosecond samples.
+ */
+static inline void benchResultAddLatency(BenchResult_t* r, uint64_t* samplesNs, size_t count) {
+    benchResultAdd(r, "samples", (double)count);
+    benchResultAdd(r, "p50_us", benchPercentile(samplesNs, count, 50) / 1000.0);
+    benchResultAdd(r, "p99_us", benchPercentile(samplesNs, count, 99) / 1000.0);
+    benchResultAdd(r, "max_us", count ? samplesNs[count - 1] / 1000.0 : 0);
+}
+
+/**
+ * @brief Writes the report as a single JSON document.
+ */
+static inline void benchReportWrite(const BenchReport_t* report, FILE* out) {
+    fprintf(out, "{\n  \"suite\": \"%s\",\n  \"workloads\": [\n", report->suite);
+    for (uint8_t i = 0; i < report->resultCount; i++) {
+        const BenchResult_t* r = &report->results[i];
+        fprintf(out, "    { \"name\": \"%s\"", r->name);
+        for (uint8_t m = 0; m < r->metricCount; m++) {
+            fprintf(out, ", \"%s\": %.3f", r->metrics[m].key, r->metrics[m].value);
+        }
+        fprintf(out, " }%s\n", i + 1 < report->resultCount ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+#endif // BENCH_UTIL_H
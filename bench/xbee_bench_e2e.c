@@ -0,0 +1,521 @@
+/**
+ * @file xbee_bench_e2e.c
+ * @brief End-to-end throughput and latency benchmarks against the module simulator.
+ *
+ * Every workload runs the unmodified library (API framing, AT command handling,
+ * LR and Cellular subclasses) over a real pty to a simulated module running on
+ * its own thread, so the numbers include the full host-side receive and send
+ * paths. Results are written as JSON: latency percentiles, frames/s, bytes/s
+ * and CPU time of the library thread(s) and of the whole process.
+ *
+ * Workloads:
+ *   at_rtt            Local AT command round trip (ATVR)
+ *   lr_uplink         LR uplinks, each waiting for its TX status
+ *   cellular_bulk     Pipelined TCP socket sends with echoed receive traffic
+ *   rx_burst          Bursts of LR downlinks drained through XBeeProcess()
+ *   multi_instance_N  Concurrent AT round trips on N instances, one thread each
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee.h"
+#include "xbee_api_frames.h"
+#include "xbee_lr.h"
+#include "xbee_cellular.h"
+#include "port.h"
+#include "xbee_sim.h"
+#include "bench_hal.h"
+#include "bench_util.h"
+#include <getopt.h>
+#include <pthread.h>
+
+#define BENCH_PAYLOAD_SIZE_LR 32
+#define BENCH_PAYLOAD_SIZE_CELL 120
+#define BENCH_PAYLOAD_SIZE_RX 64
+#define BENCH_CELL_WINDOW 8
+#define BENCH_RX_BURST 32
+#define BENCH_DRAIN_TIMEOUT_MS 5000
+
+/**
+ * @struct BenchOptions_t
+ * @brief Command line options shared by all workloads.
+ */
+typedef struct {
+    uint32_t iterations;
+    uint32_t baudRate;
+    uint32_t latencyMs;
+    uint32_t radioLatencyMs;
+    const char* only;
+    const char* outPath;
+} BenchOptions_t;
+
+/**
+ * @struct BenchInstance_t
+ * @brief A library instance wired to its own simulated module.
+ */
+typedef struct {
+    XBeeSimPty pty;
+    XBee* xbee;
+    uint8_t slot;
+    XBeeCTable ctable;
+    volatile uint32_t rxFrames;
+    uint64_t rxBytes;
+    uint64_t* rxStampsNs;       ///< Receive time of each frame, when recording
+    uint32_t rxStampsMax;
+    uint32_t iterations;        ///< Work item count for threaded workloads
+    uint64_t* latenciesNs;
+    uint32_t completed;
+    uint64_t cpuNs;
+} BenchInstance_t;
+
+static BenchInstance_t benchInstances[BENCH_HAL_MAX_SLOTS];
+
+static void benchOnReceive(XBee* self, void* data) {
+    for (uint8_t i = 0; i < BENCH_HAL_MAX_SLOTS; i++) {
+        BenchInstance_t* inst = &benchInstances[i];
+        if (inst->xbee != self) continue;
+
+        if (inst->rxStampsNs && inst->rxFrames < inst->rxStampsMax) {
+            inst->rxStampsNs[inst->rxFrames] = benchNowNs();
+        }
+        inst->rxFrames++;
+        // Both LR and Cellular packet structures carry payloadSize; pick the matching layout
+        if (self->vtable->sendData == XBeeLRSendPacket) {
+            inst->rxBytes += ((XBeeLRPacket_t*)data)->payloadSize;
+        } else {
+            inst->rxBytes += ((XBeeCellularPacket_t*)data)->payloadSize;
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Starts a simulated module and attaches a new library instance to it.
+ */
+static bool benchInstanceOpen(BenchInstance_t* inst, uint8_t slot, const XBeeSimConfig_t* simConfig) {
+    memset(inst, 0, sizeof(*inst));
+    inst->slot = slot;
+    inst->ctable.OnReceiveCallback = benchOnReceive;
+
+    if (XBeeSimPtyOpen(&inst->pty, simConfig) != 0 || XBeeSimPtyStart(&inst->pty) != 0) {
+        fprintf(stderr, "bench: unable to start simulator\n");
+        return false;
+    }
+
+    if (simConfig->mode == XBEE_SIM_MODE_LR) {
+        inst->xbee = (XBee*)XBeeLRCreate(&inst->ctable, BenchHalTable(slot));
+    } else {
+        inst->xbee = (XBee*)XBeeCellularCreate(&inst->ctable, BenchHalTable(slot));
+    }
+
+    if (!inst->xbee || !XBeeInit(inst->xbee, simConfig->baudRate, inst->pty.slavePath)) {
+        fprintf(stderr, "bench: unable to initialize XBee on %s\n", inst->pty.slavePath);
+        return false;
+    }
+    return true;
+}
+
+static void benchInstanceClose(BenchInstance_t* inst) {
+    XBeeSimPtyClose(&inst->pty);
+    BenchHalClose(inst->slot);
+    free(inst->xbee);
+    inst->xbee = NULL;
+}
+
+/**
+ * @brief Joins (LR) or waits for attach (Cellular), polling XBeeConnected().
+ *
+ * XBeeProcess() delivers the modem status frame that XBeeConnected() reports.
+ */
+static bool benchInstanceConnect(BenchInstance_t* inst) {
+    XBeeConnect(inst->xbee, false);
+    uint32_t start = portMillis();
+    while (portMillis() - start < BENCH_DRAIN_TIMEOUT_MS) {
+        XBeeProcess(inst->xbee);
+        if (XBeeConnected(inst->xbee)) return true;
+        portDelay(20);
+    }
+    fprintf(stderr, "bench: instance %u did not connect\n", inst->slot);
+    return false;
+}
+
+static uint64_t benchUartBytes(const BenchInstance_t* inst) {
+    const BenchUart_t* uart = BenchHalUart(inst->slot);
+    return uart->bytesRead + uart->bytesWritten;
+}
+
+static uint32_t benchSimFrames(BenchInstance_t* inst) {
+    XBeeSimStats_t stats;
+    XBeeSimPtyGetStats(&inst->pty, &stats);
+    return stats.framesIn + stats.framesOut;
+}
+
+static XBeeSimConfig_t benchSimConfig(const BenchOptions_t* opt, xbee_sim_mode_t mode) {
+    XBeeSimConfig_t c = {
+        .mode = mode,
+        .baudRate = opt->baudRate,
+        .latencyMs = opt->latencyMs,
+        .radioLatencyMs = opt->radioLatencyMs,
+        .joinDelayMs = 0,
+        .echo = true,
+        .seed = 1,
+    };
+    return c;
+}
+
+/**
+ * @brief Adds the throughput and CPU metrics common to every workload.
+ */
+static void benchAddThroughput(BenchResult_t* r, uint32_t frames, uint64_t bytes, uint64_t wallNs,
+                               uint64_t threadCpuNs, uint64_t processCpuNs) {
+    double seconds = wallNs / 1e9;
+    benchResultAdd(r, "wall_ms", wallNs / 1e6);
+    benchResultAdd(r, "frames_per_s", seconds > 0 ? frames / seconds : 0);
+    benchResultAdd(r, "bytes_per_s", seconds > 0 ? bytes / seconds : 0);
+    benchResultAdd(r, "cpu_ms", threadCpuNs / 1e6);
+    benchResultAdd(r, "process_cpu_ms", processCpuNs / 1e6);
+}
+
+/**
+ * @brief Runs `count` ATVR round trips on one instance, recording each latency.
+ *
+ * @return uint32_t Number of round trips that completed successfully.
+ */
+static uint32_t benchAtLoop(BenchInstance_t* inst, uint32_t count, uint64_t* latenciesNs) {
+    uint32_t ok = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t response[8];
+        uint8_t responseLength = 0;
+        uint64_t t0 = benchNowNs();
+        int status = apiSendAtCommandAndGetResponse(inst->xbee, AT_VR, NULL, 0, response,
+                                                    &responseLength, 1000, sizeof(response));
+        if (status == API_SEND_SUCCESS) {
+            latenciesNs[ok++] = benchNowNs() - t0;
+        }
+    }
+    return ok;
+}
+
+static void benchAtRtt(BenchReport_t* report, const BenchOptions_t* opt) {
+    BenchInstance_t* inst = &benchInstances[0];
+    XBeeSimConfig_t simConfig = benchSimConfig(opt, XBEE_SIM_MODE_LR);
+    if (!benchInstanceOpen(inst, 0, &simConfig)) return;
+
+    uint64_t* lat = calloc(opt->iterations, sizeof(uint64_t));
+    uint32_t frames0 = benchSimFrames(inst);
+    uint64_t bytes0 = benchUartBytes(inst);
+    uint64_t cpu0 = benchThreadCpuNs(), pcpu0 = benchProcessCpuNs(), t0 = benchNowNs();
+
+    uint32_t ok = benchAtLoop(inst, opt->iterations, lat);
+
+    uint64_t wall = benchNowNs() - t0;
+    BenchResult_t* r = benchResultNew(report, "at_rtt");
+    benchResultAdd(r, "iterations", opt->iterations);
+    benchResultAdd(r, "failures", opt->iterations - ok);
+    benchResultAddLatency(r, lat, ok);
+    benchAddThroughput(r, benchSimFrames(inst) - frames0, benchUartBytes(inst) - bytes0, wall,
+                       benchThreadCpuNs() - cpu0, benchProcessCpuNs() - pcpu0);
+
+    free(lat);
+    benchInstanceClose(inst);
+}
+
+static void benchLrUplink(BenchReport_t* report, const BenchOptions_t* opt) {
+    BenchInstance_t* inst = &benchInstances[0];
+    XBeeSimConfig_t simConfig = benchSimConfig(opt, XBEE_SIM_MODE_LR);
+    if (!benchInstanceOpen(inst, 0, &simConfig)) return;
+    if (!benchInstanceConnect(inst)) { benchInstanceClose(inst); return; }
+
+    uint8_t payload[BENCH_PAYLOAD_SIZE_LR];
+    for (uint16_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)i;
+    XBeeLRPacket_t packet = { .payload = payload, .payloadSize = sizeof(payload), .port = 2, .ack = 0 };
+
+    uint64_t* lat = calloc(opt->iterations, sizeof(uint64_t));
+    uint32_t frames0 = benchSimFrames(inst);
+    uint64_t bytes0 = benchUartBytes(inst);
+    uint64_t cpu0 = benchThreadCpuNs(), pcpu0 = benchProcessCpuNs(), t0 = benchNowNs();
+
+    uint32_t ok = 0;
+    for (uint32_t i = 0; i < opt->iterations; i++) {
+        payload[0] = (uint8_t)i;
+        uint64_t s = benchNowNs();
+        if (XBeeSendPacket(inst->xbee, &packet) == XBEE_DELIVERY_STATUS_SUCCESS) {
+            lat[ok++] = benchNowNs() - s;
+        }
+    }
+
+    uint64_t wall = benchNowNs() - t0;
+    BenchResult_t* r = benchResultNew(report, "lr_uplink");
+    benchResultAdd(r, "iterations", opt->iterations);
+    benchResultAdd(r, "failures", opt->iterations - ok);
+    benchResultAdd(r, "uplinks_per_s", wall ? ok / (wall / 1e9) : 0);
+    benchResultAddLatency(r, lat, ok);
+    benchAddThroughput(r, benchSimFrames(inst) - frames0, benchUartBytes(inst) - bytes0, wall,
+                       benchThreadCpuNs() - cpu0, benchProcessCpuNs() - pcpu0);
+
+    free(lat);
+    benchInstanceClose(inst);
+}
+
+static void benchCellularBulk(BenchReport_t* report, const BenchOptions_t* opt) {
+    BenchInstance_t* inst = &benchInstances[0];
+    XBeeSimConfig_t simConfig = benchSimConfig(opt, XBEE_SIM_MODE_CELLULAR);
+    if (!benchInstanceOpen(inst, 0, &simConfig)) return;
+    if (!benchInstanceConnect(inst)) { benchInstanceClose(inst); return; }
+
+    const uint8_t ip[4] = { 10, 0, 0, 1 };
+    uint8_t socketId = 0;
+    if (!XBeeCellularSocketCreate(inst->xbee, XBEE_PROTOCOL_TCP, &socketId) ||
+        !XBeeCellularSocketConnect(inst->xbee, socketId, ip, 7, false)) {
+        fprintf(stderr, "bench: cellular socket setup failed\n");
+        benchInstanceClose(inst);
+        return;
+    }
+
+    uint32_t n = opt->iterations;
+    uint8_t payload[BENCH_PAYLOAD_SIZE_CELL];
+    memset(payload, 0x5A, sizeof(payload));
+    uint64_t* sentNs = calloc(n, sizeof(uint64_t));
+    uint64_t* lat = calloc(n, sizeof(uint64_t));
+    inst->rxStampsNs = calloc(n, sizeof(uint64_t));
+    inst->rxStampsMax = n;
+    inst->rxFrames = 0;
+
+    uint32_t frames0 = benchSimFrames(inst);
+    uint64_t bytes0 = benchUartBytes(inst);
+    uint64_t cpu0 = benchThreadCpuNs(), pcpu0 = benchProcessCpuNs(), t0 = benchNowNs();
+
+    // Keep a bounded number of echoes in flight, like a windowed TCP sender
+    uint32_t sent = 0;
+    uint32_t deadline = portMillis() + BENCH_DRAIN_TIMEOUT_MS;
+    while ((sent < n || inst->rxFrames < n) && (int32_t)(portMillis() - deadline) < 0) {
+        if (sent < n && sent - inst->rxFrames < BENCH_CELL_WINDOW) {
+            payload[0] = (uint8_t)sent;
+            sentNs[sent] = benchNowNs();
+            if (XBeeCellularSocketSend(inst->xbee, socketId, payload, sizeof(payload))) sent++;
+        } else {
+            XBeeProcess(inst->xbee);
+        }
+    }
+
+    uint64_t wall = benchNowNs() - t0;
+    uint32_t received = inst->rxFrames < n ? inst->rxFrames : n;
+    for (uint32_t i = 0; i < received; i++) lat[i] = inst->rxStampsNs[i] - sentNs[i];
+
+    BenchResult_t* r = benchResultNew(report, "cellular_bulk");
+    benchResultAdd(r, "iterations", n);
+    benchResultAdd(r, "failures", n - received);
+    benchResultAdd(r, "payload_bytes_per_s", wall ? (double)sent * sizeof(payload) / (wall / 1e9) : 0);
+    benchResultAddLatency(r, lat, received);
+    benchAddThroughput(r, benchSimFrames(inst) - frames0, benchUartBytes(inst) - bytes0, wall,
+                       benchThreadCpuNs() - cpu0, benchProcessCpuNs() - pcpu0);
+
+    XBeeCellularSocketClose(inst->xbee, socketId, false);
+    free(inst->rxStampsNs);
+    free(sentNs);
+    free(lat);
+    benchInstanceClose(inst);
+}
+
+static void benchRxBurst(BenchReport_t* report, const BenchOptions_t* opt) {
+    BenchInstance_t* inst = &benchInstances[0];
+    XBeeSimConfig_t simConfig = benchSimConfig(opt, XBEE_SIM_MODE_LR);
+    simConfig.radioLatencyMs = 0;
+    simConfig.explicitRx = true;
+    if (!benchInstanceOpen(inst, 0, &simConfig)) return;
+    if (!benchInstanceConnect(inst)) { benchInstanceClose(inst); return; }
+
+    uint32_t bursts = opt->iterations / BENCH_RX_BURST;
+    if (bursts == 0) bursts = 1;
+    uint32_t total = bursts * BENCH_RX_BURST;
+    uint8_t payload[BENCH_PAYLOAD_SIZE_RX];
+    memset(payload, 0xA5, sizeof(payload));
+    uint64_t* lat = calloc(total, sizeof(uint64_t));
+    inst->rxStampsNs = calloc(total, sizeof(uint64_t));
+    inst->rxStampsMax = total;
+    inst->rxFrames = 0;
+
+    uint32_t frames0 = benchSimFrames(inst);
+    uint64_t bytes0 = benchUartBytes(inst);
+    uint64_t cpu0 = benchThreadCpuNs(), pcpu0 = benchProcessCpuNs(), t0 = benchNowNs();
+
+    uint32_t injected = 0;
+    for (uint32_t b = 0; b < bursts; b++) {
+        uint64_t burstNs = benchNowNs();
+        uint32_t first = inst->rxFrames;
+        for (uint32_t i = 0; i < BENCH_RX_BURST; i++) {
+            if (XBeeSimPtyInjectDownlink(&inst->pty, 2, payload, sizeof(payload))) injected++;
+        }
+
+        uint32_t start = portMillis();
+        while (inst->rxFrames < injected && portMillis() - start < BENCH_DRAIN_TIMEOUT_MS) {
+            XBeeProcess(inst->xbee);
+        }
+        uint32_t last = inst->rxFrames < total ? inst->rxFrames : total;
+        for (uint32_t i = first; i < last; i++) lat[i] = inst->rxStampsNs[i] - burstNs;
+    }
+
+    uint64_t wall = benchNowNs() - t0;
+    uint32_t received = inst->rxFrames < total ? inst->rxFrames : total;
+    BenchResult_t* r = benchResultNew(report, "rx_burst");
+    benchResultAdd(r, "iterations", total);
+    benchResultAdd(r, "burst_size", BENCH_RX_BURST);
+    benchResultAdd(r, "failures", total - received);
+    benchResultAdd(r, "payload_bytes_per_s", wall ? inst->rxBytes / (wall / 1e9) : 0);
+    benchResultAddLatency(r, lat, received);
+    benchAddThroughput(r, benchSimFrames(inst) - frames0, benchUartBytes(inst) - bytes0, wall,
+                       benchThreadCpuNs() - cpu0, benchProcessCpuNs() - pcpu0);
+
+    free(inst->rxStampsNs);
+    free(lat);
+    benchInstanceClose(inst);
+}
+
+static void* benchMultiThread(void* arg) {
+    BenchInstance_t* inst = (BenchInstance_t*)arg;
+    uint64_t cpu0 = benchThreadCpuNs();
+    inst->completed = benchAtLoop(inst, inst->iterations, inst->latenciesNs);
+    inst->cpuNs = benchThreadCpuNs() - cpu0;
+    return NULL;
+}
+
+static void benchMultiInstance(BenchReport_t* report, const BenchOptions_t* opt, uint8_t count) {
+    XBeeSimConfig_t simConfig = benchSimConfig(opt, XBEE_SIM_MODE_LR);
+    pthread_t threads[BENCH_HAL_MAX_SLOTS];
+    uint8_t opened = 0;
+
+    for (; opened < count; opened++) {
+        BenchInstance_t* inst = &benchInstances[opened];
+        if (!benchInstanceOpen(inst, opened, &simConfig)) break;
+        inst->iterations = opt->iterations;
+        inst->latenciesNs = calloc(opt->iterations, sizeof(uint64_t));
+    }
+
+    if (opened == count) {
+        uint32_t frames0 = 0;
+        uint64_t bytes0 = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            frames0 += benchSimFrames(&benchInstances[i]);
+            bytes0 += benchUartBytes(&benchInstances[i]);
+        }
+        uint64_t pcpu0 = benchProcessCpuNs(), t0 = benchNowNs();
+
+        for (uint8_t i = 0; i < count; i++) {
+            pthread_create(&threads[i], NULL, benchMultiThread, &benchInstances[i]);
+        }
+        for (uint8_t i = 0; i < count; i++) pthread_join(threads[i], NULL);
+
+        uint64_t wall = benchNowNs() - t0;
+        uint64_t* all = calloc((size_t)count * opt->iterations, sizeof(uint64_t));
+        uint32_t completed = 0, frames = 0;
+        uint64_t bytes = 0, cpu = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            BenchInstance_t* inst = &benchInstances[i];
+            memcpy(&all[completed], inst->latenciesNs, inst->completed * sizeof(uint64_t));
+            completed += inst->completed;
+            frames += benchSimFrames(inst);
+            bytes += benchUartBytes(inst);
+            cpu += inst->cpuNs;
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "multi_instance_%u", count);
+        BenchResult_t* r = benchResultNew(report, name);
+        benchResultAdd(r, "instances", count);
+        benchResultAdd(r, "iterations", (double)count * opt->iterations);
+        benchResultAdd(r, "failures", (double)count * opt->iterations - completed);
+        benchResultAdd(r, "at_per_s", wall ? completed / (wall / 1e9) : 0);
+        benchResultAddLatency(r, all, completed);
+        benchAddThroughput(r, frames - frames0, bytes - bytes0, wall, cpu, benchProcessCpuNs() - pcpu0);
+        free(all);
+    }
+
+    for (uint8_t i = 0; i < opened; i++) {
+        free(benchInstances[i].latenciesNs);
+        benchInstanceClose(&benchInstances[i]);
+    }
+}
+
+static bool benchSelected(const BenchOptions_t* opt, const char* name) {
+    return !opt->only || strncmp(opt->only, name, strlen(opt->only)) == 0;
+}
+
+static void usage(const char* prog) {
+    printf("Usage: %s [options]\n"
+           "  --iterations N        Work items per workload (default 200)\n"
+           "  --baud N              Simulated UART baud rate, 0 = unpaced (default 0)\n"
+           "  --latency MS          Simulated local command latency (default 0)\n"
+           "  --radio-latency MS    Simulated over-the-air latency (default 0)\n"
+           "  --only PREFIX         Run only workloads whose name starts with PREFIX\n"
+           "  --out FILE            Write JSON to FILE instead of stdout\n", prog);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions_t opt = { .iterations = 200 };
+    static const struct option options[] = {
+        { "iterations",    required_argument, 0, 'n' },
+        { "baud",          required_argument, 0, 'b' },
+        { "latency",       required_argument, 0, 'l' },
+        { "radio-latency", required_argument, 0, 'r' },
+        { "only",          required_argument, 0, 'o' },
+        { "out",           required_argument, 0, 'O' },
+        { "help",          no_argument,       0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (c) {
+            case 'n': opt.iterations = strtoul(optarg, NULL, 0); break;
+            case 'b': opt.baudRate = strtoul(optarg, NULL, 0); break;
+            case 'l': opt.latencyMs = strtoul(optarg, NULL, 0); break;
+            case 'r': opt.radioLatencyMs = strtoul(optarg, NULL, 0); break;
+            case 'o': opt.only = optarg; break;
+            case 'O': opt.outPath = optarg; break;
+            default: usage(argv[0]); return c == 'h' ? 0 : 1;
+        }
+    }
+    if (opt.iterations == 0) opt.iterations = 1;
+
+    static BenchReport_t report = { .suite = "xbee_e2e" };
+
+    if (benchSelected(&opt, "at_rtt")) benchAtRtt(&report, &opt);
+    if (benchSelected(&opt, "lr_uplink")) benchLrUplink(&report, &opt);
+    if (benchSelected(&opt, "cellular_bulk")) benchCellularBulk(&report, &opt);
+    if (benchSelected(&opt, "rx_burst")) benchRxBurst(&report, &opt);
+    for (uint8_t n = 1; n <= BENCH_HAL_MAX_SLOTS; n *= 2) {
+        if (benchSelected(&opt, "multi_instance")) benchMultiInstance(&report, &opt, n);
+    }
+
+    FILE* out = opt.outPath ? fopen(opt.outPath, "w") : stdout;
+    if (!out) {
+        perror("bench: unable to open output");
+        return 1;
+    }
+    benchReportWrite(&report, out);
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file xbee_bench_fault.c
+ * @brief Frame loss and resync time of the receive path under injected UART faults.
+ *
+ * A generated LR RX frame stream is fed through the fault-injection shim
+ * (ports/port_fault.c) into apiReceiveApiFrame(). The source HAL runs on a
+ * virtual clock: frame i becomes readable at i * interval ms and time only
+ * advances through PortDelay(), so every run is deterministic for a given
+ * seed and a multi-minute stream completes in a fraction of a second.
+ *
+ * Each workload reports frames lost per injected fault, frames that passed
+ * the checksum with corrupted content, and the virtual time from a fault to
+ * the next valid frame (resync time).
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "bench_util.h"
+#include "port_fault.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include <getopt.h>
+
+#define FAULT_SEQ_BYTES 4
+
+/**
+ * @brief A named set of fault rates.
+ */
+typedef struct {
+    const char* name;
+    PortFaultConfig_t config;
+} FaultWorkload_t;
+
+// ==== Virtual-clock frame source ====
+
+static uint8_t* sourceStream;
+static uint32_t* sourceFrameEnd;    ///< Stream offset just past frame i
+static uint32_t sourceFrames;
+static uint32_t sourcePos;
+static uint32_t sourceIntervalMs;
+static uint32_t sourceNowMs;
+
+static int sourceUartRead(uint8_t* buffer, int length) {
+    uint32_t due = sourceNowMs / sourceIntervalMs + 1;
+    if (due > sourceFrames) due = sourceFrames;
+    uint32_t limit = sourceFrameEnd[due - 1];
+    uint32_t avail = limit > sourcePos ? limit - sourcePos : 0;
+    uint32_t n = (uint32_t)length < avail ? (uint32_t)length : avail;
+    memcpy(buffer, &sourceStream[sourcePos], n);
+    sourcePos += n;
+    return (int)n;
+}
+
+static int sourceUartWrite(const uint8_t* buf, uint16_t len) { (void)buf; return len; }
+static uint32_t sourceMillis(void) { return sourceNowMs; }
+static void sourceFlushRx(void) {}
+static int sourceUartInit(uint32_t baudrate, void* device) { (void)baudrate; (void)device; return UART_SUCCESS; }
+static void sourceDelay(uint32_t ms) { sourceNowMs += ms; }
+
+static const XBeeHTable sourceHTable = {
+    .PortUartRead  = sourceUartRead,
+    .PortUartWrite = sourceUartWrite,
+    .PortMillis    = sourceMillis,
+    .PortFlushRx   = sourceFlushRx,
+    .PortUartInit  = sourceUartInit,
+    .PortDelay     = sourceDelay,
+};
+
+static const XBeeHTable faultHTable = {
+    .PortUartRead  = portFaultUartRead,
+    .PortUartWrite = portFaultUartWrite,
+    .PortMillis    = portFaultMillis,
+    .PortFlushRx   = portFaultFlushRx,
+    .PortUartInit  = portFaultUartInit,
+    .PortDelay     = portFaultDelay,
+};
+
+static const XBeeCTable faultCTable = {0};
+
+static uint8_t payloadByte(uint32_t seq, uint16_t i) {
+    return (uint8_t)(seq * 31 + i * 7);
+}
+
+/**
+ * @brief Builds N encoded LR RX (0xD0) frames carrying a sequence number and a known pattern.
+ */
+static bool sourceBuild(uint32_t frames, uint16_t payloadSize, uint32_t intervalMs) {
+    uint16_t dataLen = 2 + payloadSize;
+    size_t frameSize = (size_t)dataLen + 4;
+
+    sourceStream = (uint8_t*)malloc(frameSize * frames);
+    sourceFrameEnd = (uint32_t*)malloc(sizeof(uint32_t) * frames);
+    if (!sourceStream || !sourceFrameEnd) return false;
+
+    uint8_t* p = sourceStream;
+    for (uint32_t seq = 0; seq < frames; seq++) {
+        uint8_t sum = 0;
+        p[0] = 0x7E;
+        p[1] = dataLen >> 8;
+        p[2] = dataLen & 0xFF;
+        p[3] = XBEE_API_TYPE_LR_RX_PACKET;
+        p[4] = 2;
+        for (uint16_t i = 0; i < payloadSize; i++) {
+            p[5 + i] = i < FAULT_SEQ_BYTES ? (uint8_t)(seq >> (8 * (FAULT_SEQ_BYTES - 1 - i))) : payloadByte(seq, i);
+        }
+        for (uint16_t i = 0; i < dataLen; i++) sum += p[3 + i];
+        p[3 + dataLen] = 0xFF - sum;
+        p += frameSize;
+        sourceFrameEnd[seq] = (uint32_t)(p - sourceStream);
+    }
+    sourceFrames = frames;
+    sourceIntervalMs = intervalMs;
+    return true;
+}
+
+/**
+ * @brief Returns the sequence number of a received frame, or -1 if its content is corrupt.
+ */
+static int64_t frameSequence(const xbee_api_frame_t* frame, uint16_t payloadSize) {
+    if (frame->type != XBEE_API_TYPE_LR_RX_PACKET || frame->length != 2 + payloadSize || frame->data[1] != 2) {
+        return -1;
+    }
+    const uint8_t* payload = &frame->data[2];
+    uint32_t seq = 0;
+    for (uint16_t i = 0; i < FAULT_SEQ_BYTES; i++) seq = (seq << 8) | payload[i];
+    if (seq >= sourceFrames) return -1;
+    for (uint16_t i = FAULT_SEQ_BYTES; i < payloadSize; i++) {
+        if (payload[i] != payloadByte(seq, i)) return -1;
+    }
+    return seq;
+}
+
+static void runWorkload(BenchReport_t* report, const FaultWorkload_t* w, uint16_t payloadSize, uint32_t seed) {
+    PortFaultConfig_t config = w->config;
+    PortFaultStats_t stats;
+    xbee_api_frame_t frame;
+    uint8_t* seen = (uint8_t*)calloc(sourceFrames, 1);
+    uint64_t* resyncNs = (uint64_t*)malloc(sizeof(uint64_t) * (sourceFrames + 1));
+    size_t resyncCount = 0;
+    uint32_t received = 0, duplicates = 0, corrupt = 0, errors = 0;
+    uint32_t faultsSeen = 0, pendingMs = 0;
+    bool pending = false;
+
+    if (!seen || !resyncNs) {
+        free(seen);
+        free(resyncNs);
+        return;
+    }
+
+    config.seed = seed;
+    sourcePos = 0;
+    sourceNowMs = 0;
+    portFaultStart(&sourceHTable, &config);
+    XBeeLR* lr = XBeeLRCreate(&faultCTable, &faultHTable);
+
+    uint32_t endMs = (sourceFrames - 1) * sourceIntervalMs + 2 * UART_READ_TIMEOUT_MS;
+    uint64_t cpuStart = benchProcessCpuNs();
+    while (sourceNowMs < endMs) {
+        api_receive_status_t status = apiReceiveApiFrame((XBee*)lr, &frame);
+        portFaultGetStats(&stats);
+        if (stats.faults != faultsSeen && !pending) {
+            pending = true;
+            pendingMs = stats.lastFaultMs;
+        }
+        if (status != API_RECEIVE_SUCCESS) {
+            if (status != API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER) errors++;
+            continue;
+        }
+
+        int64_t seq = frameSequence(&frame, payloadSize);
+        if (seq < 0) {
+            corrupt++;
+            continue;
+        }
+        if (seen[seq]) {
+            duplicates++;
+            continue;
+        }
+        seen[seq] = 1;
+        received++;
+        if (pending) {
+            resyncNs[resyncCount++] = (uint64_t)(sourceNowMs - pendingMs) * 1000000ull;
+            pending = false;
+        }
+        faultsSeen = stats.faults;
+    }
+    uint64_t cpuNs = benchProcessCpuNs() - cpuStart;
+
+    uint32_t lost = sourceFrames - received;
+    BenchResult_t* r = benchResultNew(report, w->name);
+    benchResultAdd(r, "frames_sent", sourceFrames);
+    benchResultAdd(r, "frames_received", received);
+    benchResultAdd(r, "faults", stats.faults);
+    benchResultAdd(r, "frames_lost", lost);
+    benchResultAdd(r, "frames_lost_per_fault", stats.faults ? (double)lost / stats.faults : 0);
+    benchResultAdd(r, "corrupt_accepted", corrupt);
+    benchResultAdd(r, "duplicates", duplicates);
+    benchResultAdd(r, "receive_errors", errors);
+    benchResultAdd(r, "resync_samples", resyncCount);
+    benchResultAdd(r, "resync_p50_ms", benchPercentile(resyncNs, resyncCount, 50) / 1e6);
+    benchResultAdd(r, "resync_p99_ms", benchPercentile(resyncNs, resyncCount, 99) / 1e6);
+    benchResultAdd(r, "resync_max_ms", resyncCount ? resyncNs[resyncCount - 1] / 1e6 : 0);
+    benchResultAdd(r, "goodput_frames_per_s", received / (sourceNowMs / 1000.0));
+    benchResultAdd(r, "cpu_ms", cpuNs / 1e6);
+
+    free(lr);
+    free(seen);
+    free(resyncNs);
+}
+
+static const FaultWorkload_t workloads[] = {
+    { "clean",             { 0 } },
+    { "bit_flip_100ppm",   { .bitFlipPpm = 100 } },
+    { "bit_flip_1000ppm",  { .bitFlipPpm = 1000 } },
+    { "drop_1000ppm",      { .dropPpm = 1000 } },
+    { "duplicate_1000ppm", { .duplicatePpm = 1000 } },
+    { "garbage_1000ppm",   { .garbagePpm = 1000 } },
+    { "delay_1000ppm",     { .delayPpm = 1000, .delayMs = 100 } },
+    { "truncate_1pct",     { .truncatePpm = 10000 } },
+    { "mixed_noisy_link",  { .bitFlipPpm = 500, .dropPpm = 200, .duplicatePpm = 100, .garbagePpm = 200,
+                             .delayPpm = 100, .delayMs = 50, .truncatePpm = 2000 } },
+};
+
+static void usage(const char* prog) {
+    printf("Usage: %s [options]\n"
+           "  --frames N      Frames per workload (default 5000)\n"
+           "  --payload N     LR RX payload bytes, at least 4 (default 32)\n"
+           "  --interval MS   Virtual time between frames (default 20)\n"
+           "  --seed N        Fault PRNG seed (default 1)\n"
+           "  --only NAME     Run only the named workload\n"
+           "  --out FILE      Write JSON to FILE instead of stdout\n", prog);
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = 5000;
+    uint32_t payload = 32;
+    uint32_t intervalMs = 20;
+    uint32_t seed = 1;
+    const char* only = NULL;
+    const char* outPath = NULL;
+    static const struct option options[] = {
+        { "frames",   required_argument, 0, 'n' },
+        { "payload",  required_argument, 0, 'p' },
+        { "interval", required_argument, 0, 'i' },
+        { "seed",     required_argument, 0, 's' },
+        { "only",     required_argument, 0, 'o' },
+        { "out",      required_argument, 0, 'O' },
+        { "help",     no_argument,       0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (c) {
+            case 'n': frames = strtoul(optarg, NULL, 0); break;
+            case 'p': payload = strtoul(optarg, NULL, 0); break;
+            case 'i': intervalMs = strtoul(optarg, NULL, 0); break;
+            case 's': seed = strtoul(optarg, NULL, 0); break;
+            case 'o': only = optarg; break;
+            case 'O': outPath = optarg; break;
+            default: usage(argv[0]); return c == 'h' ? 0 : 1;
+        }
+    }
+    if (frames == 0 || intervalMs == 0 || payload < FAULT_SEQ_BYTES || payload > XBEE_LR_MAX_FRAME_DATA_SIZE - 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!sourceBuild(frames, (uint16_t)payload, intervalMs)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    static BenchReport_t report = { .suite = "xbee_fault" };
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+        if (only && strcmp(only, workloads[i].name) != 0) continue;
+        runWorkload(&report, &workloads[i], (uint16_t)payload, seed);
+    }
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        perror("bench: unable to open output");
+        return 1;
+    }
+    benchReportWrite(&report, out);
+    if (out != stdout) fclose(out);
+
+    free(sourceStream);
+    free(sourceFrameEnd);
+    return 0;
+}
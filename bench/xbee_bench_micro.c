@@ -0,0 +1,454 @@
+/**
+ * @file xbee_bench_micro.c
+ * @brief Microbenchmarks for the CPU-bound framing, checksum and parsing kernels.
+ *
+ * The library runs against in-memory HAL stubs: writes land in a sink buffer,
+ * reads replay a pre-encoded frame stream and time never advances, so only
+ * CPU work is measured. xbee_api_frames.c is compiled into this translation
+ * unit (the same approach test_xbee_at_cmds.c uses) to reach its static
+ * kernels directly.
+ *
+ * Each kernel reports ns per operation and bytes per cycle. Cycles come from
+ * the time-stamp counter on x86, or from --cpu-mhz when given, which is the
+ * figure to use when extrapolating to a fixed-clock MCU.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "../src/xbee_api_frames.c"
+#include "xbee_lr.h"
+#include "xbee_cellular.h"
+#include "bench_util.h"
+#include <getopt.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+#define MICRO_STREAM_SIZE 65536
+#define MICRO_REPEATS 5
+
+/*****************************************************************************
+ * In-memory HAL stubs
+ *****************************************************************************/
+
+static uint8_t microSink[4096];
+static size_t microSinkLen;
+static uint8_t microStream[MICRO_STREAM_SIZE];
+static size_t microStreamLen;
+static size_t microStreamPos;
+
+static int microUartWrite(const uint8_t* buf, uint16_t len) {
+    if (len > sizeof(microSink)) len = sizeof(microSink);
+    memcpy(microSink, buf, len);
+    microSinkLen = len;
+    return len;
+}
+
+static int microUartRead(uint8_t* buffer, int length) {
+    int n = 0;
+    while (n < length) {
+        size_t avail = microStreamLen - microStreamPos;
+        size_t chunk = (size_t)(length - n) < avail ? (size_t)(length - n) : avail;
+        memcpy(buffer + n, microStream + microStreamPos, chunk);
+        n += chunk;
+        microStreamPos += chunk;
+        if (microStreamPos == microStreamLen) microStreamPos = 0;
+    }
+    return n;
+}
+
+static uint32_t microMillis(void) { return 0; }
+static void microFlushRx(void) {}
+static int microUartInit(uint32_t baudrate, void* device) { (void)baudrate; (void)device; return UART_SUCCESS; }
+static void microDelay(uint32_t ms) { (void)ms; }
+
+static const XBeeHTable microHTable = {
+    .PortUartRead = microUartRead,
+    .PortUartWrite = microUartWrite,
+    .PortMillis = microMillis,
+    .PortFlushRx = microFlushRx,
+    .PortUartInit = microUartInit,
+    .PortDelay = microDelay,
+};
+
+static volatile uint32_t microRxCount;
+static void microOnReceive(XBee* self, void* data) { (void)self; (void)data; microRxCount++; }
+static const XBeeCTable microCTable = { .OnReceiveCallback = microOnReceive };
+
+/**
+ * @brief Encodes one API frame (type byte included in data) into a buffer.
+ *
+ * @return size_t Encoded length.
+ */
+static size_t microEncode(uint8_t* out, const uint8_t* data, uint16_t len) {
+    uint8_t sum = 0;
+    out[0] = 0x7E;
+    out[1] = len >> 8;
+    out[2] = len & 0xFF;
+    for (uint16_t i = 0; i < len; i++) {
+        out[3 + i] = data[i];
+        sum += data[i];
+    }
+    out[3 + len] = 0xFF - sum;
+    return (size_t)len + 4;
+}
+
+/**
+ * @brief Fills the replay stream with back-to-back copies of one frame, escaped if asked to.
+ */
+static void microLoadStream(const uint8_t* data, uint16_t len, bool escaped) {
+    uint8_t plain[XBEE_MAX_FRAME_DATA_SIZE + 4];
+    uint8_t frame[2 * sizeof(plain)];
+    size_t frameLen = microEncode(plain, data, len);
+    if (escaped) {
+        size_t consumed;
+        frame[0] = plain[0];
+        frameLen = 1 + xbeeEscape(&frame[1], sizeof(frame) - 1, &plain[1], frameLen - 1, &consumed);
+    } else {
+        memcpy(frame, plain, frameLen);
+    }
+    microStreamLen = 0;
+    while (microStreamLen + frameLen <= sizeof(microStream)) {
+        memcpy(microStream + microStreamLen, frame, frameLen);
+        microStreamLen += frameLen;
+    }
+    microStreamPos = 0;
+}
+
+/*****************************************************************************
+ * Measurement
+ *****************************************************************************/
+
+static double microCpuMhz;
+
+static inline uint64_t microCycles(void) {
+#if BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+typedef void (*MicroKernel_t)(void* ctx, uint32_t iterations);
+
+/**
+ * @brief Times a kernel, keeping the fastest of several repeats, and records the result.
+ *
+ * @param[in] bytesPerOp Payload bytes processed per operation, for bytes/cycle (0 to omit).
+ */
+static void microRun(BenchReport_t* report, const char* name, MicroKernel_t kernel, void* ctx,
+                     uint32_t iterations, uint32_t bytesPerOp) {
+    uint64_t bestNs = UINT64_MAX, bestCycles = UINT64_MAX;
+
+    kernel(ctx, iterations / 10 + 1);   // Warm caches and branch predictors
+    for (int r = 0; r < MICRO_REPEATS; r++) {
+        uint64_t c0 = microCycles();
+        uint64_t t0 = benchThreadCpuNs();
+        kernel(ctx, iterations);
+        uint64_t ns = benchThreadCpuNs() - t0;
+        uint64_t cycles = microCycles() - c0;
+        if (ns < bestNs) { bestNs = ns; bestCycles = cycles; }
+    }
+
+    double nsPerOp = (double)bestNs / iterations;
+    double cyclesPerOp = microCpuMhz > 0 ? nsPerOp * microCpuMhz / 1000.0
+                                          : (BENCH_HAVE_TSC ? (double)bestCycles / iterations : 0);
+
+    BenchResult_t* res = benchResultNew(report, name);
+    benchResultAdd(res, "iterations", iterations);
+    benchResultAdd(res, "ns_per_op", nsPerOp);
+    benchResultAdd(res, "cycles_per_op", cyclesPerOp);
+    if (bytesPerOp) {
+        benchResultAdd(res, "bytes_per_op", bytesPerOp);
+        benchResultAdd(res, "bytes_per_cycle", cyclesPerOp > 0 ? bytesPerOp / cyclesPerOp : 0);
+        benchResultAdd(res, "mb_per_s", nsPerOp > 0 ? bytesPerOp / nsPerOp * 1000.0 : 0);
+    }
+}
+
+/*****************************************************************************
+ * Kernels
+ *****************************************************************************/
+
+typedef struct {
+    XBee* xbee;
+    uint8_t buf[XBEE_MAX_FRAME_DATA_SIZE + 4];
+    uint16_t len;
+    xbee_api_frame_t frame;
+    const char* text;
+} MicroCtx_t;
+
+static volatile uint32_t microSinkValue;
+
+/**
+ * @brief The byte-at-a-time loop the library used before xbee_checksum.c, as a baseline.
+ */
+static uint8_t microChecksumBytewise(const uint8_t* data, uint16_t len) {
+    uint8_t sum = 0;
+    for (uint16_t i = 0; i < len; i++) {
+        sum += data[i];
+    }
+    return 0xFF - sum;
+}
+
+static void kernelChecksumBytewise(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        ctx->buf[0] = (uint8_t)i;   // Defeat hoisting of the loop-invariant sum
+        acc += microChecksumBytewise(ctx->buf, ctx->len);
+    }
+    microSinkValue = acc;
+}
+
+static void kernelChecksum(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        ctx->buf[0] = (uint8_t)i;
+        acc += 0xFF - xbeeChecksumAdd(0, ctx->buf, ctx->len);
+    }
+    microSinkValue = acc;
+}
+
+static void kernelChecksumCopy(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    static uint8_t copy[sizeof(ctx->buf)];
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        ctx->buf[0] = (uint8_t)i;
+        acc += xbeeChecksumCopy(0, copy, ctx->buf, ctx->len);
+    }
+    microSinkValue = acc + copy[0];
+}
+
+static void kernelEscape(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    uint8_t wire[2 * sizeof(ctx->buf)];
+    size_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        size_t consumed;
+        acc += xbeeEscape(wire, sizeof(wire), ctx->buf, ctx->len, &consumed);
+    }
+    microSinkValue = (uint32_t)acc;
+}
+
+static void kernelSendFrame(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    for (uint32_t i = 0; i < n; i++) {
+        apiSendFrame(ctx->xbee, XBEE_API_TYPE_LR_TX_REQUEST, ctx->buf, ctx->len);
+    }
+    microSinkValue = microSinkLen;
+}
+
+static void kernelReceiveFrame(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    uint32_t ok = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        ok += apiReceiveApiFrame(ctx->xbee, &ctx->frame) == API_RECEIVE_SUCCESS;
+    }
+    microSinkValue = ok;
+}
+
+static void kernelAsciiToHex(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    int acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += asciiToHexArray(ctx->text, ctx->buf, sizeof(ctx->buf));
+    }
+    microSinkValue = acc;
+}
+
+static void kernelAtToString(void* p, uint32_t n) {
+    (void)p;
+    uintptr_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uintptr_t)atCommandToString((at_command_t)(i % AT_COMMAND_COUNT));
+    }
+    microSinkValue = (uint32_t)acc;
+}
+
+static void kernelAtFromString(void* p, uint32_t n) {
+    (void)p;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        at_command_t command = AT_;
+        atCommandFromString(AT_MODULE_COMMON, atCommandToString((at_command_t)(i % AT_COMMAND_COUNT)), &command);
+        acc += command;
+    }
+    microSinkValue = acc;
+}
+
+static void kernelRxParse(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    for (uint32_t i = 0; i < n; i++) {
+        ctx->xbee->vtable->handleRxPacketFrame(ctx->xbee, &ctx->frame);
+    }
+}
+
+static void kernelHandleFrame(void* p, uint32_t n) {
+    MicroCtx_t* ctx = p;
+    for (uint32_t i = 0; i < n; i++) {
+        apiHandleFrame(ctx->xbee, ctx->frame);
+    }
+}
+
+/**
+ * @brief Builds a received frame structure the way apiReceiveApiFrame() would, over `data`.
+ */
+static void microMakeFrame(xbee_api_frame_t* frame, uint8_t* data, uint16_t len) {
+    memset(frame, 0, sizeof(*frame));
+    frame->data = data;
+    frame->length = len;
+    frame->type = data[0];
+}
+
+static void usage(const char* prog) {
+    printf("Usage: %s [options]\n"
+           "  --scale N       Multiply iteration counts by N (default 1)\n"
+           "  --cpu-mhz MHZ   Convert time to cycles at this clock instead of the TSC\n"
+           "  --out FILE      Write JSON to FILE instead of stdout\n", prog);
+}
+
+int main(int argc, char** argv) {
+    uint32_t scale = 1;
+    const char* outPath = NULL;
+    static const struct option options[] = {
+        { "scale",   required_argument, 0, 's' },
+        { "cpu-mhz", required_argument, 0, 'm' },
+        { "out",     required_argument, 0, 'O' },
+        { "help",    no_argument,       0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (c) {
+            case 's': scale = strtoul(optarg, NULL, 0); break;
+            case 'm': microCpuMhz = strtod(optarg, NULL); break;
+            case 'O': outPath = optarg; break;
+            default: usage(argv[0]); return c == 'h' ? 0 : 1;
+        }
+    }
+    if (scale == 0) scale = 1;
+
+    static BenchReport_t report = { .suite = "xbee_micro" };
+    static MicroCtx_t ctx;
+    XBeeLR* lr = XBeeLRCreate(&microCTable, &microHTable);
+    XBeeCellular* cell = XBeeCellularCreate(&microCTable, &microHTable);
+    lr->base.frameIdCntr = 1;
+    cell->base.frameIdCntr = 1;
+    lr->base.apiMode = XBEE_API_MODE_UNESCAPED;
+    cell->base.apiMode = XBEE_API_MODE_UNESCAPED;
+    ctx.xbee = (XBee*)lr;
+
+    static const uint16_t checksumSizes[] = { 16, 64, 256, 1024 };
+    for (size_t i = 0; i < sizeof(checksumSizes) / sizeof(checksumSizes[0]); i++) {
+        char name[32];
+        for (uint16_t b = 0; b < sizeof(ctx.buf); b++) ctx.buf[b] = (uint8_t)(b * 7);
+        ctx.len = checksumSizes[i];
+        uint32_t iterations = 200000 * scale / (ctx.len / 16);
+        snprintf(name, sizeof(name), "checksum_bytewise_%u", ctx.len);
+        microRun(&report, name, kernelChecksumBytewise, &ctx, iterations, ctx.len);
+        snprintf(name, sizeof(name), "checksum_%u", ctx.len);
+        microRun(&report, name, kernelChecksum, &ctx, iterations, ctx.len);
+        snprintf(name, sizeof(name), "checksum_copy_%u", ctx.len);
+        microRun(&report, name, kernelChecksumCopy, &ctx, iterations, ctx.len);
+    }
+
+    // b * 7 hits each byte value once per 256, so 4 in 256 bytes need escaping
+    static const uint16_t escapeSizes[] = { 64, 1024 };
+    for (size_t i = 0; i < sizeof(escapeSizes) / sizeof(escapeSizes[0]); i++) {
+        char name[32];
+        ctx.len = escapeSizes[i];
+        snprintf(name, sizeof(name), "escape_%u", ctx.len);
+        microRun(&report, name, kernelEscape, &ctx, 200000 * scale / (ctx.len / 16), ctx.len);
+    }
+
+    // apiSendFrame() assembles into a 256 byte stack buffer
+    static const uint16_t sendSizes[] = { 8, 64, 240 };
+    for (int escaped = 0; escaped <= 1; escaped++) {
+        ctx.xbee->apiMode = escaped ? XBEE_API_MODE_ESCAPED : XBEE_API_MODE_UNESCAPED;
+        for (size_t i = 0; i < sizeof(sendSizes) / sizeof(sendSizes[0]); i++) {
+            char name[32];
+            ctx.len = sendSizes[i];
+            snprintf(name, sizeof(name), escaped ? "send_frame_escaped_%u" : "send_frame_%u", ctx.len);
+            microRun(&report, name, kernelSendFrame, &ctx, 200000 * scale, ctx.len + 5);
+        }
+    }
+
+    // Received on the cellular instance, whose frame limit covers all of the sizes
+    static const uint16_t receiveSizes[] = { 8, 64, 256, 1024 };
+    ctx.xbee = (XBee*)cell;
+    for (int escaped = 0; escaped <= 1; escaped++) {
+        ctx.xbee->apiMode = escaped ? XBEE_API_MODE_ESCAPED : XBEE_API_MODE_UNESCAPED;
+        for (size_t i = 0; i < sizeof(receiveSizes) / sizeof(receiveSizes[0]); i++) {
+            char name[32];
+            uint8_t data[XBEE_MAX_FRAME_DATA_SIZE];
+            uint16_t len = receiveSizes[i];
+            data[0] = XBEE_API_TYPE_LR_RX_PACKET;
+            for (uint16_t b = 1; b < len; b++) data[b] = (uint8_t)b;
+            microLoadStream(data, len, escaped);
+            snprintf(name, sizeof(name), escaped ? "receive_frame_escaped_%u" : "receive_frame_%u", len);
+            microRun(&report, name, kernelReceiveFrame, &ctx, 100000 * scale / (len / 8 > 16 ? 16 : len / 8), len + 4);
+        }
+    }
+    ctx.xbee->apiMode = XBEE_API_MODE_UNESCAPED;
+    ctx.xbee = (XBee*)lr;
+
+    ctx.text = "CD32AAB41C54175E9060D86F3A8B7F48";
+    microRun(&report, "ascii_to_hex_32", kernelAsciiToHex, &ctx, 200000 * scale, 32);
+    ctx.text = "9E1177BD6B1DF41E";
+    microRun(&report, "ascii_to_hex_16", kernelAsciiToHex, &ctx, 200000 * scale, 16);
+
+    microRun(&report, "at_command_to_string", kernelAtToString, &ctx, 2000000 * scale, 0);
+    microRun(&report, "at_command_from_string", kernelAtFromString, &ctx, 2000000 * scale, 0);
+
+    uint8_t rx[10 + 64] = { XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET, 2, 0xC4, 0x08, 0x10, 0, 0, 0, 1, 0 };
+    microMakeFrame(&ctx.frame, rx, sizeof(rx));
+    microRun(&report, "lr_rx_parse", kernelRxParse, &ctx, 1000000 * scale, 64);
+    microRun(&report, "handle_frame_lr_rx", kernelHandleFrame, &ctx, 1000000 * scale, 64);
+
+    uint8_t cellRx[4 + 120] = { XBEE_API_TYPE_CELLULAR_SOCKET_RX, 0, 0, 0 };
+    microMakeFrame(&ctx.frame, cellRx, sizeof(cellRx));
+    ctx.xbee = (XBee*)cell;
+    microRun(&report, "cellular_rx_parse", kernelRxParse, &ctx, 1000000 * scale, 120);
+    microRun(&report, "handle_frame_cellular_rx", kernelHandleFrame, &ctx, 1000000 * scale, 120);
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        perror("bench: unable to open output");
+        return 1;
+    }
+    benchReportWrite(&report, out);
+    if (out != stdout) fclose(out);
+
+    free(lr);
+    XBeeCellularDestroy(cell);
+    return 0;
+}
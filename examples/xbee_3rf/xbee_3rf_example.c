@@ -0,0 +1,168 @@
+/***************************************************************************//**
+ * @file xbee_3rf_example.c
+ * @brief Example application demonstrating the XBee 3 RF subclass.
+ *
+ * This file contains a sample application that joins a Zigbee or DigiMesh
+ * network and streams readings to the coordinator through the transmit
+ * window, reporting each delivery status from the send callback, and prints
+ * the IO samples that sensor nodes report.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ ******************************************************************************/
+
+#include "xbee_3rf.h"
+#include "port.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Choose default serial port path based on OS
+#if defined(_WIN32)
+    #define DEFAULT_SERIAL_PORT "COM3"
+#elif defined(__APPLE__)
+    #define DEFAULT_SERIAL_PORT "/dev/cu.usbserial-1110"
+#elif defined(__linux__)
+    #define DEFAULT_SERIAL_PORT "/dev/ttyUSB0"
+#else
+    #define DEFAULT_SERIAL_PORT ""
+#endif
+
+/**
+ * @brief Callback function triggered when data is received from the XBee module.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] data Pointer to the received XBee3RFPacket_t.
+ *
+ * @return void This function does not return a value.
+ */
+void OnReceiveCallback(XBee* self, void* data){
+    (void) self;
+    XBee3RFPacket_t* packet = (XBee3RFPacket_t*) data;
+    portDebugPrintf("Received Packet from %08lX%08lX: ",
+                    (unsigned long)(packet->address64 >> 32), (unsigned long)(packet->address64 & 0xFFFFFFFF));
+    for (int i = 0; i < packet->payloadSize; i++) {
+        portDebugPrintf("0x%02X ", packet->payload[i]);
+    }
+    portDebugPrintf("\n");
+}
+
+/**
+ * @brief Callback function triggered when the TX status of a sent frame arrives.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] data Pointer to an XBee3RFPacket_t with the frame ID, destination and status.
+ *
+ * @return void This function does not return a value.
+ */
+void OnSendCallback(XBee* self, void* data){
+    (void) self;
+    XBee3RFPacket_t* packet = (XBee3RFPacket_t*) data;
+    if (packet->status == XBEE_3RF_DELIVERY_SUCCESS) {
+        portDebugPrintf("Delivered (frameId: 0x%02X, retries: %u)\n", packet->frameId, packet->retries);
+    } else {
+        portDebugPrintf("Send failed (frameId: 0x%02X) (reason: 0x%02X)\n", packet->frameId, packet->status);
+    }
+}
+
+int main() {
+
+    // Harware Abstraction Function Pointer Table for XBee3RF (needs to be set!)
+    const XBeeHTable XBee3RFHTable = {
+        .PortUartRead = portUartRead,
+        .PortUartWrite = portUartWrite,
+        .PortMillis = portMillis,
+        .PortFlushRx = portFlushRx,
+        .PortUartInit = portUartInit,
+        .PortDelay = portDelay,
+    };
+
+    // Callback Function Pointer Table for XBee3RF
+    const XBeeCTable XBee3RFCTable = {
+        .OnReceiveCallback = OnReceiveCallback,
+        .OnSendCallback = OnSendCallback, // Reports the status of every frame sent
+    };
+
+    portDebugPrintf("XBee 3 RF Example App\n");
+
+    // Library log output is buffered and written from XBeeProcess()
+    XBeeLogSetSink(portDebugWrite);
+
+    // Create an instance of the XBee3RF class in static storage, no heap needed
+    static XBee3RF myXbee3RfStorage;
+    XBee3RF * myXbee3Rf = XBee3RFInitStatic(&myXbee3RfStorage, &XBee3RFCTable, &XBee3RFHTable);
+
+    // Init XBee
+    if(!XBeeInit((XBee*)myXbee3Rf, 9600, DEFAULT_SERIAL_PORT)){
+        portDebugPrintf("Failed to initialize XBee\n");
+    }
+
+    // Set Network Settings; only settings that differ are written
+    portDebugPrintf("Configuring...\n");
+    const XBee3RFConfig_t config = {
+        .panId = "0000000000001234",
+        .fields = XBEE_3RF_CONFIG_COORDINATOR | XBEE_3RF_CONFIG_API_OPTIONS,
+        .coordinator = 0,
+        .apiOptions = 0x00,
+    };
+    if (!XBeeConfigure((XBee*)myXbee3Rf, &config)) {
+        portDebugPrintf("Failed to configure XBee\n");
+    }
+
+    // Wait for the module to join
+    portDebugPrintf("Connecting...\n");
+    if (!XBeeConnect((XBee*)myXbee3Rf, true)) {
+        portDebugPrintf("Not joined yet\n");
+    }
+
+    // Learn the 16-bit addresses of the nodes around, so sends skip address discovery
+    uint16_t found = 0;
+    if (XBee3RFDiscoverNodes((XBee*)myXbee3Rf, &found)) {
+        portDebugPrintf("Discovered %u nodes\n", found);
+    }
+
+    uint8_t reading[4] = {0};
+    uint32_t startMs = portMillis();
+
+    while (1) {
+        // Let XBee class process any serial data and TX statuses
+        XBeeProcess((XBee*)myXbee3Rf);
+
+        // Print the IO samples that arrived from sensor nodes
+        uint64_t sources[XBEE_3RF_IO_SOURCES];
+        uint8_t sourceCount = XBee3RFIoSources((XBee*)myXbee3Rf, sources, XBEE_3RF_IO_SOURCES);
+        for (uint8_t i = 0; i < sourceCount; i++) {
+            XBee3RFIoSample_t samples[XBEE_3RF_IO_RING_SIZE];
+            uint16_t count = XBee3RFIoRead((XBee*)myXbee3Rf, sources[i], samples, XBEE_3RF_IO_RING_SIZE);
+            for (uint16_t j = 0; j < count; j++) {
+                uint16_t millivolts;
+                XBee3RFIoToMillivolts(&samples[j].analog[0], &millivolts, 1, 2500);
+                portDebugPrintf("IO from %08lX: DIO 0x%04X, AD0 %u mV\n",
+                                (unsigned long)(sources[i] & 0xFFFFFFFF), samples[j].digital, millivolts);
+            }
+        }
+
+        // Stream a reading to the coordinator every second without waiting for
+        // its status; the send only waits when the transmit window is full
+        if ((portMillis() - startMs) >= 1000) {
+            XBee3RFPacket_t packet = {
+                .address64 = XBEE_3RF_ADDRESS_COORDINATOR,
+                .address16 = XBEE_3RF_ADDRESS16_UNKNOWN,
+                .payload = reading,
+                .payloadSize = sizeof(reading),
+                .options = XBEE_3RF_TX_OPT_DISABLE_RETRIES, // Stale readings are not worth retrying
+            };
+            if (!XBee3RFSendPacketAsync((XBee*)myXbee3Rf, &packet)) {
+                portDebugPrintf("Failed to send data.\n");
+            }
+            reading[3]++;
+            startMs = portMillis();
+        }
+    }
+
+    return 0;
+}
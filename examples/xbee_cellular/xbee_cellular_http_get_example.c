@@ -129,6 +129,9 @@ int main() {
 
     portDebugPrintf("XBee 3 Cellular - HTTP GET Example\n");
 
+    // Library log output is buffered and written from XBeeProcess()
+    XBeeLogSetSink(portDebugWrite);
+
     // Allocate instance
     XBeeCellular* xbee = XBeeCellularCreate(&cb, &hw);
 
@@ -85,6 +85,9 @@ int main(void)
 
     portDebugPrintf("XBee 3 Cellular – UDP Echo example (Extended Socket)\n");
 
+    // Library log output is buffered and written from XBeeProcess()
+    XBeeLogSetSink(portDebugWrite);
+
     /* Instance ------------------------------------------------------------- */
     XBeeCellular *xbee = XBeeCellularCreate(&cb, &hw);
 
@@ -110,8 +110,12 @@ int main() {
 
     portDebugPrintf("XBee LR Example App\n");
 
-    // Create an instance of the XBeeLR class
-    XBeeLR * myXbeeLr = XBeeLRCreate(&XBeeLRCTable,&XBeeLRHTable);
+    // Library log output is buffered and written from XBeeProcess()
+    XBeeLogSetSink(portDebugWrite);
+
+    // Create an instance of the XBeeLR class in static storage, no heap needed
+    static XBeeLR myXbeeLrStorage;
+    XBeeLR * myXbeeLr = XBeeLRInitStatic(&myXbeeLrStorage, &XBeeLRCTable, &XBeeLRHTable);
 
     // Init XBee
     if(!XBeeInit((XBee*)myXbeeLr, 9600, DEFAULT_SERIAL_PORT)){
@@ -123,16 +127,20 @@ int main() {
     XBeeLRGetDevEUI((XBee*)myXbeeLr, devEui, sizeof(devEui));
     portDebugPrintf("DEVEUI: %s\n", devEui);
 
-    // Set LoRaWAN Network Settings
+    // Set LoRaWAN Network Settings; only settings that differ are written
     portDebugPrintf("Configuring...\n");
-    XBeeLRSetAppEUI((XBee*)myXbeeLr, "9E1177BD6B1DF41E");
-    XBeeLRSetAppKey((XBee*)myXbeeLr, "CD32AAB41C54175E9060D86F3A8B7F48");
-    XBeeLRSetNwkKey((XBee*)myXbeeLr, "CD32AAB41C54175E9060D86F3A8B7F48");
-    XBeeLRSetRegion((XBee*)myXbeeLr, 8);
-    XBeeLRSetClass((XBee*)myXbeeLr, 'C');
-    XBeeSetAPIOptions((XBee*)myXbeeLr, 0x01);
-    XBeeWriteConfig((XBee*)myXbeeLr);
-    XBeeApplyChanges((XBee*)myXbeeLr);
+    const XBeeLRConfig_t config = {
+        .appEUI = "9E1177BD6B1DF41E",
+        .appKey = "CD32AAB41C54175E9060D86F3A8B7F48",
+        .nwkKey = "CD32AAB41C54175E9060D86F3A8B7F48",
+        .lorawanClass = 'C',
+        .fields = XBEE_LR_CONFIG_REGION | XBEE_LR_CONFIG_API_OPTIONS,
+        .region = 8,
+        .apiOptions = 0x01,
+    };
+    if (!XBeeConfigure((XBee*)myXbeeLr, &config)) {
+        portDebugPrintf("Failed to configure XBee\n");
+    }
 
     // Connect to LoRaWAN network
     portDebugPrintf("Connecting...\n");
@@ -44,18 +44,242 @@
  #define UART_READ_TIMEOUT_MS 2000
  #define UART_WRITE_TIMEOUT_MS 10
  
+ // AT command response timeouts by latency class (see atCommandTimeout())
+#ifndef XBEE_AT_TIMEOUT_REGISTER_MS
+#define XBEE_AT_TIMEOUT_REGISTER_MS 1000    // Read or write of a RAM setting
+#endif
+#ifndef XBEE_AT_TIMEOUT_APPLY_MS
+#define XBEE_AT_TIMEOUT_APPLY_MS 2000       // AC, NR
+#endif
+#ifndef XBEE_AT_TIMEOUT_FLASH_MS
+#define XBEE_AT_TIMEOUT_FLASH_MS 5000       // WR, FR, RE
+#endif
+
+// Learn per-class timeouts from observed round trips (see xbee_timeout.h)
+#ifndef XBEE_AT_TIMEOUT_ADAPTIVE
+#define XBEE_AT_TIMEOUT_ADAPTIVE 1
+#endif
+#ifndef XBEE_AT_TIMEOUT_FLOOR_MS
+#define XBEE_AT_TIMEOUT_FLOOR_MS 100        // Lowest learned timeout, before wire time
+#endif
+#ifndef XBEE_AT_TIMEOUT_CEILING_MS
+#define XBEE_AT_TIMEOUT_CEILING_MS 10000    // Highest learned or backed-off timeout
+#endif
+
+// Slack added to the wire time of the rest of a frame once its start delimiter arrived.
+// Defaults to the full UART read timeout; a tighter value (e.g. 50) drops stalled
+// frames sooner but needs a UART driver that never pauses longer than that mid-frame.
+#ifndef XBEE_UART_FRAME_SLACK_MS
+#define XBEE_UART_FRAME_SLACK_MS UART_READ_TIMEOUT_MS
+#endif
+
+// Log levels (see xbee_log.h)
+ #define XBEE_LOG_LEVEL_NONE 0
+ #define XBEE_LOG_LEVEL_ERROR 1
+ #define XBEE_LOG_LEVEL_WARN 2
+ #define XBEE_LOG_LEVEL_INFO 3
+ #define XBEE_LOG_LEVEL_DEBUG 4
+ 
+ // Setting either flag compiles in debug output and enables it at startup for
+ // the API frame layer or the rest of the library respectively
  #define API_FRAME_DEBUG_PRINT_ENABLED 0
- #if API_FRAME_DEBUG_PRINT_ENABLED
- #define APIFrameDebugPrint(...) portDebugPrintf(__VA_ARGS__)
+ #define XBEE_DEBUG_PRINT_ENABLED 0
+ 
+ // Most verbose level compiled in; XBeeLogSetLevel() filters below it at runtime
+ #ifndef XBEE_LOG_MAX_LEVEL
+ #if API_FRAME_DEBUG_PRINT_ENABLED || XBEE_DEBUG_PRINT_ENABLED
+ #define XBEE_LOG_MAX_LEVEL XBEE_LOG_LEVEL_DEBUG
  #else
- #define APIFrameDebugPrint(...)
+ #define XBEE_LOG_MAX_LEVEL XBEE_LOG_LEVEL_WARN
+ #endif
  #endif
  
- #define XBEE_DEBUG_PRINT_ENABLED 0
- #if XBEE_DEBUG_PRINT_ENABLED
- #define XBEEDebugPrint(...) portDebugPrintf(__VA_ARGS__)
+ #ifndef XBEE_LOG_DEFAULT_LEVEL
+ #define XBEE_LOG_DEFAULT_LEVEL XBEE_LOG_MAX_LEVEL
+ #endif
+ 
+ #ifndef XBEE_LOG_DEFAULT_MODULES
+ #if API_FRAME_DEBUG_PRINT_ENABLED && !XBEE_DEBUG_PRINT_ENABLED
+ #define XBEE_LOG_DEFAULT_MODULES XBEE_LOG_MODULE_API
+ #elif XBEE_DEBUG_PRINT_ENABLED && !API_FRAME_DEBUG_PRINT_ENABLED
+ #define XBEE_LOG_DEFAULT_MODULES (XBEE_LOG_MODULE_ALL & ~XBEE_LOG_MODULE_API)
  #else
- #define XBEEDebugPrint(...)
+ #define XBEE_LOG_DEFAULT_MODULES XBEE_LOG_MODULE_ALL
+ #endif
+ #endif
+ 
+ #ifndef XBEE_LOG_BUFFER_SIZE
+ #define XBEE_LOG_BUFFER_SIZE 1024     // Ring of formatted text waiting for the sink, power of two
+ #endif
+ #ifndef XBEE_LOG_LINE_MAX
+ #define XBEE_LOG_LINE_MAX 160         // Longest single log line, longer lines are truncated
+ #endif
+ #ifndef XBEE_LOG_DRAIN_BUDGET
+ #define XBEE_LOG_DRAIN_BUDGET 256     // Bytes XBeeProcess() drains per call, 0 to drain only explicitly
+ #endif
+ 
+ #define APIFrameDebugPrint(...) XBEE_LOG_DEBUG(XBEE_LOG_MODULE_API, __VA_ARGS__)
+ #define XBEEDebugPrint(...) XBEE_LOG_DEBUG(XBEE_LOG_MODULE, __VA_ARGS__)
+
+ // Per-instance counters and latency histograms (see xbee_stats.h)
+ #ifndef XBEE_STATS_ENABLED
+ #define XBEE_STATS_ENABLED 1
+ #endif
+ #ifndef XBEE_STATS_AT_COMMANDS
+ #define XBEE_STATS_AT_COMMANDS 1      // Count AT responses per command, 4 bytes per at_command_t
+ #endif
+ 
+ // Per-instance event tracing (see xbee_trace.h)
+ #ifndef XBEE_TRACE_ENABLED
+ #define XBEE_TRACE_ENABLED 0
+ #endif
+ #ifndef XBEE_TRACE_RING_SIZE
+ #define XBEE_TRACE_RING_SIZE 128
+ #endif
+ 
+ // Per-instance shadow of module parameters (see xbee_shadow.h)
+ #ifndef XBEE_SHADOW_ENABLED
+ #define XBEE_SHADOW_ENABLED 1
+ #endif
+ #ifndef XBEE_SHADOW_MAX_PARAMS
+ #define XBEE_SHADOW_MAX_PARAMS 16     // Parameters tracked per instance
+ #endif
+ #ifndef XBEE_SHADOW_PIPELINE_DEPTH
+ #define XBEE_SHADOW_PIPELINE_DEPTH 4  // Queries in flight during XBeeShadowSync()
+ #endif
+ 
+ // Per-instance cache of polled AT reads (see xbee_cache.h)
+ #ifndef XBEE_CACHE_ENABLED
+ #define XBEE_CACHE_ENABLED 1
+ #endif
+ #ifndef XBEE_CACHE_ENTRIES
+ #define XBEE_CACHE_ENTRIES 8          // Parameters cached per instance
+ #endif
+ #ifndef XBEE_CACHE_TTL_STATUS_MS
+ #define XBEE_CACHE_TTL_STATUS_MS 1000 // JS, AI; also dropped on modem status
+ #endif
+ #ifndef XBEE_CACHE_TTL_LINK_MS
+ #define XBEE_CACHE_TTL_LINK_MS 1000   // DB; also dropped on received packets
+ #endif
+ 
+ // 16-byte SSE2/NEON checksum kernels where the compiler targets them (see xbee_checksum.h)
+ #ifndef XBEE_CHECKSUM_SIMD
+ #define XBEE_CHECKSUM_SIMD 1
+ #endif
+ 
+ // API escaped mode framing, ATAP=2 (see xbee_escape.h)
+ #ifndef XBEE_API_ESCAPE_ENABLED
+ #define XBEE_API_ESCAPE_ENABLED 1
+ #endif
+ #ifndef XBEE_API_MODE_DEFAULT
+ #define XBEE_API_MODE_DEFAULT 1       // ATAP the module runs with after XBeeInit(), 2 for escaped
+ #endif
+ #ifndef XBEE_ESCAPE_CHUNK_SIZE
+ #define XBEE_ESCAPE_CHUNK_SIZE 64     // Stack buffer apiSendFrame() escapes into per UART write
+ #endif
+ 
+ // Received frame storage (see apiReceiveApiFrame()). Each subclass instance holds
+ // a pool that frames are received into; a frame stays reserved while it is
+ // dispatched, so the pool holds one frame per level of nested AT waits.
+ #ifndef XBEE_LR_MAX_FRAME_DATA_SIZE
+ #define XBEE_LR_MAX_FRAME_DATA_SIZE 256         // 242-byte LoRaWAN payload plus the RX packet header
+ #endif
+ #ifndef XBEE_LR_FRAME_POOL_SIZE
+ #define XBEE_LR_FRAME_POOL_SIZE (2 * XBEE_LR_MAX_FRAME_DATA_SIZE)
+ #endif
+ #ifndef XBEE_CELLULAR_MAX_FRAME_DATA_SIZE
+ #define XBEE_CELLULAR_MAX_FRAME_DATA_SIZE 1024
+ #endif
+ #ifndef XBEE_CELLULAR_FRAME_POOL_SIZE
+ #define XBEE_CELLULAR_FRAME_POOL_SIZE (2 * XBEE_CELLULAR_MAX_FRAME_DATA_SIZE)
+ #endif
+ #ifndef XBEE_3RF_MAX_FRAME_DATA_SIZE
+ #define XBEE_3RF_MAX_FRAME_DATA_SIZE 288        // 255-byte fragmented payload plus the explicit RX packet header
+ #endif
+ #ifndef XBEE_3RF_FRAME_POOL_SIZE
+ #define XBEE_3RF_FRAME_POOL_SIZE (2 * XBEE_3RF_MAX_FRAME_DATA_SIZE)
+ #endif
+ 
+ // Stack buffers the send paths build frames in; longer frames are refused
+ #ifndef XBEE_TX_FRAME_BUFFER_SIZE
+ #define XBEE_TX_FRAME_BUFFER_SIZE 256   // apiSendFrame(), delimiter, length and checksum included
+ #endif
+ #ifndef XBEE_AT_PARAM_MAX_SIZE
+ #define XBEE_AT_PARAM_MAX_SIZE 128      // apiSendAtCommand() parameter bytes
+ #endif
+ #ifndef XBEE_LR_TX_FRAME_SIZE
+ #define XBEE_LR_TX_FRAME_SIZE 128       // XBeeLRSendPacket(), 3 header bytes and the payload
+ #endif
+ #ifndef XBEE_CELLULAR_TX_FRAME_SIZE
+ #define XBEE_CELLULAR_TX_FRAME_SIZE 128 // Cellular packet, socket send and socket option frames
+ #endif
+ #ifndef XBEE_3RF_TX_FRAME_SIZE
+ #define XBEE_3RF_TX_FRAME_SIZE 128      // XBee3RFSendPacket(), 13 header bytes and the payload
+ #endif
+
+ // DigiMesh and 802.15.4 modules report no join, so while an XBee 3 RF link is
+ // down XBeeConnected() queries AT_AI at most this often
+ #ifndef XBEE_3RF_LINK_POLL_MS
+ #define XBEE_3RF_LINK_POLL_MS 1000
+ #endif
+
+ // XBee 3 RF transmit window: unicasts sent without waiting for their TX status
+ // (see XBee3RFSendPacketAsync())
+ #ifndef XBEE_3RF_TX_WINDOW
+ #define XBEE_3RF_TX_WINDOW 8            // Frames awaiting a TX status per instance
+ #endif
+ #ifndef XBEE_3RF_TX_WINDOW_PER_DEST
+ #define XBEE_3RF_TX_WINDOW_PER_DEST 4   // Of those, frames to any one destination
+ #endif
+
+ // XBee 3 RF node cache: 16-bit addresses and node identifiers learned from
+ // node discovery and received frames (see XBee3RFDiscoverNodes())
+ #ifndef XBEE_3RF_NODE_CACHE_SIZE
+ #define XBEE_3RF_NODE_CACHE_SIZE 32     // Entries per instance, a power of two
+ #endif
+ #ifndef XBEE_3RF_NODE_TTL_MS
+ #define XBEE_3RF_NODE_TTL_MS 600000     // An entry not refreshed for this long is dropped
+ #endif
+ #ifndef XBEE_3RF_NODE_ID_SIZE
+ #define XBEE_3RF_NODE_ID_SIZE 21        // Node identifier (AT_NI) and its terminator
+ #endif
+ #ifndef XBEE_3RF_ROUTE_MAX_HOPS
+ #define XBEE_3RF_ROUTE_MAX_HOPS 11      // Longest source route kept per node (see XBee3RFHandleRouteRecord())
+ #endif
+ #ifndef XBEE_3RF_DISCOVERY_GUARD_MS
+ #define XBEE_3RF_DISCOVERY_GUARD_MS 1000  // Wait for late responses past the discovery time (AT_LD)
+ #endif
+
+ // XBee 3 RF remote AT commands run on many nodes at once (see XBee3RFRemoteAtCommand())
+ #ifndef XBEE_3RF_REMOTE_AT_WINDOW
+ #define XBEE_3RF_REMOTE_AT_WINDOW 8     // Commands awaiting a response at once
+ #endif
+ #ifndef XBEE_3RF_REMOTE_AT_TIMEOUT_MS
+ #define XBEE_3RF_REMOTE_AT_TIMEOUT_MS 5000  // Per attempt, over the mesh and back
+ #endif
+ #ifndef XBEE_3RF_REMOTE_AT_ATTEMPTS
+ #define XBEE_3RF_REMOTE_AT_ATTEMPTS 3   // Per node, the first included
+ #endif
+ #ifndef XBEE_3RF_REMOTE_AT_VALUE_MAX
+ #define XBEE_3RF_REMOTE_AT_VALUE_MAX 20 // Response bytes kept per node, longer values are cut
+ #endif
+
+ // XBee 3 RF IO samples (0x92) kept per source until read (see XBee3RFIoRead())
+ #ifndef XBEE_3RF_IO_ENABLED
+ #define XBEE_3RF_IO_ENABLED 1
+ #endif
+ #ifndef XBEE_3RF_IO_SOURCES
+ #define XBEE_3RF_IO_SOURCES 8           // Nodes with samples kept per instance
+ #endif
+ #ifndef XBEE_3RF_IO_RING_SIZE
+ #define XBEE_3RF_IO_RING_SIZE 8         // Samples kept per node, a power of two; the oldest is overwritten
+ #endif
+ 
+ // Static memory only: instances come from XBeeLRInitStatic(), XBeeCellularInitStatic()
+ // or XBee3RFInitStatic() and the heap constructors are left out. The example
+ // Makefiles check the objects for heap references when built with NO_HEAP=1.
+ #ifndef XBEE_NO_HEAP
+ #define XBEE_NO_HEAP 0
  #endif
  
  #if defined(__cplusplus)
@@ -41,6 +41,7 @@ extern "C"
 #endif
     
 #include <stdint.h>
+#include <stddef.h>
 
 // Enum for UART read status
 typedef enum {
@@ -58,6 +59,7 @@ void portFlushRx(void);
 int portUartInit(uint32_t baudrate, void *device);
 void portDelay(uint32_t ms);
 void portDebugPrintf(const char *format, ...);
+void portDebugWrite(const char *text, size_t len);
 
 #if defined(__cplusplus)
 }
@@ -0,0 +1,112 @@
+/**
+ * @file port_capture.h
+ * @brief UART capture shim and capture file reader.
+ *
+ * The capture shim is an XBeeHTable that forwards every call to another
+ * ("inner") HAL and logs the bytes that cross the UART, with a millisecond
+ * timestamp, to a compact binary file. Captures are played back with the
+ * replay HAL (port_replay.h) or decoded offline with tools/xbee_analyze.
+ *
+ * File layout (all multi-byte fields little endian):
+ *   header : 'X' 'B' 'C' 'P' version(1) flags(1) reserved(2)
+ *   record : direction(1) timestampMs(4) length(2) data(length)
+ *
+ * Consecutive chunks in the same direction within the same millisecond are
+ * merged into one record. Like the other HAL implementations the shim keeps
+ * its state in globals, so one capture can be active at a time.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef PORT_CAPTURE_H
+#define PORT_CAPTURE_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "xbee.h"
+
+#define PORT_CAPTURE_VERSION 1
+#define PORT_CAPTURE_HEADER_SIZE 8
+#define PORT_CAPTURE_RECORD_HEADER_SIZE 7
+#define PORT_CAPTURE_CHUNK_MAX 512    ///< Largest record the shim writes; bigger chunks are split
+
+/**
+ * @brief Direction of a captured chunk, seen from the host.
+ */
+typedef enum {
+    PORT_CAPTURE_DIR_TX = 0,    ///< Host to module (PortUartWrite)
+    PORT_CAPTURE_DIR_RX = 1     ///< Module to host (PortUartRead)
+} PortCaptureDir_t;
+
+/**
+ * @brief One decoded capture record. data points into the reader's buffer.
+ */
+typedef struct {
+    uint8_t dir;
+    uint32_t timestampMs;       ///< Milliseconds since portCaptureStart()
+    uint16_t length;
+    const uint8_t* data;
+} PortCaptureRecord_t;
+
+/**
+ * @brief Sequential reader over a capture file loaded into memory.
+ */
+typedef struct {
+    uint8_t* buffer;
+    size_t size;
+    size_t pos;
+} PortCaptureReader_t;
+
+// Recording shim control
+bool portCaptureStart(const XBeeHTable* inner, const char* path);
+void portCaptureFlush(void);
+void portCaptureStop(void);
+
+// XBeeHTable implementation (forwards to the inner HAL)
+int portCaptureUartRead(uint8_t* buffer, int length);
+int portCaptureUartWrite(const uint8_t* buf, uint16_t len);
+uint32_t portCaptureMillis(void);
+void portCaptureFlushRx(void);
+int portCaptureUartInit(uint32_t baudrate, void* device);
+void portCaptureDelay(uint32_t ms);
+
+// Capture file reader
+bool portCaptureReaderOpen(PortCaptureReader_t* reader, const char* path);
+bool portCaptureReaderNext(PortCaptureReader_t* reader, PortCaptureRecord_t* record);
+void portCaptureReaderRewind(PortCaptureReader_t* reader);
+void portCaptureReaderClose(PortCaptureReader_t* reader);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PORT_CAPTURE_H
@@ -0,0 +1,104 @@
+/**
+ * @file port_fault.h
+ * @brief Fault-injection UART shim for parser robustness testing.
+ *
+ * The fault shim is an XBeeHTable that forwards every call to another
+ * ("inner") HAL and corrupts the module-to-host byte stream on the way to
+ * the library: bits are flipped, bytes are dropped, duplicated or delayed,
+ * garbage bytes are inserted and whole frames are truncated, each at a
+ * configurable rate. Host writes are passed through unchanged.
+ *
+ * Rates are given in parts per million so low real-world error rates can be
+ * expressed exactly. Faults are drawn from a seeded PRNG; on a deterministic
+ * inner HAL (port_vclock.h) a run is fully reproducible. As with the other
+ * HAL implementations, state is global and one shim can be active at a time.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef PORT_FAULT_H
+#define PORT_FAULT_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "xbee.h"
+
+#define PORT_FAULT_PPM 1000000UL       ///< Rate that injects a fault every time
+#define PORT_FAULT_QUEUE_SIZE 2048     ///< Corrupted bytes buffered ahead of the library
+
+/**
+ * @brief Fault rates. Byte faults are mutually exclusive per byte; their rates add up.
+ */
+typedef struct {
+    uint32_t seed;           ///< PRNG seed; 0 selects a fixed default
+    uint32_t bitFlipPpm;     ///< Flip one random bit of the byte
+    uint32_t dropPpm;        ///< Drop the byte
+    uint32_t duplicatePpm;   ///< Deliver the byte twice
+    uint32_t garbagePpm;     ///< Insert a random byte before the byte
+    uint32_t delayPpm;       ///< Hold the byte, and everything after it, for delayMs
+    uint32_t delayMs;
+    uint32_t truncatePpm;    ///< Per frame: drop everything from a random point to the end of the frame
+} PortFaultConfig_t;
+
+/**
+ * @brief Counters for the faults injected so far.
+ */
+typedef struct {
+    uint32_t bytesIn;        ///< Bytes read from the inner HAL
+    uint32_t bytesOut;       ///< Bytes handed to the library
+    uint32_t framesIn;       ///< Frame delimiters seen in the uncorrupted stream
+    uint32_t bitFlips;
+    uint32_t drops;
+    uint32_t duplicates;
+    uint32_t garbage;
+    uint32_t delays;
+    uint32_t truncations;
+    uint32_t faults;         ///< Sum of all injected faults
+    uint32_t lastFaultMs;    ///< Inner PortMillis() at the most recent fault
+} PortFaultStats_t;
+
+// Shim control
+void portFaultStart(const XBeeHTable* inner, const PortFaultConfig_t* config);
+void portFaultGetStats(PortFaultStats_t* stats);
+
+// XBeeHTable implementation (forwards to the inner HAL)
+int portFaultUartRead(uint8_t* buffer, int length);
+int portFaultUartWrite(const uint8_t* buf, uint16_t len);
+uint32_t portFaultMillis(void);
+void portFaultFlushRx(void);
+int portFaultUartInit(uint32_t baudrate, void* device);
+void portFaultDelay(uint32_t ms);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PORT_FAULT_H
@@ -0,0 +1,68 @@
+/**
+ * @file port_replay.h
+ * @brief Replay HAL that plays a UART capture back through the library.
+ *
+ * The replay HAL runs on a virtual clock like port_vclock.h. Received chunks
+ * from the capture are released in their recorded order; a chunk that followed
+ * a host write in the capture is held back until the host has written the same
+ * number of bytes again, and then becomes readable after the same delay it had
+ * in the capture. The bytes the host writes are compared with the recorded TX
+ * stream so a replay doubles as a regression test of the library's output.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef PORT_REPLAY_H
+#define PORT_REPLAY_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Replay control
+bool portReplayOpen(const char* path);
+void portReplayClose(void);
+bool portReplayDone(void);
+uint32_t portReplayTxMismatches(void);
+
+// XBeeHTable implementation
+int portReplayUartRead(uint8_t* buffer, int length);
+int portReplayUartWrite(const uint8_t* buf, uint16_t len);
+uint32_t portReplayMillis(void);
+void portReplayFlushRx(void);
+int portReplayUartInit(uint32_t baudrate, void* device);
+void portReplayDelay(uint32_t ms);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PORT_REPLAY_H
@@ -0,0 +1,66 @@
+/**
+ * @file port_unix_metrics.h
+ * @brief Prometheus text-format exporter for Linux gateways.
+ *
+ * The exporter serves the counters and histograms of every registered XBee
+ * instance (frames and bytes per frame type, receive results, AT outcomes,
+ * latency histograms, last link RSSI/SNR) over HTTP on a loopback TCP port
+ * or a Unix domain socket, from a thread of its own. Snapshots are taken
+ * with XBeeGetStats(), which never blocks the thread driving the instance,
+ * so a slow or stuck scraper cannot stall the receive path.
+ *
+ * Like port_unix.c this is POSIX only; add it to the build beside the Unix
+ * port and link with -pthread.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef PORT_UNIX_METRICS_H
+#define PORT_UNIX_METRICS_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "xbee.h"
+
+#define PORT_UNIX_METRICS_MAX_INSTANCES 8     ///< Registered instances served at once
+#define PORT_UNIX_METRICS_NAME_MAX 32         ///< Longest instance label, including the terminator
+
+bool portUnixMetricsRegister(XBee* self, const char* name);
+void portUnixMetricsUnregister(XBee* self);
+void portUnixMetricsWrite(FILE* out);
+bool portUnixMetricsStart(const char* address);
+void portUnixMetricsStop(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PORT_UNIX_METRICS_H
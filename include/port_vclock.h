@@ -0,0 +1,93 @@
+/**
+ * @file port_vclock.h
+ * @brief Virtual-clock platform abstraction layer for deterministic testing.
+ *
+ * This file declares a HAL implementation in which time only moves when the
+ * library calls PortDelay() (or a test calls portVClockAdvance()). Bytes the
+ * simulated module sends are scripted ahead of time with a due time and become
+ * readable once the virtual clock reaches it, so code paths with multi-second
+ * timeouts run in microseconds and always take the same path.
+ *
+ * The HAL has a single global clock and UART, matching the context-free
+ * XBeeHTable function signatures.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef PORT_VCLOCK_H
+#define PORT_VCLOCK_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "xbee.h"
+
+#define PORT_VCLOCK_MAX_RX_EVENTS 32       ///< Scripted RX chunks that can be pending at once
+#define PORT_VCLOCK_RX_POOL_SIZE 4096      ///< Bytes of scripted RX data that can be pending at once
+#define PORT_VCLOCK_TX_BUFFER_SIZE 4096    ///< Bytes of host writes captured for inspection
+
+/**
+ * @brief Called for every UART write so a test can script the module's reply.
+ *
+ * The hook runs at the virtual time of the write; calling portVClockScheduleRx()
+ * or portVClockScheduleFrame() from inside it is allowed.
+ */
+typedef void (*PortVClockWriteHook)(const uint8_t* data, uint16_t len, void* ctx);
+
+// Test control
+void portVClockReset(void);
+uint32_t portVClockNow(void);
+void portVClockAdvance(uint32_t ms);
+bool portVClockScheduleRx(uint32_t delayMs, const uint8_t* data, uint16_t len);
+bool portVClockScheduleFrame(uint32_t delayMs, const uint8_t* frameData, uint16_t len);
+size_t portVClockPendingRx(void);
+const uint8_t* portVClockTxData(void);
+size_t portVClockTxLength(void);
+void portVClockTxClear(void);
+void portVClockSetWriteHook(PortVClockWriteHook hook, void* ctx);
+bool portVClockScheduleAtResponse(uint32_t delayMs, const uint8_t* request, uint16_t len,
+                                  uint8_t status, const uint8_t* value, uint16_t valueLength);
+
+// XBeeHTable implementation
+int portVClockUartRead(uint8_t* buffer, int length);
+int portVClockUartWrite(const uint8_t* buf, uint16_t len);
+uint32_t portVClockMillis(void);
+void portVClockFlushRx(void);
+int portVClockUartInit(uint32_t baudrate, void* device);
+void portVClockDelay(uint32_t ms);
+
+extern const XBeeHTable portVClockHTable;    ///< The functions above, ready to pass to a constructor
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PORT_VCLOCK_H
@@ -46,10 +46,35 @@ extern "C"
 #include <stdlib.h>
 #include "config.h"
 #include "port.h"
+#include "xbee_stats.h"
+#include "xbee_trace.h"
+#include "xbee_log.h"
+#include "xbee_at_cmds.h"
+#include "xbee_shadow.h"
+#include "xbee_timeout.h"
+#include "xbee_cache.h"
 
 // Abstract base class for XBee
 typedef struct XBee XBee;
 
+/**
+ * @brief Network state kept from modem status frames, see XBeeConnected().
+ */
+typedef enum {
+    XBEE_LINK_UNKNOWN,      ///< Nothing reported yet; XBeeConnected() asks the module
+    XBEE_LINK_DOWN,         ///< Not joined (LR) or not registered (Cellular)
+    XBEE_LINK_UP,
+} xbee_link_state_t;
+
+/**
+ * @brief Framing selected with ATAP, see XBeeSetApiEnable().
+ */
+typedef enum {
+    XBEE_API_MODE_TRANSPARENT = 0,  ///< Not usable by this library
+    XBEE_API_MODE_UNESCAPED = 1,
+    XBEE_API_MODE_ESCAPED = 2,      ///< Special bytes are escaped, see xbee_escape.h
+} xbee_api_mode_t;
+
 /**
  * @typedef XBeeVTable
  * @brief Virtual table structure for platform-specific XBee operations.
@@ -71,6 +96,7 @@ typedef struct {
     bool (*connected)(XBee* self);
     void (*handleRxPacketFrame)(XBee* self, void *frame);
     void (*handleTransmitStatusFrame)(XBee* self, void *frame);
+    void (*handleRouteRecordFrame)(XBee* self, void *frame);
     bool (*configure)(XBee* self, const void* config);
 } XBeeVTable;
 
@@ -127,6 +153,34 @@ struct XBee {
     uint8_t frameIdCntr;
     bool txStatusReceived;        ///< Flag to indicate if TX Status frame was received
     uint8_t deliveryStatus;        ///< Stores the delivery status of the transmitted frame
+    uint32_t baudRate;             ///< UART rate passed to XBeeInit(), scales frame timeouts
+    uint8_t linkState;             ///< xbee_link_state_t, kept by xbeeLinkStateSet()
+    uint32_t linkPollMs;           ///< While down, how often XBeeConnected() asks the module; 0 to wait for a status
+    uint32_t linkPolledMs;         ///< When the link went down or the module was last asked
+    uint8_t modemStatus;           ///< Last modem status code received, 0xFF before the first
+    uint8_t apiMode;               ///< xbee_api_mode_t the frames are encoded in
+    uint8_t atModule;              ///< at_module_t of the subclass, for atCommandFromString()
+    uint8_t* framePool;            ///< Received frame storage in the subclass instance
+    uint16_t framePoolSize;
+    uint16_t framePoolTop;         ///< Start of the free space; frames being dispatched sit below it
+    uint16_t rxCarryOffset;        ///< Pool offset of bytes read past an aborted frame
+    uint16_t rxCarryLength;        ///< Number of those bytes, read again before the UART
+    uint16_t maxFrameDataSize;     ///< Longest frame the subclass receives
+#if XBEE_STATS_ENABLED
+    XBeeStats_t stats;             ///< Counters and histograms, read with XBeeGetStats()
+#endif
+#if XBEE_TRACE_ENABLED
+    XBeeTraceRing_t trace;         ///< Event ring, read with XBeeTraceDump()
+#endif
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+    XBeeTimeouts_t atTimeouts;     ///< Learned AT response timeouts, see XBeeAtTimeout()
+#endif
+#if XBEE_SHADOW_ENABLED
+    XBeeShadow_t shadow;           ///< Last known parameter values, see XBeeShadowSync()
+#endif
+#if XBEE_CACHE_ENABLED
+    XBeeCache_t cache;             ///< Recent AT reads, see xbee_cache.h
+#endif
 
 };
 
@@ -136,6 +190,7 @@ bool XBeeConnect(XBee* self, bool blocking);
 bool XBeeDisconnect(XBee* self);
 uint8_t XBeeSendPacket(XBee* self, const void*);
 bool XBeeSoftReset(XBee* self);
+bool XBeeSoftRestart(XBee* self);
 void XBeeHardReset(XBee* self);
 void XBeeProcess(XBee* self);
 bool XBeeConnected(XBee* self);
@@ -144,6 +199,12 @@ bool XBeeApplyChanges(XBee* self);
 bool XBeeSetAPIOptions(XBee* self, const uint8_t value);
 bool XBeeGetFirmwareVersion(XBee* self, uint32_t* version);
 bool XBeeConfigure(XBee* self, const void* config);
+bool XBeeAtSet(XBee* self, at_command_t command, uint32_t value);
+bool XBeeAtGet(XBee* self, at_command_t command, uint32_t* value);
+bool XBeeAtSetBytes(XBee* self, at_command_t command, const uint8_t* data, uint8_t length);
+bool XBeeAtGetBytes(XBee* self, at_command_t command, uint8_t* data, uint8_t* length, uint8_t size);
+bool XBeeAtExecute(XBee* self, at_command_t command);
+uint32_t XBeeAtTimeout(XBee* self, at_command_t command, uint16_t wireBytes);
 bool XBeeFactoryReset        (XBee* self);                          /* ATFR */
 bool XBeeExitCommandMode     (XBee* self);                          /* ATCN */
 bool XBeeSetApiEnable        (XBee* self, uint8_t mode);            /* ATAP */
@@ -151,6 +212,16 @@ bool XBeeSetBaudRate         (XBee* self, uint8_t rateCode);        /* ATBD */
 bool XBeeGetLastRssi         (XBee* self, int8_t*  rssiOut);        /* ATDB */
 bool XBeeGetHardwareVersion  (XBee* self, uint16_t* hvOut);         /* ATHV */
 bool XBeeGetSerialNumber     (XBee* self, uint64_t* snOut);         /* ATSH/ATSL */
+bool XBeeGetStats(XBee* self, XBeeStats_t* out);
+void XBeeResetStats(XBee* self);
+void XBeeTraceConfigure(XBee* self, uint16_t instanceId, uint32_t (*clockUs)(void));
+size_t XBeeTraceDump(XBee* self, uint8_t* buf, size_t size);
+bool XBeeShadowSync(XBee* self, const XBeeShadowParam_t* params, uint8_t count, uint8_t* changed);
+void XBeeShadowInvalidate(XBee* self);
+void XBeeCacheInvalidate(XBee* self);
+
+// Used by the frame handlers and subclasses to report network state changes
+void xbeeLinkStateSet(XBee* self, uint8_t state);
 
 #if defined(__cplusplus)
 }
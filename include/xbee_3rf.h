@@ -0,0 +1,250 @@
+/**
+ * @file xbee_3rf.h
+ * @brief Header file for the XBee 3 RF (Zigbee, DigiMesh, 802.15.4) subclass.
+ *
+ * This file defines the interface for the XBee 3 RF subclass, which extends the
+ * functionality of the base XBee class to support 64/16-bit addressed
+ * transmissions on XBee 3 Zigbee, DigiMesh and 802.15.4 firmware.
+ *
+ * Unicasts can be sent without waiting for their TX status. Up to
+ * XBEE_3RF_TX_WINDOW frames are then in flight at once, at most
+ * XBEE_3RF_TX_WINDOW_PER_DEST of them to one destination, and each status
+ * (0x8B, or 0x89 on 802.15.4) is matched to its frame by frame ID.
+ *
+ * Unicasts with an unknown 16-bit address take it from the node cache,
+ * filled by node discovery and kept current by received frames, so the
+ * module does not run address discovery before each of them. On a Zigbee
+ * many-to-one concentrator the cache also keeps the route each node's
+ * route record reported, and unicasts go out along it as source routes.
+ *
+ * Remote AT commands run on many nodes at once, XBEE_3RF_REMOTE_AT_WINDOW
+ * at a time, with a result per node.
+ *
+ * IO samples are decoded as they arrive into a ring per sending node, and
+ * read out in bulk with XBee3RFIoRead().
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE3RF_H
+#define XBEE3RF_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include "xbee.h"
+#include "config.h"
+
+#define XBEE_3RF_CONNECTION_TIMEOUT_MS 30000   // Zigbee join, polled through AI
+#define XBEE_3RF_TX_STATUS_TIMEOUT_MS 10000    // A frame without a TX status by then is reported as timed out
+
+// Well-known addresses
+#define XBEE_3RF_ADDRESS_COORDINATOR 0x0000000000000000ULL
+#define XBEE_3RF_ADDRESS_BROADCAST   0x000000000000FFFFULL
+#define XBEE_3RF_ADDRESS64_UNKNOWN   0xFFFFFFFFFFFFFFFFULL  ///< Send to the 16-bit address instead
+#define XBEE_3RF_ADDRESS16_UNKNOWN   0xFFFE     ///< Let the module resolve the 16-bit address
+
+// XBee3RFPacket_t.options bits for transmit; 0 uses the module's TO setting
+#define XBEE_3RF_TX_OPT_DISABLE_RETRIES          0x01   ///< No retries (Zigbee) or no ACK (DigiMesh, 802.15.4)
+#define XBEE_3RF_TX_OPT_DISABLE_ROUTE_DISCOVERY  0x02   ///< DigiMesh: fail rather than discover a missing route
+#define XBEE_3RF_TX_OPT_APS_ENCRYPTION           0x20   ///< Zigbee: end-to-end APS encryption
+#define XBEE_3RF_TX_OPT_EXTENDED_TIMEOUT         0x40   ///< Zigbee: allow for sleeping end devices
+
+#define XBEE_3RF_DELIVERY_SUCCESS 0x00
+#define XBEE_3RF_DELIVERY_NETWORK_ACK_FAILURE 0x21
+#define XBEE_3RF_DELIVERY_ADDRESS_NOT_FOUND 0x24
+#define XBEE_3RF_DELIVERY_ROUTE_NOT_FOUND 0x25
+#define XBEE_3RF_DELIVERY_TIMEOUT 0xFF  ///< No TX status within XBEE_3RF_TX_STATUS_TIMEOUT_MS
+
+// Structure for XBee 3 RF packet
+typedef struct XBee3RFPacket_s{
+    uint64_t address64;         ///< Destination (TX) or source (RX) 64-bit address
+    uint16_t address16;         ///< 16-bit network address, XBEE_3RF_ADDRESS16_UNKNOWN if not known
+    uint16_t payloadSize;
+    uint8_t *payload;
+    uint8_t options;            ///< XBEE_3RF_TX_OPT_* bits (TX) or receive options (RX)
+    uint8_t status;             ///< Delivery status, XBEE_3RF_DELIVERY_SUCCESS if delivered
+    uint8_t frameId;
+    //For TX only
+    uint8_t radius;             ///< Broadcast radius in hops, 0 for the network maximum
+    uint8_t retries;            ///< Transmit retries, from an extended TX status
+    uint8_t discovery;          ///< Discovery status, from an extended TX status
+    //For explicit RX only
+    uint8_t sourceEndpoint;
+    uint8_t destinationEndpoint;
+    uint16_t clusterId;
+    uint16_t profileId;
+}XBee3RFPacket_t;
+
+// XBee3RFConfig_t.fields bits selecting the integer settings to apply
+#define XBEE_3RF_CONFIG_COORDINATOR    0x01
+#define XBEE_3RF_CONFIG_BROADCAST_HOPS 0x02
+#define XBEE_3RF_CONFIG_API_OPTIONS    0x04
+
+/**
+ * @brief Desired network configuration, applied with XBeeConfigure().
+ *
+ * Only settings that differ from the module are written (see
+ * XBeeShadowSync()). A NULL PAN ID is left unchanged, as are integer
+ * settings whose bit is not set in `fields`.
+ */
+typedef struct {
+    const char* panId;          ///< 16 hex characters on Zigbee, 4 on DigiMesh and 802.15.4
+    uint8_t fields;             ///< XBEE_3RF_CONFIG_* bits
+    uint8_t coordinator;
+    uint8_t broadcastHops;
+    uint8_t apiOptions;
+} XBee3RFConfig_t;
+
+/**
+ * @brief A frame awaiting its TX status.
+ */
+typedef struct {
+    uint64_t address64;
+    uint16_t address16;         ///< The destination when `address64` is XBEE_3RF_ADDRESS64_UNKNOWN
+    uint32_t sentAt;            ///< PortMillis() when the frame was written
+    uint8_t frameId;            ///< 0 when the slot is free
+    uint8_t status;
+    bool done;                  ///< The status arrived or the frame timed out
+    bool waited;                ///< XBee3RFSendPacket() releases the slot itself
+} XBee3RFTxSlot_t;
+
+#define XBEE_3RF_ROUTE_UNKNOWN 0xFF    ///< XBee3RFNode_t.routeHops when no route record arrived
+
+/**
+ * @brief A node in the node cache.
+ *
+ * Entries come from node discovery (XBee3RFDiscoverNodes()) and route
+ * records, and are refreshed by every frame received from the node and
+ * every delivery status naming its 16-bit address.
+ */
+typedef struct {
+    uint64_t address64;         ///< 0 when the entry is free
+    uint32_t updatedAt;         ///< PortMillis() when the entry was last refreshed
+    uint16_t address16;         ///< XBEE_3RF_ADDRESS16_UNKNOWN on DigiMesh
+    char nodeIdentifier[XBEE_3RF_NODE_ID_SIZE];   ///< Empty until the node answers a discovery
+    uint8_t routeHops;          ///< Hops in `route`, 0 for a neighbor, or XBEE_3RF_ROUTE_UNKNOWN
+    uint16_t route[XBEE_3RF_ROUTE_MAX_HOPS];      ///< 16-bit addresses of the hops, nearest the node first
+} XBee3RFNode_t;
+
+// Remote AT command options
+#define XBEE_3RF_REMOTE_AT_APPLY 0x02   ///< Apply changes on the node, as AC would
+
+// XBee3RFRemoteAtResult_t.status values; 1-4 are reported by the node or the module
+#define XBEE_3RF_REMOTE_AT_OK                0x00
+#define XBEE_3RF_REMOTE_AT_ERROR             0x01
+#define XBEE_3RF_REMOTE_AT_INVALID_COMMAND   0x02
+#define XBEE_3RF_REMOTE_AT_INVALID_PARAMETER 0x03
+#define XBEE_3RF_REMOTE_AT_TX_FAILURE        0x04   ///< The node was not reached
+#define XBEE_3RF_REMOTE_AT_TIMEOUT           0xFF   ///< No response to any attempt
+
+/**
+ * @brief Outcome of a remote AT command on one node, see XBee3RFRemoteAtCommand().
+ */
+typedef struct {
+    uint64_t address64;         ///< Node to run the command on, set by the caller
+    uint8_t status;             ///< XBEE_3RF_REMOTE_AT_* status of the last attempt
+    uint8_t attempts;           ///< Commands sent to the node
+    uint8_t length;             ///< Bytes in `value`
+    uint8_t value[XBEE_3RF_REMOTE_AT_VALUE_MAX];  ///< Value returned by a query
+} XBee3RFRemoteAtResult_t;
+
+#define XBEE_3RF_IO_ANALOG_CHANNELS 5      ///< AD0-AD3 and the supply voltage
+#define XBEE_3RF_IO_SUPPLY 4               ///< XBee3RFIoSample_t.analog index of the supply voltage
+#define XBEE_3RF_IO_ANALOG_SUPPLY_BIT 0x80 ///< XBee3RFIoSample_t.analogMask bit of the supply voltage
+
+/**
+ * @brief One IO sample, as reported by an IO Data Sample RX Indicator (0x92) or `AT_IS`.
+ */
+typedef struct {
+    uint32_t receivedAt;        ///< PortMillis() on arrival
+    uint16_t digitalMask;       ///< Bit n set: DIOn was sampled
+    uint16_t digital;           ///< Bit n: level of DIOn
+    uint8_t analogMask;         ///< Bits 0-3: AD0-AD3 were sampled, bit 7: the supply voltage
+    uint16_t analog[XBEE_3RF_IO_ANALOG_CHANNELS];   ///< Raw 10-bit readings, AD0-AD3 then the supply
+} XBee3RFIoSample_t;
+
+/**
+ * @brief Samples received from one node, oldest first from `tail` to `head`.
+ */
+typedef struct {
+    uint64_t address64;         ///< 0 when the source is free
+    uint32_t updatedAt;         ///< PortMillis() of the latest sample
+    uint16_t head;              ///< Samples written, wrapping
+    uint16_t tail;              ///< Samples read or overwritten, wrapping
+    uint16_t overruns;          ///< Samples overwritten before they were read
+    XBee3RFIoSample_t ring[XBEE_3RF_IO_RING_SIZE];
+} XBee3RFIoSource_t;
+
+// Subclass for XBee3RF
+typedef struct {
+    XBee base;  // Inherit from XBee
+    XBee3RFTxSlot_t txWindow[XBEE_3RF_TX_WINDOW];   ///< Frames awaiting a TX status
+    uint8_t txInFlight;
+    XBee3RFNode_t nodes[XBEE_3RF_NODE_CACHE_SIZE];  ///< Open-addressed by 64-bit address
+#if XBEE_3RF_IO_ENABLED
+    XBee3RFIoSource_t ioSources[XBEE_3RF_IO_SOURCES];  ///< IO samples received, see XBee3RFIoRead()
+#endif
+    uint8_t framePool[XBEE_3RF_FRAME_POOL_SIZE];    ///< Received frames, see apiReceiveApiFrame()
+} XBee3RF;
+
+
+XBee3RF* XBee3RFInitStatic(XBee3RF* storage, const XBeeCTable* cTable, const XBeeHTable* hTable);
+#if !XBEE_NO_HEAP
+XBee3RF* XBee3RFCreate(const XBeeCTable* cTable, const XBeeHTable* hTable);
+void XBee3RFDestroy(XBee3RF* self);
+#endif
+bool XBee3RFInit(XBee* self, uint32_t baudRate, void* device);
+bool XBee3RFConfigure(XBee* self, const void* config);
+bool XBee3RFConnected(XBee* self);
+uint8_t XBee3RFSendPacket(XBee* self, const void* data);
+bool XBee3RFSendPacketAsync(XBee* self, XBee3RFPacket_t* packet);
+void XBee3RFFlush(XBee* self);
+uint8_t XBee3RFInFlight(XBee* self);
+bool XBee3RFGetAddress64(XBee* self, uint64_t* address64);
+bool XBee3RFSetNodeIdentifier(XBee* self, const char* value);
+bool XBee3RFDiscoverNodes(XBee* self, uint16_t* found);
+const XBee3RFNode_t* XBee3RFNodeLookup(XBee* self, uint64_t address64);
+const XBee3RFNode_t* XBee3RFNodeFind(XBee* self, const char* nodeIdentifier);
+void XBee3RFNodeCacheClear(XBee* self);
+uint16_t XBee3RFRemoteAtCommand(XBee* self, at_command_t command, const uint8_t* parameter, uint8_t paramLength,
+                                uint8_t options, XBee3RFRemoteAtResult_t* results, uint16_t count);
+bool XBee3RFIoDecode(const uint8_t* data, uint16_t length, XBee3RFIoSample_t* sample);
+uint8_t XBee3RFIoUnpackDigital(const XBee3RFIoSample_t* sample, uint8_t* pins, uint8_t* levels);
+void XBee3RFIoToMillivolts(const uint16_t* raw, uint16_t* millivolts, uint16_t count, uint16_t referenceMv);
+bool XBee3RFIoSampleNow(XBee* self, XBee3RFIoSample_t* sample);
+#if XBEE_3RF_IO_ENABLED
+uint8_t XBee3RFIoSources(XBee* self, uint64_t* address64, uint8_t max);
+uint16_t XBee3RFIoRead(XBee* self, uint64_t address64, XBee3RFIoSample_t* samples, uint16_t max);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE3RF_H
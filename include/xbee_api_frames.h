@@ -46,7 +46,18 @@
  #include "xbee.h"
  #include "config.h"
  
- #define XBEE_MAX_FRAME_DATA_SIZE 1024 //@todo: Dynamic size based on api frame length
+ // Largest frame any subclass receives; each instance is limited by its own XBEE_<SUBCLASS>_MAX_FRAME_DATA_SIZE
+ #if XBEE_LR_MAX_FRAME_DATA_SIZE >= XBEE_CELLULAR_MAX_FRAME_DATA_SIZE && XBEE_LR_MAX_FRAME_DATA_SIZE >= XBEE_3RF_MAX_FRAME_DATA_SIZE
+ #define XBEE_MAX_FRAME_DATA_SIZE XBEE_LR_MAX_FRAME_DATA_SIZE
+ #elif XBEE_CELLULAR_MAX_FRAME_DATA_SIZE >= XBEE_3RF_MAX_FRAME_DATA_SIZE
+ #define XBEE_MAX_FRAME_DATA_SIZE XBEE_CELLULAR_MAX_FRAME_DATA_SIZE
+ #else
+ #define XBEE_MAX_FRAME_DATA_SIZE XBEE_3RF_MAX_FRAME_DATA_SIZE
+ #endif
+ #if XBEE_LR_FRAME_POOL_SIZE < XBEE_LR_MAX_FRAME_DATA_SIZE || XBEE_CELLULAR_FRAME_POOL_SIZE < XBEE_CELLULAR_MAX_FRAME_DATA_SIZE || \
+     XBEE_3RF_FRAME_POOL_SIZE < XBEE_3RF_MAX_FRAME_DATA_SIZE
+ #error "A frame pool must hold at least one frame of its subclass"
+ #endif
  #define API_SEND_SUCCESS 0
  #define API_SEND_ERROR_TIMEOUT -1
  #define API_SEND_ERROR_INVALID_COMMAND -2
@@ -172,6 +183,17 @@
   * @var XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET
   *     Frame type specific to XBee 3 RF modules for receiving explicitly addressed data packets.
   *     It includes addressing information along with the received payload.
+  * @var XBEE_API_TYPE_3RF_EXTENDED_TX_STATUS
+  *     Frame type specific to XBee 3 RF modules that reports the delivery status of a TX Request
+  *     along with the 16-bit address used, the retry count and the route discovery status.
+  *
+  * @var XBEE_API_TYPE_3RF_CREATE_SOURCE_ROUTE
+  *     Frame type specific to XBee 3 Zigbee modules that gives the module the hops to a node,
+  *     used for the next transmissions to it instead of a route discovery.
+  *
+  * @var XBEE_API_TYPE_3RF_ROUTE_RECORD
+  *     Frame type specific to XBee 3 Zigbee modules that reports the hops a packet took from a
+  *     node to this module when it acts as a many-to-one concentrator.
   *
   * @var XBEE_API_TYPE_CELLULAR_TX_IPV4
   *     Frame type specific to XBee Cellular modules for transmitting IPv4 data packets. It initiates
@@ -222,6 +244,9 @@
      XBEE_API_TYPE_3RF_REMOTE_AT_RESPONSE = 0x97,   ///< Frame for receiving remote AT responses (XBee 3 RF)
      XBEE_API_TYPE_3RF_RX_PACKET = 0x90,            ///< Frame for receiving data packets (XBee 3 RF)
      XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET = 0x91,   ///< Frame for receiving explicitly addressed packets (XBee 3 RF)
+     XBEE_API_TYPE_3RF_EXTENDED_TX_STATUS = 0x8B,   ///< Frame for extended delivery status reports (XBee 3 RF)
+     XBEE_API_TYPE_3RF_CREATE_SOURCE_ROUTE = 0x21,  ///< Frame for setting the route to a node (XBee 3 Zigbee)
+     XBEE_API_TYPE_3RF_ROUTE_RECORD = 0xA1,         ///< Frame for route record indicators (XBee 3 Zigbee)
  
      /**< XBee Cellular Specific API Frames */
      XBEE_API_TYPE_CELLULAR_TX_IPV4 = 0x20,         ///< Frame for transmitting IPv4 data (XBee Cellular)
@@ -254,6 +279,20 @@
  
  } xbee_api_frame_type_t;
  
+ /**
+  * @enum xbee_modem_status_t
+  * @brief Status codes carried by XBEE_API_TYPE_MODEM_STATUS frames.
+  *
+  * Only the codes the library acts on are listed; xbeeHandleModemStatus()
+  * records every code in XBee::modemStatus.
+  */
+ typedef enum {
+     XBEE_MODEM_STATUS_HARDWARE_RESET = 0x00,   ///< Power up or reset pin
+     XBEE_MODEM_STATUS_WATCHDOG_RESET = 0x01,   ///< Reset by the module's watchdog
+     XBEE_MODEM_STATUS_JOINED = 0x02,           ///< Joined the LoRaWAN network, or registered with the cellular network
+     XBEE_MODEM_STATUS_LEFT = 0x03,             ///< Left the network, or unregistered
+ } xbee_modem_status_t;
+ 
  
  /**
   * @enum api_receive_status_t
@@ -273,7 +312,8 @@
      API_RECEIVE_ERROR_TIMEOUT_DATA = -6,      ///< Timeout or error reading frame data
      API_RECEIVE_ERROR_TIMEOUT_CHECKSUM = -7,  ///< Timeout or error reading checksum
      API_RECEIVE_ERROR_INVALID_CHECKSUM = -8,  ///< Invalid checksum detected
-     API_RECEIVE_ERROR_UART_FAILURE = -9       ///< UART read or write failure
+     API_RECEIVE_ERROR_UART_FAILURE = -9,      ///< UART read or write failure
+     API_RECEIVE_ERROR_FRAME_ABORTED = -10     ///< Start delimiter inside an escaped-mode frame
  } api_receive_status_t;
  
  /**
@@ -302,30 +342,32 @@
   *     The checksum is calculated over the frame's data and is essential for detecting 
   *     transmission errors.
   * @var xbee_api_frame_t::data
-  *     The actual data contained within the API frame. This array holds the payload or 
-  *     command data associated with the frame type. The size of this array is defined by 
-  *     `XBEE_MAX_FRAME_DATA_SIZE`, which should be set according to the maximum expected 
-  *     frame size in the application.
+  *     The actual data contained within the API frame, starting with the frame type. 
+  *     Received frames point into the frame pool of the instance they were received on 
+  *     (see apiReceiveApiFrame()), so the structure itself stays a few bytes on the stack. 
+  *     Frames built by hand may point at any buffer of at least `length` bytes.
   *
   * Example Usage:
   * @code
+  * uint8_t data[10] = { XBEE_API_TYPE_TX_REQUEST, 0x01 }; // Example payload data
   * xbee_api_frame_t frame;
   * frame.type = XBEE_API_TYPE_TX_REQUEST;
-  * frame.length = 10;
-  * frame.data[0] = 0x01; // Example payload data
-  * frame.checksum = calculateChecksum(frame.data, frame.length);
+  * frame.length = sizeof(data);
+  * frame.data = data;
+  * frame.checksum = 0xFF - xbeeChecksumAdd(0, frame.data, frame.length);
   * @endcode
   */
  typedef struct {
      xbee_api_frame_type_t type;  ///< Type of the API frame
      uint16_t length;             ///< Length of the frame data
      uint8_t checksum;            ///< Checksum of the API frame
-     uint8_t data[XBEE_MAX_FRAME_DATA_SIZE]; ///< Frame data
+     uint8_t* data;               ///< Frame data, `length` bytes
  } xbee_api_frame_t;
  
  
  // Function prototypes
  api_receive_status_t apiReceiveApiFrame(XBee* self, xbee_api_frame_t *frame);
+ api_receive_status_t apiReceiveApiFrameWithin(XBee* self, xbee_api_frame_t *frame, uint32_t idleTimeoutMs);
  int apiSendAtCommand(XBee* self,at_command_t command, const uint8_t *parameter, uint8_t paramLength);
  int apiSendFrame(XBee* self,uint8_t frame_type, const uint8_t *data, uint16_t len);
  int apiSendAtCommandAndGetResponse(XBee* self, at_command_t command, const uint8_t *parameter, 
@@ -41,6 +41,7 @@ extern "C"
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "config.h"
 
 /**
@@ -169,6 +170,7 @@ typedef enum {
 
     // ... (other existing AT commands) ...
 
+    AT_COMMAND_COUNT,   /**< Number of commands, not a command */
 } at_command_t;
 
 
@@ -183,6 +185,72 @@ typedef enum {
  */
 const char* atCommandToString(at_command_t command);
 
+/**
+ * @brief Module families whose firmware gives a common command name its own meaning.
+ *
+ * Selects the module specific commands, such as AT_DE_RF, in the reverse
+ * lookup; each subclass sets XBee::atModule to its family.
+ */
+typedef enum {
+    AT_MODULE_COMMON,       /**< Only the commands in the common list */
+    AT_MODULE_3RF,          /**< XBee 3 RF: AT_DE_RF, AT_WR_RF */
+    AT_MODULE_CELLULAR,     /**< XBee 3 Cellular: AT_RI_CELL */
+} at_module_t;
+
+bool atCommandFromString(uint8_t module, const char* name, at_command_t* command);
+at_command_t atCommandForModule(uint8_t module, at_command_t command);
+
+/**
+ * @brief Parameter types described by at_command_info_t.
+ *
+ * Integers are always sent and received big-endian, as the XBee AT command
+ * set specifies, so the type also fixes the byte order.
+ */
+typedef enum {
+    AT_TYPE_NONE,       /**< Executed, takes and returns no value */
+    AT_TYPE_UINT,       /**< Unsigned integer, big-endian on the wire */
+    AT_TYPE_BYTES,      /**< Raw bytes such as EUIs and keys */
+    AT_TYPE_STRING,     /**< ASCII text, not NUL terminated on the wire */
+} at_param_type_t;
+
+/**
+ * @brief How long the module takes to answer a command.
+ *
+ * Each class starts from one of the XBEE_AT_TIMEOUT_*_MS values in config.h
+ * and, with XBEE_AT_TIMEOUT_ADAPTIVE, learns its own timeout (xbee_timeout.h).
+ */
+typedef enum {
+    AT_LATENCY_REGISTER,    /**< Reads or writes a RAM setting */
+    AT_LATENCY_APPLY,       /**< Applies settings to the radio */
+    AT_LATENCY_FLASH,       /**< Writes flash or restores defaults */
+    AT_LATENCY_COUNT
+} at_latency_t;
+
+#define AT_FLAG_VARIABLE    0x01    /**< Value may be shorter than width */
+#define AT_FLAG_READ_ONLY   0x02    /**< Query only */
+#define AT_FLAG_WRITE_ONLY  0x04    /**< Set only, e.g. keys */
+#define AT_FLAG_CACHE_STATIC 0x08   /**< Identity value, read once per boot (xbee_cache.h) */
+#define AT_FLAG_CACHE_STATUS 0x10   /**< Network status, cached for XBEE_CACHE_TTL_STATUS_MS */
+#define AT_FLAG_CACHE_LINK  0x20    /**< Link quality, cached for XBEE_CACHE_TTL_LINK_MS */
+#define AT_FLAG_CACHE       (AT_FLAG_CACHE_STATIC | AT_FLAG_CACHE_STATUS | AT_FLAG_CACHE_LINK)
+
+/**
+ * @brief Metadata for one AT command, see atCommandInfo().
+ */
+typedef struct {
+    const char* name;   /**< Two character command string */
+    uint8_t type;       /**< at_param_type_t */
+    uint8_t width;      /**< Value size in bytes, the maximum if AT_FLAG_VARIABLE */
+    uint8_t flags;      /**< AT_FLAG_* bits */
+    uint8_t latency;    /**< at_latency_t */
+    uint32_t min;       /**< Smallest accepted AT_TYPE_UINT value */
+    uint32_t max;       /**< Largest accepted AT_TYPE_UINT value */
+} at_command_info_t;
+
+const at_command_info_t* atCommandInfo(at_command_t command);
+uint8_t atCommandLatency(at_command_t command);
+uint32_t atCommandTimeout(at_command_t command);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,102 @@
+/**
+ * @file xbee_cache.h
+ * @brief Per-instance cache of polled AT reads.
+ *
+ * XBeeAtGet() and XBeeAtGetBytes() answer reads of parameters flagged
+ * AT_FLAG_CACHE_* in the metadata table from this cache when they can:
+ *
+ * - AT_FLAG_CACHE_STATIC values (VR, HV, SH, SL, DE, LV) are read once and
+ *   kept until the module is reset.
+ * - AT_FLAG_CACHE_STATUS values (JS, AI) live XBEE_CACHE_TTL_STATUS_MS and
+ *   are dropped when a modem status frame arrives.
+ * - AT_FLAG_CACHE_LINK values (DB) live XBEE_CACHE_TTL_LINK_MS and are
+ *   dropped when a packet is received, since it updates the module's value.
+ *
+ * A read issued while a query for the same parameter is already waiting
+ * further up the stack, e.g. from a callback dispatched during that wait,
+ * does not send a second query: it gets the last known value, or fails if
+ * there is none yet.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_CACHE_H
+#define XBEE_CACHE_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "xbee_at_cmds.h"
+
+#define XBEE_CACHE_VALUE_MAX 16    ///< Largest value cached, e.g. the LoRaWAN version string
+
+#define XBEE_CACHE_PENDING 0x01    ///< A query for the entry is waiting for its response
+#define XBEE_CACHE_DROPPED 0x02    ///< Invalidated while pending; the response is not cached
+
+/**
+ * @brief One cached AT parameter. `length` is 0 while no value is known.
+ */
+typedef struct {
+    uint8_t command;                        ///< at_command_t
+    uint8_t flags;                          ///< AT_FLAG_CACHE_* bits of the command
+    uint8_t state;                          ///< XBEE_CACHE_PENDING/DROPPED
+    uint8_t length;
+    uint32_t storedAt;                      ///< PortMillis() when the value was read
+    uint8_t value[XBEE_CACHE_VALUE_MAX];
+} XBeeCacheEntry_t;
+
+typedef struct {
+    XBeeCacheEntry_t entries[XBEE_CACHE_ENTRIES];
+    uint8_t count;
+} XBeeCache_t;
+
+#if XBEE_CACHE_ENABLED
+void xbeeCacheReset(XBeeCache_t* cache);
+void xbeeCacheDrop(XBeeCache_t* cache, uint8_t flags);
+XBeeCacheEntry_t* xbeeCacheTrack(XBeeCache_t* cache, at_command_t command, uint8_t flags);
+bool xbeeCacheFresh(const XBeeCacheEntry_t* entry, uint32_t now);
+void xbeeCacheStore(XBeeCacheEntry_t* entry, const uint8_t* value, uint8_t length, uint32_t now);
+
+// Used by XBeeInit() only: malloc left the entry count undefined
+#define XBEE_CACHE_INIT(self)         ((self)->cache.count = 0)
+#define XBEE_CACHE_RESET(self)        xbeeCacheReset(&(self)->cache)
+#define XBEE_CACHE_DROP(self, flags)  xbeeCacheDrop(&(self)->cache, (flags))
+#else
+#define XBEE_CACHE_INIT(self)         ((void)0)
+#define XBEE_CACHE_RESET(self)        ((void)0)
+#define XBEE_CACHE_DROP(self, flags)  ((void)0)
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_CACHE_H
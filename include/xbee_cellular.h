@@ -101,6 +101,7 @@ typedef struct {
 typedef struct {
     XBee base;
     XBeeCellularConfig_t config;
+    uint8_t framePool[XBEE_CELLULAR_FRAME_POOL_SIZE];   ///< Received frames, see apiReceiveApiFrame()
 } XBeeCellular;
 
 /**
@@ -148,6 +149,12 @@ void XBeeCellularHardReset(XBee* self);
  */
 void XBeeCellularProcess(XBee* self);
 
+/**
+ * @brief Initializes an XBeeCellular instance in caller-provided (usually static) storage.
+ */
+XBeeCellular* XBeeCellularInitStatic(XBeeCellular* storage, const XBeeCTable* cTable, const XBeeHTable* hTable);
+
+#if !XBEE_NO_HEAP
 /**
  * @brief Allocates and initializes an XBeeCellular instance.
  */
@@ -157,6 +164,7 @@ XBeeCellular* XBeeCellularCreate(const XBeeCTable* cTable, const XBeeHTable* hTa
  * @brief Deallocates the XBeeCellular instance.
  */
 void XBeeCellularDestroy(XBeeCellular* self);
+#endif
 
 /**
  * @brief Creates a new socket on the XBee module.
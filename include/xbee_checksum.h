@@ -0,0 +1,56 @@
+/**
+ * @file xbee_checksum.h
+ * @brief API frame checksum kernels.
+ *
+ * The checksum of an API frame is 0xFF minus the low byte of the sum of the
+ * bytes between the length field and the checksum. These kernels add bytes
+ * to a running sum many at a time: 16 with SSE2 or NEON where the compiler
+ * targets them, otherwise a machine word. xbeeChecksumCopy() adds the bytes
+ * while copying them, so frames are not read a second time to checksum them.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_CHECKSUM_H
+#define XBEE_CHECKSUM_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+uint8_t xbeeChecksumAdd(uint8_t sum, const uint8_t* data, size_t length);
+uint8_t xbeeChecksumCopy(uint8_t sum, uint8_t* dst, const uint8_t* src, size_t length);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_CHECKSUM_H
@@ -0,0 +1,67 @@
+/**
+ * @file xbee_escape.h
+ * @brief Byte stuffing for API escaped mode (ATAP=2).
+ *
+ * In escaped mode every byte of a frame after the start delimiter that is a
+ * delimiter (0x7E), an escape (0x7D), XON (0x11) or XOFF (0x13) is sent as
+ * 0x7D followed by the byte XOR 0x20. The start delimiter then never occurs
+ * inside a frame and the flow control characters are left to the UART.
+ *
+ * Both directions scan a machine word at a time for bytes that need work
+ * and copy the runs between them in bulk, so frames without special bytes
+ * cost little more than a memcpy.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_ESCAPE_H
+#define XBEE_ESCAPE_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define XBEE_START_DELIMITER 0x7E
+#define XBEE_ESCAPE          0x7D
+#define XBEE_XON             0x11
+#define XBEE_XOFF            0x13
+#define XBEE_ESCAPE_XOR      0x20    ///< Applied to the byte that follows XBEE_ESCAPE
+
+bool xbeeEscapeNeeded(uint8_t byte);
+size_t xbeeEscapeScan(const uint8_t* data, size_t length);
+size_t xbeeEscape(uint8_t* out, size_t outSize, const uint8_t* in, size_t inLength, size_t* consumed);
+int xbeeUnescape(uint8_t* data, size_t length, bool* escaped, uint8_t* sum);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_ESCAPE_H
@@ -0,0 +1,143 @@
+/**
+ * @file xbee_log.h
+ * @brief Leveled, buffered logging for the XBee library.
+ *
+ * Log statements carry a level and a module. Statements more verbose than
+ * XBEE_LOG_MAX_LEVEL are compiled out; the rest are filtered at runtime by
+ * XBeeLogSetLevel() and XBeeLogSetModules(). A statement that passes is
+ * formatted once into a line and appended to a RAM ring; nothing is written
+ * to the debug port from the logging call itself. XBeeLogDrain(), called by
+ * XBeeProcess() or by the application from any thread, hands the buffered
+ * text to the sink set with XBeeLogSetSink() in as few writes as possible.
+ *
+ * Byte buffers are logged with XBEE_LOG_HEX(), which formats the whole dump
+ * into one line with a lookup table instead of one printf call per byte.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_LOG_H
+#define XBEE_LOG_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#if (XBEE_LOG_BUFFER_SIZE & (XBEE_LOG_BUFFER_SIZE - 1)) != 0
+#error "XBEE_LOG_BUFFER_SIZE must be a power of two"
+#endif
+
+// Module bits for XBeeLogSetModules()
+#define XBEE_LOG_MODULE_CORE     0x01UL    ///< xbee.c
+#define XBEE_LOG_MODULE_API      0x02UL    ///< API frame encode/decode and dispatch
+#define XBEE_LOG_MODULE_LR       0x04UL    ///< XBee LR subclass
+#define XBEE_LOG_MODULE_CELLULAR 0x08UL    ///< XBee 3 Cellular subclass
+#define XBEE_LOG_MODULE_3RF      0x10UL    ///< XBee 3 RF subclass
+#define XBEE_LOG_MODULE_ALL      0xFFFFFFFFUL
+
+// Module used by XBEEDebugPrint() in the including source file
+#ifndef XBEE_LOG_MODULE
+#define XBEE_LOG_MODULE XBEE_LOG_MODULE_CORE
+#endif
+
+/**
+ * @brief Receives drained log text; `text` is not NUL terminated.
+ */
+typedef void (*XBeeLogSink)(const char* text, size_t len);
+
+extern volatile uint8_t xbeeLogLevel;
+extern volatile uint32_t xbeeLogModules;
+
+void XBeeLogSetLevel(uint8_t level);
+void XBeeLogSetModules(uint32_t mask);
+void XBeeLogSetSink(XBeeLogSink sink);
+size_t XBeeLogDrain(size_t maxBytes);
+size_t XBeeLogPending(void);
+uint32_t XBeeLogDropped(void);
+void XBeeLogReset(void);
+
+void xbeeLogPrintf(uint8_t level, uint32_t module, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+void xbeeLogHex(uint8_t level, uint32_t module, const char* prefix, const uint8_t* data, size_t len);
+void xbeeLogText(uint8_t level, uint32_t module, const char* prefix, const uint8_t* data, size_t len);
+
+/**
+ * @brief True if a statement at `level` for `module` would be logged.
+ *
+ * The first term is a compile-time constant, so statements above
+ * XBEE_LOG_MAX_LEVEL are removed by the compiler.
+ */
+#define XBEE_LOG_ON(level, module) \
+    ((level) <= XBEE_LOG_MAX_LEVEL && (level) <= xbeeLogLevel && (xbeeLogModules & (module)))
+
+#define XBEE_LOG(level, module, ...) \
+    do { if (XBEE_LOG_ON(level, module)) xbeeLogPrintf((level), (module), __VA_ARGS__); } while (0)
+
+/** @brief Logs `prefix` followed by `len` bytes as space separated hex pairs. */
+#define XBEE_LOG_HEX(level, module, prefix, data, len) \
+    do { if (XBEE_LOG_ON(level, module)) xbeeLogHex((level), (module), (prefix), (data), (len)); } while (0)
+
+/** @brief Logs `prefix` followed by `len` bytes as text, with non-printable bytes shown as '.'. */
+#define XBEE_LOG_TEXT(level, module, prefix, data, len) \
+    do { if (XBEE_LOG_ON(level, module)) xbeeLogText((level), (module), (prefix), (data), (len)); } while (0)
+
+#if XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_ERROR
+#define XBEE_LOG_ERROR(module, ...) XBEE_LOG(XBEE_LOG_LEVEL_ERROR, module, __VA_ARGS__)
+#else
+#define XBEE_LOG_ERROR(module, ...) ((void)0)
+#endif
+
+#if XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_WARN
+#define XBEE_LOG_WARN(module, ...) XBEE_LOG(XBEE_LOG_LEVEL_WARN, module, __VA_ARGS__)
+#else
+#define XBEE_LOG_WARN(module, ...) ((void)0)
+#endif
+
+#if XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_INFO
+#define XBEE_LOG_INFO(module, ...) XBEE_LOG(XBEE_LOG_LEVEL_INFO, module, __VA_ARGS__)
+#else
+#define XBEE_LOG_INFO(module, ...) ((void)0)
+#endif
+
+#if XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_DEBUG
+#define XBEE_LOG_DEBUG(module, ...) XBEE_LOG(XBEE_LOG_LEVEL_DEBUG, module, __VA_ARGS__)
+#else
+#define XBEE_LOG_DEBUG(module, ...) ((void)0)
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_LOG_H
@@ -67,14 +67,47 @@
      int8_t power;
  }XBeeLRPacket_t;
  
+ // XBeeLRConfig_t.fields bits selecting the integer settings to apply
+ #define XBEE_LR_CONFIG_REGION       0x01
+ #define XBEE_LR_CONFIG_ACTIVATION   0x02
+ #define XBEE_LR_CONFIG_ADR          0x04
+ #define XBEE_LR_CONFIG_DATA_RATE    0x08
+ #define XBEE_LR_CONFIG_API_OPTIONS  0x10
+ 
+ /**
+  * @brief Desired LoRaWAN configuration, applied with XBeeConfigure().
+  *
+  * Only settings that differ from the module are written (see
+  * XBeeShadowSync()). NULL strings and a zero class are left unchanged, as
+  * are integer settings whose bit is not set in `fields`.
+  */
+ typedef struct {
+     const char* appEUI;         ///< 16 hex characters
+     const char* appKey;         ///< 32 hex characters
+     const char* nwkKey;         ///< 32 hex characters
+     const char* channelsMask;   ///< Up to 32 hex characters
+     char lorawanClass;          ///< 'A', 'B' or 'C'
+     uint8_t fields;             ///< XBEE_LR_CONFIG_* bits
+     uint8_t region;
+     uint8_t activationMode;
+     uint8_t adr;
+     uint8_t dataRate;
+     uint8_t apiOptions;
+ } XBeeLRConfig_t;
+ 
  // Subclass for XBeeLR
  typedef struct {
      XBee base;  // Inherit from XBee
      // Add XBeeLR specific attributes here like methods specific to an XBee type
+     uint8_t framePool[XBEE_LR_FRAME_POOL_SIZE];     ///< Received frames, see apiReceiveApiFrame()
  } XBeeLR;
  
  
+ XBeeLR* XBeeLRInitStatic(XBeeLR* storage, const XBeeCTable* cTable, const XBeeHTable* hTable);
+ #if !XBEE_NO_HEAP
  XBeeLR* XBeeLRCreate(const XBeeCTable* cTable, const XBeeHTable* hTable);
+ void XBeeLRDestroy(XBeeLR* self);
+ #endif
  bool XBeeLRGetDevEUI(XBee* self, char* responseBuffer, uint8_t buffer_size);
  bool XBeeLRSetAppEUI(XBee* self, const char* value);
  bool XBeeLRSetAppKey(XBee* self, const char* value);
@@ -96,6 +129,7 @@
  bool XBeeLRSetTransmitPower(XBee* self, const uint8_t value);
  bool XBeeLRSetChannelsMask(XBee* self, const char* value);
  bool XBeeLRInit(XBee* self, uint32_t baudRate, void* device);
+ bool XBeeLRConfigure(XBee* self, const void* config);
  bool XBeeLRConnected(XBee* self);
  uint8_t XBeeLRSendPacket(XBee* self, const void* data);
  
@@ -0,0 +1,109 @@
+/**
+ * @file xbee_shadow.h
+ * @brief Host-side shadow of XBee module parameters.
+ *
+ * Every XBee instance can carry an XBeeShadow_t holding the last known value
+ * of the AT parameters it tracks. XBeeShadowSync() fills the shadow with one
+ * pipelined read of the parameters it has not seen yet, compares them with
+ * the desired values, sends only the ones that differ and finishes with a
+ * single WR and AC when something changed. A boot with an unchanged
+ * configuration therefore costs a burst of queries and no flash write.
+ *
+ * The shadow is kept coherent by XBeeAtSet(), XBeeAtGet() and their byte
+ * variants, and is invalidated by the reset calls in xbee.c.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_SHADOW_H
+#define XBEE_SHADOW_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "xbee_at_cmds.h"
+
+#define XBEE_SHADOW_VALUE_MAX 16    ///< Largest parameter kept, e.g. a LoRaWAN key
+
+/**
+ * @brief Last known value of one tracked AT parameter.
+ *
+ * `length` is 0 while the value is unknown: not read yet, invalidated by a
+ * reset, or write-only and not written since.
+ */
+typedef struct {
+    uint8_t command;                        ///< at_command_t
+    uint8_t length;
+    uint8_t value[XBEE_SHADOW_VALUE_MAX];   ///< Raw big-endian bytes as exchanged with the module
+} XBeeShadowEntry_t;
+
+typedef struct {
+    XBeeShadowEntry_t entries[XBEE_SHADOW_MAX_PARAMS];
+    uint8_t count;
+} XBeeShadow_t;
+
+/**
+ * @brief Desired value of one parameter passed to XBeeShadowSync().
+ *
+ * Integer parameters use `value` and are encoded at the width given by
+ * their metadata entry; byte parameters set `data` and `length`.
+ */
+typedef struct {
+    at_command_t command;
+    uint32_t value;
+    const uint8_t* data;    ///< NULL for integer parameters
+    uint8_t length;
+} XBeeShadowParam_t;
+
+#define XBEE_SHADOW_UINT(cmd, v)          { .command = (cmd), .value = (v) }
+#define XBEE_SHADOW_BYTES(cmd, d, len)    { .command = (cmd), .data = (d), .length = (len) }
+
+#if XBEE_SHADOW_ENABLED
+void xbeeShadowReset(XBeeShadow_t* shadow);
+void xbeeShadowInvalidate(XBeeShadow_t* shadow);
+XBeeShadowEntry_t* xbeeShadowFind(XBeeShadow_t* shadow, at_command_t command);
+XBeeShadowEntry_t* xbeeShadowTrack(XBeeShadow_t* shadow, at_command_t command);
+void xbeeShadowStore(XBeeShadow_t* shadow, at_command_t command, const uint8_t* value, uint8_t length);
+
+#define XBEE_SHADOW_RESET(self)                   xbeeShadowReset(&(self)->shadow)
+#define XBEE_SHADOW_INVALIDATE(self)              xbeeShadowInvalidate(&(self)->shadow)
+#define XBEE_SHADOW_STORE(self, cmd, value, len)  xbeeShadowStore(&(self)->shadow, (cmd), (value), (len))
+#else
+#define XBEE_SHADOW_RESET(self)                   ((void)0)
+#define XBEE_SHADOW_INVALIDATE(self)              ((void)0)
+#define XBEE_SHADOW_STORE(self, cmd, value, len)  ((void)0)
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_SHADOW_H
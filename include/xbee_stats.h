@@ -0,0 +1,156 @@
+/**
+ * @file xbee_stats.h
+ * @brief Per-instance counters and latency histograms for the XBee library.
+ *
+ * Every XBee instance carries an XBeeStats_t that the API frame layer
+ * updates as frames are sent and received: frame and byte counts by frame
+ * type, receive results by api_receive_status_t, AT command outcomes, and
+ * log2-bucketed histograms for AT round-trip time, TX status latency and
+ * XBeeProcess() duration. Updates are plain increments on the owning
+ * instance, bracketed by a sequence counter so that XBeeGetStats() can take
+ * a consistent copy from another thread without ever blocking the writer.
+ *
+ * Set XBEE_STATS_ENABLED to 0 (config.h or the compiler command line) to
+ * compile the instrumentation out entirely.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_STATS_H
+#define XBEE_STATS_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "xbee_at_cmds.h"
+
+#define XBEE_STATS_FRAME_TYPE_SLOTS 32    ///< Slot 0 collects frame types without a slot of their own
+#define XBEE_STATS_RX_STATUS_COUNT 11     ///< One counter per api_receive_status_t, indexed by -status
+#define XBEE_STATS_HIST_BUCKETS 16
+
+/**
+ * @brief Log2 latency histogram in milliseconds.
+ *
+ * Bucket 0 counts 0 ms samples, bucket k (1..14) counts [2^(k-1), 2^k) ms,
+ * and bucket 15 counts everything from 16384 ms up.
+ */
+typedef struct {
+    uint32_t buckets[XBEE_STATS_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t maxMs;
+    uint64_t sumMs;
+} XBeeStatsHist_t;
+
+/**
+ * @brief Instrumentation counters for one XBee instance.
+ *
+ * Frame and byte counters are indexed by XBeeStatsFrameTypeSlot(frameType);
+ * byte counts include the delimiter, length and checksum.
+ */
+typedef struct {
+    uint32_t seq;                                   ///< Odd while an update is in progress
+    uint32_t txFrames[XBEE_STATS_FRAME_TYPE_SLOTS];
+    uint32_t txBytes[XBEE_STATS_FRAME_TYPE_SLOTS];
+    uint32_t txErrors;                              ///< apiSendFrame() UART failures
+    uint32_t rxFrames[XBEE_STATS_FRAME_TYPE_SLOTS];
+    uint32_t rxBytes[XBEE_STATS_FRAME_TYPE_SLOTS];
+    uint32_t rxStatus[XBEE_STATS_RX_STATUS_COUNT];  ///< apiReceiveApiFrame() results, indexed by -status
+    uint32_t atCommands;                            ///< AT commands sent expecting a response
+    uint32_t atErrors;                              ///< Responses with a non-zero command status
+    uint32_t atTimeouts;                            ///< No response within the timeout
+    uint32_t atCacheHits;                           ///< AT reads answered from the cache (xbee_cache.h)
+#if XBEE_STATS_AT_COMMANDS
+    uint32_t atResponses[AT_COMMAND_COUNT];         ///< AT responses received, by the command they answer
+#endif
+    uint32_t txStatusTimeouts;                      ///< Transmissions that never got a TX status
+    uint32_t linkSamples;                           ///< RSSI readings recorded in lastRssi
+    int8_t lastRssi;                                ///< dBm, from the latest received packet or XBeeGetLastRssi()
+    int8_t lastSnr;                                 ///< dB, from the latest packet that reported one
+    XBeeStatsHist_t atRoundTrip;
+    XBeeStatsHist_t txStatusLatency;
+    XBeeStatsHist_t processLoop;
+} XBeeStats_t;
+
+uint8_t XBeeStatsFrameTypeSlot(uint8_t frameType);
+uint8_t XBeeStatsSlotFrameType(uint8_t slot);
+uint32_t XBeeStatsHistPercentile(const XBeeStatsHist_t* hist, uint8_t percent);
+
+#if XBEE_STATS_ENABLED
+void xbeeStatsReset(XBeeStats_t* stats);
+void xbeeStatsRecordTx(XBeeStats_t* stats, uint8_t frameType, uint16_t wireBytes);
+void xbeeStatsRecordRx(XBeeStats_t* stats, int status, uint8_t frameType, uint16_t wireBytes);
+void xbeeStatsHistAdd(XBeeStatsHist_t* hist, uint32_t ms);
+
+// Writer side of the sequence lock read by XBeeGetStats()
+#if defined(__GNUC__)
+#define XBEE_STATS_WRITE_BEGIN(stats) \
+    do { __atomic_store_n(&(stats)->seq, (stats)->seq + 1, __ATOMIC_RELAXED); \
+         __atomic_thread_fence(__ATOMIC_RELEASE); } while (0)
+#define XBEE_STATS_WRITE_END(stats) __atomic_store_n(&(stats)->seq, (stats)->seq + 1, __ATOMIC_RELEASE)
+#else
+#define XBEE_STATS_WRITE_BEGIN(stats) ((stats)->seq++)
+#define XBEE_STATS_WRITE_END(stats)   ((stats)->seq++)
+#endif
+
+#define XBEE_STATS_UPDATE(self, statement) \
+    do { XBEE_STATS_WRITE_BEGIN(&(self)->stats); statement; XBEE_STATS_WRITE_END(&(self)->stats); } while (0)
+
+// Used by XBeeInit() only: the instance is not yet visible to readers, and malloc left seq undefined
+#define XBEE_STATS_INIT(self)                  ((self)->stats.seq = 0, xbeeStatsReset(&(self)->stats))
+#define XBEE_STATS_RESET(self)                 XBEE_STATS_UPDATE(self, xbeeStatsReset(&(self)->stats))
+#define XBEE_STATS_TX(self, type, bytes)       XBEE_STATS_UPDATE(self, xbeeStatsRecordTx(&(self)->stats, (type), (bytes)))
+#define XBEE_STATS_RX(self, status, type, bytes) \
+    XBEE_STATS_UPDATE(self, xbeeStatsRecordRx(&(self)->stats, (status), (type), (bytes)))
+#define XBEE_STATS_INC(self, counter)          XBEE_STATS_UPDATE(self, (self)->stats.counter++)
+#define XBEE_STATS_HIST(self, hist, ms)        XBEE_STATS_UPDATE(self, xbeeStatsHistAdd(&(self)->stats.hist, (ms)))
+#define XBEE_STATS_LINK(self, rssi, snr) \
+    XBEE_STATS_UPDATE(self, ((self)->stats.lastRssi = (rssi), (self)->stats.lastSnr = (snr), (self)->stats.linkSamples++))
+#if XBEE_STATS_AT_COMMANDS
+#define XBEE_STATS_AT_RESPONSE(self, command)  XBEE_STATS_INC(self, atResponses[command])
+#else
+#define XBEE_STATS_AT_RESPONSE(self, command)  ((void)0)
+#endif
+#else
+#define XBEE_STATS_INIT(self)                  ((void)0)
+#define XBEE_STATS_RESET(self)                 ((void)0)
+#define XBEE_STATS_TX(self, type, bytes)       ((void)0)
+#define XBEE_STATS_RX(self, status, type, bytes) ((void)0)
+#define XBEE_STATS_INC(self, counter)          ((void)0)
+#define XBEE_STATS_HIST(self, hist, ms)        ((void)0)
+#define XBEE_STATS_LINK(self, rssi, snr)       ((void)0)
+#define XBEE_STATS_AT_RESPONSE(self, command)  ((void)0)
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_STATS_H
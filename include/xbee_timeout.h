@@ -0,0 +1,82 @@
+/**
+ * @file xbee_timeout.h
+ * @brief Adaptive AT response timeouts learned from observed round trips.
+ *
+ * Every XBee instance keeps, per AT latency class, a smoothed round-trip
+ * time and its mean deviation, updated like a TCP retransmission timer
+ * (RFC 6298). The timeout for the next command of that class is the
+ * smoothed time plus four deviations, clamped to XBEE_AT_TIMEOUT_FLOOR_MS
+ * and XBEE_AT_TIMEOUT_CEILING_MS, plus the time the request and the largest
+ * expected response take on the wire at the instance's baud rate. Samples
+ * exclude that wire time, so one estimate serves short and long frames.
+ *
+ * Until a class has a sample its timeout is the XBEE_AT_TIMEOUT_*_MS default;
+ * a timeout doubles it, up to the ceiling, until the module answers again.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_TIMEOUT_H
+#define XBEE_TIMEOUT_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include "config.h"
+#include "xbee_at_cmds.h"
+
+// Bytes an AT command and its response add on the wire around the parameter and value
+#define XBEE_AT_REQUEST_WIRE_BYTES 8     ///< Delimiter, length, type, frame ID, command, checksum
+#define XBEE_AT_RESPONSE_WIRE_BYTES 9    ///< As above plus the command status
+
+/**
+ * @brief Round-trip estimate for one latency class.
+ */
+typedef struct {
+    uint32_t srtt8;      ///< Smoothed round trip in 1/8 ms
+    uint32_t rttvar4;    ///< Mean deviation in 1/4 ms
+    uint32_t rtoMs;      ///< Timeout before wire time is added
+    uint32_t samples;
+} XBeeTimeoutClass_t;
+
+typedef struct {
+    XBeeTimeoutClass_t classes[AT_LATENCY_COUNT];
+} XBeeTimeouts_t;
+
+void xbeeTimeoutReset(XBeeTimeouts_t* timeouts);
+uint32_t xbeeTimeoutGet(const XBeeTimeouts_t* timeouts, uint8_t latency);
+void xbeeTimeoutSample(XBeeTimeouts_t* timeouts, uint8_t latency, uint32_t rttMs);
+void xbeeTimeoutBackoff(XBeeTimeouts_t* timeouts, uint8_t latency);
+uint32_t xbeeWireTimeMs(uint32_t baudRate, uint32_t bytes);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_TIMEOUT_H
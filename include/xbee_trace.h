@@ -0,0 +1,142 @@
+/**
+ * @file xbee_trace.h
+ * @brief Binary event tracing for latency investigations.
+ *
+ * When XBEE_TRACE_ENABLED is set, every XBee instance records timed spans
+ * into a fixed-size ring: API frame receive and send, apiHandleFrame()
+ * dispatch, application callbacks, blocking waits and XBeeProcess(). The
+ * ring has a single writer (the thread driving the instance) and can be read
+ * concurrently without locks; the oldest events are overwritten when it is
+ * full. XBeeTraceDump() serializes the ring and tools/xbee_trace converts one
+ * or more dumps into Chrome trace JSON for chrome://tracing or Perfetto.
+ *
+ * With XBEE_TRACE_ENABLED at 0 (the default) the trace points compile to
+ * nothing and XBee carries no ring.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_TRACE_H
+#define XBEE_TRACE_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#if (XBEE_TRACE_RING_SIZE & (XBEE_TRACE_RING_SIZE - 1)) != 0
+#error "XBEE_TRACE_RING_SIZE must be a power of two"
+#endif
+
+#define XBEE_TRACE_DUMP_MAGIC "XBTR"
+#define XBEE_TRACE_DUMP_VERSION 1
+#define XBEE_TRACE_DUMP_HEADER_SIZE 20
+#define XBEE_TRACE_DUMP_EVENT_SIZE 12
+
+/**
+ * @brief Trace point identifiers.
+ *
+ * Each event is a span with a start time and a duration; `arg` carries the
+ * detail noted for each identifier.
+ */
+typedef enum {
+    XBEE_TRACE_EVENT_RX_FRAME = 1,          ///< Start delimiter to end of frame; arg = type | (-status << 8)
+    XBEE_TRACE_EVENT_TX_FRAME = 2,          ///< UART write of one frame; arg = type | (1 << 8) on failure
+    XBEE_TRACE_EVENT_DISPATCH = 3,          ///< apiHandleFrame(); arg = frame type
+    XBEE_TRACE_EVENT_CALLBACK = 4,          ///< Application callback; arg = XBeeTraceCallback_t
+    XBEE_TRACE_EVENT_WAIT_AT = 5,           ///< AT command round trip; arg = at_command_t
+    XBEE_TRACE_EVENT_WAIT_TX_STATUS = 6,    ///< Wait for a TX status; arg = frame ID
+    XBEE_TRACE_EVENT_WAIT_JOIN = 7,         ///< LR join window
+    XBEE_TRACE_EVENT_WAIT_ATTACH = 8,       ///< Cellular network attach
+    XBEE_TRACE_EVENT_PROCESS = 9,           ///< XBeeProcess()
+} XBeeTraceEventId_t;
+
+typedef enum {
+    XBEE_TRACE_CALLBACK_RECEIVE = 0,
+    XBEE_TRACE_CALLBACK_SEND = 1,
+    XBEE_TRACE_CALLBACK_CONNECT = 2,
+    XBEE_TRACE_CALLBACK_DISCONNECT = 3,
+} XBeeTraceCallback_t;
+
+typedef struct {
+    uint32_t tsUs;      ///< Span start
+    uint32_t durUs;     ///< Span duration
+    uint8_t event;      ///< XBeeTraceEventId_t
+    uint8_t reserved;
+    uint16_t arg;
+} XBeeTraceEvent_t;
+
+/**
+ * @brief Single-writer event ring.
+ *
+ * `head` counts every event ever recorded; the writer fills the slot and
+ * then publishes it by advancing `head`. Readers see the newest
+ * XBEE_TRACE_RING_SIZE - 1 events.
+ */
+typedef struct {
+    XBeeTraceEvent_t events[XBEE_TRACE_RING_SIZE];
+    volatile uint32_t head;
+    uint32_t rxStartUs;             ///< Start delimiter time of the frame being received
+    uint8_t rxActive;               ///< Set between the start delimiter and the end of a receive
+    uint16_t instanceId;            ///< Copied to dumps so the converter can label modules
+    uint32_t (*clockUs)(void);      ///< Optional microsecond clock; PortMillis() * 1000 otherwise
+} XBeeTraceRing_t;
+
+void XBeeTraceRingReset(XBeeTraceRing_t* ring);
+void XBeeTraceRingRecord(XBeeTraceRing_t* ring, uint32_t tsUs, uint32_t durUs, uint8_t event, uint16_t arg);
+size_t XBeeTraceRingSnapshot(const XBeeTraceRing_t* ring, XBeeTraceEvent_t* out, size_t maxEvents, uint32_t* lost);
+size_t XBeeTraceRingDump(const XBeeTraceRing_t* ring, uint8_t* buf, size_t size);
+
+#if XBEE_TRACE_ENABLED
+struct XBee;
+uint32_t xbeeTraceNow(const struct XBee* self);
+
+#define XBEE_TRACE_RESET(self)                  XBeeTraceRingReset(&(self)->trace)
+#define XBEE_TRACE_START(self, t0)              uint32_t t0 = xbeeTraceNow(self)
+#define XBEE_TRACE_SPAN(self, t0, event, arg)   \
+    XBeeTraceRingRecord(&(self)->trace, (t0), xbeeTraceNow(self) - (t0), (event), (uint16_t)(arg))
+#define XBEE_TRACE_RX_START(self)               \
+    ((self)->trace.rxStartUs = xbeeTraceNow(self), (self)->trace.rxActive = 1)
+#define XBEE_TRACE_RX_END(self, arg)            \
+    ((self)->trace.rxActive ? ((self)->trace.rxActive = 0, \
+        XBEE_TRACE_SPAN(self, (self)->trace.rxStartUs, XBEE_TRACE_EVENT_RX_FRAME, arg)) : (void)0)
+#else
+#define XBEE_TRACE_RESET(self)                  ((void)0)
+#define XBEE_TRACE_START(self, t0)              ((void)0)
+#define XBEE_TRACE_SPAN(self, t0, event, arg)   ((void)0)
+#define XBEE_TRACE_RX_START(self)               ((void)0)
+#define XBEE_TRACE_RX_END(self, arg)            ((void)0)
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_TRACE_H
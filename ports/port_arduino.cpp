@@ -162,4 +162,14 @@ void portDebugPrintf(const char *format, ...) {
     vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
     Serial.print(buffer);
+}
+
+/**
+ * @brief Writes raw debug text, used as the XBeeLogSetSink() sink.
+ *
+ * @param[in] text Characters to write; not NUL terminated.
+ * @param[in] len Number of characters.
+ */
+void portDebugWrite(const char *text, size_t len) {
+    Serial.write((const uint8_t*)text, len);
 }
\ No newline at end of file
@@ -0,0 +1,248 @@
+/**
+ * @file port_capture.c
+ * @brief UART capture shim and capture file reader.
+ *
+ * This file implements the functions declared in port_capture.h. The shim
+ * forwards every HAL call to the inner XBeeHTable and appends the bytes that
+ * were actually transferred to the capture file; timestamps come from the
+ * inner HAL's PortMillis() so a capture taken on a virtual clock is as
+ * deterministic as the clock itself.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "port_capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t captureMagic[4] = { 'X', 'B', 'C', 'P' };
+
+static const XBeeHTable* innerHal;
+static FILE* captureFile;
+static uint32_t captureStartMs;
+
+// Record being accumulated; written out when the direction or millisecond changes
+static uint8_t pendingDir;
+static uint32_t pendingTimestamp;
+static uint16_t pendingLength;
+static uint8_t pendingData[PORT_CAPTURE_CHUNK_MAX];
+
+static void putLe16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void putLe32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+
+static uint16_t getLe16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void captureWritePending(void) {
+    uint8_t header[PORT_CAPTURE_RECORD_HEADER_SIZE];
+
+    if (!captureFile || pendingLength == 0) return;
+
+    header[0] = pendingDir;
+    putLe32(&header[1], pendingTimestamp);
+    putLe16(&header[5], pendingLength);
+    fwrite(header, 1, sizeof(header), captureFile);
+    fwrite(pendingData, 1, pendingLength, captureFile);
+    pendingLength = 0;
+}
+
+/**
+ * @brief Appends transferred bytes to the pending record, starting a new one when needed.
+ */
+static void captureLog(uint8_t dir, const uint8_t* data, size_t len) {
+    if (!captureFile || len == 0) return;
+
+    uint32_t ts = innerHal->PortMillis() - captureStartMs;
+    if (pendingLength > 0 && (pendingDir != dir || pendingTimestamp != ts)) {
+        captureWritePending();
+    }
+
+    while (len > 0) {
+        if (pendingLength == PORT_CAPTURE_CHUNK_MAX) captureWritePending();
+        size_t room = PORT_CAPTURE_CHUNK_MAX - pendingLength;
+        size_t copy = len < room ? len : room;
+        pendingDir = dir;
+        pendingTimestamp = ts;
+        memcpy(&pendingData[pendingLength], data, copy);
+        pendingLength += (uint16_t)copy;
+        data += copy;
+        len -= copy;
+    }
+}
+
+/**
+ * @brief Starts capturing UART traffic that goes through the shim.
+ *
+ * @param[in] inner HAL the shim forwards to; it must stay valid until portCaptureStop().
+ * @param[in] path Capture file to create (truncated if it exists).
+ *
+ * @return bool True if the file was created.
+ */
+bool portCaptureStart(const XBeeHTable* inner, const char* path) {
+    uint8_t header[PORT_CAPTURE_HEADER_SIZE] = { 0 };
+
+    portCaptureStop();
+    captureFile = fopen(path, "wb");
+    if (!captureFile) return false;
+
+    memcpy(header, captureMagic, sizeof(captureMagic));
+    header[4] = PORT_CAPTURE_VERSION;
+    fwrite(header, 1, sizeof(header), captureFile);
+
+    innerHal = inner;
+    captureStartMs = inner->PortMillis();
+    pendingLength = 0;
+    return true;
+}
+
+/**
+ * @brief Writes buffered records to disk without stopping the capture.
+ */
+void portCaptureFlush(void) {
+    captureWritePending();
+    if (captureFile) fflush(captureFile);
+}
+
+/**
+ * @brief Writes the last record and closes the capture file.
+ */
+void portCaptureStop(void) {
+    if (!captureFile) return;
+    captureWritePending();
+    fclose(captureFile);
+    captureFile = NULL;
+}
+
+int portCaptureUartRead(uint8_t* buffer, int length) {
+    int n = innerHal->PortUartRead(buffer, length);
+    if (n > 0) captureLog(PORT_CAPTURE_DIR_RX, buffer, (size_t)n);
+    return n;
+}
+
+int portCaptureUartWrite(const uint8_t* buf, uint16_t len) {
+    int n = innerHal->PortUartWrite(buf, len);
+    if (n > 0) captureLog(PORT_CAPTURE_DIR_TX, buf, (size_t)n);
+    return n;
+}
+
+uint32_t portCaptureMillis(void) {
+    return innerHal->PortMillis();
+}
+
+void portCaptureFlushRx(void) {
+    innerHal->PortFlushRx();
+}
+
+int portCaptureUartInit(uint32_t baudrate, void* device) {
+    return innerHal->PortUartInit(baudrate, device);
+}
+
+void portCaptureDelay(uint32_t ms) {
+    innerHal->PortDelay(ms);
+}
+
+/**
+ * @brief Loads a capture file into memory and validates its header.
+ *
+ * @param[out] reader Reader to initialize; release it with portCaptureReaderClose().
+ * @param[in] path Capture file.
+ *
+ * @return bool True if the file was read and has a supported header.
+ */
+bool portCaptureReaderOpen(PortCaptureReader_t* reader, const char* path) {
+    FILE* f = fopen(path, "rb");
+    long size;
+
+    memset(reader, 0, sizeof(*reader));
+    if (!f) return false;
+
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < PORT_CAPTURE_HEADER_SIZE) {
+        fclose(f);
+        return false;
+    }
+    rewind(f);
+
+    reader->buffer = (uint8_t*)malloc((size_t)size);
+    if (!reader->buffer || fread(reader->buffer, 1, (size_t)size, f) != (size_t)size) {
+        fclose(f);
+        portCaptureReaderClose(reader);
+        return false;
+    }
+    fclose(f);
+    reader->size = (size_t)size;
+
+    if (memcmp(reader->buffer, captureMagic, sizeof(captureMagic)) != 0 ||
+        reader->buffer[4] != PORT_CAPTURE_VERSION) {
+        portCaptureReaderClose(reader);
+        return false;
+    }
+    reader->pos = PORT_CAPTURE_HEADER_SIZE;
+    return true;
+}
+
+/**
+ * @brief Returns the next record.
+ *
+ * @return bool False at the end of the capture or on a truncated record.
+ */
+bool portCaptureReaderNext(PortCaptureReader_t* reader, PortCaptureRecord_t* record) {
+    if (reader->pos + PORT_CAPTURE_RECORD_HEADER_SIZE > reader->size) return false;
+
+    const uint8_t* p = &reader->buffer[reader->pos];
+    uint16_t length = getLe16(&p[5]);
+    if (reader->pos + PORT_CAPTURE_RECORD_HEADER_SIZE + length > reader->size) return false;
+
+    record->dir = p[0];
+    record->timestampMs = getLe32(&p[1]);
+    record->length = length;
+    record->data = &p[PORT_CAPTURE_RECORD_HEADER_SIZE];
+    reader->pos += PORT_CAPTURE_RECORD_HEADER_SIZE + length;
+    return true;
+}
+
+void portCaptureReaderRewind(PortCaptureReader_t* reader) {
+    reader->pos = PORT_CAPTURE_HEADER_SIZE;
+}
+
+void portCaptureReaderClose(PortCaptureReader_t* reader) {
+    free(reader->buffer);
+    memset(reader, 0, sizeof(*reader));
+}
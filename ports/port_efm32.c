@@ -138,3 +138,15 @@ void portDebugPrintf(const char *format, ...) {
         RETARGETWritechar(buffer[i]);
     }
 }
+
+/**
+ * @brief Writes raw debug text, used as the XBeeLogSetSink() sink.
+ *
+ * @param[in] text Characters to write; not NUL terminated.
+ * @param[in] len Number of characters.
+ */
+void portDebugWrite(const char *text, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        RETARGETWritechar(text[i]);
+    }
+}
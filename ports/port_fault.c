@@ -0,0 +1,249 @@
+/**
+ * @file port_fault.c
+ * @brief Fault-injection UART shim for parser robustness testing.
+ *
+ * This file implements the functions declared in port_fault.h. Bytes read
+ * from the inner HAL pass through a small frame tracker (so truncation knows
+ * where the current frame ends) and the per-byte fault roll, and the result
+ * is queued. Reads are served from the queue; a delay fault gates the queue
+ * at the delayed byte until the inner clock reaches the release time.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "port_fault.h"
+#include <string.h>
+
+// Each input byte produces at most two output bytes (garbage + byte, or a duplicate)
+#define FAULT_MAX_EXPANSION 2
+
+typedef enum {
+    TRACK_DELIMITER,
+    TRACK_LENGTH_MSB,
+    TRACK_LENGTH_LSB,
+    TRACK_BODY
+} FaultTrackState_t;
+
+static const XBeeHTable* innerHal;
+static PortFaultConfig_t config;
+static PortFaultStats_t stats;
+static uint32_t rngState;
+
+// Output queue; head and tail are free-running byte counts
+static uint8_t queue[PORT_FAULT_QUEUE_SIZE];
+static uint32_t queueHead;
+static uint32_t queueTail;
+
+// Pending delay fault: bytes from delayPos on are held until delayUntilMs
+static bool delayActive;
+static uint32_t delayPos;
+static uint32_t delayUntilMs;
+
+// Frame tracker over the uncorrupted stream
+static FaultTrackState_t trackState;
+static uint16_t trackLength;
+static uint32_t trackRemaining;     ///< Body and checksum bytes left in the current frame
+static uint32_t truncateRemaining;  ///< Bytes still to be dropped for the current truncation
+
+static uint32_t faultRandom(void) {
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static bool faultRoll(uint32_t ppm) {
+    return ppm != 0 && (faultRandom() % PORT_FAULT_PPM) < ppm;
+}
+
+static void faultCount(uint32_t* counter) {
+    (*counter)++;
+    stats.faults++;
+    stats.lastFaultMs = innerHal->PortMillis();
+}
+
+static void queuePut(uint8_t b) {
+    queue[queueHead % PORT_FAULT_QUEUE_SIZE] = b;
+    queueHead++;
+}
+
+/**
+ * @brief Advances the frame tracker and decides whether this byte falls in a truncated tail.
+ *
+ * @return bool True if the byte must be dropped.
+ */
+static bool faultTrack(uint8_t b) {
+    bool dropByte = truncateRemaining > 0;
+    if (dropByte) truncateRemaining--;
+
+    switch (trackState) {
+        case TRACK_DELIMITER:
+            if (b == 0x7E) {
+                stats.framesIn++;
+                trackState = TRACK_LENGTH_MSB;
+            }
+            break;
+        case TRACK_LENGTH_MSB:
+            trackLength = (uint16_t)(b << 8);
+            trackState = TRACK_LENGTH_LSB;
+            break;
+        case TRACK_LENGTH_LSB:
+            trackLength |= b;
+            trackRemaining = (uint32_t)trackLength + 1;
+            trackState = TRACK_BODY;
+            if (faultRoll(config.truncatePpm)) {
+                // Keep a random prefix of the body, drop the rest including the checksum
+                truncateRemaining = trackRemaining - (faultRandom() % trackRemaining);
+                faultCount(&stats.truncations);
+            }
+            break;
+        case TRACK_BODY:
+            if (--trackRemaining == 0) trackState = TRACK_DELIMITER;
+            break;
+    }
+    return dropByte;
+}
+
+/**
+ * @brief Applies at most one byte fault and queues the result.
+ */
+static void faultInject(uint8_t b) {
+    uint32_t r = faultRandom() % PORT_FAULT_PPM;
+    uint32_t threshold = config.bitFlipPpm;
+
+    if (r < threshold) {
+        queuePut(b ^ (uint8_t)(1u << (faultRandom() & 7)));
+        faultCount(&stats.bitFlips);
+        return;
+    }
+    if (r < (threshold += config.dropPpm)) {
+        faultCount(&stats.drops);
+        return;
+    }
+    if (r < (threshold += config.duplicatePpm)) {
+        queuePut(b);
+        queuePut(b);
+        faultCount(&stats.duplicates);
+        return;
+    }
+    if (r < (threshold += config.garbagePpm)) {
+        queuePut((uint8_t)faultRandom());
+        queuePut(b);
+        faultCount(&stats.garbage);
+        return;
+    }
+    if (r < (threshold += config.delayPpm) && !delayActive) {
+        delayActive = true;
+        delayPos = queueHead;
+        delayUntilMs = innerHal->PortMillis() + config.delayMs;
+        faultCount(&stats.delays);
+    }
+    queuePut(b);
+}
+
+/**
+ * @brief Starts injecting faults into the RX stream of the inner HAL.
+ *
+ * Resets the queue and statistics. May be called again to change rates.
+ *
+ * @param[in] inner HAL the shim forwards to; it must stay valid while the shim is used.
+ * @param[in] faultConfig Fault rates; copied.
+ */
+void portFaultStart(const XBeeHTable* inner, const PortFaultConfig_t* faultConfig) {
+    innerHal = inner;
+    config = *faultConfig;
+    memset(&stats, 0, sizeof(stats));
+    rngState = config.seed ? config.seed : 0x2545F491;
+    queueHead = 0;
+    queueTail = 0;
+    delayActive = false;
+    trackState = TRACK_DELIMITER;
+    truncateRemaining = 0;
+}
+
+/**
+ * @brief Copies the current fault counters.
+ */
+void portFaultGetStats(PortFaultStats_t* out) {
+    *out = stats;
+}
+
+/**
+ * @brief Reads from the inner HAL, corrupts the bytes and returns what is deliverable now.
+ */
+int portFaultUartRead(uint8_t* buffer, int length) {
+    uint8_t raw[PORT_FAULT_QUEUE_SIZE / FAULT_MAX_EXPANSION];
+    uint32_t room = (PORT_FAULT_QUEUE_SIZE - (queueHead - queueTail)) / FAULT_MAX_EXPANSION;
+    int want = length < (int)room ? length : (int)room;
+
+    if (want > 0) {
+        int n = innerHal->PortUartRead(raw, want);
+        for (int i = 0; i < n; i++) {
+            stats.bytesIn++;
+            if (faultTrack(raw[i])) continue;
+            faultInject(raw[i]);
+        }
+    }
+
+    if (delayActive && (int32_t)(innerHal->PortMillis() - delayUntilMs) >= 0) {
+        delayActive = false;
+    }
+
+    uint32_t limit = delayActive ? delayPos : queueHead;
+    int copied = 0;
+    while (copied < length && queueTail != limit) {
+        buffer[copied++] = queue[queueTail % PORT_FAULT_QUEUE_SIZE];
+        queueTail++;
+    }
+    stats.bytesOut += copied;
+    return copied;
+}
+
+int portFaultUartWrite(const uint8_t* buf, uint16_t len) {
+    return innerHal->PortUartWrite(buf, len);
+}
+
+uint32_t portFaultMillis(void) {
+    return innerHal->PortMillis();
+}
+
+/**
+ * @brief Discards queued bytes along with the inner HAL's RX buffer.
+ */
+void portFaultFlushRx(void) {
+    queueTail = queueHead;
+    delayActive = false;
+    innerHal->PortFlushRx();
+}
+
+int portFaultUartInit(uint32_t baudrate, void* device) {
+    return innerHal->PortUartInit(baudrate, device);
+}
+
+void portFaultDelay(uint32_t ms) {
+    innerHal->PortDelay(ms);
+}
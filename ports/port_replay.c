@@ -0,0 +1,186 @@
+/**
+ * @file port_replay.c
+ * @brief Replay HAL that plays a UART capture back through the library.
+ *
+ * This file implements the functions declared in port_replay.h. The capture
+ * is decoded once into a record table; a cursor walks it as the host reads
+ * and writes. Received data is timed relative to the end of the preceding
+ * host write (the "anchor"), so module response latencies are reproduced
+ * exactly even if the host spends a different amount of time between
+ * requests than it did when the capture was taken.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "port_replay.h"
+#include "port_capture.h"
+#include "port.h"
+#include <stdlib.h>
+#include <string.h>
+
+static PortCaptureReader_t replayReader;
+static PortCaptureRecord_t* records;
+static size_t recordCount;
+
+static size_t recordIndex;      ///< Record the cursor is in
+static uint16_t recordOffset;   ///< Bytes of that record already consumed
+static uint32_t nowMs;
+static uint32_t anchorMs;       ///< Virtual time the last recorded host write completed
+static uint32_t anchorTs;       ///< Capture timestamp of that write
+static uint32_t txMismatches;
+
+/**
+ * @brief Releases the decoded capture and resets the cursor.
+ */
+void portReplayClose(void) {
+    free(records);
+    records = NULL;
+    recordCount = 0;
+    portCaptureReaderClose(&replayReader);
+    recordIndex = 0;
+    recordOffset = 0;
+    nowMs = 0;
+    anchorMs = 0;
+    anchorTs = 0;
+    txMismatches = 0;
+}
+
+/**
+ * @brief Loads a capture file and rewinds the virtual clock to zero.
+ *
+ * @param[in] path Capture written by the port_capture shim.
+ *
+ * @return bool True if the capture was loaded.
+ */
+bool portReplayOpen(const char* path) {
+    PortCaptureRecord_t record;
+    size_t capacity = 0;
+
+    portReplayClose();
+    if (!portCaptureReaderOpen(&replayReader, path)) return false;
+
+    while (portCaptureReaderNext(&replayReader, &record)) {
+        if (recordCount == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            PortCaptureRecord_t* grown = (PortCaptureRecord_t*)realloc(records, capacity * sizeof(*records));
+            if (!grown) {
+                portReplayClose();
+                return false;
+            }
+            records = grown;
+        }
+        records[recordCount++] = record;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns true once every recorded byte has been read or written.
+ */
+bool portReplayDone(void) {
+    return recordIndex >= recordCount;
+}
+
+/**
+ * @brief Returns the number of written bytes that differ from, or go beyond, the recorded TX stream.
+ */
+uint32_t portReplayTxMismatches(void) {
+    return txMismatches;
+}
+
+static void replayAdvance(void) {
+    recordIndex++;
+    recordOffset = 0;
+}
+
+static bool replayRxDue(const PortCaptureRecord_t* record) {
+    uint32_t delay = (int32_t)(record->timestampMs - anchorTs) > 0 ? record->timestampMs - anchorTs : 0;
+    return (int32_t)(nowMs - (anchorMs + delay)) >= 0;
+}
+
+/**
+ * @brief Returns recorded module bytes that are due at the current virtual time.
+ *
+ * Nothing is returned while the next record is a host write that has not happened yet.
+ */
+int portReplayUartRead(uint8_t* buffer, int length) {
+    int n = 0;
+    while (n < length && recordIndex < recordCount) {
+        const PortCaptureRecord_t* record = &records[recordIndex];
+        if (record->dir != PORT_CAPTURE_DIR_RX || !replayRxDue(record)) break;
+
+        uint16_t left = record->length - recordOffset;
+        uint16_t chunk = (uint16_t)((length - n) < left ? (length - n) : left);
+        memcpy(buffer + n, record->data + recordOffset, chunk);
+        n += chunk;
+        recordOffset += chunk;
+        if (recordOffset == record->length) replayAdvance();
+    }
+    return n;
+}
+
+/**
+ * @brief Compares host writes with the recorded TX stream and moves the anchor.
+ *
+ * @return int Always len; the virtual UART never blocks or fails.
+ */
+int portReplayUartWrite(const uint8_t* buf, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        if (recordIndex >= recordCount || records[recordIndex].dir != PORT_CAPTURE_DIR_TX) {
+            txMismatches++;
+            continue;
+        }
+
+        const PortCaptureRecord_t* record = &records[recordIndex];
+        if (record->data[recordOffset] != buf[i]) txMismatches++;
+        if (++recordOffset == record->length) {
+            anchorMs = nowMs;
+            anchorTs = record->timestampMs;
+            replayAdvance();
+        }
+    }
+    return len;
+}
+
+uint32_t portReplayMillis(void) {
+    return nowMs;
+}
+
+/**
+ * @brief No-op: every byte in the capture was read by the host when it was recorded.
+ */
+void portReplayFlushRx(void) {
+}
+
+int portReplayUartInit(uint32_t baudrate, void* device) {
+    (void)baudrate;
+    (void)device;
+    return UART_SUCCESS;
+}
+
+void portReplayDelay(uint32_t ms) {
+    nowMs += ms;
+}
@@ -148,3 +148,13 @@ void portDebugPrintf(const char *format, ...) {
     va_end(args);
     printf("%s", buffer);  // Print the formatted buffer
 }
+
+/**
+ * @brief Writes raw debug text, used as the XBeeLogSetSink() sink.
+ *
+ * @param[in] text Characters to write; not NUL terminated.
+ * @param[in] len Number of characters.
+ */
+void portDebugWrite(const char *text, size_t len) {
+    fwrite(text, 1, len, stdout);
+}
@@ -143,3 +143,13 @@ void portDebugPrintf(const char *format, ...) {
    // Transmit the formatted string over the VCOM port
    CDC_Transmit_FS((uint8_t*)buffer, strlen(buffer));
 }
+
+/**
+ * @brief Writes raw debug text, used as the XBeeLogSetSink() sink.
+ *
+ * @param[in] text Characters to write; not NUL terminated.
+ * @param[in] len Number of characters.
+ */
+void portDebugWrite(const char *text, size_t len) {
+   CDC_Transmit_FS((uint8_t*)text, len);
+}
@@ -44,6 +44,11 @@
 #include <sys/ioctl.h>
 #include <stdarg.h>
 
+// XON/XOFF flow control; needs the module in API escaped mode (ATAP=2) so frames never contain them
+#ifndef PORT_UNIX_SOFT_FLOW_CONTROL
+#define PORT_UNIX_SOFT_FLOW_CONTROL 0
+#endif
+
 static int uartFd = -1;
 
 /**
@@ -80,6 +85,10 @@ int portUartInit(uint32_t baudrate, void *device) {
     options.c_cflag &= ~CSIZE;
     options.c_cflag |= CS8;
 
+#if PORT_UNIX_SOFT_FLOW_CONTROL
+    options.c_iflag |= IXON | IXOFF;
+#endif
+
     // Set non-blocking mode
     fcntl(uartFd, F_SETFL, FNDELAY);
 
@@ -198,4 +207,15 @@ void portDebugPrintf(const char *format, ...) {
     va_start(args, format);
     vprintf(format, args);  // Standard POSIX vprintf function
     va_end(args);
+}
+
+/**
+ * @brief Writes raw debug text, used as the XBeeLogSetSink() sink.
+ *
+ * @param[in] text Characters to write; not NUL terminated.
+ * @param[in] len Number of characters.
+ */
+void portDebugWrite(const char *text, size_t len) {
+    fwrite(text, 1, len, stdout);
+    fflush(stdout);
 }
\ No newline at end of file
@@ -0,0 +1,416 @@
+/**
+ * @file port_unix_metrics.c
+ * @brief Prometheus text-format exporter for Linux gateways.
+ *
+ * This file implements the instance registry, the text exposition format
+ * and a small HTTP/1.0 server thread listening on loopback TCP or a Unix
+ * domain socket. Every request, whatever its path, is answered with the
+ * current metrics.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "port_unix_metrics.h"
+#include "xbee_api_frames.h"
+#include <stddef.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define METRICS_POLL_MS 200             // How often the server checks for portUnixMetricsStop()
+#define METRICS_REQUEST_TIMEOUT_MS 1000
+#define METRICS_REQUEST_MAX 2048
+
+typedef struct {
+    XBee* self;
+    char name[PORT_UNIX_METRICS_NAME_MAX];
+} MetricsInstance_t;
+
+static MetricsInstance_t instances[PORT_UNIX_METRICS_MAX_INSTANCES];
+static pthread_mutex_t registryLock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_t serverThread;
+static int listenFd = -1;
+static volatile bool serverRunning;
+static char unixPath[sizeof(((struct sockaddr_un*)0)->sun_path)];
+
+// Names of the api_receive_status_t results, indexed by -status
+static const char* const rxResultNames[XBEE_STATS_RX_STATUS_COUNT] = {
+    "success",
+    "invalid_pointer",
+    "timeout_start_delimiter",
+    "invalid_start_delimiter",
+    "timeout_length",
+    "frame_too_large",
+    "timeout_data",
+    "timeout_checksum",
+    "invalid_checksum",
+    "uart_failure",
+    "frame_aborted",
+};
+
+/**
+ * @brief Registers an instance to be exported under the label instance="name".
+ *
+ * Unregister the instance before freeing it.
+ *
+ * @return bool False if the registry is full or a pointer is NULL.
+ */
+bool portUnixMetricsRegister(XBee* self, const char* name) {
+    bool added = false;
+    if (!self || !name) return false;
+
+    pthread_mutex_lock(&registryLock);
+    for (int i = 0; i < PORT_UNIX_METRICS_MAX_INSTANCES && !added; i++) {
+        if (!instances[i].self || instances[i].self == self) {
+            instances[i].self = self;
+            strncpy(instances[i].name, name, PORT_UNIX_METRICS_NAME_MAX - 1);
+            instances[i].name[PORT_UNIX_METRICS_NAME_MAX - 1] = '\0';
+            added = true;
+        }
+    }
+    pthread_mutex_unlock(&registryLock);
+    return added;
+}
+
+/**
+ * @brief Stops exporting an instance; returns once no scrape is reading it.
+ */
+void portUnixMetricsUnregister(XBee* self) {
+    pthread_mutex_lock(&registryLock);
+    for (int i = 0; i < PORT_UNIX_METRICS_MAX_INSTANCES; i++) {
+        if (instances[i].self == self) instances[i].self = NULL;
+    }
+    pthread_mutex_unlock(&registryLock);
+}
+
+/**
+ * @brief Writes a label value with quotes, backslashes and newlines escaped.
+ */
+static void writeLabel(FILE* out, const char* value) {
+    for (const char* p = value; *p; p++) {
+        if (*p == '"' || *p == '\\') fputc('\\', out);
+        if (*p == '\n') fputs("\\n", out);
+        else fputc(*p, out);
+    }
+}
+
+static void writeHeader(FILE* out, const char* metric, const char* type, const char* help) {
+    fprintf(out, "# HELP %s %s\n# TYPE %s %s\n", metric, help, metric, type);
+}
+
+/**
+ * @brief Writes one sample: metric{instance="name"[,extra]} value.
+ */
+static void writeSample(FILE* out, const char* metric, const char* name, const char* extra, double value) {
+    fprintf(out, "%s{instance=\"", metric);
+    writeLabel(out, name);
+    fprintf(out, "\"%s%s} %.17g\n", extra ? "," : "", extra ? extra : "", value);
+}
+
+/**
+ * @brief Writes one per-frame-type counter family, skipping types never seen.
+ */
+static void writePerType(FILE* out, const char* metric, const char* help,
+                         const XBeeStats_t* stats, const MetricsInstance_t* list, int count, size_t field) {
+    writeHeader(out, metric, "counter", help);
+    for (int i = 0; i < count; i++) {
+        const uint32_t* values = (const uint32_t*)((const uint8_t*)&stats[i] + field);
+        for (uint8_t slot = 0; slot < XBEE_STATS_FRAME_TYPE_SLOTS; slot++) {
+            if (!values[slot]) continue;
+            char label[24];
+            if (slot == 0) snprintf(label, sizeof(label), "type=\"other\"");
+            else snprintf(label, sizeof(label), "type=\"0x%02X\"", XBeeStatsSlotFrameType(slot));
+            writeSample(out, metric, list[i].name, label, values[slot]);
+        }
+    }
+}
+
+static void writeCounter(FILE* out, const char* metric, const char* help,
+                         const XBeeStats_t* stats, const MetricsInstance_t* list, int count, size_t field) {
+    writeHeader(out, metric, "counter", help);
+    for (int i = 0; i < count; i++) {
+        writeSample(out, metric, list[i].name, NULL, *(const uint32_t*)((const uint8_t*)&stats[i] + field));
+    }
+}
+
+/**
+ * @brief Writes a log2 millisecond histogram as cumulative buckets in seconds.
+ *
+ * Samples are whole milliseconds, so bucket k (values below 2^k ms) becomes
+ * le="2^k/1000" and the 0 ms bucket becomes le="0.001".
+ */
+static void writeHistogram(FILE* out, const char* metric, const char* help,
+                           const XBeeStats_t* stats, const MetricsInstance_t* list, int count, size_t field) {
+    char series[96];
+    writeHeader(out, metric, "histogram", help);
+    for (int i = 0; i < count; i++) {
+        const XBeeStatsHist_t* hist = (const XBeeStatsHist_t*)((const uint8_t*)&stats[i] + field);
+        uint32_t cumulative = 0;
+        snprintf(series, sizeof(series), "%s_bucket", metric);
+        for (uint8_t b = 0; b < XBEE_STATS_HIST_BUCKETS - 1; b++) {
+            char le[24];
+            cumulative += hist->buckets[b];
+            snprintf(le, sizeof(le), "le=\"%g\"", (b == 0 ? 1 : (double)(1UL << b)) / 1000.0);
+            writeSample(out, series, list[i].name, le, cumulative);
+        }
+        writeSample(out, series, list[i].name, "le=\"+Inf\"", hist->count);
+        snprintf(series, sizeof(series), "%s_sum", metric);
+        writeSample(out, series, list[i].name, NULL, (double)hist->sumMs / 1000.0);
+        snprintf(series, sizeof(series), "%s_count", metric);
+        writeSample(out, series, list[i].name, NULL, hist->count);
+    }
+}
+
+/**
+ * @brief Writes the metrics of every registered instance in Prometheus text format.
+ */
+void portUnixMetricsWrite(FILE* out) {
+    static XBeeStats_t stats[PORT_UNIX_METRICS_MAX_INSTANCES];
+    static MetricsInstance_t list[PORT_UNIX_METRICS_MAX_INSTANCES];
+    int count = 0;
+
+    // Snapshot under the registry lock so instances cannot be unregistered mid-copy;
+    // the lock is never taken by the threads driving the instances
+    pthread_mutex_lock(&registryLock);
+    for (int i = 0; i < PORT_UNIX_METRICS_MAX_INSTANCES; i++) {
+        if (instances[i].self && XBeeGetStats(instances[i].self, &stats[count])) {
+            list[count++] = instances[i];
+        }
+    }
+    pthread_mutex_unlock(&registryLock);
+
+#define FIELD(name) offsetof(XBeeStats_t, name)
+    writePerType(out, "xbee_tx_frames_total", "API frames sent, by frame type.", stats, list, count, FIELD(txFrames));
+    writePerType(out, "xbee_tx_bytes_total", "Bytes sent on the UART, including framing, by frame type.",
+                 stats, list, count, FIELD(txBytes));
+    writePerType(out, "xbee_rx_frames_total", "Valid API frames received, by frame type.", stats, list, count, FIELD(rxFrames));
+    writePerType(out, "xbee_rx_bytes_total", "Bytes received on the UART in valid frames, by frame type.",
+                 stats, list, count, FIELD(rxBytes));
+    writeCounter(out, "xbee_tx_errors_total", "UART write failures.", stats, list, count, FIELD(txErrors));
+
+    writeHeader(out, "xbee_rx_results_total", "counter", "Receive attempts that saw a start delimiter or failed, by result.");
+    for (int i = 0; i < count; i++) {
+        for (int r = 0; r < XBEE_STATS_RX_STATUS_COUNT; r++) {
+            char label[48];
+            if (!stats[i].rxStatus[r]) continue;
+            snprintf(label, sizeof(label), "result=\"%s\"", rxResultNames[r]);
+            writeSample(out, "xbee_rx_results_total", list[i].name, label, stats[i].rxStatus[r]);
+        }
+    }
+
+    writeCounter(out, "xbee_at_commands_total", "AT commands sent expecting a response.", stats, list, count, FIELD(atCommands));
+#if XBEE_STATS_AT_COMMANDS
+    writeHeader(out, "xbee_at_responses_total", "counter", "AT responses received, by command.");
+    for (int i = 0; i < count; i++) {
+        for (int c = 0; c < AT_COMMAND_COUNT; c++) {
+            char label[24];
+            if (!stats[i].atResponses[c]) continue;
+            snprintf(label, sizeof(label), "command=\"%s\"", atCommandToString((at_command_t)c));
+            writeSample(out, "xbee_at_responses_total", list[i].name, label, stats[i].atResponses[c]);
+        }
+    }
+#endif
+    writeCounter(out, "xbee_at_errors_total", "AT responses with an error status.", stats, list, count, FIELD(atErrors));
+    writeCounter(out, "xbee_at_timeouts_total", "AT commands that got no response.", stats, list, count, FIELD(atTimeouts));
+    writeCounter(out, "xbee_at_cache_hits_total", "AT reads answered from the cache.", stats, list, count, FIELD(atCacheHits));
+    writeCounter(out, "xbee_tx_status_timeouts_total", "Transmissions that never got a TX status.",
+                 stats, list, count, FIELD(txStatusTimeouts));
+    writeCounter(out, "xbee_link_samples_total", "RSSI readings recorded.", stats, list, count, FIELD(linkSamples));
+
+    writeHeader(out, "xbee_link_rssi_dbm", "gauge", "RSSI of the latest received packet or ATDB reading.");
+    for (int i = 0; i < count; i++) {
+        if (stats[i].linkSamples) writeSample(out, "xbee_link_rssi_dbm", list[i].name, NULL, stats[i].lastRssi);
+    }
+    writeHeader(out, "xbee_link_snr_db", "gauge", "SNR of the latest received packet that reported one.");
+    for (int i = 0; i < count; i++) {
+        if (stats[i].linkSamples) writeSample(out, "xbee_link_snr_db", list[i].name, NULL, stats[i].lastSnr);
+    }
+
+    writeHistogram(out, "xbee_at_round_trip_seconds", "AT command round-trip time.",
+                   stats, list, count, FIELD(atRoundTrip));
+    writeHistogram(out, "xbee_tx_status_latency_seconds", "Time from a transmit request to its TX status.",
+                   stats, list, count, FIELD(txStatusLatency));
+    writeHistogram(out, "xbee_process_loop_seconds", "Time spent in XBeeProcess().",
+                   stats, list, count, FIELD(processLoop));
+#undef FIELD
+}
+
+/**
+ * @brief Reads and discards one request, then sends the metrics.
+ */
+static void serveClient(int fd) {
+    struct timeval timeout = { METRICS_REQUEST_TIMEOUT_MS / 1000, (METRICS_REQUEST_TIMEOUT_MS % 1000) * 1000 };
+    char request[METRICS_REQUEST_MAX];
+    size_t received = 0;
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    while (received < sizeof(request) - 1) {
+        ssize_t n = recv(fd, request + received, sizeof(request) - 1 - received, 0);
+        if (n <= 0) return;
+        received += (size_t)n;
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) break;
+    }
+
+    char* body = NULL;
+    size_t bodyLen = 0;
+    FILE* out = open_memstream(&body, &bodyLen);
+    if (!out) return;
+    portUnixMetricsWrite(out);
+    fclose(out);
+
+    char header[160];
+    int headerLen = snprintf(header, sizeof(header),
+                             "HTTP/1.0 200 OK\r\n"
+                             "Content-Type: text/plain; version=0.0.4\r\n"
+                             "Content-Length: %zu\r\n"
+                             "Connection: close\r\n\r\n", bodyLen);
+    if (send(fd, header, (size_t)headerLen, MSG_NOSIGNAL) == headerLen) {
+        size_t sent = 0;
+        while (sent < bodyLen) {
+            ssize_t n = send(fd, body + sent, bodyLen - sent, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            sent += (size_t)n;
+        }
+    }
+    free(body);
+}
+
+static void* serverMain(void* arg) {
+    (void)arg;
+    while (serverRunning) {
+        struct pollfd pfd = { listenFd, POLLIN, 0 };
+        if (poll(&pfd, 1, METRICS_POLL_MS) <= 0) continue;
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) continue;
+        serveClient(fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Opens the listening socket for "unix:/path", "host:port" or "port".
+ *
+ * A bare port listens on 127.0.0.1 only.
+ */
+static int openListener(const char* address) {
+    int fd;
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un addr = { .sun_family = AF_UNIX };
+        if (strlen(address + 5) >= sizeof(addr.sun_path)) return -1;
+        strcpy(addr.sun_path, address + 5);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        unlink(addr.sun_path);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        strcpy(unixPath, addr.sun_path);
+    } else {
+        struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+        const char* colon = strrchr(address, ':');
+        const char* port = colon ? colon + 1 : address;
+        if (colon) {
+            char host[64];
+            size_t hostLen = (size_t)(colon - address);
+            if (hostLen >= sizeof(host)) return -1;
+            memcpy(host, address, hostLen);
+            host[hostLen] = '\0';
+            if (hostLen && inet_pton(AF_INET, host, &addr.sin_addr) != 1) return -1;
+        }
+        char* end;
+        long value = strtol(port, &end, 10);
+        if (*port == '\0' || *end != '\0' || value <= 0 || value > 65535) return -1;
+        addr.sin_port = htons((uint16_t)value);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        unixPath[0] = '\0';
+    }
+
+    if (listen(fd, 4) != 0) {
+        close(fd);
+        if (unixPath[0]) unlink(unixPath);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Starts serving metrics from a background thread.
+ *
+ * @param[in] address "unix:/run/xbee-metrics.sock", "127.0.0.1:9464" or just "9464" (loopback).
+ *
+ * @return bool False if the exporter is already running or the socket cannot be opened.
+ */
+bool portUnixMetricsStart(const char* address) {
+    if (serverRunning || !address) return false;
+
+    listenFd = openListener(address);
+    if (listenFd < 0) return false;
+
+    serverRunning = true;
+    if (pthread_create(&serverThread, NULL, serverMain, NULL) != 0) {
+        serverRunning = false;
+        close(listenFd);
+        listenFd = -1;
+        if (unixPath[0]) unlink(unixPath);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Stops the server thread and closes its socket; registrations are kept.
+ */
+void portUnixMetricsStop(void) {
+    if (!serverRunning) return;
+    serverRunning = false;
+    pthread_join(serverThread, NULL);
+    close(listenFd);
+    listenFd = -1;
+    if (unixPath[0]) unlink(unixPath);
+    unixPath[0] = '\0';
+}
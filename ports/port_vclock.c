@@ -0,0 +1,306 @@
+/**
+ * @file port_vclock.c
+ * @brief Virtual-clock platform abstraction layer for deterministic testing.
+ *
+ * This file implements the HAL functions declared in port_vclock.h. The clock
+ * starts at zero and only advances through portVClockDelay() and
+ * portVClockAdvance(). Scripted RX data is held as time-stamped chunks and
+ * released to portVClockUartRead() once due; host writes are captured and
+ * optionally passed to a hook that can script the module's reply.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "port_vclock.h"
+#include "port.h"
+#include "xbee_api_frames.h"
+#include <string.h>
+
+/**
+ * @brief A chunk of scripted RX data that becomes readable at dueMs.
+ */
+typedef struct {
+    uint32_t dueMs;
+    uint16_t offset;    ///< Start of the unread part within rxPool
+    uint16_t length;    ///< Unread bytes left in this chunk
+} VClockRxEvent_t;
+
+static uint32_t nowMs;
+static VClockRxEvent_t rxEvents[PORT_VCLOCK_MAX_RX_EVENTS];
+static uint8_t rxEventCount;
+static uint8_t rxPool[PORT_VCLOCK_RX_POOL_SIZE];
+static uint16_t rxPoolUsed;
+static uint8_t txBuffer[PORT_VCLOCK_TX_BUFFER_SIZE];
+static size_t txLength;
+static PortVClockWriteHook writeHook;
+static void* writeHookCtx;
+
+static bool vclockDue(uint32_t dueMs) {
+    return (int32_t)(nowMs - dueMs) >= 0;
+}
+
+/**
+ * @brief Drops the head RX event, reclaiming the pool once nothing is pending.
+ */
+static void vclockPopEvent(void) {
+    rxEventCount--;
+    memmove(&rxEvents[0], &rxEvents[1], rxEventCount * sizeof(VClockRxEvent_t));
+    if (rxEventCount == 0) rxPoolUsed = 0;
+}
+
+/**
+ * @brief Packs the unread parts of all pending events to the start of the pool.
+ */
+static void vclockCompact(void) {
+    static uint8_t scratch[PORT_VCLOCK_RX_POOL_SIZE];
+    uint16_t used = 0;
+    for (uint8_t i = 0; i < rxEventCount; i++) {
+        memcpy(&scratch[used], &rxPool[rxEvents[i].offset], rxEvents[i].length);
+        rxEvents[i].offset = used;
+        used += rxEvents[i].length;
+    }
+    memcpy(rxPool, scratch, used);
+    rxPoolUsed = used;
+}
+
+/**
+ * @brief Resets the clock to zero and clears all scripted and captured data.
+ */
+void portVClockReset(void) {
+    nowMs = 0;
+    rxEventCount = 0;
+    rxPoolUsed = 0;
+    txLength = 0;
+    writeHook = NULL;
+    writeHookCtx = NULL;
+}
+
+/**
+ * @brief Returns the current virtual time in milliseconds.
+ */
+uint32_t portVClockNow(void) {
+    return nowMs;
+}
+
+/**
+ * @brief Moves the virtual clock forward without going through the HAL.
+ */
+void portVClockAdvance(uint32_t ms) {
+    nowMs += ms;
+}
+
+/**
+ * @brief Scripts bytes the module will send, readable delayMs after the current time.
+ *
+ * Chunks with the same due time are delivered in the order they were scheduled.
+ *
+ * @param[in] delayMs Delay from now until the bytes become readable.
+ * @param[in] data Raw bytes as they appear on the UART.
+ * @param[in] len Number of bytes.
+ *
+ * @return bool True if scheduled, false if the event table or pool is full.
+ */
+bool portVClockScheduleRx(uint32_t delayMs, const uint8_t* data, uint16_t len) {
+    if (len > PORT_VCLOCK_RX_POOL_SIZE - rxPoolUsed) {
+        vclockCompact();
+    }
+    if (rxEventCount >= PORT_VCLOCK_MAX_RX_EVENTS || len > PORT_VCLOCK_RX_POOL_SIZE - rxPoolUsed) {
+        return false;
+    }
+
+    uint32_t dueMs = nowMs + delayMs;
+    uint8_t pos = rxEventCount;
+    while (pos > 0 && (int32_t)(rxEvents[pos - 1].dueMs - dueMs) > 0) {
+        rxEvents[pos] = rxEvents[pos - 1];
+        pos--;
+    }
+
+    memcpy(&rxPool[rxPoolUsed], data, len);
+    rxEvents[pos].dueMs = dueMs;
+    rxEvents[pos].offset = rxPoolUsed;
+    rxEvents[pos].length = len;
+    rxPoolUsed += len;
+    rxEventCount++;
+    return true;
+}
+
+/**
+ * @brief Scripts a complete API frame, adding delimiter, length and checksum.
+ *
+ * @param[in] delayMs Delay from now until the frame becomes readable.
+ * @param[in] frameData Frame data starting with the frame type byte.
+ * @param[in] len Length of frameData.
+ *
+ * @return bool True if scheduled.
+ */
+bool portVClockScheduleFrame(uint32_t delayMs, const uint8_t* frameData, uint16_t len) {
+    uint8_t frame[PORT_VCLOCK_RX_POOL_SIZE];
+    uint8_t sum = 0;
+
+    if ((size_t)len + 4 > sizeof(frame)) return false;
+
+    frame[0] = 0x7E;
+    frame[1] = len >> 8;
+    frame[2] = len & 0xFF;
+    for (uint16_t i = 0; i < len; i++) {
+        frame[3 + i] = frameData[i];
+        sum += frameData[i];
+    }
+    frame[3 + len] = 0xFF - sum;
+    return portVClockScheduleRx(delayMs, frame, len + 4);
+}
+
+/**
+ * @brief Scripts the module's answer to a local AT command frame.
+ *
+ * Meant to be called from a write hook with the bytes the host wrote. The
+ * response echoes the request's frame ID and command name.
+ *
+ * @param[in] delayMs Delay from now until the response becomes readable.
+ * @param[in] request Unescaped wire bytes of the request, starting at the delimiter.
+ * @param[in] len Length of request.
+ * @param[in] status Command status (0 = OK).
+ * @param[in] value Response value, or NULL when valueLength is 0.
+ * @param[in] valueLength Length of value.
+ *
+ * @return bool True if the request was an AT command frame and the response was scheduled.
+ */
+bool portVClockScheduleAtResponse(uint32_t delayMs, const uint8_t* request, uint16_t len,
+                                  uint8_t status, const uint8_t* value, uint16_t valueLength) {
+    uint8_t resp[PORT_VCLOCK_RX_POOL_SIZE - 4];
+
+    if (len < 8 || request[0] != 0x7E || request[3] != XBEE_API_TYPE_AT_COMMAND) return false;
+    if ((size_t)valueLength + 5 > sizeof(resp)) return false;
+
+    resp[0] = XBEE_API_TYPE_AT_RESPONSE;
+    resp[1] = request[4];
+    resp[2] = request[5];
+    resp[3] = request[6];
+    resp[4] = status;
+    if (valueLength) memcpy(&resp[5], value, valueLength);
+    return portVClockScheduleFrame(delayMs, resp, (uint16_t)(valueLength + 5));
+}
+
+/**
+ * @brief Returns the number of scripted bytes not yet read, due or not.
+ */
+size_t portVClockPendingRx(void) {
+    size_t total = 0;
+    for (uint8_t i = 0; i < rxEventCount; i++) total += rxEvents[i].length;
+    return total;
+}
+
+/**
+ * @brief Returns the bytes written by the host since the last reset or clear.
+ */
+const uint8_t* portVClockTxData(void) {
+    return txBuffer;
+}
+
+size_t portVClockTxLength(void) {
+    return txLength;
+}
+
+void portVClockTxClear(void) {
+    txLength = 0;
+}
+
+/**
+ * @brief Installs a hook called on every UART write (NULL to remove).
+ */
+void portVClockSetWriteHook(PortVClockWriteHook hook, void* ctx) {
+    writeHook = hook;
+    writeHookCtx = ctx;
+}
+
+/**
+ * @brief Reads scripted bytes that are due at the current virtual time.
+ *
+ * @return int Number of bytes copied, 0 if nothing is due yet.
+ */
+int portVClockUartRead(uint8_t* buffer, int length) {
+    int n = 0;
+    while (n < length && rxEventCount > 0 && vclockDue(rxEvents[0].dueMs)) {
+        VClockRxEvent_t* ev = &rxEvents[0];
+        uint16_t chunk = (uint16_t)((length - n) < ev->length ? (length - n) : ev->length);
+        memcpy(buffer + n, &rxPool[ev->offset], chunk);
+        n += chunk;
+        ev->offset += chunk;
+        ev->length -= chunk;
+        if (ev->length == 0) vclockPopEvent();
+    }
+    return n;
+}
+
+/**
+ * @brief Captures host writes and forwards them to the write hook.
+ *
+ * @return int Always len; the virtual UART never blocks or fails.
+ */
+int portVClockUartWrite(const uint8_t* buf, uint16_t len) {
+    size_t room = sizeof(txBuffer) - txLength;
+    size_t copy = len < room ? len : room;
+    memcpy(&txBuffer[txLength], buf, copy);
+    txLength += copy;
+
+    if (writeHook) writeHook(buf, len, writeHookCtx);
+    return len;
+}
+
+uint32_t portVClockMillis(void) {
+    return nowMs;
+}
+
+/**
+ * @brief Discards scripted bytes that have already arrived; future bytes are kept.
+ */
+void portVClockFlushRx(void) {
+    while (rxEventCount > 0 && vclockDue(rxEvents[0].dueMs)) {
+        vclockPopEvent();
+    }
+}
+
+int portVClockUartInit(uint32_t baudrate, void* device) {
+    (void)baudrate;
+    (void)device;
+    return UART_SUCCESS;
+}
+
+/**
+ * @brief Advances the virtual clock; any RX data that falls due becomes readable.
+ */
+void portVClockDelay(uint32_t ms) {
+    nowMs += ms;
+}
+
+const XBeeHTable portVClockHTable = {
+    .PortUartRead  = portVClockUartRead,
+    .PortUartWrite = portVClockUartWrite,
+    .PortMillis    = portVClockMillis,
+    .PortFlushRx   = portVClockFlushRx,
+    .PortUartInit  = portVClockUartInit,
+    .PortDelay     = portVClockDelay,
+};
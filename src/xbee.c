@@ -35,14 +35,15 @@
 
 #include "xbee.h"
 #include "xbee_api_frames.h" 
+#include <string.h>
 
 // Base class methods
 
 /**
  * @brief Initializes the XBee module.
  * 
- * This function initializes the XBee module by setting the initial frame ID counter 
- * and calling the XBee subclass specific initialization routine.
+ * This function initializes the XBee module by setting the initial frame ID counter,
+ * clearing the instance statistics and calling the XBee subclass specific initialization routine.
  * 
  * @param[in] self Pointer to the XBee instance.
  * @param[in] baudrate Baud rate for the serial communication.
@@ -52,6 +53,19 @@
  */
 bool XBeeInit(XBee* self, uint32_t baudRate, void* device) {
     self->frameIdCntr = 1;
+    self->baudRate = baudRate;
+    self->linkState = XBEE_LINK_UNKNOWN;
+    self->modemStatus = 0xFF;
+    self->apiMode = XBEE_API_MODE_DEFAULT;
+    self->framePoolTop = 0;
+    self->rxCarryLength = 0;
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+    xbeeTimeoutReset(&self->atTimeouts);
+#endif
+    XBEE_STATS_INIT(self);
+    XBEE_TRACE_RESET(self);
+    XBEE_SHADOW_RESET(self);
+    XBEE_CACHE_INIT(self);
     return self->vtable->init(self, baudRate, device);
 }
 
@@ -67,6 +81,7 @@ bool XBeeInit(XBee* self, uint32_t baudRate, void* device) {
  * @todo Add support for non-blocking connection attempts.
  */
 bool XBeeConnect(XBee* self, bool blocking) {
+    XBEE_CACHE_DROP(self, AT_FLAG_CACHE_STATUS);
     return self->vtable->connect(self, blocking);
 }
 
@@ -81,6 +96,7 @@ bool XBeeConnect(XBee* self, bool blocking) {
  * @return True if the disconnection is successful, otherwise false.
  */
 bool XBeeDisconnect(XBee* self) {
+    XBEE_CACHE_DROP(self, AT_FLAG_CACHE_STATUS);
     return self->vtable->disconnect(self);
 }
 
@@ -106,6 +122,9 @@ uint8_t XBeeSendPacket(XBee* self, const void* data) {
  * @return bool True if the command was sent successfully, otherwise false.
  */
 bool XBeeSoftReset(XBee* self){
+    XBEE_SHADOW_INVALIDATE(self);
+    XBEE_CACHE_RESET(self);
+    xbeeLinkStateSet(self, XBEE_LINK_DOWN);
     return apiSendAtCommand(self, AT_RE, NULL, 0) == API_SEND_SUCCESS;
 }
 
@@ -121,6 +140,9 @@ bool XBeeSoftReset(XBee* self){
  * @return void This function does not return a value.
  */
 void XBeeHardReset(XBee* self) {
+    XBEE_SHADOW_INVALIDATE(self);
+    XBEE_CACHE_RESET(self);
+    xbeeLinkStateSet(self, XBEE_LINK_DOWN);
     self->vtable->hardReset(self);
 }
 
@@ -130,29 +152,84 @@ void XBeeHardReset(XBee* self) {
  * This function invokes the `process` method defined in the XBee subclass's 
  * virtual table (vtable). It is responsible for processing any ongoing tasks 
  * or events related to the XBee module and must be called continuously in the 
- * application's main loop to ensure proper operation.
+ * application's main loop to ensure proper operation. The time spent in each call
+ * is recorded in the processLoop histogram when XBEE_STATS_ENABLED is set and
+ * as a trace span when XBEE_TRACE_ENABLED is set. Afterwards up to
+ * XBEE_LOG_DRAIN_BUDGET bytes of buffered log text are written to the log sink.
  * 
  * @param[in] self Pointer to the XBee instance.
  * 
  * @return void This function does not return a value.
  */
 void XBeeProcess(XBee* self) {
+    XBEE_TRACE_START(self, traceStart);
+#if XBEE_STATS_ENABLED
+    uint32_t startTime = self->htable->PortMillis();
     self->vtable->process(self);
+    XBEE_STATS_HIST(self, processLoop, self->htable->PortMillis() - startTime);
+#else
+    self->vtable->process(self);
+#endif
+    XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_PROCESS, 0);
+#if XBEE_LOG_DRAIN_BUDGET > 0
+    XBeeLogDrain(XBEE_LOG_DRAIN_BUDGET);
+#endif
 }
 
 /**
  * @brief Checks if the XBee module is connected to the network.
  * 
- * This function calls the `connected` method defined in the XBee subclass's 
- * virtual table (vtable) to determine if the XBee module is currently connected 
- * to the network. It returns true if the module is connected, otherwise false.
+ * The answer comes from the network state kept from modem status frames,
+ * so polling it costs no UART traffic. Only while nothing has been reported
+ * yet, e.g. right after XBeeInit() with a module that was already joined,
+ * does it call the `connected` method of the XBee subclass, which queries
+ * the module and records the result. Subclasses whose modules may never
+ * report a join set `linkPollMs`; while their link is down the module is
+ * asked again at most that often.
  * 
  * @param[in] self Pointer to the XBee instance.
  * 
  * @return bool Returns true if the XBee module is connected, otherwise false.
  */
 bool XBeeConnected(XBee* self) {
-    return self->vtable->connected(self);
+    if (self->linkState == XBEE_LINK_UNKNOWN) {
+        return self->vtable->connected(self);
+    }
+    if (self->linkState == XBEE_LINK_DOWN && self->linkPollMs &&
+        self->htable->PortMillis() - self->linkPolledMs >= self->linkPollMs) {
+        self->linkPolledMs = self->htable->PortMillis();
+        return self->vtable->connected(self);
+    }
+    return self->linkState == XBEE_LINK_UP;
+}
+
+/**
+ * @brief Records the network state and reports transitions to the application.
+ *
+ * OnConnectCallback runs when the link comes up, and OnDisconnectCallback
+ * when a link that was up goes down. Repeated reports of the same state
+ * are ignored.
+ *
+ * @param[in] self  Pointer to the XBee instance.
+ * @param[in] state The new xbee_link_state_t.
+ */
+void xbeeLinkStateSet(XBee* self, uint8_t state) {
+    uint8_t previous = self->linkState;
+
+    if (state == previous) return;
+    self->linkState = state;
+    if (state == XBEE_LINK_DOWN && self->htable) self->linkPolledMs = self->htable->PortMillis();
+    if (!self->ctable) return;
+
+    if (state == XBEE_LINK_UP && self->ctable->OnConnectCallback) {
+        XBEE_TRACE_START(self, traceStart);
+        self->ctable->OnConnectCallback(self);
+        XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_CONNECT);
+    } else if (previous == XBEE_LINK_UP && self->ctable->OnDisconnectCallback) {
+        XBEE_TRACE_START(self, traceStart);
+        self->ctable->OnDisconnectCallback(self);
+        XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_DISCONNECT);
+    }
 }
 
 /**
@@ -168,14 +245,7 @@ bool XBeeConnected(XBee* self) {
  * @return bool Returns true if the configuration was successfully written, otherwise false.
  */
 bool XBeeWriteConfig(XBee* self) {
-    uint8_t response[33];
-    uint8_t responseLength;
-    int status = apiSendAtCommandAndGetResponse(self, AT_WR, NULL, 0, response, &responseLength, 5000, sizeof(response));
-    if(status != API_SEND_SUCCESS){
-        XBEEDebugPrint("Failed to Write Config\n");
-        return false;
-    }
-    return true;
+    return XBeeAtExecute(self, AT_WR);
 }
 
 /**
@@ -191,14 +261,7 @@ bool XBeeWriteConfig(XBee* self) {
  */
 
 bool XBeeApplyChanges(XBee* self) {
-    uint8_t response[33];
-    uint8_t responseLength;
-    int status = apiSendAtCommandAndGetResponse(self, AT_AC, NULL, 0, response, &responseLength, 5000, sizeof(response));
-    if(status != API_SEND_SUCCESS){
-        XBEEDebugPrint("Failed to Apply Changes\n");
-        return false;
-    }
-    return true;
+    return XBeeAtExecute(self, AT_AC);
 }
 
 /**
@@ -216,14 +279,7 @@ bool XBeeApplyChanges(XBee* self) {
  * @return bool Returns true if the API Options was successfully set, otherwise false.
  */
 bool XBeeSetAPIOptions(XBee* self, const uint8_t value) {
-    uint8_t response[33];
-    uint8_t responseLength;
-    int status = apiSendAtCommandAndGetResponse(self, AT_AO, (const uint8_t[]){value}, 1, response, &responseLength, 5000, sizeof(response));
-    if(status != API_SEND_SUCCESS){
-        XBEEDebugPrint("Failed to set API Options\n");
-        return false;
-    }
-    return true;
+    return XBeeAtSet(self, AT_AO, value);
 }
 
 /**
@@ -241,10 +297,271 @@ bool XBeeConfigure(XBee* self, const void* config) {
     if (self->vtable->configure) {
         return self->vtable->configure(self, config);
     }
-    XBEEDebugPrint("Configure() not supported for this module.\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "Configure() not supported for this module.\n");
     return false;
 }
 
+/**
+ * @brief Looks up the metadata of an AT command and checks that it supports an access.
+ *
+ * @param[in] command The AT command enum value.
+ * @param[in] type    Expected parameter type, AT_TYPE_BYTES also accepts AT_TYPE_STRING.
+ * @param[in] denied  AT_FLAG_READ_ONLY for sets, AT_FLAG_WRITE_ONLY for gets.
+ *
+ * @return const at_command_info_t* The table entry, or NULL if the access is not allowed.
+ */
+static const at_command_info_t* atLookup(at_command_t command, uint8_t type, uint8_t denied) {
+    const at_command_info_t* info = atCommandInfo(command);
+
+    if (!info) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "No metadata for AT command %d\n", (int)command);
+        return NULL;
+    }
+    bool typeOk = info->type == type || (type == AT_TYPE_BYTES && info->type == AT_TYPE_STRING);
+    if (!typeOk || (info->flags & denied)) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "AT%s does not support this access\n", info->name);
+        return NULL;
+    }
+    return info;
+}
+
+/**
+ * @brief Returns the response timeout for an AT command on this instance.
+ *
+ * The timeout of the command's latency class, learned from earlier round
+ * trips when XBEE_AT_TIMEOUT_ADAPTIVE is set, plus the time `wireBytes`
+ * take at the instance's baud rate.
+ *
+ * @param[in] self      Pointer to the XBee instance.
+ * @param[in] command   The AT command to be sent.
+ * @param[in] wireBytes Bytes of the request and the largest expected response, framing included.
+ *
+ * @return uint32_t Timeout in milliseconds.
+ */
+uint32_t XBeeAtTimeout(XBee* self, at_command_t command, uint16_t wireBytes) {
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+    uint32_t timeout = xbeeTimeoutGet(&self->atTimeouts, atCommandLatency(command));
+#else
+    uint32_t timeout = atCommandTimeout(command);
+#endif
+    return timeout + xbeeWireTimeMs(self->baudRate, wireBytes);
+}
+
+/**
+ * @brief Sends an AT command and waits for its response using the instance's timeout for it.
+ *
+ * Every answer, OK or not, refines the timeout of the command's latency
+ * class; a timeout backs it off.
+ *
+ * @return bool True if the module answered with an OK status, otherwise false.
+ */
+static bool atTransact(XBee* self, at_command_t command, const uint8_t* param, uint8_t paramLength,
+                       uint8_t* response, uint8_t* responseLength, uint8_t responseSize) {
+    uint8_t length = 0;
+    uint16_t wireBytes = XBEE_AT_REQUEST_WIRE_BYTES + paramLength + XBEE_AT_RESPONSE_WIRE_BYTES + responseSize;
+    uint32_t startTime = self->htable->PortMillis();
+    int status = apiSendAtCommandAndGetResponse(self, command, param, paramLength, response, &length,
+                                                XBeeAtTimeout(self, command, wireBytes), responseSize);
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+    if (status == API_SEND_AT_CMD_RESONSE_TIMEOUT) {
+        xbeeTimeoutBackoff(&self->atTimeouts, atCommandLatency(command));
+    } else if (status == API_SEND_SUCCESS || status == API_SEND_AT_CMD_ERROR) {
+        uint32_t elapsed = self->htable->PortMillis() - startTime;
+        uint32_t wire = xbeeWireTimeMs(self->baudRate, XBEE_AT_REQUEST_WIRE_BYTES + paramLength +
+                                                       XBEE_AT_RESPONSE_WIRE_BYTES + length);
+        xbeeTimeoutSample(&self->atTimeouts, atCommandLatency(command), elapsed > wire ? elapsed - wire : 0);
+    }
+#else
+    (void)startTime;
+#endif
+    if (status != API_SEND_SUCCESS) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "AT%s failed, error code: %d\n", atCommandToString(command), status);
+        return false;
+    }
+    if (responseLength) *responseLength = length;
+    return true;
+}
+
+/**
+ * @brief True if a value of `length` bytes is valid for the command's metadata entry.
+ */
+static bool atLengthValid(const at_command_info_t* info, uint8_t length) {
+    if (!(info->flags & AT_FLAG_VARIABLE)) return length == info->width;
+    return info->type != AT_TYPE_UINT || length >= 1;
+}
+
+/**
+ * @brief Queries a parameter, answering from the instance cache when its metadata allows.
+ *
+ * Commands flagged AT_FLAG_CACHE_* are served from the cache while their
+ * value is fresh (xbee_cache.h). A read of a parameter whose query is still
+ * waiting further up the stack gets the last known value instead of
+ * sending a second query, and fails if there is none.
+ *
+ * @return bool True if a value of valid length was read, otherwise false.
+ */
+static bool atRead(XBee* self, const at_command_info_t* info, at_command_t command,
+                   uint8_t* response, uint8_t* responseLength, uint8_t responseSize) {
+    uint8_t length = 0;
+#if XBEE_CACHE_ENABLED
+    XBeeCacheEntry_t* entry = (info->flags & AT_FLAG_CACHE) ? xbeeCacheTrack(&self->cache, command, info->flags) : NULL;
+
+    if (entry) {
+        bool pending = entry->state & XBEE_CACHE_PENDING;
+        bool usable = pending ? entry->length != 0 : xbeeCacheFresh(entry, self->htable->PortMillis());
+        if (usable && entry->length <= responseSize) {
+            memcpy(response, entry->value, entry->length);
+            *responseLength = entry->length;
+            XBEE_STATS_INC(self, atCacheHits);
+            return true;
+        }
+        if (pending) return false;
+        entry->state = XBEE_CACHE_PENDING;
+    }
+#endif
+
+    bool ok = atTransact(self, command, NULL, 0, response, &length, responseSize);
+    if (ok && !atLengthValid(info, length)) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "AT%s returned %u bytes\n", info->name, (unsigned)length);
+        ok = false;
+    }
+
+#if XBEE_CACHE_ENABLED
+    if (entry) {
+        if (ok && !(entry->state & XBEE_CACHE_DROPPED)) {
+            xbeeCacheStore(entry, response, length, self->htable->PortMillis());
+        }
+        entry->state = 0;
+    }
+#endif
+    if (!ok) return false;
+    XBEE_SHADOW_STORE(self, command, response, length);
+    *responseLength = length;
+    return true;
+}
+
+/**
+ * @brief Sets an integer AT parameter.
+ *
+ * The value is checked against the command's range and sent big-endian in
+ * the width given by its metadata entry.
+ *
+ * @param[in] self    Pointer to the XBee instance.
+ * @param[in] command The AT command to set.
+ * @param[in] value   The value to set.
+ *
+ * @return bool True if the module accepted the value, otherwise false.
+ */
+bool XBeeAtSet(XBee* self, at_command_t command, uint32_t value) {
+    const at_command_info_t* info = atLookup(command, AT_TYPE_UINT, AT_FLAG_READ_ONLY);
+    uint8_t param[4];
+
+    if (!info) return false;
+    if (value < info->min || value > info->max) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "AT%s value %lu out of range\n", info->name, (unsigned long)value);
+        return false;
+    }
+    for (uint8_t i = 0; i < info->width; i++) {
+        param[i] = (uint8_t)(value >> (8 * (info->width - 1 - i)));
+    }
+    if (!atTransact(self, command, param, info->width, NULL, NULL, 0)) return false;
+    XBEE_SHADOW_STORE(self, command, param, info->width);
+    if (command == AT_AP) self->apiMode = (uint8_t)value;    // Applied as soon as it is accepted
+    return true;
+}
+
+/**
+ * @brief Reads an integer AT parameter.
+ *
+ * The big-endian response must be exactly the entry's width, or between one
+ * byte and the width for entries flagged AT_FLAG_VARIABLE.
+ * Parameters flagged AT_FLAG_CACHE_* may be answered from the instance
+ * cache without a round trip (xbee_cache.h).
+ *
+ * @param[in]  self    Pointer to the XBee instance.
+ * @param[in]  command The AT command to query.
+ * @param[out] value   Receives the decoded value.
+ *
+ * @return bool True if a valid value was read, otherwise false.
+ */
+bool XBeeAtGet(XBee* self, at_command_t command, uint32_t* value) {
+    const at_command_info_t* info = atLookup(command, AT_TYPE_UINT, AT_FLAG_WRITE_ONLY);
+    uint8_t response[4];
+    uint8_t length;
+
+    if (!info || !value) return false;
+    if (!atRead(self, info, command, response, &length, info->width)) return false;
+
+    uint32_t decoded = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        decoded = (decoded << 8) | response[i];
+    }
+    *value = decoded;
+    return true;
+}
+
+/**
+ * @brief Sets a byte array or string AT parameter.
+ *
+ * @param[in] self    Pointer to the XBee instance.
+ * @param[in] command The AT command to set.
+ * @param[in] data    The value to set.
+ * @param[in] length  Length of `data`; must equal the entry's width unless it is AT_FLAG_VARIABLE.
+ *
+ * @return bool True if the module accepted the value, otherwise false.
+ */
+bool XBeeAtSetBytes(XBee* self, at_command_t command, const uint8_t* data, uint8_t length) {
+    const at_command_info_t* info = atLookup(command, AT_TYPE_BYTES, AT_FLAG_READ_ONLY);
+
+    if (!info || (length && !data)) return false;
+    bool lengthOk = (info->flags & AT_FLAG_VARIABLE) ? length <= info->width : length == info->width;
+    if (!lengthOk) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid AT%s length %u\n", info->name, (unsigned)length);
+        return false;
+    }
+    if (!atTransact(self, command, data, length, NULL, NULL, 0)) return false;
+    XBEE_SHADOW_STORE(self, command, data, length);
+    return true;
+}
+
+/**
+ * @brief Reads a byte array or string AT parameter.
+ *
+ * Strings are returned as received, without a NUL terminator. Parameters
+ * flagged AT_FLAG_CACHE_* may be answered from the instance cache.
+ *
+ * @param[in]  self    Pointer to the XBee instance.
+ * @param[in]  command The AT command to query.
+ * @param[out] data    Buffer that receives the value.
+ * @param[out] length  Receives the number of bytes written to `data`.
+ * @param[in]  size    Size of `data`.
+ *
+ * @return bool True if a valid value was read, otherwise false.
+ */
+bool XBeeAtGetBytes(XBee* self, at_command_t command, uint8_t* data, uint8_t* length, uint8_t size) {
+    const at_command_info_t* info = atLookup(command, AT_TYPE_BYTES, AT_FLAG_WRITE_ONLY);
+    uint8_t received;
+
+    if (!info || !data || !length) return false;
+    if (!atRead(self, info, command, data, &received, size)) return false;
+
+    *length = received;
+    return true;
+}
+
+/**
+ * @brief Runs an AT command that takes no parameter, such as ATWR or ATAC.
+ *
+ * @param[in] self    Pointer to the XBee instance.
+ * @param[in] command The AT command to execute.
+ *
+ * @return bool True if the module answered with an OK status, otherwise false.
+ */
+bool XBeeAtExecute(XBee* self, at_command_t command) {
+    if (!atLookup(command, AT_TYPE_NONE, 0)) return false;
+    return atTransact(self, command, NULL, 0, NULL, NULL, 0);
+}
+
 /**
  * @brief Retrieves the firmware version of the XBee module using the ATVR command.
  * 
@@ -257,19 +574,7 @@ bool XBeeConfigure(XBee* self, const void* config) {
  * @return bool Returns true if the firmware version was retrieved successfully.
  */
 bool XBeeGetFirmwareVersion(XBee* self, uint32_t* version) {
-    if (!version) return false;
-
-    uint8_t response[4];
-    uint8_t responseLength = 0;
-    int status = apiSendAtCommandAndGetResponse(self, AT_VR, NULL, 0, response, &responseLength, 5000, sizeof(response));
-
-    if (status != API_SEND_SUCCESS || responseLength != 4) {
-        XBEEDebugPrint("Failed to retrieve firmware version (ATVR)\n");
-        return false;
-    }
-
-    *version = (response[0] << 24) | (response[1] << 16) | (response[2] << 8) | response[3];
-    return true;
+    return XBeeAtGet(self, AT_VR, version);
 }
 
 /**
@@ -283,6 +588,9 @@ bool XBeeGetFirmwareVersion(XBee* self, uint32_t* version) {
  */
 bool XBeeFactoryReset(XBee* self)
 {
+    XBEE_SHADOW_INVALIDATE(self);
+    XBEE_CACHE_RESET(self);
+    xbeeLinkStateSet(self, XBEE_LINK_DOWN);
     return apiSendAtCommand(self, AT_FR, NULL, 0) == API_SEND_SUCCESS;
 }
 
@@ -294,6 +602,9 @@ bool XBeeFactoryReset(XBee* self)
  * @return bool True if the command was sent successfully, otherwise false.
  */
 bool XBeeSoftRestart(XBee* self){
+    XBEE_SHADOW_INVALIDATE(self);
+    XBEE_CACHE_RESET(self);
+    xbeeLinkStateSet(self, XBEE_LINK_DOWN);
     return apiSendAtCommand(self, AT_RE, NULL, 0) == API_SEND_SUCCESS;
 }
 
@@ -313,13 +624,18 @@ bool XBeeExitCommandMode(XBee* self){
 /**
  * @brief Enables or disables API mode (ATAP).
  *
+ * The request and its response use the previous framing; unless the frame
+ * ID or checksum is a special byte they read the same in both. Once the
+ * module answers OK, frames sent and received use the new framing. If the
+ * module rejects the value or does not answer, the framing is unchanged.
+ *
  * @param[in] self  Pointer to the XBee instance.
  * @param[in] mode  0 = Transparent, 1 = API (no escape), 2 = API-escaped.
  *
- * @return bool True if the command was accepted, otherwise false.
+ * @return bool True if the module accepted the mode, otherwise false.
  */
 bool XBeeSetApiEnable(XBee* self, uint8_t mode){
-    return apiSendAtCommand(self, AT_AP, &mode, 1) == API_SEND_SUCCESS;
+    return XBeeAtSet(self, AT_AP, mode);
 }
 
 /**
@@ -345,19 +661,12 @@ bool XBeeSetBaudRate(XBee* self, uint8_t rateCode){
  * @return bool True if RSSI was read successfully, otherwise false.
  */
 bool XBeeGetLastRssi(XBee* self, int8_t* rssiOut){
-    if (!rssiOut) return false;
+    uint32_t resp;
 
-    uint8_t resp;
-    uint8_t len = 0;
-
-    if (apiSendAtCommandAndGetResponse(self, AT_DB, NULL, 0,
-                                       &resp, &len, 2000, sizeof(resp)) != API_SEND_SUCCESS || len != 1)
-    {
-        XBEEDebugPrint("Failed to read RSSI (ATDB)\n");
-        return false;
-    }
+    if (!rssiOut || !XBeeAtGet(self, AT_DB, &resp)) return false;
 
     *rssiOut = -(int8_t)resp;   /* Digi returns a positive offset */
+    XBEE_STATS_LINK(self, *rssiOut, self->stats.lastSnr);
     return true;
 }
 
@@ -370,19 +679,11 @@ bool XBeeGetLastRssi(XBee* self, int8_t* rssiOut){
  * @return bool True if the hardware version was retrieved, otherwise false.
  */
 bool XBeeGetHardwareVersion(XBee* self, uint16_t* hvOut){
-    if (!hvOut) return false;
+    uint32_t hv;
 
-    uint8_t resp[2];
-    uint8_t len = 0;
+    if (!hvOut || !XBeeAtGet(self, AT_HV, &hv)) return false;
 
-    if (apiSendAtCommandAndGetResponse(self, AT_HV, NULL, 0,
-                                       resp, &len, 2000, sizeof(resp)) != API_SEND_SUCCESS || len != 2)
-    {
-        XBEEDebugPrint("Failed to retrieve hardware version (ATHV)\n");
-        return false;
-    }
-
-    *hvOut = (uint16_t)resp[0] << 8 | resp[1];
+    *hvOut = (uint16_t)hv;
     return true;
 }
 
@@ -395,29 +696,10 @@ bool XBeeGetHardwareVersion(XBee* self, uint16_t* hvOut){
  * @return bool True if the serial number was retrieved, otherwise false.
  */
 bool XBeeGetSerialNumber(XBee* self, uint64_t* snOut){
-    if (!snOut) return false;
-
-    uint8_t hi[4], lo[4];
-    uint8_t lenHi = 0, lenLo = 0;
-
-    if (apiSendAtCommandAndGetResponse(self, AT_SH, NULL, 0,
-                                       hi, &lenHi, 2000, sizeof(hi)) != API_SEND_SUCCESS || lenHi != 4)
-    {
-        XBEEDebugPrint("Failed to retrieve serial high (ATSH)\n");
-        return false;
-    }
-
-    if (apiSendAtCommandAndGetResponse(self, AT_SL, NULL, 0,
-                                       lo, &lenLo, 2000, sizeof(lo)) != API_SEND_SUCCESS || lenLo != 4)
-    {
-        XBEEDebugPrint("Failed to retrieve serial low (ATSL)\n");
-        return false;
-    }
+    uint32_t hi, lo;
 
-    *snOut = ((uint64_t)hi[0] << 56) | ((uint64_t)hi[1] << 48) |
-             ((uint64_t)hi[2] << 40) | ((uint64_t)hi[3] << 32) |
-             ((uint64_t)lo[0] << 24) | ((uint64_t)lo[1] << 16) |
-             ((uint64_t)lo[2] <<  8) |  (uint64_t)lo[3];
+    if (!snOut || !XBeeAtGet(self, AT_SH, &hi) || !XBeeAtGet(self, AT_SL, &lo)) return false;
 
+    *snOut = ((uint64_t)hi << 32) | lo;
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,1426 @@
+/**
+ * @file xbee_3rf.c
+ * @brief Implementation of the XBee 3 RF (Zigbee, DigiMesh, 802.15.4) subclass.
+ *
+ * This file contains the implementation of functions specific to XBee 3 RF
+ * modules: addressed transmissions through the transmit window, matching of
+ * TX statuses to the frames they report on, and parsing of received packets.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#define XBEE_LOG_MODULE XBEE_LOG_MODULE_3RF
+#include "xbee_3rf.h"
+#include "xbee_api_frames.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if XBEE_3RF_TX_WINDOW < 1 || XBEE_3RF_TX_WINDOW > 254
+#error "XBEE_3RF_TX_WINDOW must leave frame IDs free for other frames"
+#endif
+
+#define TX_REQUEST_HEADER_SIZE 13   // Frame ID, 64/16-bit destination, radius and options
+#define RX_PACKET_HEADER_SIZE 12    // Frame type, 64/16-bit source and options
+#define RX_EXPLICIT_HEADER_SIZE 18  // As above plus endpoints, cluster and profile
+#define ND_RESPONSE_HEADER_SIZE 15  // AT response header, 16 and 64-bit address
+#define ROUTE_RECORD_HEADER_SIZE 13 // Frame type, 64/16-bit source, options and hop count
+#define SOURCE_ROUTE_HEADER_SIZE 13 // Frame ID, 64/16-bit destination, options and hop count
+#define REMOTE_AT_REQUEST_HEADER_SIZE 14    // Frame ID, 64/16-bit destination, options and command
+#define REMOTE_AT_RESPONSE_HEADER_SIZE 15   // Frame type, frame ID, 64/16-bit source, command and status
+
+#if XBEE_3RF_NODE_CACHE_SIZE < 1 || (XBEE_3RF_NODE_CACHE_SIZE & (XBEE_3RF_NODE_CACHE_SIZE - 1))
+#error "XBEE_3RF_NODE_CACHE_SIZE must be a power of two"
+#endif
+
+#define NODE_MASK (XBEE_3RF_NODE_CACHE_SIZE - 1)
+
+#if XBEE_3RF_ROUTE_MAX_HOPS < 1 || XBEE_3RF_ROUTE_MAX_HOPS >= XBEE_3RF_ROUTE_UNKNOWN
+#error "XBEE_3RF_ROUTE_MAX_HOPS must be between 1 and 254"
+#endif
+
+#if XBEE_3RF_IO_ENABLED
+#if XBEE_3RF_IO_RING_SIZE < 1 || XBEE_3RF_IO_RING_SIZE > 32768 || (XBEE_3RF_IO_RING_SIZE & (XBEE_3RF_IO_RING_SIZE - 1))
+#error "XBEE_3RF_IO_RING_SIZE must be a power of two up to 32768"
+#endif
+#define IO_RING_MASK (XBEE_3RF_IO_RING_SIZE - 1)
+#endif
+
+static void put64(uint8_t* out, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        out[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static uint64_t get64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero mask.
+ */
+static uint8_t lowestBit(uint16_t mask) {
+#if defined(__GNUC__)
+    return (uint8_t)__builtin_ctz(mask);
+#else
+    uint8_t bit = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Returns the number of set bits in `mask`.
+ */
+static uint8_t bitCount(uint8_t mask) {
+    uint8_t count = 0;
+    for (; mask; mask &= (uint8_t)(mask - 1)) count++;
+    return count;
+}
+
+// XBee3RF transmit window
+
+/**
+ * @brief Returns the window slot holding `frameId`, or NULL.
+ */
+static XBee3RFTxSlot_t* rfSlotFor(XBee3RF* rf, uint8_t frameId) {
+    for (uint8_t i = 0; i < XBEE_3RF_TX_WINDOW; i++) {
+        if (frameId && rf->txWindow[i].frameId == frameId) return &rf->txWindow[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns a free window slot, or NULL if the window is full.
+ */
+static XBee3RFTxSlot_t* rfFreeSlot(XBee3RF* rf) {
+    for (uint8_t i = 0; i < XBEE_3RF_TX_WINDOW; i++) {
+        if (!rf->txWindow[i].frameId) return &rf->txWindow[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns the number of frames to a destination still awaiting a status.
+ *
+ * Frames sent by 16-bit address (`address64` XBEE_3RF_ADDRESS64_UNKNOWN)
+ * are told apart by `address16`.
+ */
+static uint8_t rfPendingTo(XBee3RF* rf, uint64_t address64, uint16_t address16) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < XBEE_3RF_TX_WINDOW; i++) {
+        const XBee3RFTxSlot_t* slot = &rf->txWindow[i];
+        count += slot->frameId && !slot->done && slot->address64 == address64 &&
+                 (address64 != XBEE_3RF_ADDRESS64_UNKNOWN || slot->address16 == address16);
+    }
+    return count;
+}
+
+/**
+ * @brief Advances the frame ID counter past 0 and the IDs of frames in the window.
+ *
+ * A late status for a frame that is still in the window then never
+ * completes a newer frame that happens to reuse its ID.
+ */
+static uint8_t rfNextFrameId(XBee3RF* rf) {
+    XBee* self = &rf->base;
+    while (self->frameIdCntr == 0 || rfSlotFor(rf, self->frameIdCntr)) {
+        self->frameIdCntr++;
+    }
+    return self->frameIdCntr;
+}
+
+/**
+ * @brief Records the outcome of a frame and reports it through OnSendCallback.
+ *
+ * The slot is released here unless XBee3RFSendPacket() is waiting on it,
+ * in which case it reads the status and releases the slot itself.
+ */
+static void rfComplete(XBee* self, XBee3RFTxSlot_t* slot, XBee3RFPacket_t* packet) {
+    XBee3RF* rf = (XBee3RF*)self;
+
+    slot->status = packet->status;
+    slot->done = true;
+    rf->txInFlight--;
+    packet->address64 = slot->address64;
+    if (!slot->waited) slot->frameId = 0;
+
+    if (self->ctable->OnSendCallback) {
+        XBEE_TRACE_START(self, traceStart);
+        self->ctable->OnSendCallback(self, packet); // Pass the address of the stack variable
+        XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_SEND);
+    }
+}
+
+/**
+ * @brief Completes frames that got no TX status within XBEE_3RF_TX_STATUS_TIMEOUT_MS.
+ */
+static void rfExpire(XBee* self) {
+    XBee3RF* rf = (XBee3RF*)self;
+    uint32_t now = self->htable->PortMillis();
+
+    for (uint8_t i = 0; i < XBEE_3RF_TX_WINDOW && rf->txInFlight; i++) {
+        XBee3RFTxSlot_t* slot = &rf->txWindow[i];
+        if (!slot->frameId || slot->done || now - slot->sentAt < XBEE_3RF_TX_STATUS_TIMEOUT_MS) continue;
+
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "No TX status for frame 0x%02X\n", slot->frameId);
+        XBEE_STATS_INC(self, txStatusTimeouts);
+        XBee3RFPacket_t packet = {0};
+        packet.frameId = slot->frameId;
+        packet.address16 = XBEE_3RF_ADDRESS16_UNKNOWN;
+        packet.status = XBEE_3RF_DELIVERY_TIMEOUT;
+        rfComplete(self, slot, &packet);
+    }
+}
+
+// XBee3RF node cache
+
+/**
+ * @brief Returns the slot `address64` hashes to.
+ *
+ * Serials from one production run differ only in their low bits; the
+ * multiplication spreads those over the bits the mask keeps.
+ */
+static uint32_t nodeHome(uint64_t address64) {
+    return (uint32_t)((address64 * 0x9E3779B97F4A7C15ULL) >> 32) & NODE_MASK;
+}
+
+/**
+ * @brief Returns the index of the entry for `address64`, or -1.
+ */
+static int nodeIndex(XBee3RF* rf, uint64_t address64) {
+    uint32_t i = nodeHome(address64);
+    for (uint32_t probes = 0; probes < XBEE_3RF_NODE_CACHE_SIZE; probes++, i = (i + 1) & NODE_MASK) {
+        if (rf->nodes[i].address64 == address64) return (int)i;
+        if (!rf->nodes[i].address64) break;
+    }
+    return -1;
+}
+
+/**
+ * @brief Frees an entry and moves later entries of its probe run back into the gap.
+ *
+ * Lookups stop at the first free slot, so an entry that had probed past
+ * the freed one would otherwise no longer be found.
+ */
+static void nodeRemove(XBee3RF* rf, uint32_t gap) {
+    rf->nodes[gap].address64 = 0;
+    for (uint32_t i = (gap + 1) & NODE_MASK; rf->nodes[i].address64; i = (i + 1) & NODE_MASK) {
+        uint32_t home = nodeHome(rf->nodes[i].address64);
+        // The entry may move unless its home lies between the gap and itself
+        if (((i - home) & NODE_MASK) >= ((i - gap) & NODE_MASK)) {
+            rf->nodes[gap] = rf->nodes[i];
+            rf->nodes[i].address64 = 0;
+            gap = i;
+        }
+    }
+}
+
+/**
+ * @brief Returns the live entry for `address64`, dropping it if it has expired.
+ */
+static XBee3RFNode_t* nodeLookup(XBee* self, uint64_t address64) {
+    XBee3RF* rf = (XBee3RF*)self;
+
+    if (!address64) return NULL;
+    int i = nodeIndex(rf, address64);
+    if (i < 0) return NULL;
+    if (self->htable->PortMillis() - rf->nodes[i].updatedAt >= XBEE_3RF_NODE_TTL_MS) {
+        nodeRemove(rf, (uint32_t)i);
+        return NULL;
+    }
+    return &rf->nodes[i];
+}
+
+/**
+ * @brief Records the 16-bit address of `address64`, adding an entry if there is none.
+ *
+ * When the table is full the least recently refreshed entry gives up its
+ * slot. A full table has no free slot to end a probe, so the new entry is
+ * found wherever it lands.
+ *
+ * @return XBee3RFNode_t* The entry, or NULL for the coordinator, broadcast and unknown 64-bit addresses.
+ */
+static XBee3RFNode_t* nodeUpdate(XBee* self, uint64_t address64, uint16_t address16) {
+    XBee3RF* rf = (XBee3RF*)self;
+    uint32_t now = self->htable->PortMillis();
+    XBee3RFNode_t* node = NULL;
+    XBee3RFNode_t* oldest = NULL;
+
+    if (!address64 || address64 == XBEE_3RF_ADDRESS_BROADCAST || address64 == XBEE_3RF_ADDRESS64_UNKNOWN) return NULL;
+
+    uint32_t i = nodeHome(address64);
+    for (uint32_t probes = 0; probes < XBEE_3RF_NODE_CACHE_SIZE; probes++, i = (i + 1) & NODE_MASK) {
+        XBee3RFNode_t* entry = &rf->nodes[i];
+        if (entry->address64 == address64) {
+            node = entry;
+            break;
+        }
+        if (!entry->address64) {
+            node = entry;
+            break;
+        }
+        if (!oldest || now - entry->updatedAt > now - oldest->updatedAt) oldest = entry;
+    }
+    if (!node) node = oldest;
+    if (node->address64 != address64) {
+        node->nodeIdentifier[0] = '\0';
+        node->routeHops = XBEE_3RF_ROUTE_UNKNOWN;
+    }
+
+    node->address64 = address64;
+    node->address16 = address16;
+    node->updatedAt = now;
+    return node;
+}
+
+/**
+ * @brief Refreshes the entry of a node the module just reported a 16-bit address for.
+ *
+ * DigiMesh and 802.15.4 report XBEE_3RF_ADDRESS16_UNKNOWN, which teaches nothing.
+ */
+static void nodeRefresh(XBee* self, uint64_t address64, uint16_t address16) {
+    if (address16 != XBEE_3RF_ADDRESS16_UNKNOWN) {
+        nodeUpdate(self, address64, address16);
+    }
+}
+
+/**
+ * @brief Adds the node described by a Node Discover (ND) response.
+ *
+ * Zigbee and DigiMesh nodes answer with their 16-bit and 64-bit address
+ * and their null-terminated node identifier, followed by fields the cache
+ * does not keep.
+ *
+ * @return bool Returns true if the response named a node.
+ */
+static bool nodeFromDiscovery(XBee* self, const xbee_api_frame_t* frame) {
+    if (frame->length <= ND_RESPONSE_HEADER_SIZE) return false;
+
+    const uint8_t* ni = &frame->data[ND_RESPONSE_HEADER_SIZE];
+    const uint8_t* end = memchr(ni, '\0', frame->length - ND_RESPONSE_HEADER_SIZE);
+    if (!end) return false;
+
+    XBee3RFNode_t* node = nodeUpdate(self, get64(&frame->data[7]), (uint16_t)(frame->data[5] << 8 | frame->data[6]));
+    if (!node) return false;
+
+    size_t length = (size_t)(end - ni);
+    if (length >= sizeof(node->nodeIdentifier)) length = sizeof(node->nodeIdentifier) - 1;
+    memcpy(node->nodeIdentifier, ni, length);
+    node->nodeIdentifier[length] = '\0';
+    return true;
+}
+
+// XBee3RF specific implementations
+
+/**
+ * @brief Checks if the XBee 3 RF module has joined a network.
+ *
+ * This function queries the Association Indication (`AT_AI`). Zigbee modules
+ * report 0 once joined; DigiMesh and 802.15.4 modules report 0 once they are
+ * running. The answer is recorded as the network state read by XBeeConnected().
+ *
+ * @param[in] self Pointer to the XBee instance.
+ *
+ * @return bool Returns true if the module is associated, otherwise false.
+ */
+bool XBee3RFConnected(XBee* self) {
+    uint32_t association = 0;
+
+    // A failed query leaves the recorded state alone
+    if (!XBeeAtGet(self, AT_AI, &association)) return false;
+    xbeeLinkStateSet(self, association == 0 ? XBEE_LINK_UP : XBEE_LINK_DOWN);
+    return association == 0;
+}
+
+/**
+ * @brief Initializes the XBee 3 RF module for communication.
+ *
+ * This function initializes the serial communication with the module through
+ * the platform-specific UART initialization provided by the hardware
+ * abstraction layer.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] baudRate The baud rate for serial communication.
+ * @param[in] device The path to the serial device (e.g., "/dev/ttyUSB0").
+ *
+ * @return bool Returns true if the initialization is successful, otherwise false.
+ */
+bool XBee3RFInit(XBee* self, uint32_t baudRate, void* device) {
+    return (self->htable->PortUartInit(baudRate, device)) == UART_SUCCESS ? true:false;
+}
+
+/**
+ * @brief Processes incoming data and events for the XBee 3 RF module.
+ *
+ * This function must be called continuously in the main loop of the
+ * application. It receives and dispatches one API frame, then reports frames
+ * in the transmit window whose TX status is overdue.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ *
+ * @return void This function does not return a value.
+ */
+void XBee3RFProcess(XBee* self) {
+    xbee_api_frame_t frame;
+    int status = apiReceiveApiFrame(self,&frame);
+    if (status == API_RECEIVE_SUCCESS) {
+        apiHandleFrame(self,frame);
+    } else if (status != API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Error receiving frame.\n");
+    }
+    if (((XBee3RF*)self)->txInFlight) {
+        rfExpire(self);
+    }
+}
+
+/**
+ * @brief Waits for the XBee 3 RF module to join a network.
+ *
+ * XBee 3 RF modules join on their own, so in non-blocking mode this function
+ * returns immediately. In blocking mode it polls the association every 500 ms
+ * until the module is associated or XBEE_3RF_CONNECTION_TIMEOUT_MS elapses.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] blocking If true, waits until the module joins or the wait times out.
+ *
+ * @return bool Returns true if the module joined (in blocking mode) or always in
+ *         non-blocking mode, otherwise false.
+ */
+bool XBee3RFConnect(XBee* self, bool blocking) {
+    if (!blocking) {
+        return true;
+    }
+
+    uint32_t startTime = self->htable->PortMillis();
+    XBEE_TRACE_START(self, traceStart);
+
+    while ((self->htable->PortMillis() - startTime) < XBEE_3RF_CONNECTION_TIMEOUT_MS) {
+        if (XBee3RFConnected(self)) {
+            XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_JOIN, 0);
+            XBEEDebugPrint("Joined\n");
+            return true;
+        }
+        self->htable->PortDelay(500);
+    }
+    XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_JOIN, 0);
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to Join\n");
+    return false;
+}
+
+/**
+ * @brief Disconnects from the network.
+ *
+ * The module stays associated; there is nothing to tear down on the host.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ *
+ * @return bool Returns true.
+ */
+bool XBee3RFDisconnect(XBee* self) {
+    (void) self;
+    return true;
+}
+
+/**
+ * @brief Hands the module the cached route to a node ahead of a unicast to it.
+ *
+ * The Create Source Route frame (0x21) gets no response. The module keeps
+ * few source routes, so the route goes out before every unicast rather
+ * than once per route record.
+ */
+static bool rfSendSourceRoute(XBee* self, const XBee3RFNode_t* node) {
+    uint8_t frame_data[SOURCE_ROUTE_HEADER_SIZE + 2 * XBEE_3RF_ROUTE_MAX_HOPS];
+    uint16_t length = SOURCE_ROUTE_HEADER_SIZE;
+
+    frame_data[0] = 0;  // No response
+    put64(&frame_data[1], node->address64);
+    frame_data[9] = (uint8_t)(node->address16 >> 8);
+    frame_data[10] = (uint8_t)node->address16;
+    frame_data[11] = 0; // Route options
+    frame_data[12] = node->routeHops;
+    for (uint8_t i = 0; i < node->routeHops; i++) {
+        frame_data[length++] = (uint8_t)(node->route[i] >> 8);
+        frame_data[length++] = (uint8_t)node->route[i];
+    }
+    return apiSendFrame(self, XBEE_API_TYPE_3RF_CREATE_SOURCE_ROUTE, frame_data, length) == API_SEND_SUCCESS;
+}
+
+/**
+ * @brief Applies what the node cache knows about a destination to a unicast about to be written.
+ *
+ * An XBEE_3RF_ADDRESS16_UNKNOWN `address16` is replaced by the cached
+ * 16-bit address, and a cached route is sent ahead of the frame.
+ *
+ * @return bool Returns false if the route could not be written.
+ */
+static bool rfPrepareUnicast(XBee* self, uint64_t address64, uint16_t* address16) {
+    const XBee3RFNode_t* node = nodeLookup(self, address64);
+
+    if (!node) return true;
+    if (*address16 == XBEE_3RF_ADDRESS16_UNKNOWN) {
+        *address16 = node->address16;
+    }
+    return node->routeHops == XBEE_3RF_ROUTE_UNKNOWN || rfSendSourceRoute(self, node);
+}
+
+/**
+ * @brief Sends a packet without waiting for its TX status.
+ *
+ * The frame is written as a TX Request (0x10) to `packet->address64`, or
+ * `packet->address16` when the 64-bit address is XBEE_3RF_ADDRESS64_UNKNOWN, with
+ * the transmit options in `packet->options`. An XBEE_3RF_ADDRESS16_UNKNOWN
+ * 16-bit address is replaced by the one in the node cache, if any, and a
+ * route cached from the node's route record is sent ahead of the frame
+ * (see XBee3RFHandleRouteRecord()). The frame then waits in the transmit window until its status arrives, which
+ * is reported through OnSendCallback with `frameId` and `address64`
+ * identifying the frame.
+ *
+ * Only when the window is full, or XBEE_3RF_TX_WINDOW_PER_DEST frames to the
+ * same destination are still awaiting a status, does this function process
+ * incoming frames until a status frees a place. Frames that get no status
+ * are completed with XBEE_3RF_DELIVERY_TIMEOUT after
+ * XBEE_3RF_TX_STATUS_TIMEOUT_MS, so that wait is bounded.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in,out] packet The packet to send; receives the frame ID used.
+ *
+ * @return bool Returns true if the frame was written, otherwise false.
+ */
+bool XBee3RFSendPacketAsync(XBee* self, XBee3RFPacket_t* packet) {
+    XBee3RF* rf = (XBee3RF*)self;
+    uint8_t frame_data[XBEE_3RF_TX_FRAME_SIZE];
+
+    if (packet->payloadSize > sizeof(frame_data) - TX_REQUEST_HEADER_SIZE) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Payload of %u bytes exceeds XBEE_3RF_TX_FRAME_SIZE.\n", packet->payloadSize);
+        return false;
+    }
+
+    // Wait for a place in the window
+    XBee3RFTxSlot_t* slot = rfFreeSlot(rf);
+    if (!slot || rfPendingTo(rf, packet->address64, packet->address16) >= XBEE_3RF_TX_WINDOW_PER_DEST) {
+        XBEE_TRACE_START(self, traceStart);
+        do {
+            XBee3RFProcess(self);
+            slot = rfFreeSlot(rf);
+        } while (!slot || rfPendingTo(rf, packet->address64, packet->address16) >= XBEE_3RF_TX_WINDOW_PER_DEST);
+        XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_TX_STATUS, 0);
+    }
+
+    // A cached 16-bit address and route spare the module an address and a route discovery
+    uint16_t address16 = packet->address16;
+    if (!rfPrepareUnicast(self, packet->address64, &address16)) {
+        return false;
+    }
+
+    packet->frameId = rfNextFrameId(rf);
+    frame_data[0] = packet->frameId;
+    put64(&frame_data[1], packet->address64);
+    frame_data[9] = (uint8_t)(address16 >> 8);
+    frame_data[10] = (uint8_t)address16;
+    frame_data[11] = packet->radius;
+    frame_data[12] = packet->options;
+    memcpy(&frame_data[TX_REQUEST_HEADER_SIZE], packet->payload, packet->payloadSize);
+
+    int send_status = apiSendFrame(self, XBEE_API_TYPE_TX_REQUEST, frame_data, TX_REQUEST_HEADER_SIZE + packet->payloadSize);
+    if (send_status != API_SEND_SUCCESS) {
+        return false;
+    }
+
+    slot->address64 = packet->address64;
+    slot->address16 = packet->address16;
+    slot->sentAt = self->htable->PortMillis();
+    slot->frameId = packet->frameId;
+    slot->status = 0;
+    slot->done = false;
+    slot->waited = false;
+    rf->txInFlight++;
+    return true;
+}
+
+/**
+ * @brief Sends a packet and waits for its TX status.
+ *
+ * This function sends through XBee3RFSendPacketAsync() and then processes
+ * incoming frames until the status of its own frame arrives. Statuses of
+ * other frames in the window are reported through OnSendCallback meanwhile.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] data Pointer to the data to be sent, encapsulated in an XBee3RFPacket_t structure.
+ *
+ * @return uint8_t The delivery status, 0 if successful, XBEE_3RF_DELIVERY_TIMEOUT
+ *         if the frame could not be sent or got no status.
+ */
+uint8_t XBee3RFSendPacket(XBee* self, const void* data) {
+    XBee3RF* rf = (XBee3RF*)self;
+    XBee3RFPacket_t* packet = (XBee3RFPacket_t*) data;
+
+    if (!XBee3RFSendPacketAsync(self, packet)) {
+        return XBEE_3RF_DELIVERY_TIMEOUT;
+    }
+
+    XBee3RFTxSlot_t* slot = rfSlotFor(rf, packet->frameId);
+    slot->waited = true;
+    XBEE_TRACE_START(self, traceStart);
+    while (!slot->done) {
+        XBee3RFProcess(self);
+    }
+    XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_TX_STATUS, packet->frameId);
+
+    packet->status = slot->status;
+    slot->frameId = 0;
+    if (packet->status) {
+        XBEEDebugPrint("TX Delivery Status 0x%02X\n", packet->status);
+    }
+    return packet->status;
+}
+
+/**
+ * @brief Processes incoming frames until every frame in the transmit window has its status.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ */
+void XBee3RFFlush(XBee* self) {
+    while (((XBee3RF*)self)->txInFlight) {
+        XBee3RFProcess(self);
+    }
+}
+
+/**
+ * @brief Returns the number of frames in the transmit window awaiting a status.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ *
+ * @return uint8_t Frames sent and not yet completed.
+ */
+uint8_t XBee3RFInFlight(XBee* self) {
+    return ((XBee3RF*)self)->txInFlight;
+}
+
+bool XBee3RFSoftReset(XBee* self) {
+    (void) self;
+    return true;
+}
+
+void XBee3RFHardReset(XBee* self) {
+    (void) self;
+}
+
+/* XBee3RF Specific Functions */
+
+/**
+ * @brief Reads the module's 64-bit address from `AT_SH` and `AT_SL`.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[out] address64 Receives the address.
+ *
+ * @return bool Returns true if both halves were read, otherwise false.
+ */
+bool XBee3RFGetAddress64(XBee* self, uint64_t* address64) {
+    uint32_t high, low;
+
+    if (!XBeeAtGet(self, AT_SH, &high) || !XBeeAtGet(self, AT_SL, &low)) {
+        return false;
+    }
+    *address64 = (uint64_t)high << 32 | low;
+    return true;
+}
+
+/**
+ * @brief Sends the AT_NI command to set the Node Identifier.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] value Up to 20 printable characters.
+ *
+ * @return bool Returns true if the Node Identifier was successfully set, otherwise false.
+ */
+bool XBee3RFSetNodeIdentifier(XBee* self, const char* value) {
+    if (!value || strlen(value) > 20) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid Node Identifier\n");
+        return false;
+    }
+    return XBeeAtSetBytes(self, AT_NI, (const uint8_t*)value, (uint8_t)strlen(value));
+}
+
+/**
+ * @brief Discovers the nodes on the network into the node cache.
+ *
+ * This function sends a Node Discover (`AT_ND`) and, for the module's node
+ * discovery time (`AT_LD`) plus XBEE_3RF_DISCOVERY_GUARD_MS, adds each
+ * node that answers to the node cache as its response arrives. A DigiMesh
+ * module's empty closing response ends the wait early. Other frames
+ * received meanwhile are handled as usual. `AT_NO` selects which nodes
+ * answer and what they append; the appended fields are not kept.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[out] found If not NULL, receives the number of nodes that answered.
+ *
+ * @return bool Returns true if the discovery ran to completion, otherwise false.
+ */
+bool XBee3RFDiscoverNodes(XBee* self, uint16_t* found) {
+    XBee3RF* rf = (XBee3RF*)self;
+    uint32_t discoveryTime;
+    uint16_t count = 0;
+
+    if (found) *found = 0;
+    if (!XBeeAtGet(self, AT_LD, &discoveryTime)) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Unable to read the node discovery time\n");
+        return false;
+    }
+    uint32_t timeoutMs = discoveryTime * 100 + XBEE_3RF_DISCOVERY_GUARD_MS;
+
+    uint8_t frameId = self->frameIdCntr;
+    if (apiSendAtCommand(self, AT_ND, NULL, 0) != API_SEND_SUCCESS) {
+        return false;
+    }
+
+    uint32_t startTime = self->htable->PortMillis();
+    while ((self->htable->PortMillis() - startTime) < timeoutMs) {
+        xbee_api_frame_t frame;
+        if (apiReceiveApiFrame(self, &frame) == API_RECEIVE_SUCCESS) {
+            if (frame.type != XBEE_API_TYPE_AT_RESPONSE || frame.length < 5 || frame.data[1] != frameId ||
+                frame.data[2] != 'N' || frame.data[3] != 'D') {
+                apiHandleFrame(self, frame);
+            } else if (frame.data[4] != 0) {
+                XBEE_LOG_WARN(XBEE_LOG_MODULE, "Node discovery failed\n");
+                return false;
+            } else if (frame.length == 5) {
+                break;
+            } else if (nodeFromDiscovery(self, &frame)) {
+                count++;
+                if (found) *found = count;
+            }
+        }
+        if (rf->txInFlight) {
+            rfExpire(self);
+        }
+    }
+    XBEEDebugPrint("Discovered %u nodes\n", count);
+    return true;
+}
+
+/**
+ * @brief Returns the node cache entry for a 64-bit address.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] address64 The node's 64-bit address.
+ *
+ * @return const XBee3RFNode_t* The entry, or NULL if the node is not cached or its entry expired.
+ */
+const XBee3RFNode_t* XBee3RFNodeLookup(XBee* self, uint64_t address64) {
+    return nodeLookup(self, address64);
+}
+
+/**
+ * @brief Returns the node cache entry for a node identifier.
+ *
+ * Node identifiers are only learned through XBee3RFDiscoverNodes(). Unlike
+ * XBee3RFNodeLookup() this searches the whole table.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] nodeIdentifier The node identifier (`AT_NI`) to find.
+ *
+ * @return const XBee3RFNode_t* The entry, or NULL if no live entry has that identifier.
+ */
+const XBee3RFNode_t* XBee3RFNodeFind(XBee* self, const char* nodeIdentifier) {
+    XBee3RF* rf = (XBee3RF*)self;
+    uint32_t now = self->htable->PortMillis();
+
+    if (!nodeIdentifier || !nodeIdentifier[0]) return NULL;
+    for (uint32_t i = 0; i < XBEE_3RF_NODE_CACHE_SIZE; i++) {
+        const XBee3RFNode_t* node = &rf->nodes[i];
+        if (node->address64 && now - node->updatedAt < XBEE_3RF_NODE_TTL_MS &&
+            strcmp(node->nodeIdentifier, nodeIdentifier) == 0) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Empties the node cache, e.g. after the module joined another network.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ */
+void XBee3RFNodeCacheClear(XBee* self) {
+    memset(((XBee3RF*)self)->nodes, 0, sizeof(((XBee3RF*)self)->nodes));
+}
+
+/**
+ * @brief A remote AT command awaiting its response.
+ */
+typedef struct {
+    uint16_t index;             ///< Into the caller's results
+    uint32_t sentAt;
+    uint8_t frameId;
+} RemoteAtRequest_t;
+
+/**
+ * @brief Writes a Remote AT Command Request (0x17) for one node.
+ *
+ * The frame ID is chosen past the frames in the transmit window and the
+ * remote commands already awaiting a response.
+ */
+static bool rfSendRemoteAt(XBee* self, const char* command, const uint8_t* parameter, uint8_t paramLength,
+                           uint8_t options, uint64_t address64, const RemoteAtRequest_t* inFlight, uint8_t active,
+                           uint8_t* frameId) {
+    uint8_t frame_data[REMOTE_AT_REQUEST_HEADER_SIZE + XBEE_AT_PARAM_MAX_SIZE];
+    uint16_t address16 = XBEE_3RF_ADDRESS16_UNKNOWN;
+
+    if (!rfPrepareUnicast(self, address64, &address16)) return false;
+
+    bool taken;
+    do {
+        *frameId = rfNextFrameId((XBee3RF*)self);
+        taken = false;
+        for (uint8_t i = 0; i < active; i++) {
+            taken |= inFlight[i].frameId == *frameId;
+        }
+        if (taken) self->frameIdCntr++;
+    } while (taken);
+
+    frame_data[0] = *frameId;
+    put64(&frame_data[1], address64);
+    frame_data[9] = (uint8_t)(address16 >> 8);
+    frame_data[10] = (uint8_t)address16;
+    frame_data[11] = options;
+    frame_data[12] = (uint8_t)command[0];
+    frame_data[13] = (uint8_t)command[1];
+    if (paramLength) {
+        memcpy(&frame_data[REMOTE_AT_REQUEST_HEADER_SIZE], parameter, paramLength);
+    }
+    return apiSendFrame(self, XBEE_API_TYPE_3RF_REMOTE_AT_COMMAND, frame_data,
+                        REMOTE_AT_REQUEST_HEADER_SIZE + paramLength) == API_SEND_SUCCESS;
+}
+
+/**
+ * @brief Runs an AT command on many nodes at once.
+ *
+ * The command, with `parameter` to set a value or without to query one,
+ * goes to every node in `results` as a Remote AT Command Request (0x17).
+ * Up to XBEE_3RF_REMOTE_AT_WINDOW requests await a response at once; each
+ * response (0x97) is matched to its request by frame ID and source
+ * address, and other frames received meanwhile are handled as usual.
+ *
+ * Nodes that did not answer within XBEE_3RF_REMOTE_AT_TIMEOUT_MS, or could
+ * not be reached, are tried again once every node has had its turn, up to
+ * XBEE_3RF_REMOTE_AT_ATTEMPTS times in all. A node answering with an error
+ * is not retried. Requests use the node cache like XBee3RFSendPacketAsync().
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] command The AT command to run.
+ * @param[in] parameter The value to set, or NULL to query.
+ * @param[in] paramLength Bytes in `parameter`, at most XBEE_AT_PARAM_MAX_SIZE.
+ * @param[in] options XBEE_3RF_REMOTE_AT_APPLY to apply a change right away, otherwise 0.
+ * @param[in,out] results One per node, `address64` set; receive each node's status and value.
+ * @param[in] count Number of entries in `results`.
+ *
+ * @return uint16_t The number of nodes that answered XBEE_3RF_REMOTE_AT_OK.
+ */
+uint16_t XBee3RFRemoteAtCommand(XBee* self, at_command_t command, const uint8_t* parameter, uint8_t paramLength,
+                                uint8_t options, XBee3RFRemoteAtResult_t* results, uint16_t count) {
+    XBee3RF* rf = (XBee3RF*)self;
+    RemoteAtRequest_t inFlight[XBEE_3RF_REMOTE_AT_WINDOW];
+    uint8_t active = 0;
+    uint16_t succeeded = 0;
+
+    const char* cmdStr = atCommandToString(command);
+    if (!cmdStr || paramLength > XBEE_AT_PARAM_MAX_SIZE || (paramLength && !parameter) || (count && !results)) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid remote AT command\n");
+        return 0;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        results[i].status = XBEE_3RF_REMOTE_AT_TIMEOUT;
+        results[i].attempts = 0;
+        results[i].length = 0;
+    }
+
+    // Each round sends to the nodes still without an answer
+    for (uint8_t attempt = 1; attempt <= XBEE_3RF_REMOTE_AT_ATTEMPTS; attempt++) {
+        uint16_t next = 0;
+
+        while (next < count || active) {
+            while (next < count && active < XBEE_3RF_REMOTE_AT_WINDOW) {
+                XBee3RFRemoteAtResult_t* result = &results[next];
+                RemoteAtRequest_t* request = &inFlight[active];
+                request->index = next++;
+                if (result->status != XBEE_3RF_REMOTE_AT_TIMEOUT && result->status != XBEE_3RF_REMOTE_AT_TX_FAILURE) {
+                    continue;
+                }
+
+                result->attempts++;
+                XBEE_STATS_INC(self, atCommands);
+                if (!rfSendRemoteAt(self, cmdStr, parameter, paramLength, options, result->address64,
+                                    inFlight, active, &request->frameId)) {
+                    result->status = XBEE_3RF_REMOTE_AT_TX_FAILURE;
+                    continue;
+                }
+                request->sentAt = self->htable->PortMillis();
+                active++;
+            }
+            if (!active) break;
+
+            xbee_api_frame_t frame;
+            if (apiReceiveApiFrame(self, &frame) == API_RECEIVE_SUCCESS) {
+                uint8_t i = active;
+                if (frame.type == XBEE_API_TYPE_3RF_REMOTE_AT_RESPONSE && frame.length >= REMOTE_AT_RESPONSE_HEADER_SIZE) {
+                    uint64_t source = get64(&frame.data[2]);
+                    for (i = 0; i < active; i++) {
+                        if (inFlight[i].frameId == frame.data[1] && results[inFlight[i].index].address64 == source) break;
+                    }
+                }
+                if (i == active) {
+                    apiHandleFrame(self, frame);
+                } else {
+                    XBee3RFRemoteAtResult_t* result = &results[inFlight[i].index];
+                    uint16_t length = frame.length - REMOTE_AT_RESPONSE_HEADER_SIZE;
+                    result->status = frame.data[14];
+                    result->length = (uint8_t)(length < sizeof(result->value) ? length : sizeof(result->value));
+                    memcpy(result->value, &frame.data[REMOTE_AT_RESPONSE_HEADER_SIZE], result->length);
+                    if (result->status == XBEE_3RF_REMOTE_AT_OK) {
+                        nodeRefresh(self, result->address64, (uint16_t)(frame.data[10] << 8 | frame.data[11]));
+                    } else {
+                        XBEE_STATS_INC(self, atErrors);
+                    }
+                    inFlight[i] = inFlight[--active];
+                }
+            }
+
+            // Unanswered requests leave the window; the node is tried again next round
+            uint32_t now = self->htable->PortMillis();
+            for (uint8_t i = 0; i < active; ) {
+                if (now - inFlight[i].sentAt >= XBEE_3RF_REMOTE_AT_TIMEOUT_MS) {
+                    XBEE_STATS_INC(self, atTimeouts);
+                    inFlight[i] = inFlight[--active];
+                } else {
+                    i++;
+                }
+            }
+            if (rf->txInFlight) {
+                rfExpire(self);
+            }
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        succeeded += results[i].status == XBEE_3RF_REMOTE_AT_OK;
+    }
+    XBEEDebugPrint("Remote %s: %u of %u nodes\n", cmdStr, succeeded, count);
+    return succeeded;
+}
+
+/**
+ * @brief Decodes one IO sample set.
+ *
+ * `data` starts at the sample count, as it follows the source address and
+ * options in an IO Data Sample RX Indicator (0x92), or as `AT_IS` answers.
+ * The digital levels follow the channel masks if any DIO line was sampled,
+ * then one reading per bit set in the analog mask, lowest bit first.
+ * Readings of analog channels other than AD0-AD3 and the supply voltage
+ * are skipped and their bits cleared.
+ *
+ * @param[in] data The sample set.
+ * @param[in] length Bytes in `data`.
+ * @param[out] sample Receives the masks, levels and readings; `receivedAt` is left alone.
+ *
+ * @return bool Returns true if `data` held a complete sample set, otherwise false.
+ */
+bool XBee3RFIoDecode(const uint8_t* data, uint16_t length, XBee3RFIoSample_t* sample) {
+    if (!data || !sample || length < 4 || data[0] == 0) return false;
+
+    uint16_t digitalMask = (uint16_t)(data[1] << 8 | data[2]);
+    uint8_t analogMask = data[3];
+    if (length < 4 + (digitalMask ? 2 : 0) + 2 * bitCount(analogMask)) return false;
+
+    const uint8_t* in = &data[4];
+    sample->digitalMask = digitalMask;
+    sample->digital = 0;
+    sample->analogMask = analogMask & (0x0F | XBEE_3RF_IO_ANALOG_SUPPLY_BIT);
+    memset(sample->analog, 0, sizeof(sample->analog));
+    if (digitalMask) {
+        sample->digital = (uint16_t)(in[0] << 8 | in[1]) & digitalMask;
+        in += 2;
+    }
+    for (uint8_t mask = analogMask; mask; mask &= (uint8_t)(mask - 1), in += 2) {
+        uint8_t bit = lowestBit(mask);
+        uint16_t reading = (uint16_t)(in[0] << 8 | in[1]);
+        if (bit < XBEE_3RF_IO_SUPPLY) {
+            sample->analog[bit] = reading;
+        } else if ((1u << bit) == XBEE_3RF_IO_ANALOG_SUPPLY_BIT) {
+            sample->analog[XBEE_3RF_IO_SUPPLY] = reading;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Lists the DIO lines of a sample with their levels.
+ *
+ * Only the set bits of the digital mask are visited, so the cost follows
+ * the number of lines sampled rather than the 16 possible.
+ *
+ * @param[in] sample The sample.
+ * @param[out] pins Receives the DIO numbers, lowest first; room for 16.
+ * @param[out] levels Receives the level, 0 or 1, of each line in `pins`; room for 16.
+ *
+ * @return uint8_t The number of lines sampled.
+ */
+uint8_t XBee3RFIoUnpackDigital(const XBee3RFIoSample_t* sample, uint8_t* pins, uint8_t* levels) {
+    uint8_t count = 0;
+
+    for (uint16_t mask = sample->digitalMask; mask; mask &= (uint16_t)(mask - 1)) {
+        uint8_t pin = lowestBit(mask);
+        pins[count] = pin;
+        levels[count++] = (uint8_t)(sample->digital >> pin & 1);
+    }
+    return count;
+}
+
+/**
+ * @brief Converts raw 10-bit ADC readings to millivolts.
+ *
+ * The loop has no branches, so a compiler can vectorize it over long
+ * batches, such as one channel of the samples returned by XBee3RFIoRead().
+ *
+ * @param[in] raw The readings.
+ * @param[out] millivolts Receives one value per reading; may be `raw` itself.
+ * @param[in] count Number of readings.
+ * @param[in] referenceMv The ADC reference voltage the module is set to, e.g. 2500.
+ */
+void XBee3RFIoToMillivolts(const uint16_t* raw, uint16_t* millivolts, uint16_t count, uint16_t referenceMv) {
+    for (uint16_t i = 0; i < count; i++) {
+        millivolts[i] = (uint16_t)(((uint32_t)raw[i] * referenceMv + 511) / 1023);
+    }
+}
+
+/**
+ * @brief Samples the module's own IO lines with `AT_IS`.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[out] sample Receives the sample.
+ *
+ * @return bool Returns true if the module answered with a sample, otherwise false.
+ */
+bool XBee3RFIoSampleNow(XBee* self, XBee3RFIoSample_t* sample) {
+    uint8_t data[22];
+    uint8_t length;
+
+    if (!sample || !XBeeAtGetBytes(self, AT_IS, data, &length, sizeof(data))) return false;
+    sample->receivedAt = self->htable->PortMillis();
+    return XBee3RFIoDecode(data, length, sample);
+}
+
+#if XBEE_3RF_IO_ENABLED
+/**
+ * @brief Lists the nodes with samples waiting to be read.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[out] address64 Receives the 64-bit address of each node.
+ * @param[in] max Room in `address64`.
+ *
+ * @return uint8_t The number of addresses written.
+ */
+uint8_t XBee3RFIoSources(XBee* self, uint64_t* address64, uint8_t max) {
+    XBee3RF* rf = (XBee3RF*)self;
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < XBEE_3RF_IO_SOURCES && count < max; i++) {
+        const XBee3RFIoSource_t* source = &rf->ioSources[i];
+        if (source->address64 && source->head != source->tail) {
+            address64[count++] = source->address64;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Takes the samples received from a node, oldest first.
+ *
+ * Samples are copied out of the node's ring in at most two blocks and are
+ * gone from the ring afterwards. A node sending faster than it is read
+ * loses its oldest samples, counted in the source's `overruns`.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] address64 The node's 64-bit address.
+ * @param[out] samples Receives the samples.
+ * @param[in] max Room in `samples`.
+ *
+ * @return uint16_t The number of samples written.
+ */
+uint16_t XBee3RFIoRead(XBee* self, uint64_t address64, XBee3RFIoSample_t* samples, uint16_t max) {
+    XBee3RF* rf = (XBee3RF*)self;
+    XBee3RFIoSource_t* source = NULL;
+
+    for (uint8_t i = 0; i < XBEE_3RF_IO_SOURCES && address64; i++) {
+        if (rf->ioSources[i].address64 == address64) source = &rf->ioSources[i];
+    }
+    if (!source || !samples) return 0;
+
+    uint16_t count = (uint16_t)(source->head - source->tail);
+    if (count > max) count = max;
+    uint16_t first = source->tail & IO_RING_MASK;
+    uint16_t run = XBEE_3RF_IO_RING_SIZE - first;
+    if (run > count) run = count;
+    memcpy(samples, &source->ring[first], run * sizeof(*samples));
+    memcpy(&samples[run], source->ring, (count - run) * sizeof(*samples));
+    source->tail += count;
+    return count;
+}
+#endif
+
+/**
+ * @brief Brings the module's network settings to an XBee3RFConfig_t.
+ *
+ * Called through XBeeConfigure(). The settings are handed to
+ * XBeeShadowSync(), so only the settings that differ are written.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] config Pointer to a valid XBee3RFConfig_t structure.
+ *
+ * @return bool Returns true if the module now has the requested settings, otherwise false.
+ */
+bool XBee3RFConfigure(XBee* self, const void* config) {
+    const XBee3RFConfig_t* cfg = (const XBee3RFConfig_t*)config;
+    XBeeShadowParam_t params[4];
+    uint8_t panId[8];
+    uint8_t count = 0;
+
+    if (!self || !cfg) return false;
+
+    if (cfg->panId) {
+        size_t chars = strlen(cfg->panId);
+        if (chars == 0 || chars % 2 != 0 || chars / 2 > sizeof(panId) ||
+            asciiToHexArray(cfg->panId, panId, chars / 2) < 0) {
+            XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid PAN ID\n");
+            return false;
+        }
+        params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_BYTES(AT_ID, panId, (uint8_t)(chars / 2));
+    }
+    if (cfg->fields & XBEE_3RF_CONFIG_COORDINATOR) {
+        params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_CE, cfg->coordinator);
+    }
+    if (cfg->fields & XBEE_3RF_CONFIG_BROADCAST_HOPS) {
+        params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_BH, cfg->broadcastHops);
+    }
+    if (cfg->fields & XBEE_3RF_CONFIG_API_OPTIONS) {
+        params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_AO, cfg->apiOptions);
+    }
+
+    return XBeeShadowSync(self, params, count, NULL);
+}
+
+// XBee3RF private functions
+
+#if XBEE_3RF_IO_ENABLED
+/**
+ * @brief Adds a sample to the ring of the node that sent it.
+ *
+ * A node without a ring takes a free one, or else the one updated least
+ * recently, whose unread samples are lost.
+ */
+static void ioStore(XBee* self, uint64_t address64, const XBee3RFIoSample_t* sample) {
+    XBee3RF* rf = (XBee3RF*)self;
+    XBee3RFIoSource_t* source = NULL;
+
+    for (uint8_t i = 0; i < XBEE_3RF_IO_SOURCES; i++) {
+        XBee3RFIoSource_t* candidate = &rf->ioSources[i];
+        if (candidate->address64 == address64) {
+            source = candidate;
+            break;
+        }
+        if (!source || (source->address64 && (!candidate->address64 ||
+            sample->receivedAt - candidate->updatedAt > sample->receivedAt - source->updatedAt))) {
+            source = candidate;
+        }
+    }
+    if (source->address64 != address64) {
+        source->address64 = address64;
+        source->head = source->tail = source->overruns = 0;
+    }
+
+    if ((uint16_t)(source->head - source->tail) == XBEE_3RF_IO_RING_SIZE) {
+        source->tail++;
+        source->overruns++;
+    }
+    source->ring[source->head++ & IO_RING_MASK] = *sample;
+    source->updatedAt = sample->receivedAt;
+}
+
+/**
+ * @brief Decodes an IO Data Sample RX Indicator into its source's ring.
+ */
+static void XBee3RFHandleIoSample(XBee* self, const xbee_api_frame_t* frame) {
+    XBee3RFIoSample_t sample;
+
+    if (frame->length < RX_PACKET_HEADER_SIZE) return;
+
+    uint64_t address64 = get64(&frame->data[1]);
+    nodeRefresh(self, address64, (uint16_t)(frame->data[9] << 8 | frame->data[10]));
+    sample.receivedAt = self->htable->PortMillis();
+    if (!address64 || !XBee3RFIoDecode(&frame->data[RX_PACKET_HEADER_SIZE], frame->length - RX_PACKET_HEADER_SIZE, &sample)) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Malformed IO sample\n");
+        return;
+    }
+    ioStore(self, address64, &sample);
+}
+#endif
+
+/**
+ * @brief Parses an RX packet frame and invokes the receive callback function.
+ *
+ * Both the RX Packet (0x90) and the Explicit RX Indicator (0x91) are parsed
+ * into an `XBee3RFPacket_t`; the payload points into the frame. The source
+ * refreshes its node cache entry. IO Data Sample RX Indicators (0x92) are
+ * decoded into their source's sample ring instead.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] param Pointer to the received API frame data.
+ *
+ * @return void This function does not return a value.
+ */
+static void XBee3RFHandleRxPacket(XBee* self, void *param) {
+
+    if (param == NULL) return;
+
+    xbee_api_frame_t *frame = (xbee_api_frame_t *)param;
+#if XBEE_3RF_IO_ENABLED
+    if (frame->type == XBEE_API_TYPE_IO_DATA_SAMPLE_RX) {
+        XBee3RFHandleIoSample(self, frame);
+        return;
+    }
+#endif
+    if (frame->type != XBEE_API_TYPE_3RF_RX_PACKET && frame->type != XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET) return;
+
+    uint16_t header = frame->type == XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET ? RX_EXPLICIT_HEADER_SIZE : RX_PACKET_HEADER_SIZE;
+    if (frame->length < header) return;
+
+    XBee3RFPacket_t packet = {0}; // Allocate on the stack and zero-initialize
+
+    XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE, "RX Packet Data: ", frame->data, frame->length);
+
+    packet.address64 = get64(&frame->data[1]);
+    packet.address16 = (uint16_t)(frame->data[9] << 8 | frame->data[10]);
+    if (frame->type == XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET) {
+        packet.sourceEndpoint = frame->data[11];
+        packet.destinationEndpoint = frame->data[12];
+        packet.clusterId = (uint16_t)(frame->data[13] << 8 | frame->data[14]);
+        packet.profileId = (uint16_t)(frame->data[15] << 8 | frame->data[16]);
+        packet.options = frame->data[17];
+    } else {
+        packet.options = frame->data[11];
+    }
+    packet.payloadSize = frame->length - header;
+    packet.payload = &(frame->data[header]); // Point directly to the payload in the frame data
+    nodeRefresh(self, packet.address64, packet.address16);
+
+    if (self->ctable->OnReceiveCallback) {
+        XBEE_TRACE_START(self, traceStart);
+        self->ctable->OnReceiveCallback(self, &packet); // Pass the address of the stack variable
+        XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_RECEIVE);
+    }
+}
+
+/**
+ * @brief Matches a TX status to its frame in the transmit window.
+ *
+ * Extended TX statuses (0x8B) carry the 16-bit address used, the retry count
+ * and the discovery status; 802.15.4 modules answer with a plain TX status
+ * (0x89). Statuses for frames not in the window, such as late statuses for
+ * frames that already timed out, are dropped. A delivered frame refreshes the
+ * node cache with the 16-bit address used; a frame that found no node or
+ * route drops the node's entry so the next send resolves it again.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] param Pointer to the received API frame data.
+ *
+ * @return void This function does not return a value.
+ */
+static void XBee3RFHandleTransmitStatus(XBee* self, void *param) {
+
+    if (param == NULL) return;
+
+    xbee_api_frame_t *frame = (xbee_api_frame_t *)param;
+    bool extended = frame->type == XBEE_API_TYPE_3RF_EXTENDED_TX_STATUS;
+    if (!extended && frame->type != XBEE_API_TYPE_TX_STATUS) return;
+    if (frame->length < (extended ? 7 : 3)) return;
+
+    XBee3RFPacket_t packet = {0}; // Allocate on the stack and zero-initialize
+
+    XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE, "Received Transmit Status Frame: ", &frame->data[1], frame->length - 1);
+
+    packet.frameId = frame->data[1];
+    if (extended) {
+        packet.address16 = (uint16_t)(frame->data[2] << 8 | frame->data[3]);
+        packet.retries = frame->data[4];
+        packet.status = frame->data[5];
+        packet.discovery = frame->data[6];
+    } else {
+        packet.address16 = XBEE_3RF_ADDRESS16_UNKNOWN;
+        packet.status = frame->data[2];
+    }
+
+    // Store the delivery status in the XBee instance
+    self->deliveryStatus = packet.status;
+    self->txStatusReceived = true;
+
+    XBee3RFTxSlot_t* slot = rfSlotFor((XBee3RF*)self, packet.frameId);
+    if (!slot || slot->done) {
+        XBEEDebugPrint("TX status for unknown frame 0x%02X\n", packet.frameId);
+        return;
+    }
+    XBEE_STATS_HIST(self, txStatusLatency, self->htable->PortMillis() - slot->sentAt);
+
+    // Keep the node cache in step with the address the module used, and
+    // forget an address that no longer leads to the node
+    if (packet.status == XBEE_3RF_DELIVERY_SUCCESS) {
+        nodeRefresh(self, slot->address64, packet.address16);
+    } else if (packet.status == XBEE_3RF_DELIVERY_NETWORK_ACK_FAILURE ||
+               packet.status == XBEE_3RF_DELIVERY_ADDRESS_NOT_FOUND ||
+               packet.status == XBEE_3RF_DELIVERY_ROUTE_NOT_FOUND) {
+        int i = nodeIndex((XBee3RF*)self, slot->address64);
+        if (i >= 0) nodeRemove((XBee3RF*)self, (uint32_t)i);
+    }
+    rfComplete(self, slot, &packet);
+}
+
+/**
+ * @brief Caches the route a route record indicator reports for its source.
+ *
+ * A Zigbee module that is a many-to-one concentrator (`AT_AR`) receives a
+ * route record (0xA1) ahead of packets from nodes whose route it does not
+ * know, listing the 16-bit addresses of the hops in between. The route is
+ * kept in the node cache with the source's 16-bit address and sent ahead of
+ * unicasts to the node, so they need no route discovery. Routes longer than
+ * XBEE_3RF_ROUTE_MAX_HOPS are not kept.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] param Pointer to the received API frame data.
+ *
+ * @return void This function does not return a value.
+ */
+static void XBee3RFHandleRouteRecord(XBee* self, void *param) {
+
+    if (param == NULL) return;
+
+    xbee_api_frame_t *frame = (xbee_api_frame_t *)param;
+    if (frame->type != XBEE_API_TYPE_3RF_ROUTE_RECORD || frame->length < ROUTE_RECORD_HEADER_SIZE) return;
+
+    uint8_t hops = frame->data[12];
+    if (frame->length < ROUTE_RECORD_HEADER_SIZE + 2 * hops) return;
+    if (hops > XBEE_3RF_ROUTE_MAX_HOPS) {
+        XBEEDebugPrint("Route of %u hops not cached\n", hops);
+        return;
+    }
+
+    XBee3RFNode_t* node = nodeUpdate(self, get64(&frame->data[1]), (uint16_t)(frame->data[9] << 8 | frame->data[10]));
+    if (!node) return;
+    for (uint8_t i = 0; i < hops; i++) {
+        const uint8_t* hop = &frame->data[ROUTE_RECORD_HEADER_SIZE + 2 * i];
+        node->route[i] = (uint16_t)(hop[0] << 8 | hop[1]);
+    }
+    node->routeHops = hops;
+}
+
+
+// VTable for XBee3RF
+const XBeeVTable XBee3RFVTable = {
+    .init = XBee3RFInit,
+    .process = XBee3RFProcess,
+    .connect = XBee3RFConnect,
+    .disconnect = XBee3RFDisconnect,
+    .sendData = XBee3RFSendPacket,
+    .softReset = XBee3RFSoftReset,
+    .hardReset = XBee3RFHardReset,
+    .connected = XBee3RFConnected,
+    .handleRxPacketFrame = XBee3RFHandleRxPacket,
+    .handleTransmitStatusFrame = XBee3RFHandleTransmitStatus,
+    .handleRouteRecordFrame = XBee3RFHandleRouteRecord,
+    .configure = XBee3RFConfigure,
+};
+
+/**
+ * @brief Constructs an XBee3RF instance in storage provided by the caller.
+ *
+ * This function clears `storage` and initializes it with the provided callback
+ * table (`cTable`) and handler table (`hTable`), the XBee 3 RF virtual table
+ * and the frame pool held in the instance. The transmit window and the node
+ * cache start empty.
+ *
+ * @param[out] storage Memory for the instance; must outlive its use.
+ * @param[in] cTable Pointer to the callback table containing function pointers for handling XBee events.
+ * @param[in] hTable Pointer to the handler table containing platform-specific function implementations.
+ *
+ * @return XBee3RF* `storage`, or NULL if `storage` is NULL.
+ */
+XBee3RF* XBee3RFInitStatic(XBee3RF* storage, const XBeeCTable* cTable, const XBeeHTable* hTable) {
+    if (!storage) return NULL;
+    memset(storage, 0, sizeof(*storage));
+    storage->base.vtable = &XBee3RFVTable;
+    storage->base.htable = hTable;
+    storage->base.ctable = cTable;
+    storage->base.framePool = storage->framePool;
+    storage->base.framePoolSize = sizeof(storage->framePool);
+    storage->base.maxFrameDataSize = XBEE_3RF_MAX_FRAME_DATA_SIZE;
+    storage->base.atModule = AT_MODULE_3RF;
+    storage->base.linkPollMs = XBEE_3RF_LINK_POLL_MS;
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+    xbeeTimeoutReset(&storage->base.atTimeouts);
+#endif
+    return storage;
+}
+
+#if !XBEE_NO_HEAP
+/**
+ * @brief Constructor for creating an XBee3RF instance.
+ *
+ * This function allocates memory for a new XBee3RF instance and initializes it
+ * with XBee3RFInitStatic(). Not available in XBEE_NO_HEAP builds.
+ *
+ * @param[in] cTable Pointer to the callback table containing function pointers for handling XBee events.
+ * @param[in] hTable Pointer to the handler table containing platform-specific function implementations.
+ *
+ * @return XBee3RF* Pointer to the newly created XBee3RF instance, or NULL if the allocation failed.
+ */
+XBee3RF* XBee3RFCreate(const XBeeCTable* cTable, const XBeeHTable* hTable) {
+    XBee3RF* instance = (XBee3RF*)malloc(sizeof(XBee3RF));
+    if (!instance) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Unable to allocate an XBee3RF instance.\n");
+        return NULL;
+    }
+    return XBee3RFInitStatic(instance, cTable, hTable);
+}
+
+void XBee3RFDestroy(XBee3RF* self) {
+    free(self);
+}
+#endif
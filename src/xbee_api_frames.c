@@ -34,6 +34,8 @@
 
  #include "xbee_api_frames.h"
  #include "xbee.h"
+ #include "xbee_escape.h"
+ #include "xbee_checksum.h"
  #include "port.h"
  #include <stdio.h>
  #include <string.h>
@@ -41,24 +43,50 @@
  // API Frame Functions
  
  /**
-  * @brief Calculates the checksum for an API frame.
-  * 
-  * This function computes the checksum for a given XBee API frame. The checksum 
-  * is calculated by summing the bytes of the frame starting from the fourth byte 
-  * (index 3) to the end of the frame and then subtracting the sum from 0xFF. 
-  * The resulting checksum ensures the integrity of the data in the API frame.
-  * 
-  * @param[in] frame Pointer to the API frame data.
-  * @param[in] len Length of the API frame data.
-  * 
-  * @return uint8_t The calculated checksum value.
+  * @brief True if the instance encodes frames in API escaped mode.
   */
- static uint8_t calculateChecksum(const uint8_t *frame, uint16_t len) {
-     uint8_t sum = 0;
-     for (uint16_t i = 3; i < len; i++) {
-         sum += frame[i];
+ static bool apiEscaped(const XBee* self) {
+ #if XBEE_API_ESCAPE_ENABLED
+     return self->apiMode == XBEE_API_MODE_ESCAPED;
+ #else
+     (void)self;
+     return false;
+ #endif
+ }
+ 
+ /**
+  * @brief Upper bound of the UART bytes `length` frame bytes take in the instance's framing.
+  */
+ static uint32_t apiWireBytes(const XBee* self, uint32_t length) {
+     return apiEscaped(self) ? 2 * length : length;
+ }
+ 
+ /**
+  * @brief Writes `length` bytes to the UART, retrying partial writes until `deadlineMs` after `startTime`.
+  *
+  * @return int `API_SEND_SUCCESS`, or `API_SEND_ERROR_UART_FAILURE` on a port error or timeout.
+  */
+ static int uartWriteAll(XBee* self, const uint8_t* data, uint16_t length, uint32_t startTime, uint32_t deadlineMs) {
+     uint16_t totalBytesWritten = 0;
+ 
+     while (totalBytesWritten < length) {
+         int bytes_written = self->htable->PortUartWrite(data + totalBytesWritten, length - totalBytesWritten);
+         if (bytes_written < 0) {
+             return API_SEND_ERROR_UART_FAILURE;
+         }
+ 
+         totalBytesWritten += bytes_written;
+         if (totalBytesWritten == length) break;
+ 
+         // Check for timeout
+         if ((self->htable->PortMillis() - startTime) > deadlineMs) {
+             XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Frame sending timeout after %lu ms\n",
+                           (unsigned long)(self->htable->PortMillis() - startTime));
+             return API_SEND_ERROR_UART_FAILURE;
+         }
+         self->htable->PortDelay(1);
      }
-     return 0xFF - sum;
+     return API_SEND_SUCCESS;
  }
  
  /**
@@ -69,6 +97,8 @@
   * data integrity. The function increments the frame ID counter with each call, 
   * ensuring that frame IDs are unique. If the frame is successfully sent, the function 
   * returns 0; otherwise, it returns an error code indicating the failure.
+  * In API escaped mode the frame is escaped in XBEE_ESCAPE_CHUNK_SIZE pieces
+  * as it is written.
   * 
   * @param[in] self Pointer to the XBee instance.
   * @param[in] frameType The type of the API frame to send.
@@ -76,11 +106,16 @@
   * @param[in] len Length of the frame data in bytes.
   * 
   * @return int Returns 0 (`API_SEND_SUCCESS`) if the frame is successfully sent, 
-  * or a non-zero error code (`API_SEND_ERROR_UART_FAILURE`) if there is a failure.
+  * or a non-zero error code (`API_SEND_ERROR_UART_FAILURE`, or `API_SEND_ERROR_FRAME_TOO_LARGE`
+  * if the frame does not fit in XBEE_TX_FRAME_BUFFER_SIZE) if there is a failure.
   */
  int apiSendFrame(XBee* self, uint8_t frameType, const uint8_t *data, uint16_t len) {
-     uint8_t frame[256];
+     uint8_t frame[XBEE_TX_FRAME_BUFFER_SIZE];
      uint16_t frameLength = 0;
+     if (len > sizeof(frame) - 5) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Frame data of %u bytes exceeds XBEE_TX_FRAME_BUFFER_SIZE.\n", len);
+         return API_SEND_ERROR_FRAME_TOO_LARGE;
+     }
      self->frameIdCntr++;
      if (self->frameIdCntr == 0) self->frameIdCntr = 1; // Reset frame counter when 0
  
@@ -94,45 +129,52 @@
      // Frame type
      frame[frameLength++] = frameType;
  
-     // Frame data
-     memcpy(&frame[frameLength], data, len);
+     // Frame data, added to the checksum as it is copied
+     uint8_t sum = xbeeChecksumCopy(frameType, &frame[frameLength], data, len);
      frameLength += len;
  
-     // Calculate and add checksum
-     frame[frameLength] = calculateChecksum(frame, frameLength);
-     frameLength++;
+     // Add checksum
+     frame[frameLength++] = 0xFF - sum;
  
      // Print the API frame in hex format
-     APIFrameDebugPrint("Sending API Frame: ");
-     for (uint16_t i = 0; i < frameLength; i++) {
-         APIFrameDebugPrint("0x%02X ", frame[i]);
-     }
-     APIFrameDebugPrint("\n");
+     XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_API, "Sending API Frame: ", frame, frameLength);
  
-     // Measure the time taken to send the frame
+     // Measure the time taken to send the frame; a port may block until it is on the wire
      uint32_t startTime = self->htable->PortMillis();
-     int totalBytesWritten = 0;
- 
-     while (totalBytesWritten < frameLength) {
-         int bytes_written = self->htable->PortUartWrite(frame + totalBytesWritten, frameLength - totalBytesWritten);
-         if (bytes_written < 0) {
-             return API_SEND_ERROR_UART_FAILURE;
-         }
- 
-         totalBytesWritten += bytes_written;
+     uint32_t writeTimeoutMs = UART_WRITE_TIMEOUT_MS + xbeeWireTimeMs(self->baudRate, apiWireBytes(self, frameLength));
+     int status;
+     XBEE_TRACE_START(self, traceStart);
+ 
+     if (apiEscaped(self)) {
+         // The start delimiter is the only byte sent as is
+         uint8_t wire[XBEE_ESCAPE_CHUNK_SIZE];
+         size_t wireLength = 1;
+         size_t offset = 1;
+         wire[0] = XBEE_START_DELIMITER;
+         do {
+             size_t consumed;
+             wireLength += xbeeEscape(&wire[wireLength], sizeof(wire) - wireLength,
+                                      &frame[offset], frameLength - offset, &consumed);
+             offset += consumed;
+             status = uartWriteAll(self, wire, (uint16_t)wireLength, startTime, writeTimeoutMs);
+             wireLength = 0;
+         } while (status == API_SEND_SUCCESS && offset < frameLength);
+     } else {
+         status = uartWriteAll(self, frame, frameLength, startTime, writeTimeoutMs);
+     }
  
-         // Check for timeout
-         if ((self->htable->PortMillis() - startTime) > UART_WRITE_TIMEOUT_MS) {
-             APIFrameDebugPrint("Error: Frame sending timeout after %lu ms\n", self->htable->PortMillis() - startTime);
-             return API_SEND_ERROR_UART_FAILURE;
-         }
-         self->htable->PortDelay(1);
+     if (status != API_SEND_SUCCESS) {
+         XBEE_STATS_INC(self, txErrors);
+         XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_TX_FRAME, frameType | 0x100);
+         return status;
      }
  
- #if API_FRAME_DEBUG_PRINT_ENABLED
+ #if XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_DEBUG
      uint32_t elapsed_time = self->htable->PortMillis() - startTime;
  #endif
-     APIFrameDebugPrint("UART write completed in %lu ms\n", elapsed_time);
+     APIFrameDebugPrint("UART write completed in %lu ms\n", (unsigned long)elapsed_time);
+     XBEE_STATS_TX(self, frameType, frameLength);
+     XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_TX_FRAME, frameType);
  
      // Return success if everything went well
      return API_SEND_SUCCESS;
@@ -158,11 +200,11 @@
   * `API_SEND_ERROR_INVALID_COMMAND`, etc.).
   */
  int apiSendAtCommand(XBee* self,at_command_t command, const uint8_t *parameter, uint8_t paramLength) {
-     uint8_t frame_data[128];
+     uint8_t frame_data[3 + XBEE_AT_PARAM_MAX_SIZE];
      uint16_t frameLength = 0;
  
     // Check if the parameter length is too large
-     if (paramLength > 128) {
+     if (paramLength > XBEE_AT_PARAM_MAX_SIZE) {
          return API_SEND_ERROR_FRAME_TOO_LARGE;
      }
  
@@ -188,11 +230,7 @@
      // Print the AT command and parameter in a readable format
      APIFrameDebugPrint("Sending AT Command: %s\n", cmd_str);
      if (paramLength > 0) {
-         APIFrameDebugPrint("Parameter: ");
-         for (uint8_t i = 0; i < paramLength; i++) {
-             APIFrameDebugPrint("0x%02X ", parameter[i]);
-         }
-         APIFrameDebugPrint("\n");
+         XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_API, "Parameter: ", parameter, paramLength);
      } else {
          APIFrameDebugPrint("No Parameters\n");
      }
@@ -201,6 +239,54 @@
      return apiSendFrame(self, XBEE_API_TYPE_AT_COMMAND, frame_data, frameLength);
  }
  
+ /**
+  * @brief Reads from the bytes carried over from an aborted frame, then from the UART.
+  * 
+  * @param[in] self Pointer to the XBee instance.
+  * @param[out] buffer Where the bytes are stored.
+  * @param[in] length Most bytes to read.
+  * 
+  * @return int Number of bytes read, or the PortUartRead() result.
+  */
+ static int uartRead(XBee* self, uint8_t* buffer, int length) {
+     if (self->rxCarryLength == 0) {
+         return self->htable->PortUartRead(buffer, length);
+     }
+     int count = length < self->rxCarryLength ? length : self->rxCarryLength;
+     // Frames are stored below the carried bytes, so this only ever moves them down
+     memmove(buffer, self->framePool + self->rxCarryOffset, (size_t)count);
+     self->rxCarryOffset += (uint16_t)count;
+     self->rxCarryLength -= (uint16_t)count;
+     return count;
+ }
+ 
+ /**
+  * @brief Keeps the bytes from the start delimiter that aborted a frame for the next receive.
+  * 
+  * They go to the start of the free frame pool, followed by any carried bytes
+  * not read yet. Bytes that do not fit are dropped.
+  * 
+  * @param[in] self Pointer to the XBee instance.
+  * @param[in] tail The start delimiter and the bytes read after it.
+  * @param[in] length Number of bytes in `tail`.
+  */
+ static void carryTail(XBee* self, const uint8_t* tail, int length) {
+     if (!self->framePool) {
+         self->rxCarryLength = 0;
+         return;
+     }
+     uint16_t room = self->framePoolSize - self->framePoolTop;
+     uint16_t tailLength = (uint16_t)length < room ? (uint16_t)length : room;
+     uint16_t restLength = self->rxCarryLength < room - tailLength ? self->rxCarryLength : room - tailLength;
+     uint8_t* carry = self->framePool + self->framePoolTop;
+
+     // The unread carried bytes sit above the tail, which sits at or above the free space
+     memmove(carry, tail, tailLength);
+     memmove(carry + tailLength, self->framePool + self->rxCarryOffset, restLength);
+     self->rxCarryOffset = self->framePoolTop;
+     self->rxCarryLength = tailLength + restLength;
+ }
+ 
  /**
   * @brief Reads a specified number of bytes from the UART with a timeout mechanism.
   * 
@@ -212,22 +298,45 @@
   * @param[out] buffer Pointer to the buffer where the received bytes will be stored.
   * @param[in] length The number of bytes to read from the UART.
   * @param[in] timeoutMs The maximum time in milliseconds to wait for the complete data to be read.
+  * @param[in] escaped True to unescape the bytes as they arrive (API escaped mode); `length` counts unescaped bytes.
+  * @param[in,out] sum Running frame checksum sum the bytes are added to as they arrive, or NULL.
   * 
   * @return api_receive_status_t Returns API_RECEIVE_SUCCESS if the specified number of bytes are successfully read.
   *         Returns API_RECEIVE_ERROR_UART_FAILURE if the UART read operation fails.
   *         Returns API_RECEIVE_ERROR_TIMEOUT_DATA if the timeout is exceeded before the required bytes are read.
+  *         Returns API_RECEIVE_ERROR_FRAME_ABORTED if an escaped read meets a start delimiter; the
+  *         delimiter and the bytes after it are read again by the next receive.
   */
- static api_receive_status_t readBytesWithTimeout(XBee* self, uint8_t* buffer, int length, uint32_t timeoutMs) {
+ static api_receive_status_t readBytesWithTimeout(XBee* self, uint8_t* buffer, int length, uint32_t timeoutMs,
+                                                   bool escaped, uint8_t* sum) {
      int totalBytesReceived = 0;
      int bytes_received = 0;
+     bool pendingEscape = false;
      uint32_t startTime = self->htable->PortMillis();
  
-     while (totalBytesReceived < length) {
-         bytes_received = self->htable->PortUartRead(buffer + totalBytesReceived, length - totalBytesReceived);
+     while (1) {
+         // Escaped bytes only take more room on the wire, so this never reads past the request
+         bytes_received = uartRead(self, buffer + totalBytesReceived, length - totalBytesReceived);
          
+         if (bytes_received > 0 && escaped) {
+             int unescaped = xbeeUnescape(buffer + totalBytesReceived, (size_t)bytes_received, &pendingEscape, sum);
+             if (unescaped < 0) {
+                 // The next frame starts at the delimiter; keep it and what followed for the next receive
+                 int delimiter = -1 - unescaped;
+                 carryTail(self, buffer + totalBytesReceived + delimiter, bytes_received - delimiter);
+                 return API_RECEIVE_ERROR_FRAME_ABORTED;
+             }
+             bytes_received = unescaped;
+         } else if (bytes_received > 0 && sum) {
+             // Checksum each piece while the rest of the frame is still on the wire
+             *sum = xbeeChecksumAdd(*sum, buffer + totalBytesReceived, (size_t)bytes_received);
+         }
          if (bytes_received > 0) {
              totalBytesReceived += bytes_received;
          }
+         if (totalBytesReceived >= length) {
+             return API_RECEIVE_SUCCESS;
+         }
  
          // Check for timeout
          if (self->htable->PortMillis() - startTime >= timeoutMs) {
@@ -235,8 +344,6 @@
          }
          self->htable->PortDelay(1);  // Add a 1 ms delay to prevent busy-waiting
      }
- 
-     return API_RECEIVE_SUCCESS;
  }
  
  /**
@@ -245,17 +352,24 @@
   * This function attempts to read and receive an XBee API frame from the UART interface. 
   * It validates the received data by checking the start delimiter, frame length, and checksum. 
   * If the frame is successfully received and validated, the frame structure is populated 
-  * with the received data. The function returns API_RECEIVE_SUCCESS if successful, or an 
+  * with the received data. In API escaped mode everything after the start delimiter
+  * is unescaped as it is read.
+  * 
+  * The frame data is stored at the top of the instance frame pool rather than in
+  * the frame structure, in a slot exactly as long as the frame. It is valid until
+  * the next frame is received on the instance, or while apiHandleFrame() dispatches
+  * it, whichever is longer. The function returns API_RECEIVE_SUCCESS if successful, or an 
   * error code from `api_receive_status_t` if any step in the process fails, including timeout.
   * 
   * @param[in] self Pointer to the XBee instance.
   * @param[out] frame Pointer to an `xbee_api_frame_t` structure where the received frame data will be stored.
+  * @param[in] idleTimeoutMs How long to wait for the start delimiter.
   * 
   * @return api_receive_status_t Returns API_RECEIVE_SUCCESS if the frame is successfully received, or an error code if a failure occurs.
   */
- api_receive_status_t apiReceiveApiFrame(XBee* self, xbee_api_frame_t *frame) {
+ static api_receive_status_t receiveApiFrame(XBee* self, xbee_api_frame_t *frame, uint32_t idleTimeoutMs) {
      if (!frame) {
-         APIFrameDebugPrint("Error: Invalid frame pointer. The frame pointer passed to the function is NULL.\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Invalid frame pointer. The frame pointer passed to the function is NULL.\n");
          return API_RECEIVE_ERROR_INVALID_POINTER;
      }
  
@@ -263,70 +377,136 @@
  
      // Attempt to read the start delimiter with timeout
      uint8_t start_delimiter;
-     api_receive_status_t result = readBytesWithTimeout(self, &start_delimiter, 1, UART_READ_TIMEOUT_MS);
+     bool escaped = apiEscaped(self);
+     api_receive_status_t result = readBytesWithTimeout(self, &start_delimiter, 1, idleTimeoutMs, false, NULL);
      if (result != API_RECEIVE_SUCCESS) {
          //APIFrameDebugPrint("Error: Timeout occurred while waiting to read start delimiter.\n");
          return API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER;
      }
+     XBEE_TRACE_RX_START(self);
      APIFrameDebugPrint("Start delimiter received: 0x%02X\n", start_delimiter);
  
      if (start_delimiter != 0x7E) {
-         APIFrameDebugPrint("Error: Invalid start delimiter. Expected 0x7E, but received 0x%02X.\n", start_delimiter);
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Invalid start delimiter. Expected 0x7E, but received 0x%02X.\n", start_delimiter);
          return API_RECEIVE_ERROR_INVALID_START_DELIMITER;
      }
  
+     // The rest of the frame follows the delimiter back to back, so wait only for its wire time
+     uint32_t frameTimeoutMs = XBEE_UART_FRAME_SLACK_MS + xbeeWireTimeMs(self->baudRate, apiWireBytes(self, 2));
+ 
      // Read length with timeout
      uint8_t length_bytes[2];
-     result = readBytesWithTimeout(self, length_bytes, 2, UART_READ_TIMEOUT_MS);
+     result = readBytesWithTimeout(self, length_bytes, 2, frameTimeoutMs, escaped, NULL);
+     if (result == API_RECEIVE_ERROR_FRAME_ABORTED) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Start delimiter inside the frame length.\n");
+         return result;
+     }
      if (result != API_RECEIVE_SUCCESS) {
-         APIFrameDebugPrint("Error: Timeout occurred while waiting to read frame length.\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Timeout occurred while waiting to read frame length.\n");
          return API_RECEIVE_ERROR_TIMEOUT_LENGTH;
      }
      uint16_t length = (length_bytes[0] << 8) | length_bytes[1];
      APIFrameDebugPrint("Frame length received: %d bytes\n", length);
  
-     //@todo: Dynamic size based on api frame length
-     if (length > XBEE_MAX_FRAME_DATA_SIZE) {
-         APIFrameDebugPrint("Error: Frame length exceeds buffer size.\n");
+     // The frame goes in the free space of the pool, above any frame still being dispatched
+     if (length > self->maxFrameDataSize || length > self->framePoolSize - self->framePoolTop) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Frame length %u exceeds the limit (%u) or the free frame pool (%u).\n",
+                       length, self->maxFrameDataSize, self->framePoolSize - self->framePoolTop);
          return API_RECEIVE_ERROR_FRAME_TOO_LARGE;
      }
+     frame->data = self->framePool + self->framePoolTop;
  
      // Read the frame data with timeout
-     result = readBytesWithTimeout(self, frame->data, length, UART_READ_TIMEOUT_MS);
+     frameTimeoutMs = XBEE_UART_FRAME_SLACK_MS + xbeeWireTimeMs(self->baudRate, apiWireBytes(self, length + 1u));
+     uint8_t sum = 0;
+     result = readBytesWithTimeout(self, frame->data, length, frameTimeoutMs, escaped, &sum);
+     if (result == API_RECEIVE_ERROR_FRAME_ABORTED) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Start delimiter inside the frame data.\n");
+         return result;
+     }
      if (result != API_RECEIVE_SUCCESS) {
-         APIFrameDebugPrint("Error: Timeout occurred while waiting to read frame data.\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Timeout occurred while waiting to read frame data.\n");
          return API_RECEIVE_ERROR_TIMEOUT_DATA;
      }
-     APIFrameDebugPrint("Complete frame data received: ");
-     for (int i = 0; i < length; i++) {
-         APIFrameDebugPrint("0x%02X ", frame->data[i]);
-     }
-     APIFrameDebugPrint("\n");
+     XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_API, "Complete frame data received: ", frame->data, length);
  
      // Read the checksum with timeout
-     result = readBytesWithTimeout(self, &(frame->checksum), 1, UART_READ_TIMEOUT_MS);
+     result = readBytesWithTimeout(self, &(frame->checksum), 1,
+                                   XBEE_UART_FRAME_SLACK_MS + xbeeWireTimeMs(self->baudRate, apiWireBytes(self, 1)), escaped, NULL);
+     if (result == API_RECEIVE_ERROR_FRAME_ABORTED) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Start delimiter in place of the checksum.\n");
+         return result;
+     }
      if (result != API_RECEIVE_SUCCESS) {
-         APIFrameDebugPrint("Error: Timeout occurred while waiting to read checksum.\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Timeout occurred while waiting to read checksum.\n");
          return API_RECEIVE_ERROR_TIMEOUT_CHECKSUM;
      }
  
      // Populate frame structure
      frame->length = length;
-     frame->type = frame->data[0];
+     frame->type = length ? frame->data[0] : 0;
  
-     // Check and verify the checksum
-     uint8_t checksum = frame->checksum;
-     for (int i = 0; i < length; i++) {
-         checksum += frame->data[i];
-     }
+     // Check and verify the checksum; the data was summed as it arrived
+     uint8_t checksum = frame->checksum + sum;
      if (checksum != 0xFF) {
-         APIFrameDebugPrint("Error: Invalid checksum. Expected 0xFF, but calculated 0x%02X.\n", checksum);
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Error: Invalid checksum. Expected 0xFF, but calculated 0x%02X.\n", checksum);
          return API_RECEIVE_ERROR_INVALID_CHECKSUM;
      }
  
      return API_RECEIVE_SUCCESS; // Successfully received a frame
  }
  
+ /**
+  * @brief Receives one frame and records the result; see apiReceiveApiFrame().
+  */
+ static api_receive_status_t receiveAndRecord(XBee* self, xbee_api_frame_t *frame, uint32_t idleTimeoutMs) {
+     api_receive_status_t status = receiveApiFrame(self, frame, idleTimeoutMs);
+     XBEE_STATS_RX(self, status, status == API_RECEIVE_SUCCESS ? frame->type : 0,
+                   status == API_RECEIVE_SUCCESS ? frame->length + 4 : 0);
+#if XBEE_STATS_ENABLED && XBEE_STATS_AT_COMMANDS
+     at_command_t responded;
+     if (status == API_RECEIVE_SUCCESS && frame->type == XBEE_API_TYPE_AT_RESPONSE && frame->length >= 5 &&
+         atCommandFromString(self->atModule, (const char*)&frame->data[2], &responded)) {
+         XBEE_STATS_AT_RESPONSE(self, responded);
+     }
+#endif
+     XBEE_TRACE_RX_END(self, (status == API_RECEIVE_SUCCESS ? frame->type : 0) | ((uint16_t)-status << 8));
+     return status;
+ }
+ 
+ /**
+  * @brief Receives one XBee API frame and records the result in the instance statistics.
+  * 
+  * See receiveApiFrame() for the framing rules. Every call counts towards the
+  * per-status receive counters; successfully received frames also count towards
+  * the per-type frame and byte counters. Calls that got past the start delimiter
+  * are traced from the delimiter to the return.
+  * 
+  * @param[in] self Pointer to the XBee instance.
+  * @param[out] frame Pointer to an `xbee_api_frame_t` structure where the received frame data will be stored.
+  * 
+  * @return api_receive_status_t Returns API_RECEIVE_SUCCESS if the frame is successfully received, or an error code if a failure occurs.
+  */
+ api_receive_status_t apiReceiveApiFrame(XBee* self, xbee_api_frame_t *frame) {
+     return receiveAndRecord(self, frame, UART_READ_TIMEOUT_MS);
+ }
+ 
+ /**
+  * @brief Like apiReceiveApiFrame(), but waits at most `idleTimeoutMs` for the start delimiter.
+  * 
+  * For callers that wait for a response within their own budget; once the
+  * delimiter arrived, the rest of the frame is read as usual.
+  * 
+  * @param[in] self Pointer to the XBee instance.
+  * @param[out] frame Pointer to an `xbee_api_frame_t` structure where the received frame data will be stored.
+  * @param[in] idleTimeoutMs How long to wait for the start delimiter.
+  * 
+  * @return api_receive_status_t Returns API_RECEIVE_SUCCESS if the frame is successfully received, or an error code if a failure occurs.
+  */
+ api_receive_status_t apiReceiveApiFrameWithin(XBee* self, xbee_api_frame_t *frame, uint32_t idleTimeoutMs) {
+     return receiveAndRecord(self, frame, idleTimeoutMs);
+ }
+ 
  
  /**
   * @brief Calls registered handlers based on the received API frame type.
@@ -337,12 +517,21 @@
   * the corresponding handler function is invoked if it is registered in the XBee 
   * virtual table (vtable). If the frame type is unknown, a debug message is printed.
   * 
+  * A frame received into the instance frame pool stays reserved while it is
+  * dispatched, so handlers may wait for further frames (AT responses, for
+  * example) without overwriting it.
+  * 
   * @param[in] self Pointer to the XBee instance.
   * @param[in] frame The received API frame to be handled.
   * 
   * @return void This function does not return a value.
   */
  void apiHandleFrame(XBee* self, xbee_api_frame_t frame){
+     XBEE_TRACE_START(self, traceStart);
+     uint16_t poolTop = self->framePoolTop;
+     if (self->framePool && frame.data == self->framePool + poolTop) {
+         self->framePoolTop += frame.length;
+     }
      switch (frame.type) {
          case XBEE_API_TYPE_AT_RESPONSE:
              xbeeHandleAtResponse(self, &frame);
@@ -352,22 +541,34 @@
              break;
          case XBEE_API_TYPE_TX_STATUS:
          case XBEE_API_TYPE_LR_EXPLICIT_TX_STATUS:
+         case XBEE_API_TYPE_3RF_EXTENDED_TX_STATUS:
              if(self->vtable->handleTransmitStatusFrame){
                  self->vtable->handleTransmitStatusFrame(self, &frame);
              }
              break;
          case XBEE_API_TYPE_LR_RX_PACKET:
          case XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET:
+         case XBEE_API_TYPE_3RF_RX_PACKET:
+         case XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET:
+         case XBEE_API_TYPE_IO_DATA_SAMPLE_RX:
          case XBEE_API_TYPE_CELLULAR_SOCKET_RX:
          case XBEE_API_TYPE_CELLULAR_SOCKET_RX_FROM:
+             XBEE_CACHE_DROP(self, AT_FLAG_CACHE_LINK);    // The packet updated ATDB
              if(self->vtable->handleRxPacketFrame){
                  self->vtable->handleRxPacketFrame(self, &frame);
              }
              break;
+         case XBEE_API_TYPE_3RF_ROUTE_RECORD:
+             if(self->vtable->handleRouteRecordFrame){
+                 self->vtable->handleRouteRecordFrame(self, &frame);
+             }
+             break;
          default:
              APIFrameDebugPrint("Received unknown frame type: 0x%02X\n", frame.type);
              break;
      }
+     self->framePoolTop = poolTop;
+     XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_DISPATCH, frame.type);
  }
  
  /**
@@ -392,8 +593,11 @@
   */
  int apiSendAtCommandAndGetResponse(XBee* self, at_command_t command, const uint8_t *parameter, uint8_t paramLength, uint8_t *responseBuffer, 
      uint8_t *responseLength, uint32_t timeoutMs, uint16_t responseBufferSize) {
+     XBEE_TRACE_START(self, traceStart);
+
      // Send the AT command using API frame
      apiSendAtCommand(self, command, (const uint8_t *)parameter, paramLength);
+     XBEE_STATS_INC(self, atCommands);
  
      // Get the start time using the platform-specific function
      uint32_t startTime = self->htable->PortMillis();
@@ -403,33 +607,41 @@
      int status;
 
     const char* cmdStr = atCommandToString(command);
-     if (!cmdStr || strlen(cmdStr) != 2) {
-         APIFrameDebugPrint("Invalid AT command enum.\n");
+     if (!cmdStr) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Invalid AT command enum.\n");
          return API_SEND_ERROR_INVALID_COMMAND;
      }
+     at_command_t expected = atCommandForModule(self->atModule, command);
  
      while (1) {
-         // Attempt to receive the API frame
-         status = apiReceiveApiFrame(self, &frame);
+         // Wait for the next frame no longer than the time left for the response
+         uint32_t elapsed = self->htable->PortMillis() - startTime;
+         uint32_t remaining = elapsed < timeoutMs ? timeoutMs - elapsed : 1;
+         status = receiveAndRecord(self, &frame, remaining < UART_READ_TIMEOUT_MS ? remaining : UART_READ_TIMEOUT_MS);
  
          // Check if a valid frame was received
          if (status == 0) {
              // Check if the received frame is an AT response
              if (frame.type == XBEE_API_TYPE_AT_RESPONSE) {
                 
-                // Verify response matches the requested AT command
-                 if (frame.data[2] != cmdStr[0] || frame.data[3] != cmdStr[1]) {
+                // Route the response to its command and compare with the request
+                 at_command_t responded;
+                 if (!atCommandFromString(self->atModule, (const char*)&frame.data[2], &responded) ||
+                     responded != expected) {
                      APIFrameDebugPrint("Mismatched AT command response: expected %s, got %c%c\n",
                          cmdStr, frame.data[2], frame.data[3]);
                      continue; // Keep waiting
                  }
 
+                 XBEE_STATS_HIST(self, atRoundTrip, self->htable->PortMillis() - startTime);
+                 XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_AT, command);
+
                  // Extract the AT command response
                  *responseLength = frame.length - 5;  // Subtract the frame ID and AT command bytes
                  APIFrameDebugPrint("responseLength: %u\n", *responseLength);
                  if(frame.data[4] == 0){
                     if (*responseLength > responseBufferSize) {
-                        APIFrameDebugPrint("Response exceeds buffer size: %u > %u\n", *responseLength, responseBufferSize);
+                        XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Response exceeds buffer size: %u > %u\n", *responseLength, responseBufferSize);
                         return API_SEND_AT_CMD_ERROR;
                     }
 
@@ -437,7 +649,8 @@
                          memcpy(responseBuffer, &frame.data[5], *responseLength);
                      }
                  }else{
-                     APIFrameDebugPrint("API Frame AT CMD Error.\n");
+                     XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "API Frame AT CMD Error.\n");
+                     XBEE_STATS_INC(self, atErrors);
                      return API_SEND_AT_CMD_ERROR;
                  }
              
@@ -451,7 +664,9 @@
  
          // Check if the timeout period has elapsed using platform-specific time
          if ((self->htable->PortMillis() - startTime) >= timeoutMs) {
-             APIFrameDebugPrint("Timeout waiting for AT response.\n");
+             XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Timeout waiting for AT response.\n");
+             XBEE_STATS_INC(self, atTimeouts);
+             XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_AT, command);
              return API_SEND_AT_CMD_RESONSE_TIMEOUT;
          }
          
@@ -462,7 +677,7 @@
  //Print out AT Response
  void xbeeHandleAtResponse(XBee* self, xbee_api_frame_t *frame) {
     (void)self;
- #if API_FRAME_DEBUG_PRINT_ENABLED
+ #if XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_DEBUG
      // The first byte of frame->data is the Frame ID
      uint8_t frame_id = frame->data[1];
  
@@ -485,21 +700,53 @@
  
      // Check if there is additional data in the frame
      if (frame->length > 5) {
-         APIFrameDebugPrint("  Data: ");
          // Print the remaining data bytes
-         APIFrameDebugPrint("%s\n", &(frame->data[5]));
+         XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_API, "  Data: ", &(frame->data[5]), frame->length - 5);
      } else {
          APIFrameDebugPrint("  No additional data.\n");
      }
  }
  
- //Should be moved to be handled by user?
+ /**
+  * @brief Decodes a modem status frame into the instance's network state.
+  * 
+  * Joined/registered and left/unregistered reports update the state read by
+  * XBeeConnected() and fire the connect and disconnect callbacks on
+  * transitions. A hardware or watchdog reset takes the link down and
+  * forgets the shadowed and cached values, since the module lost its
+  * unsaved settings. Every status drops the cached network status.
+  * 
+  * @param[in] self Pointer to the XBee instance.
+  * @param[in] frame Pointer to the received modem status frame.
+  * 
+  * @return void This function does not return a value.
+  */
  void xbeeHandleModemStatus(XBee* self, xbee_api_frame_t *frame) {
-     (void)self;
-     if (frame->type != XBEE_API_TYPE_MODEM_STATUS) return;
- 
-     APIFrameDebugPrint("Modem Status: %d\n", frame->data[1]);
-     // Add further processing as needed
+     if (frame->type != XBEE_API_TYPE_MODEM_STATUS || frame->length < 2) return;
+ 
+     uint8_t status = frame->data[1];
+     APIFrameDebugPrint("Modem Status: %d\n", status);
+     self->modemStatus = status;
+     XBEE_CACHE_DROP(self, AT_FLAG_CACHE_STATUS | AT_FLAG_CACHE_LINK);
+ 
+     switch (status) {
+         case XBEE_MODEM_STATUS_WATCHDOG_RESET:
+             XBEE_LOG_WARN(XBEE_LOG_MODULE_API, "Module reset by its watchdog\n");
+             // fall through
+         case XBEE_MODEM_STATUS_HARDWARE_RESET:
+             XBEE_SHADOW_INVALIDATE(self);
+             XBEE_CACHE_RESET(self);
+             xbeeLinkStateSet(self, XBEE_LINK_DOWN);
+             break;
+         case XBEE_MODEM_STATUS_JOINED:
+             xbeeLinkStateSet(self, XBEE_LINK_UP);
+             break;
+         case XBEE_MODEM_STATUS_LEFT:
+             xbeeLinkStateSet(self, XBEE_LINK_DOWN);
+             break;
+         default:
+             break;
+     }
  }
  
  /**
@@ -38,6 +38,195 @@
  
  // AT Command Functions
  
+ /**
+  * @brief Every AT command with its two characters, in at_command_t order.
+  *
+  * Expanded into the name table and the reverse lookup table below. Module
+  * specific commands that reuse two characters are in AT_MODULE_COMMAND_LIST.
+  */
+ #define AT_COMMAND_LIST(X) \
+     /* XBee Common AT Commands */ \
+     X(AT_,  'A', 'T')   /* Placeholder for unspecified commands */ \
+     X(AT_CN, 'C', 'N')   /* Exit Command Mode */ \
+     X(AT_AP, 'A', 'P')   /* API Enable */ \
+     X(AT_BD, 'B', 'D')   /* Baud Rate */ \
+     X(AT_WR, 'W', 'R')   /* Write to non-volatile memory */ \
+     X(AT_RE, 'R', 'E')   /* Soft Reset */ \
+     X(AT_FR, 'F', 'R')   /* Factory Reset */ \
+     X(AT_VR, 'V', 'R')   /* Firmware Version */ \
+     X(AT_AC, 'A', 'C')   /* Apply Changes */ \
+     X(AT_NR, 'N', 'R')   /* Network Reset */ \
+     X(AT_DD, 'D', 'D')   /* Device Type Identifier */ \
+     X(AT_ID, 'I', 'D')   /* PAN ID */ \
+     X(AT_NI, 'N', 'I')   /* Node Identifier */ \
+     X(AT_DL, 'D', 'L')   /* Destination Address Low */ \
+     X(AT_DH, 'D', 'H')   /* Destination Address High */ \
+     X(AT_SH, 'S', 'H')   /* Serial Number High */ \
+     X(AT_SL, 'S', 'L')   /* Serial Number Low */ \
+     X(AT_PL, 'P', 'L')   /* Power Level */ \
+     X(AT_AI, 'A', 'I')   /* Association Indication */ \
+     X(AT_RP, 'R', 'P')   /* RSSI PWM Timer */ \
+     X(AT_RN, 'R', 'N')   /* Random Delay Slots */ \
+     X(AT_RR, 'R', 'R')   /* Retries */ \
+     X(AT_ND, 'N', 'D')   /* Node Discover */ \
+     X(AT_NO, 'N', 'O')   /* Network Discovery Options */ \
+     X(AT_RO, 'R', 'O')   /* Packetization Timeout */ \
+     X(AT_SM, 'S', 'M')   /* Sleep Mode */ \
+     X(AT_SO, 'S', 'O')   /* Sleep Options */ \
+     X(AT_SP, 'S', 'P')   /* Sleep Period */ \
+     X(AT_ST, 'S', 'T')   /* Time Before Sleep */ \
+     X(AT_IS, 'I', 'S')   /* Force Sample (IO) */ \
+     X(AT_P0, 'P', '0')   /* DIO0/AD0 Configuration */ \
+     X(AT_P1, 'P', '1')   /* DIO1/AD1 Configuration */ \
+     X(AT_P2, 'P', '2')   /* DIO2/AD2 Configuration */ \
+     X(AT_P3, 'P', '3')   /* DIO3/AD3 Configuration */ \
+     X(AT_P4, 'P', '4')   /* DIO4 Configuration */ \
+     X(AT_P5, 'P', '5')   /* DIO5 Configuration */ \
+     X(AT_P6, 'P', '6')   /* DIO6 Configuration */ \
+     X(AT_P7, 'P', '7')   /* DIO7 Configuration */ \
+     X(AT_P8, 'P', '8')   /* DIO8 Configuration */ \
+     X(AT_PR, 'P', 'R')   /* Pull-up Resistor Enable */ \
+     X(AT_RI, 'R', 'I')   /* Ring Indicator */ \
+     X(AT_CT, 'C', 'T')   /* Command Mode Timeout */ \
+     X(AT_GT, 'G', 'T')   /* Guard Times */ \
+     X(AT_SB, 'S', 'B')   /* Stop Bits */ \
+     X(AT_D7, 'D', '7')   /* DIO7 Configuration */ \
+     X(AT_D8, 'D', '8')   /* DIO8 Configuration */ \
+     X(AT_D9, 'D', '9')   /* DIO9 Configuration */ \
+     X(AT_DA, 'D', 'A')   /* DIO10 Configuration */ \
+     X(AT_DB, 'D', 'B')   /* RSSI for Last Hop */ \
+     X(AT_DC, 'D', 'C')   /* DIO Change Detect */ \
+     X(AT_FT, 'F', 'T')   /* Flow Control Threshold */ \
+     X(AT_GU, 'G', 'U')   /* DIO Pull-up Resistor Enable */ \
+     X(AT_HS, 'H', 'S')   /* Hardware Sleep Control */ \
+     X(AT_IT, 'I', 'T')   /* RSSI Timer */ \
+     X(AT_NJ, 'N', 'J')   /* Node Join Time */ \
+     X(AT_JN, 'J', 'N')   /* Join Notification */ \
+     X(AT_JT, 'J', 'T')   /* Join Time */ \
+     X(AT_JV, 'J', 'V')   /* Channel Verification */ \
+     X(AT_LD, 'L', 'D')   /* Node Discovery Time */ \
+     X(AT_AO, 'A', 'O')   /* API Options */ \
+     X(AT_HV, 'H', 'V')   /* Hardware Version */ \
+     /* XBee 3 RF Specific AT Commands */ \
+     X(AT_CE, 'C', 'E')   /* Coordinator Enable */ \
+     X(AT_SE, 'S', 'E')   /* Source Endpoint */ \
+     X(AT_CI, 'C', 'I')   /* Cluster Identifier */ \
+     X(AT_BH, 'B', 'H')   /* Broadcast Hops */ \
+     X(AT_YS, 'Y', 'S')   /* Sleep Status */ \
+     /* XBee 3 Cellular Specific AT Commands */ \
+     X(AT_IP, 'I', 'P')   /* IP Address */ \
+     X(AT_MA, 'M', 'A')   /* MAC Address */ \
+     X(AT_OK, 'O', 'K')   /* Cellular OK Command */ \
+     X(AT_SR, 'S', 'R')   /* Serial Number */ \
+     X(AT_TD, 'T', 'D')   /* Transmit Delay */ \
+     X(AT_TR, 'T', 'R')   /* Transmission Retry Count */ \
+     X(AT_TS, 'T', 'S')   /* Transmission Status */ \
+     X(AT_UK, 'U', 'K')   /* Unlock Password */ \
+     X(AT_VE, 'V', 'E')   /* Voltage Supply */ \
+     X(AT_VL, 'V', 'L')   /* Cellular Module Version */ \
+     X(AT_PN, 'P', 'N')   /* SIM PIN */ \
+     X(AT_AN, 'A', 'N')   /* APN */ \
+     X(AT_CP, 'C', 'P')   /* Carrier Profile */ \
+     X(AT_SD, 'S', 'D')   /* Shutdown */ \
+     /* XBee LR Specific AT Commands */ \
+     X(AT_DE, 'D', 'E')   /* LoRaWAN Device EUI */ \
+     X(AT_AK, 'A', 'K')   /* LoRaWAN Application Key */ \
+     X(AT_AE, 'A', 'E')   /* LoRaWAN Application EUI */ \
+     X(AT_NK, 'N', 'K')   /* LoRaWAN Network Key */ \
+     X(AT_JS, 'J', 'S')   /* LoRaWAN Join Status */ \
+     X(AT_LC, 'L', 'C')   /* LoRaWAN Class */ \
+     X(AT_AM, 'A', 'M')   /* LoRaWAN Activation Mode */ \
+     X(AT_AD, 'A', 'D')   /* LoRaWAN ADR */ \
+     X(AT_DR, 'D', 'R')   /* LoRaWAN DataRate */ \
+     X(AT_LR, 'L', 'R')   /* LoRaWAN Region */ \
+     X(AT_LV, 'L', 'V')   /* LoRaWAN Spec Version */ \
+     X(AT_J1, 'J', '1')   /* LoRaWAN Join RX1 Delay */ \
+     X(AT_J2, 'J', '2')   /* LoRaWAN Join RX2 Delay */ \
+     X(AT_D1, 'D', '1')   /* LoRaWAN RX1 Delay */ \
+     X(AT_D2, 'D', '2')   /* LoRaWAN RX2 Delay */ \
+     X(AT_XD, 'X', 'D')   /* LoRaWAN RX2 Data Rate */ \
+     X(AT_XF, 'X', 'F')   /* LoRaWAN RX2 Frequency */ \
+     X(AT_PO, 'P', 'O')   /* LoRaWAN Transmit Power */ \
+     X(AT_CM, 'C', 'M')   /* LoRaWAN Channels Mask */
+ 
+ /**
+  * @brief Module specific commands spelled like a command in AT_COMMAND_LIST.
+  *
+  * They have their own enum value and metadata. The perfect hash maps their
+  * two characters to the AT_COMMAND_LIST command; atCommandFromString() then
+  * swaps in the entry for the module the lookup is made for.
+  */
+ #define AT_MODULE_COMMAND_LIST(X) \
+     X(AT_DE_RF, 'D', 'E', AT_MODULE_3RF)        /* Destination Endpoint */ \
+     X(AT_WR_RF, 'W', 'R', AT_MODULE_3RF)        /* Write to non-volatile memory */ \
+     X(AT_RI_CELL, 'R', 'I', AT_MODULE_CELLULAR) /* Ring Indicator */
+ 
+ #define AT_NAME_ENTRY(command, c0, c1) [command] = { c0, c1, '\0' },
+ #define AT_MODULE_NAME_ENTRY(command, c0, c1, module) AT_NAME_ENTRY(command, c0, c1)
+ #define AT_MODULE_ENTRY(command, c0, c1, module) { command, module },
+ 
+ static const char atCommandNames[AT_COMMAND_COUNT][3] = {
+     AT_COMMAND_LIST(AT_NAME_ENTRY)
+     AT_MODULE_COMMAND_LIST(AT_MODULE_NAME_ENTRY)
+ };
+ 
+ static const struct {
+     uint8_t command;    ///< at_command_t
+     uint8_t module;     ///< at_module_t that spells it like a common command
+ } atModuleCommands[] = {
+     AT_MODULE_COMMAND_LIST(AT_MODULE_ENTRY)
+ };
+ 
+ /**
+  * @brief Row bases of the perfect hash used by atCommandFromString().
+  *
+  * Reverse lookup is a perfect hash: the slot of a command is the base of the
+  * row for its first character plus its second character. The row bases were
+  * chosen so that no two commands share a slot, and because the lookup table
+  * is built from AT_COMMAND_LIST with designated initializers, a command that
+  * collides is reported by the compiler (-Woverride-init) and by the unit
+  * tests. Pick a free base for the row when that happens.
+  */
+ #define AT_HASH_ROW(c) ( \
+     (c) == 'A' ? 25 : \
+     (c) == 'B' ? 2 : \
+     (c) == 'C' ? 62 : \
+     (c) == 'D' ? 0 : \
+     (c) == 'F' ? 54 : \
+     (c) == 'G' ? 12 : \
+     (c) == 'H' ? 62 : \
+     (c) == 'I' ? 90 : \
+     (c) == 'J' ? 71 : \
+     (c) == 'L' ? 13 : \
+     (c) == 'M' ? 10 : \
+     (c) == 'N' ? 33 : \
+     (c) == 'O' ? 2 : \
+     (c) == 'P' ? 35 : \
+     (c) == 'R' ? 83 : \
+     (c) == 'S' ? 50 : \
+     (c) == 'T' ? 42 : \
+     (c) == 'U' ? 3 : \
+     (c) == 'V' ? 68 : \
+     (c) == 'W' ? 41 : \
+     (c) == 'X' ? 3 : \
+     (c) == 'Y' ? 45 : 0)
+ #define AT_HASH(c0, c1) (AT_HASH_ROW(c0) + (c1) - '0')
+ #define AT_HASH_SIZE 133    ///< Largest row base plus one row of '0'..'Z'
+ #define AT_HASH_ENTRY(command, c0, c1) [AT_HASH(c0, c1)] = command,
+ 
+ static const uint8_t atHashRows['Z' - '0' + 1] = {
+     AT_HASH_ROW('0'), AT_HASH_ROW('1'), AT_HASH_ROW('2'), AT_HASH_ROW('3'), AT_HASH_ROW('4'), AT_HASH_ROW('5'), AT_HASH_ROW('6'), AT_HASH_ROW('7'),
+     AT_HASH_ROW('8'), AT_HASH_ROW('9'), AT_HASH_ROW(':'), AT_HASH_ROW(';'), AT_HASH_ROW('<'), AT_HASH_ROW('='), AT_HASH_ROW('>'), AT_HASH_ROW('?'),
+     AT_HASH_ROW('@'), AT_HASH_ROW('A'), AT_HASH_ROW('B'), AT_HASH_ROW('C'), AT_HASH_ROW('D'), AT_HASH_ROW('E'), AT_HASH_ROW('F'), AT_HASH_ROW('G'),
+     AT_HASH_ROW('H'), AT_HASH_ROW('I'), AT_HASH_ROW('J'), AT_HASH_ROW('K'), AT_HASH_ROW('L'), AT_HASH_ROW('M'), AT_HASH_ROW('N'), AT_HASH_ROW('O'),
+     AT_HASH_ROW('P'), AT_HASH_ROW('Q'), AT_HASH_ROW('R'), AT_HASH_ROW('S'), AT_HASH_ROW('T'), AT_HASH_ROW('U'), AT_HASH_ROW('V'), AT_HASH_ROW('W'),
+     AT_HASH_ROW('X'), AT_HASH_ROW('Y'), AT_HASH_ROW('Z'),
+ };
+ 
+ static const uint8_t atHashSlots[AT_HASH_SIZE] = {
+     AT_COMMAND_LIST(AT_HASH_ENTRY)
+ };
+ 
  /**
   * @brief Converts an AT command enum to its string representation.
   * 
@@ -46,125 +235,203 @@
   * 
   * @param[in] command The AT command enum value.
   * 
-  * @return The string representation of the AT command.
+  * @return The string representation of the AT command, or NULL if the value is not a command.
   */
  const char* atCommandToString(at_command_t command) {
-     switch (command) {
-         /**< XBee Common AT Commands */
-         case AT_: return "AT";              ///< Placeholder for unspecified commands
-         case AT_CN: return "CN";            ///< Exit Command Mode
-         case AT_AP: return "AP";            ///< API Enable
-         case AT_BD: return "BD";            ///< Baud Rate
-         case AT_WR: return "WR";            ///< Write to non-volatile memory
-         case AT_RE: return "RE";            ///< Soft Reset
-         case AT_FR: return "FR";            ///< Factory Reset
-         case AT_VR: return "VR";            ///< Firmware Version
-         case AT_AC: return "AC";            ///< Apply Changes
-         case AT_NR: return "NR";            ///< Network Reset
-         case AT_DD: return "DD";            ///< Device Type Identifier
-         case AT_ID: return "ID";            ///< PAN ID
-         case AT_NI: return "NI";            ///< Node Identifier
-         case AT_DL: return "DL";            ///< Destination Address Low
-         case AT_DH: return "DH";            ///< Destination Address High
-         case AT_SH: return "SH";            ///< Serial Number High
-         case AT_SL: return "SL";            ///< Serial Number Low
-         case AT_PL: return "PL";            ///< Power Level
-         case AT_AI: return "AI";            ///< Association Indication
-         case AT_RP: return "RP";            ///< RSSI PWM Timer
-         case AT_RN: return "RN";            ///< Random Delay Slots
-         case AT_RR: return "RR";            ///< Retries
-         case AT_ND: return "ND";            ///< Node Discover
-         case AT_NO: return "NO";            ///< Network Discovery Options
-         case AT_RO: return "RO";            ///< Packetization Timeout
-         case AT_SM: return "SM";            ///< Sleep Mode
-         case AT_SO: return "SO";            ///< Sleep Options
-         case AT_SP: return "SP";            ///< Sleep Period
-         case AT_ST: return "ST";            ///< Time Before Sleep
-         case AT_IS: return "IS";            ///< Force Sample (IO)
-         case AT_P0: return "P0";            ///< DIO0/AD0 Configuration
-         case AT_P1: return "P1";            ///< DIO1/AD1 Configuration
-         case AT_P2: return "P2";            ///< DIO2/AD2 Configuration
-         case AT_P3: return "P3";            ///< DIO3/AD3 Configuration
-         case AT_P4: return "P4";            ///< DIO4 Configuration
-         case AT_P5: return "P5";            ///< DIO5 Configuration
-         case AT_P6: return "P6";            ///< DIO6 Configuration
-         case AT_P7: return "P7";            ///< DIO7 Configuration
-         case AT_P8: return "P8";            ///< DIO8 Configuration
-         case AT_PR: return "PR";            ///< Pull-up Resistor Enable
-         case AT_RI: return "RI";            ///< Ring Indicator
-         case AT_CT: return "CT";            ///< Command Mode Timeout
-         case AT_GT: return "GT";            ///< Guard Times
-         case AT_SB: return "SB";            ///< Stop Bits
-         case AT_D7: return "D7";            ///< DIO7 Configuration
-         case AT_D8: return "D8";            ///< DIO8 Configuration
-         case AT_D9: return "D9";            ///< DIO9 Configuration
-         case AT_DA: return "DA";            ///< DIO10 Configuration
-         case AT_DB: return "DB";            ///< RSSI for Last Hop
-         case AT_DC: return "DC";            ///< DIO Change Detect
-         case AT_FT: return "FT";            ///< Flow Control Threshold
-         case AT_GU: return "GU";            ///< DIO Pull-up Resistor Enable
-         case AT_HS: return "HS";            ///< Hardware Sleep Control
-         case AT_IT: return "IT";            ///< RSSI Timer
-         case AT_NJ: return "NJ";            ///< Node Join Time
-         case AT_JN: return "JN";            ///< Join Notification
-         case AT_JT: return "JT";            ///< Join Time
-         case AT_JV: return "JV";            ///< Channel Verification
-         case AT_LD: return "LD";            ///< Node Discovery Time
-         case AT_AO: return "AO";            ///< API Options
-         case AT_HV: return "HV";            ///< Hardware Version
+     if ((unsigned)command >= AT_COMMAND_COUNT) {
+         return NULL;
+     }
+     return atCommandNames[command];
+ }
+ 
+ /**
+  * @brief Swaps a common command for the module's own command of the same name.
+  */
+ static uint8_t atModuleCommand(uint8_t module, uint8_t common) {
+     if (module == AT_MODULE_COMMON) return common;
+     for (uint8_t i = 0; i < sizeof(atModuleCommands) / sizeof(atModuleCommands[0]); i++) {
+         uint8_t command = atModuleCommands[i].command;
+         if (atModuleCommands[i].module == module &&
+             atCommandNames[command][0] == atCommandNames[common][0] &&
+             atCommandNames[command][1] == atCommandNames[common][1]) {
+             return command;
+         }
+     }
+     return common;
+ }
+ 
+ /**
+  * @brief Converts two command characters, e.g. from an AT response frame, to the enum.
+  *
+  * Characters shared by several commands map to the one `module` means by
+  * them: "DE" is AT_DE_RF on AT_MODULE_3RF and AT_DE everywhere else.
+  *
+  * @param[in]  module  The at_module_t the characters come from, e.g. XBee::atModule.
+  * @param[in]  name    The two command characters; no terminator is needed.
+  * @param[out] command Receives the AT command enum value; may be NULL.
+  *
+  * @return bool True if the characters name a known command, otherwise false.
+  */
+ bool atCommandFromString(uint8_t module, const char* name, at_command_t* command) {
+     if (!name) return false;
+ 
+     unsigned row = (unsigned char)name[0] - '0';
+     unsigned col = (unsigned char)name[1] - '0';
+     if (row > 'Z' - '0' || col > 'Z' - '0') return false;
+ 
+     uint8_t found = atHashSlots[atHashRows[row] + col];
+     if (atCommandNames[found][0] != name[0] || atCommandNames[found][1] != name[1]) {
+         return false;
+     }
+     if (command) *command = (at_command_t)atModuleCommand(module, found);
+     return true;
+ }
+ 
+ /**
+  * @brief Returns the command `module` answers a request for `command` with.
+  *
+  * This is `command` itself unless another command of the same name belongs
+  * to the module, e.g. AT_WR_RF for AT_WR on AT_MODULE_3RF, so responses
+  * routed with atCommandFromString() can be compared to the request by enum.
+  *
+  * @param[in] module  The at_module_t the request is sent to.
+  * @param[in] command The AT command enum value.
+  *
+  * @return at_command_t The module's command, or AT_COMMAND_COUNT if `command` is not a command.
+  */
+ at_command_t atCommandForModule(uint8_t module, at_command_t command) {
+     at_command_t found;
+     if (!atCommandFromString(module, atCommandToString(command), &found)) return AT_COMMAND_COUNT;
+     return found;
+ }
+ 
+ #define AT_EXEC(cmd, lat) \
+     [cmd] = { .name = atCommandNames[cmd], .type = AT_TYPE_NONE, .latency = lat }
+ #define AT_UINT(cmd, w, lo, hi, fl) \
+     [cmd] = { .name = atCommandNames[cmd], .type = AT_TYPE_UINT, .width = w, .flags = fl, .min = lo, .max = hi }
+ #define AT_BYTES(cmd, w, fl) \
+     [cmd] = { .name = atCommandNames[cmd], .type = AT_TYPE_BYTES, .width = w, .flags = fl }
+ #define AT_STRING(cmd, w, fl) \
+     [cmd] = { .name = atCommandNames[cmd], .type = AT_TYPE_STRING, .width = w, .flags = (fl) | AT_FLAG_VARIABLE }
+ 
+ /**
+  * @brief Parameter metadata indexed by at_command_t.
+  *
+  * Commands without an entry are not available through XBeeAtGet() and
+  * XBeeAtSet(); atCommandInfo() returns NULL for them.
+  */
+ static const at_command_info_t atCommandTable[] = {
+     /**< XBee Common AT Commands */
+     AT_EXEC(AT_CN, AT_LATENCY_REGISTER),
+     AT_UINT(AT_AP, 1, 0, 2, 0),
+     AT_UINT(AT_BD, 4, 0, UINT32_MAX, AT_FLAG_VARIABLE),   ///< Rate code or non-standard rate
+     AT_EXEC(AT_WR, AT_LATENCY_FLASH),
+     AT_EXEC(AT_RE, AT_LATENCY_FLASH),
+     AT_EXEC(AT_FR, AT_LATENCY_FLASH),
+     AT_UINT(AT_VR, 4, 0, UINT32_MAX, AT_FLAG_VARIABLE | AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATIC),
+     AT_EXEC(AT_AC, AT_LATENCY_APPLY),
+     AT_EXEC(AT_NR, AT_LATENCY_APPLY),
+     AT_UINT(AT_DD, 4, 0, UINT32_MAX, AT_FLAG_VARIABLE),
+     AT_STRING(AT_NI, 20, 0),
+     AT_UINT(AT_DL, 4, 0, UINT32_MAX, 0),
+     AT_UINT(AT_DH, 4, 0, UINT32_MAX, 0),
+     AT_UINT(AT_SH, 4, 0, UINT32_MAX, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATIC),
+     AT_UINT(AT_SL, 4, 0, UINT32_MAX, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATIC),
+     AT_UINT(AT_PL, 1, 0, 4, 0),
+     AT_UINT(AT_AI, 1, 0, UINT8_MAX, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATUS),
+     AT_UINT(AT_DB, 1, 0, UINT8_MAX, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_LINK),
+     AT_UINT(AT_DC, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_AO, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_HV, 2, 0, UINT16_MAX, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATIC),
 
+     /**< XBee 3 RF Specific AT Commands */
+     AT_BYTES(AT_ID, 8, AT_FLAG_VARIABLE),     ///< 64-bit on Zigbee, 16-bit on DigiMesh and 802.15.4
+     AT_UINT(AT_CE, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_DE_RF, 1, 0, UINT8_MAX, 0),
+     AT_EXEC(AT_WR_RF, AT_LATENCY_FLASH),
+     AT_UINT(AT_BH, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_NO, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_LD, 2, 0, UINT16_MAX, AT_FLAG_VARIABLE),    ///< 100 ms units
+     AT_BYTES(AT_IS, 22, AT_FLAG_READ_ONLY | AT_FLAG_VARIABLE),  ///< One sample set, see XBee3RFIoDecode()
+     AT_UINT(AT_P0, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P1, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P2, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P3, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P4, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P5, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P6, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P7, 1, 0, UINT8_MAX, 0),
+     AT_UINT(AT_P8, 1, 0, UINT8_MAX, 0),
+ 
+     /**< XBee 3 Cellular Specific AT Commands */
+     AT_STRING(AT_PN, 8, AT_FLAG_WRITE_ONLY),
+     AT_STRING(AT_AN, 100, 0),
+ 
+     /**< XBee LR Specific AT Commands */
+     AT_BYTES(AT_DE, 8, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATIC),   ///< DevEUI
+     AT_BYTES(AT_AK, 16, AT_FLAG_WRITE_ONLY),
+     AT_BYTES(AT_AE, 8, 0),
+     AT_BYTES(AT_NK, 16, AT_FLAG_WRITE_ONLY),
+     AT_UINT(AT_JS, 1, 0, 1, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATUS),
+     AT_UINT(AT_LC, 1, 'A', 'C', 0),
+     AT_UINT(AT_AM, 1, 0, 1, 0),
+     AT_UINT(AT_AD, 1, 0, 1, 0),
+     AT_UINT(AT_DR, 1, 0, 15, 0),
+     AT_UINT(AT_LR, 1, 0, UINT8_MAX, 0),
+     AT_STRING(AT_LV, 16, AT_FLAG_READ_ONLY | AT_FLAG_CACHE_STATIC),
+     AT_UINT(AT_J1, 4, 0, UINT32_MAX, 0),     ///< Milliseconds
+     AT_UINT(AT_J2, 4, 0, UINT32_MAX, 0),     ///< Milliseconds
+     AT_UINT(AT_D1, 4, 0, UINT32_MAX, 0),     ///< Milliseconds
+     AT_UINT(AT_D2, 4, 0, UINT32_MAX, 0),     ///< Milliseconds
+     AT_UINT(AT_XD, 1, 0, 15, 0),
+     AT_UINT(AT_XF, 4, 0, UINT32_MAX, 0),     ///< Hz
+     AT_UINT(AT_PO, 1, 0, UINT8_MAX, 0),
+     AT_BYTES(AT_CM, 16, AT_FLAG_VARIABLE),
+ };
  
-         /**< XBee 3 RF Specific AT Commands */
-         case AT_CE: return "CE";            ///< Coordinator Enable
-         case AT_SE: return "SE";            ///< Source Endpoint
-         case AT_DE_RF: return "DE";         ///< Destination Endpoint (RF specific)
-         case AT_CI: return "CI";            ///< Cluster Identifier
-         case AT_BH: return "BH";            ///< Broadcast Hops
-         case AT_YS: return "YS";            ///< Sleep Status
-         case AT_WR_RF: return "WR";         ///< Write to non-volatile memory (RF specific)
- 
-         /**< XBee 3 Cellular Specific AT Commands */
-         case AT_IP: return "IP";            ///< IP Address
-         case AT_MA: return "MA";            ///< MAC Address
-         case AT_OK: return "OK";            ///< Cellular OK Command
-         case AT_RI_CELL: return "RI";       ///< Ring Indicator (Cellular Specific)
-         case AT_SR: return "SR";            ///< Serial Number
-         case AT_TD: return "TD";            ///< Transmit Delay
-         case AT_TR: return "TR";            ///< Transmission Retry Count
-         case AT_TS: return "TS";            ///< Transmission Status
-         case AT_UK: return "UK";            ///< Unlock Password
-         case AT_VE: return "VE";            ///< Voltage Supply
-         case AT_VL: return "VL";            ///< Cellular Module Version
-         case AT_PN: return "PN";     ///< SIM PIN
-         case AT_AN: return "AN";     ///< APN
-         case AT_CP: return "CP";     ///< Carrier Profile
-         case AT_SD: return "SD";     ///< Shutdown
-        
-         /**< XBee LR Specific AT Commands */
-         case AT_DE: return "DE";            ///< LoRaWAN Device EUI
-         case AT_AK: return "AK";            ///< LoRaWAN Application Key
-         case AT_AE: return "AE";            ///< LoRaWAN Application EUI
-         case AT_NK: return "NK";            ///< LoRaWAN Network Key
-         case AT_JS: return "JS";            ///< LoRaWAN Join Status
-         case AT_LC: return "LC";            ///< LoRaWAN Class
-         case AT_AM: return "AM";            ///< LoRaWAN Activation Mode
-         case AT_AD: return "AD";            ///< LoRaWAN ADR
-         case AT_DR: return "DR";            ///< LoRaWAN DataRate
-         case AT_LR: return "LR";            ///< LoRaWAN Region
-        // case AT_DC: return "DC";            ///< LoRaWAN Duty Cycle        
-         case AT_LV: return "LV";            ///< LoRaWAN Spec Version     
-         case AT_J1: return "J1";            ///< LoRaWAN Join RX1 Delay        
-         case AT_J2: return "J2";            ///< LoRaWAN Join RX2 Delay
-         case AT_D1: return "D1";            ///< LoRaWAN RX1 Delay
-         case AT_D2: return "D2";            ///< LoRaWAN RX2 Delay
-         case AT_XD: return "XD";            ///< LoRaWAN RX2 Data Rate
-         case AT_XF: return "XF";            ///< LoRaWAN RX2 Frequency   
-         case AT_PO: return "PO";            ///< LoRaWAN Transmit Power   
-         case AT_CM: return "CM";            ///< LoRaWAN Channels Mask
- 
-         default: return NULL;               ///< Unknown command
+ /**
+  * @brief Returns the parameter metadata for an AT command.
+  *
+  * @param[in] command The AT command enum value.
+  *
+  * @return const at_command_info_t* The table entry, or NULL if the command has none.
+  */
+ const at_command_info_t* atCommandInfo(at_command_t command) {
+     if ((unsigned)command >= sizeof(atCommandTable) / sizeof(atCommandTable[0])) {
+         return NULL;
      }
+     const at_command_info_t* info = &atCommandTable[command];
+     return info->name ? info : NULL;
  }
  
+ /**
+  * @brief Returns the latency class of an AT command.
+  *
+  * Commands without metadata are in the flash class, the slowest of the three.
+  *
+  * @param[in] command The AT command enum value.
+  *
+  * @return uint8_t The at_latency_t class.
+  */
+ uint8_t atCommandLatency(at_command_t command) {
+     const at_command_info_t* info = atCommandInfo(command);
+     return info ? info->latency : AT_LATENCY_FLASH;
+ }
  
- 
\ No newline at end of file
+ /**
+  * @brief Returns the default response timeout for an AT command from its latency class.
+  *
+  * Commands without metadata get the flash timeout, the longest of the three.
+  * XBeeAtTimeout() refines this per instance from observed round trips.
+  *
+  * @param[in] command The AT command enum value.
+  *
+  * @return uint32_t Timeout in milliseconds.
+  */
+ uint32_t atCommandTimeout(at_command_t command) {
+     switch (atCommandLatency(command)) {
+         case AT_LATENCY_REGISTER: return XBEE_AT_TIMEOUT_REGISTER_MS;
+         case AT_LATENCY_APPLY: return XBEE_AT_TIMEOUT_APPLY_MS;
+         default: return XBEE_AT_TIMEOUT_FLASH_MS;
+     }
+ }
@@ -0,0 +1,130 @@
+/**
+ * @file xbee_cache.c
+ * @brief Per-instance cache of polled AT reads.
+ *
+ * This file implements the cache entries declared in xbee_cache.h and the
+ * XBeeCacheInvalidate() accessor declared in xbee.h. The lookup itself is
+ * part of the AT read path in xbee.c.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_cache.h"
+#include "xbee.h"
+#include <string.h>
+
+#if XBEE_CACHE_ENABLED
+
+/**
+ * @brief Forgets every cached value; used by the reset calls.
+ *
+ * Entries with a query pending stay in place so the caller waiting on them
+ * keeps a valid pointer, but their response will not be cached.
+ */
+void xbeeCacheReset(XBeeCache_t* cache) {
+    xbeeCacheDrop(cache, AT_FLAG_CACHE);
+}
+
+/**
+ * @brief Marks unknown the cached values of commands with any of `flags`.
+ */
+void xbeeCacheDrop(XBeeCache_t* cache, uint8_t flags) {
+    for (uint8_t i = 0; i < cache->count; i++) {
+        XBeeCacheEntry_t* entry = &cache->entries[i];
+        if (!(entry->flags & flags)) continue;
+        entry->length = 0;
+        if (entry->state & XBEE_CACHE_PENDING) entry->state |= XBEE_CACHE_DROPPED;
+    }
+}
+
+/**
+ * @brief Returns the entry caching `command`, adding it if needed.
+ *
+ * @return XBeeCacheEntry_t* The entry, or NULL if the cache is full.
+ */
+XBeeCacheEntry_t* xbeeCacheTrack(XBeeCache_t* cache, at_command_t command, uint8_t flags) {
+    XBeeCacheEntry_t* slot = NULL;
+
+    for (uint8_t i = 0; i < cache->count; i++) {
+        XBeeCacheEntry_t* entry = &cache->entries[i];
+        if (entry->command == (uint8_t)command) return entry;
+        if (!slot && entry->length == 0 && entry->state == 0) slot = entry;
+    }
+    if (!slot) {
+        if (cache->count >= XBEE_CACHE_ENTRIES) return NULL;
+        slot = &cache->entries[cache->count++];
+    }
+    slot->command = (uint8_t)command;
+    slot->flags = flags & AT_FLAG_CACHE;
+    slot->state = 0;
+    slot->length = 0;
+    return slot;
+}
+
+/**
+ * @brief True if the entry holds a value that is still within its TTL at `now`.
+ */
+bool xbeeCacheFresh(const XBeeCacheEntry_t* entry, uint32_t now) {
+    if (entry->length == 0) return false;
+    if (entry->flags & AT_FLAG_CACHE_STATIC) return true;
+
+    uint32_t ttl = (entry->flags & AT_FLAG_CACHE_STATUS) ? XBEE_CACHE_TTL_STATUS_MS : XBEE_CACHE_TTL_LINK_MS;
+    return now - entry->storedAt < ttl;
+}
+
+/**
+ * @brief Records a value just read from the module.
+ *
+ * Values longer than XBEE_CACHE_VALUE_MAX are not cached.
+ */
+void xbeeCacheStore(XBeeCacheEntry_t* entry, const uint8_t* value, uint8_t length, uint32_t now) {
+    if (length > XBEE_CACHE_VALUE_MAX) {
+        entry->length = 0;
+        return;
+    }
+    memcpy(entry->value, value, length);
+    entry->length = length;
+    entry->storedAt = now;
+}
+
+#endif // XBEE_CACHE_ENABLED
+
+/**
+ * @brief Forgets every cached AT read so the next call queries the module.
+ *
+ * Resets and modem status frames already invalidate the cache; call this
+ * after changing the module by other means, such as a firmware update.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ */
+void XBeeCacheInvalidate(XBee* self) {
+#if XBEE_CACHE_ENABLED
+    if (!self) return;
+    xbeeCacheReset(&self->cache);
+#else
+    (void)self;
+#endif
+}
@@ -32,6 +32,7 @@
  * @contact felix.galindo@digi.com
  ******************************************************************************/
 
+#define XBEE_LOG_MODULE XBEE_LOG_MODULE_CELLULAR
 #include "xbee_cellular.h"
 #include "xbee_api_frames.h"
 #include <stdlib.h>
@@ -57,7 +58,8 @@ bool XBeeCellularInit(XBee* self, uint32_t baudRate, void* device) {
 /**
  * @brief Determines if the XBee Cellular module is connected to a network.
  *
- * Sends AT command `AI` to check for network registration.
+ * Sends AT command `AI` to check for network registration and records the
+ * answer as the network state read by XBeeConnected().
  *
  * @param[in] self Pointer to the XBee instance.
  *
@@ -65,10 +67,12 @@ bool XBeeCellularInit(XBee* self, uint32_t baudRate, void* device) {
  * @todo Add support for non-blocking connection attempts.
  ******************************************************************************/
 bool XBeeCellularConnected(XBee* self) {
-    uint8_t response = 0;
-    uint8_t responseLength;
-    int status = apiSendAtCommandAndGetResponse(self, AT_AI, NULL, 0, &response, &responseLength, 5000, sizeof(response));
-    return (status == API_SEND_SUCCESS && response == 0);
+    uint32_t status;
+
+    // A failed query leaves the recorded state alone
+    if (!XBeeAtGet(self, AT_AI, &status)) return false;
+    xbeeLinkStateSet(self, status == 0 ? XBEE_LINK_UP : XBEE_LINK_DOWN);
+    return status == 0;
 }
 
 /*****************************************************************************/
@@ -101,15 +105,18 @@ bool XBeeCellularConnect(XBee* self, bool blocking) {
     if (!blocking) return true;
 
     XBEEDebugPrint("Waiting for network attach...\n");
+    XBEE_TRACE_START(self, traceStart);
     for (int i = 0; i < 60; ++i) {
         if (XBeeCellularConnected(self)) {
             XBEEDebugPrint("Successfully attached to cellular network.\n");
+            XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_ATTACH, 0);
             return true;
         }
         self->htable->PortDelay(1000);
     }
+    XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_ATTACH, 0);
 
-    XBEEDebugPrint("Network attach failed.\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "Network attach failed.\n");
     return false;
 }
 
@@ -137,9 +144,13 @@ bool XBeeCellularDisconnect(XBee* self) {
  ******************************************************************************/
 uint8_t XBeeCellularSendPacket(XBee* self, const void* data) {
     XBeeCellularPacket_t* packet = (XBeeCellularPacket_t*) data;
-    uint8_t frame[128];
+    uint8_t frame[XBEE_CELLULAR_TX_FRAME_SIZE];
     uint8_t frameId = self->frameIdCntr;
-    uint8_t offset = 0;
+    uint16_t offset = 0;
+    if (packet->payloadSize > sizeof(frame) - 8) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Payload of %u bytes exceeds XBEE_CELLULAR_TX_FRAME_SIZE\n", packet->payloadSize);
+        return 0xFF;
+    }
 
     frame[offset++] = frameId;
     frame[offset++] = packet->protocol;
@@ -223,7 +234,7 @@ bool XBeeCellularConfigure(XBee* self, const void* config) {
  ******************************************************************************/
 static void XBeeCellularHandleRxPacket(XBee* self, void* param) {
     if (!param) {
-        XBEEDebugPrint("HandleRxPacket: Null parameter received\n");
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "HandleRxPacket: Null parameter received\n");
         return;
     }
 
@@ -231,7 +242,7 @@ static void XBeeCellularHandleRxPacket(XBee* self, void* param) {
 
     if (frame->type != XBEE_API_TYPE_CELLULAR_SOCKET_RX &&
         frame->type != XBEE_API_TYPE_CELLULAR_SOCKET_RX_FROM) {
-        XBEEDebugPrint("HandleRxPacket: Unexpected frame type 0x%02X\n", frame->type);
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "HandleRxPacket: Unexpected frame type 0x%02X\n", frame->type);
         return;
     }
 
@@ -239,7 +250,7 @@ static void XBeeCellularHandleRxPacket(XBee* self, void* param) {
 
     if ((frame->type == XBEE_API_TYPE_CELLULAR_SOCKET_RX && frame->length < 3) ||
         (frame->type == XBEE_API_TYPE_CELLULAR_SOCKET_RX_FROM && frame->length < 9)) {
-        XBEEDebugPrint("HandleRxPacket: Frame too short to be valid\n");
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "HandleRxPacket: Frame too short to be valid\n");
         return;
     }
 
@@ -273,22 +284,13 @@ static void XBeeCellularHandleRxPacket(XBee* self, void* param) {
                    frameId, socketId, status);
     XBEEDebugPrint("HandleRxPacket: Payload size: %u bytes\n", packet.payloadSize);
 
-    XBEEDebugPrint("[Payload HEX Dump]:\n");
-    for (int i = 0; i < packet.payloadSize && i < 64; ++i) {
-        XBEEDebugPrint("%02X ", packet.payload[i]);
-    }
-    if (packet.payloadSize > 64) XBEEDebugPrint("... [truncated]\n");
-    else XBEEDebugPrint("\n");
-
-    XBEEDebugPrint("[Payload ASCII Dump]:\n");
-    for (int i = 0; i < packet.payloadSize && i < 64; ++i) {
-        char c = packet.payload[i];
-        XBEEDebugPrint("%c", (c >= 32 && c <= 126) ? c : '.');
-    }
-    XBEEDebugPrint("\n");
+    XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE, "Payload HEX: ", packet.payload, packet.payloadSize);
+    XBEE_LOG_TEXT(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE, "Payload ASCII: ", packet.payload, packet.payloadSize);
 
     if (self->ctable && self->ctable->OnReceiveCallback) {
+        XBEE_TRACE_START(self, traceStart);
         self->ctable->OnReceiveCallback(self, &packet);
+        XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_RECEIVE);
     }
 }
 
@@ -310,21 +312,54 @@ static const XBeeVTable XBeeCellularVTable = {
     .configure = XBeeCellularConfigure
 };
 
+/*****************************************************************************/
+/**
+ * @brief Initializes an XBeeCellular instance in storage provided by the caller.
+ *
+ * The storage is cleared first. A static `XBeeCellular` gives an instance
+ * that takes no heap, with a footprint fixed at build time by config.h.
+ *
+ * @param[out] storage Memory for the instance; must outlive its use.
+ * @param[in] cTable Callback table for RX/TX handlers.
+ * @param[in] hTable Platform-specific HAL interface table.
+ *
+ * @return `storage`, or NULL if `storage` is NULL.
+ ******************************************************************************/
+XBeeCellular* XBeeCellularInitStatic(XBeeCellular* storage, const XBeeCTable* cTable, const XBeeHTable* hTable) {
+    if (!storage) return NULL;
+    memset(storage, 0, sizeof(*storage));
+    storage->base.vtable = &XBeeCellularVTable;
+    storage->base.ctable = cTable;
+    storage->base.htable = hTable;
+    storage->base.framePool = storage->framePool;
+    storage->base.framePoolSize = sizeof(storage->framePool);
+    storage->base.maxFrameDataSize = XBEE_CELLULAR_MAX_FRAME_DATA_SIZE;
+    storage->base.atModule = AT_MODULE_CELLULAR;
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+    xbeeTimeoutReset(&storage->base.atTimeouts);
+#endif
+    return storage;
+}
+
+#if !XBEE_NO_HEAP
 /*****************************************************************************/
 /**
  * @brief Allocates and initializes a new XBeeCellular instance.
  *
+ * Not available in XBEE_NO_HEAP builds; see XBeeCellularInitStatic().
+ *
  * @param[in] cTable Callback table for RX/TX handlers.
  * @param[in] hTable Platform-specific HAL interface table.
  *
- * @return Pointer to the new XBeeCellular instance.
+ * @return Pointer to the new XBeeCellular instance, or NULL if the allocation failed.
  ******************************************************************************/
 XBeeCellular* XBeeCellularCreate(const XBeeCTable* cTable, const XBeeHTable* hTable) {
     XBeeCellular* instance = (XBeeCellular*)malloc(sizeof(XBeeCellular));
-    instance->base.vtable = &XBeeCellularVTable;
-    instance->base.ctable = cTable;
-    instance->base.htable = hTable;
-    return instance;
+    if (!instance) {
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Unable to allocate an XBeeCellular instance\n");
+        return NULL;
+    }
+    return XBeeCellularInitStatic(instance, cTable, hTable);
 }
 
 /*****************************************************************************/
@@ -336,6 +371,7 @@ XBeeCellular* XBeeCellularCreate(const XBeeCTable* cTable, const XBeeHTable* hTa
 void XBeeCellularDestroy(XBeeCellular* self) {
     free(self);
 }
+#endif
 
 /*****************************************************************************/
 /**
@@ -359,7 +395,7 @@ bool XBeeCellularSocketCreate(XBee* self, uint8_t protocol, uint8_t* socketIdOut
 
     // Send SOCKET_CREATE request
     if (apiSendFrame(self, XBEE_API_TYPE_CELLULAR_SOCKET_CREATE, frame, 2) != API_SEND_SUCCESS) {
-        XBEEDebugPrint("Socket Create: Failed to send frame\n");
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "Socket Create: Failed to send frame\n");
         return false;
     }
 
@@ -380,14 +416,14 @@ bool XBeeCellularSocketCreate(XBee* self, uint8_t protocol, uint8_t* socketIdOut
                 XBEEDebugPrint("Socket Create: Assigned socket ID %u\n", socketId);
                 return true;
             } else {
-                XBEEDebugPrint("Socket Create: Failed, status 0x%02X\n", status);
+                XBEE_LOG_WARN(XBEE_LOG_MODULE, "Socket Create: Failed, status 0x%02X\n", status);
                 return false;
             }
         }
         self->htable->PortDelay(10);
     }
 
-    XBEEDebugPrint("Socket Create: Timed out waiting for response\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "Socket Create: Timed out waiting for response\n");
     return false;
 }
 
@@ -414,8 +450,8 @@ bool XBeeCellularSocketCreate(XBee* self, uint8_t protocol, uint8_t* socketIdOut
 bool XBeeCellularSocketConnect(XBee* self, uint8_t socketId, const void* addr, uint16_t port, bool isString) {
     if (!self || !addr) return false;
 
-    uint8_t frame[128];
-    uint8_t offset = 0;
+    uint8_t frame[XBEE_CELLULAR_TX_FRAME_SIZE];
+    uint16_t offset = 0;
     uint8_t frameId = self->frameIdCntr++;
 
     frame[offset++] = frameId;
@@ -441,7 +477,7 @@ bool XBeeCellularSocketConnect(XBee* self, uint8_t socketId, const void* addr, u
 
     // Send the SOCKET_CONNECT frame
     if (apiSendFrame(self, XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT, frame, offset) != API_SEND_SUCCESS) {
-        XBEEDebugPrint("SocketConnect: Failed to send connect frame\n");
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketConnect: Failed to send connect frame\n");
         return false;
     }
 
@@ -459,14 +495,14 @@ bool XBeeCellularSocketConnect(XBee* self, uint8_t socketId, const void* addr, u
                 XBEEDebugPrint("SocketConnect: Connect response OK\n");
                 goto wait_for_status;
             } else {
-                XBEEDebugPrint("SocketConnect: Connect failed - status 0x%02X\n", response.data[2]);
+                XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketConnect: Connect failed - status 0x%02X\n", response.data[2]);
                 return false;
             }
         }
         self->htable->PortDelay(10);
     }
 
-    XBEEDebugPrint("SocketConnect: Timed out waiting for connect response\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketConnect: Timed out waiting for connect response\n");
     return false;
 
 wait_for_status:
@@ -480,14 +516,14 @@ wait_for_status:
                 XBEEDebugPrint("SocketConnect: Socket status CONNECTED\n");
                 return true;
             } else {
-                XBEEDebugPrint("SocketConnect: Unexpected socket status 0x%02X\n", response.data[2]);
+                XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketConnect: Unexpected socket status 0x%02X\n", response.data[2]);
                 return false;
             }
         }
         self->htable->PortDelay(10);
     }
 
-    XBEEDebugPrint("SocketConnect: Timed out waiting for socket status\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketConnect: Timed out waiting for socket status\n");
     return false;
 }
 
@@ -505,10 +541,10 @@ wait_for_status:
  * @return true if send was accepted, false otherwise.
  ******************************************************************************/
 bool XBeeCellularSocketSend(XBee* self, uint8_t socketId, const uint8_t* payload, uint16_t payloadLen) {
-    if (!payload || payloadLen == 0 || payloadLen > 120) return false;
+    uint8_t frame[XBEE_CELLULAR_TX_FRAME_SIZE];
+    if (!payload || payloadLen == 0 || payloadLen > sizeof(frame) - 3) return false;
 
-    uint8_t frame[128];
-    uint8_t offset = 0;
+    uint16_t offset = 0;
     frame[offset++] = self->frameIdCntr++;
     frame[offset++] = socketId;
     frame[offset++] = 0x00; //Transmit options
@@ -533,10 +569,10 @@ bool XBeeCellularSocketSend(XBee* self, uint8_t socketId, const uint8_t* payload
  * @return true if option was set successfully, false otherwise.
  ******************************************************************************/
 bool XBeeCellularSocketSetOption(XBee* self, uint8_t socketId, uint8_t option, const uint8_t* value, uint8_t valueLen) {
-    if (!value || valueLen == 0) return false;
+    uint8_t frame[XBEE_CELLULAR_TX_FRAME_SIZE];
+    if (!value || valueLen == 0 || valueLen > sizeof(frame) - 3) return false;
 
-    uint8_t frame[128];
-    uint8_t offset = 0;
+    uint16_t offset = 0;
     frame[offset++] = self->frameIdCntr++;
     frame[offset++] = socketId;
     frame[offset++] = option;
@@ -568,7 +604,7 @@ bool XBeeCellularSocketClose(XBee* self, uint8_t socketId, bool blocking) {
     uint8_t frame[2] = { frameId, socketId };
 
     if (apiSendFrame(self, XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE, frame, sizeof(frame)) != API_SEND_SUCCESS) {
-        XBEEDebugPrint("SocketClose: Failed to send close frame\n");
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketClose: Failed to send close frame\n");
         return false;
     }
 
@@ -589,14 +625,14 @@ bool XBeeCellularSocketClose(XBee* self, uint8_t socketId, bool blocking) {
                 return true;
             }
 
-            XBEEDebugPrint("SocketClose: Unexpected socket status (ID: %u, Status: 0x%02X)\n",
+            XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketClose: Unexpected socket status (ID: %u, Status: 0x%02X)\n",
                            response.data[2], response.data[3]);
             return false;
         }
         self->htable->PortDelay(10);
     }
 
-    XBEEDebugPrint("SocketClose: Timeout waiting for socket status\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketClose: Timeout waiting for socket status\n");
     return false;
 }
 
@@ -621,14 +657,14 @@ bool XBeeCellularSocketBind(XBee* self, uint8_t socketId, uint16_t port, bool bl
 
     uint8_t frameId = self->frameIdCntr++;
     uint8_t frame[4];
-    uint8_t offset = 0;
+    uint16_t offset = 0;
     frame[offset++] = frameId;
     frame[offset++] = socketId;
     frame[offset++] = (port >> 8) & 0xFF;
     frame[offset++] = port & 0xFF;
 
     if (apiSendFrame(self, XBEE_API_TYPE_CELLULAR_SOCKET_BIND, frame, offset) != API_SEND_SUCCESS) {
-        XBEEDebugPrint("SocketBind: Failed to send bind frame\n");
+        XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketBind: Failed to send bind frame\n");
         return false;
     }
 
@@ -649,14 +685,14 @@ bool XBeeCellularSocketBind(XBee* self, uint8_t socketId, uint16_t port, bool bl
                 return true;
             }
 
-            XBEEDebugPrint("SocketBind: Unexpected bind status (ID: %u, Status: 0x%02X)\n",
+            XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketBind: Unexpected bind status (ID: %u, Status: 0x%02X)\n",
                            response.data[2], response.data[3]);
             return false;
         }
         self->htable->PortDelay(10);
     }
 
-    XBEEDebugPrint("SocketBind: Timeout waiting for bind status\n");
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "SocketBind: Timeout waiting for bind status\n");
     return false;
 }
 
@@ -677,10 +713,10 @@ bool XBeeCellularSocketBind(XBee* self, uint8_t socketId, uint16_t port, bool bl
  ******************************************************************************/
 bool XBeeCellularSocketSendTo(XBee* self, uint8_t socketId, const uint8_t* ip, uint16_t port,
                               const uint8_t* payload, uint16_t payloadLen) {
-    if (!self || !ip || !payload || payloadLen == 0 || payloadLen > 120) return false;
+    uint8_t frame[XBEE_CELLULAR_TX_FRAME_SIZE];
+    if (!self || !ip || !payload || payloadLen == 0 || payloadLen > sizeof(frame) - 9) return false;
 
-    uint8_t frame[128];
-    uint8_t offset = 0;
+    uint16_t offset = 0;
 
     frame[offset++] = self->frameIdCntr++;
     frame[offset++] = socketId;
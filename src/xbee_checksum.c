@@ -0,0 +1,177 @@
+/**
+ * @file xbee_checksum.c
+ * @brief API frame checksum kernels.
+ *
+ * This file implements the kernels declared in xbee_checksum.h. The SIMD
+ * variants are compiled in when XBEE_CHECKSUM_SIMD is set and the compiler
+ * targets SSE2 or NEON; every other build uses the word-at-a-time loop.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_checksum.h"
+#include <string.h>
+
+#if XBEE_CHECKSUM_SIMD && defined(__SSE2__)
+#include <emmintrin.h>
+#define CHECKSUM_SSE2 1
+#elif XBEE_CHECKSUM_SIMD && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define CHECKSUM_NEON 1
+#endif
+
+#if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint64_t checksumWord_t;
+#else
+typedef uint32_t checksumWord_t;
+#endif
+
+#define WORD_EVEN_BYTES ((checksumWord_t)-1 / 0xFFFF * 0xFF)  ///< 0x00FF in every 16-bit lane
+
+// Words added into 16-bit lanes before a lane could carry into its neighbour: 128 * 2 * 255 < 65536
+#define WORDS_PER_FOLD 128
+
+/**
+ * @brief Adds the 16-bit lanes of `acc` to `sum`.
+ */
+static uint8_t foldLanes(uint8_t sum, checksumWord_t acc) {
+    for (unsigned shift = 0; shift < 8 * sizeof(acc); shift += 16) {
+        sum += (uint8_t)(acc >> shift);
+    }
+    return sum;
+}
+
+/**
+ * @brief Word-at-a-time sum, optionally copying the words to `dst` as they are read.
+ *
+ * Even and odd bytes are added into separate 16-bit lanes, which are folded
+ * into the 8-bit sum before any of them can overflow.
+ */
+static uint8_t checksumWords(uint8_t sum, uint8_t* dst, const uint8_t* src, size_t* offset, size_t length) {
+    size_t i = *offset;
+
+    while (i + sizeof(checksumWord_t) <= length) {
+        checksumWord_t acc = 0;
+        for (unsigned n = 0; n < WORDS_PER_FOLD && i + sizeof(checksumWord_t) <= length; n++) {
+            checksumWord_t w;
+            memcpy(&w, src + i, sizeof(w));
+            if (dst) memcpy(dst + i, &w, sizeof(w));
+            acc += (w & WORD_EVEN_BYTES) + ((w >> 8) & WORD_EVEN_BYTES);
+            i += sizeof(w);
+        }
+        sum = foldLanes(sum, acc);
+    }
+    *offset = i;
+    return sum;
+}
+
+#if CHECKSUM_SSE2
+/**
+ * @brief Sums 16 bytes per step with PSADBW, optionally copying them to `dst`.
+ */
+static uint8_t checksumVector(uint8_t sum, uint8_t* dst, const uint8_t* src, size_t* offset, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    size_t i = *offset;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (dst) _mm_storeu_si128((__m128i*)(dst + i), v);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+    }
+    *offset = i;
+    return (uint8_t)(sum + _mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+}
+#elif CHECKSUM_NEON
+/**
+ * @brief Sums 16 bytes per step into 16-bit lanes, optionally copying them to `dst`.
+ *
+ * Lanes wrap modulo 65536, which keeps their low byte exact.
+ */
+static uint8_t checksumVector(uint8_t sum, uint8_t* dst, const uint8_t* src, size_t* offset, size_t length) {
+    uint16x8_t acc = vdupq_n_u16(0);
+    size_t i = *offset;
+
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (dst) vst1q_u8(dst + i, v);
+        acc = vpadalq_u8(acc, v);
+    }
+    *offset = i;
+    uint64x2_t total = vpaddlq_u32(vpaddlq_u16(acc));
+    return (uint8_t)(sum + vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1));
+}
+#endif
+
+/**
+ * @brief Sums `length` bytes with the widest kernel available, copying them to `dst` if not NULL.
+ *
+ * `dst` may overlap `src` as long as it does not start after it, since
+ * every step loads its bytes before storing them.
+ */
+static uint8_t checksumRun(uint8_t sum, uint8_t* dst, const uint8_t* src, size_t length) {
+    size_t i = 0;
+
+#if CHECKSUM_SSE2 || CHECKSUM_NEON
+    sum = checksumVector(sum, dst, src, &i, length);
+#endif
+    sum = checksumWords(sum, dst, src, &i, length);
+    for (; i < length; i++) {
+        if (dst) dst[i] = src[i];
+        sum += src[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Adds bytes to a running API frame checksum sum.
+ *
+ * @param[in] sum    Sum of the bytes before `data`, 0 to start.
+ * @param[in] data   Bytes to add.
+ * @param[in] length Number of bytes in `data`.
+ *
+ * @return uint8_t The new sum; the frame checksum is 0xFF minus the final sum.
+ */
+uint8_t xbeeChecksumAdd(uint8_t sum, const uint8_t* data, size_t length) {
+    return checksumRun(sum, NULL, data, length);
+}
+
+/**
+ * @brief Copies bytes and adds them to a running API frame checksum sum in the same pass.
+ *
+ * `dst` may overlap `src` if it starts at or before it, as when bytes are
+ * compacted in place.
+ *
+ * @param[in]  sum    Sum of the bytes before `src`, 0 to start.
+ * @param[out] dst    Receives the bytes.
+ * @param[in]  src    Bytes to copy and add.
+ * @param[in]  length Number of bytes to copy.
+ *
+ * @return uint8_t The new sum.
+ */
+uint8_t xbeeChecksumCopy(uint8_t sum, uint8_t* dst, const uint8_t* src, size_t length) {
+    return checksumRun(sum, dst, src, length);
+}
@@ -0,0 +1,202 @@
+/**
+ * @file xbee_escape.c
+ * @brief Byte stuffing for API escaped mode (ATAP=2).
+ *
+ * This file implements the escape and unescape kernels declared in
+ * xbee_escape.h. apiSendFrame() and the receive path in xbee_api_frames.c
+ * apply them when the instance runs in XBEE_API_MODE_ESCAPED.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_escape.h"
+#include "xbee_checksum.h"
+#include <string.h>
+
+// Scans run on native words: 64 bits on 64-bit hosts, 32 bits on MCUs
+#if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint64_t escapeWord_t;
+#else
+typedef uint32_t escapeWord_t;
+#endif
+
+#define WORD_ONES   ((escapeWord_t)-1 / 0xFF)   ///< 0x01 in every byte
+#define WORD_HIGHS  (WORD_ONES * 0x80)
+#define WORD_OF(b)  (WORD_ONES * (b))
+
+/**
+ * @brief Non-zero if any byte of `v` is zero.
+ */
+static escapeWord_t wordHasZero(escapeWord_t v) {
+    return (v - WORD_ONES) & ~v & WORD_HIGHS;
+}
+
+static escapeWord_t wordLoad(const uint8_t* p) {
+    escapeWord_t w;
+    memcpy(&w, p, sizeof(w));   // Unaligned-safe, compiles to a single load
+    return w;
+}
+
+/**
+ * @brief Non-zero if a byte of `w` must be escaped when sending.
+ *
+ * XON and XOFF differ only in bit 1, so one compare covers both.
+ */
+static escapeWord_t wordNeedsEscape(escapeWord_t w) {
+    return wordHasZero(w ^ WORD_OF(XBEE_START_DELIMITER)) |
+           wordHasZero(w ^ WORD_OF(XBEE_ESCAPE)) |
+           wordHasZero((w | WORD_OF(0x02)) ^ WORD_OF(XBEE_XOFF));
+}
+
+/**
+ * @brief Non-zero if a byte of `w` is an escape or a delimiter when receiving.
+ */
+static escapeWord_t wordNeedsUnescape(escapeWord_t w) {
+    return wordHasZero(w ^ WORD_OF(XBEE_START_DELIMITER)) |
+           wordHasZero(w ^ WORD_OF(XBEE_ESCAPE));
+}
+
+/**
+ * @brief Returns the length of the leading run of `data` that the receive side copies as is.
+ */
+static size_t scanUnescape(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i + sizeof(escapeWord_t) <= length && !wordNeedsUnescape(wordLoad(data + i))) {
+        i += sizeof(escapeWord_t);
+    }
+    while (i < length && data[i] != XBEE_START_DELIMITER && data[i] != XBEE_ESCAPE) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief True if `byte` must be escaped inside an escaped-mode frame.
+ */
+bool xbeeEscapeNeeded(uint8_t byte) {
+    return byte == XBEE_START_DELIMITER || byte == XBEE_ESCAPE || (byte | 0x02) == XBEE_XOFF;
+}
+
+/**
+ * @brief Returns the index of the first byte of `data` that must be escaped.
+ *
+ * @return size_t The index, or `length` if no byte needs escaping.
+ */
+size_t xbeeEscapeScan(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i + sizeof(escapeWord_t) <= length && !wordNeedsEscape(wordLoad(data + i))) {
+        i += sizeof(escapeWord_t);
+    }
+    while (i < length && !xbeeEscapeNeeded(data[i])) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Escapes as much of `in` as fits in `out`.
+ *
+ * An escape pair is never split across calls, so a frame can be escaped
+ * into a small buffer in several pieces.
+ *
+ * @param[out] out       Receives the escaped bytes.
+ * @param[in]  outSize   Size of `out`.
+ * @param[in]  in        Frame bytes after the start delimiter.
+ * @param[in]  inLength  Number of bytes in `in`.
+ * @param[out] consumed  Receives the number of bytes of `in` that were escaped.
+ *
+ * @return size_t Number of bytes written to `out`.
+ */
+size_t xbeeEscape(uint8_t* out, size_t outSize, const uint8_t* in, size_t inLength, size_t* consumed) {
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < inLength && written < outSize) {
+        size_t window = inLength - read < outSize - written ? inLength - read : outSize - written;
+        size_t run = xbeeEscapeScan(in + read, window);
+
+        memcpy(out + written, in + read, run);
+        read += run;
+        written += run;
+        if (run == window || outSize - written < 2) break;
+
+        out[written++] = XBEE_ESCAPE;
+        out[written++] = in[read++] ^ XBEE_ESCAPE_XOR;
+    }
+    *consumed = read;
+    return written;
+}
+
+/**
+ * @brief Removes escapes from received bytes in place.
+ *
+ * `escaped` carries an escape that ended the previous piece of the same
+ * frame into this one; start each frame with it false. A start delimiter
+ * cannot occur inside an escaped-mode frame, so finding one means the frame
+ * was cut short, typically by a module reset. When `sum` is given, the
+ * unescaped bytes are added to it as they are moved into place.
+ *
+ * @param[in,out] data     Bytes as read from the UART; receives the unescaped bytes.
+ * @param[in]     length   Number of bytes in `data`.
+ * @param[in,out] escaped  True if the byte before `data` was an escape.
+ * @param[in,out] sum      Running frame checksum sum (xbee_checksum.h), or NULL.
+ *
+ * @return int Number of unescaped bytes at the start of `data`, or -1 - n if a start delimiter
+ *             was found at `data[n]`; the bytes from it on are left as they were read.
+ */
+int xbeeUnescape(uint8_t* data, size_t length, bool* escaped, uint8_t* sum) {
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < length) {
+        if (*escaped) {
+            if (data[read] == XBEE_START_DELIMITER) return -1 - (int)read;
+            data[written] = data[read++] ^ XBEE_ESCAPE_XOR;
+            if (sum) *sum += data[written];
+            written++;
+            *escaped = false;
+            continue;
+        }
+
+        size_t run = scanUnescape(data + read, length - read);
+        if (sum) {
+            *sum = written != read ? xbeeChecksumCopy(*sum, data + written, data + read, run)
+                                   : xbeeChecksumAdd(*sum, data + read, run);
+        } else if (written != read) {
+            memmove(data + written, data + read, run);
+        }
+        read += run;
+        written += run;
+        if (read == length) break;
+
+        if (data[read] == XBEE_START_DELIMITER) return -1 - (int)read;
+        *escaped = true;
+        read++;
+    }
+    return (int)written;
+}
@@ -0,0 +1,295 @@
+/**
+ * @file xbee_log.c
+ * @brief Leveled, buffered logging for the XBee library.
+ *
+ * This file implements the line formatter, the hex and text dump encoders
+ * and the text ring drained by XBeeLogDrain(). Producers serialize on a
+ * small spin flag while they copy a finished line into the ring; the sink is
+ * only ever called from XBeeLogDrain().
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_log.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_MASK (XBEE_LOG_BUFFER_SIZE - 1)
+#define LOG_PREFIX_LEN 7    ///< "W api: "
+
+#if defined(__GNUC__)
+#define LOG_LOAD(var)           __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define LOG_STORE(var, value)   __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#define LOG_LOCK()              while (__atomic_test_and_set(&producerLock, __ATOMIC_ACQUIRE)) {}
+#define LOG_UNLOCK()            __atomic_clear(&producerLock, __ATOMIC_RELEASE)
+#else
+#define LOG_LOAD(var)           (var)
+#define LOG_STORE(var, value)   ((var) = (value))
+#define LOG_LOCK()
+#define LOG_UNLOCK()
+#endif
+
+volatile uint8_t xbeeLogLevel = XBEE_LOG_DEFAULT_LEVEL;
+volatile uint32_t xbeeLogModules = XBEE_LOG_DEFAULT_MODULES;
+
+static char ring[XBEE_LOG_BUFFER_SIZE];
+static volatile uint32_t ringHead;     ///< Total bytes written, advanced by producers
+static volatile uint32_t ringTail;     ///< Total bytes drained, advanced by XBeeLogDrain()
+static volatile uint32_t dropped;      ///< Lines that did not fit, reported on the next drain
+static XBeeLogSink logSink;
+#if defined(__GNUC__)
+static bool producerLock;
+#endif
+
+static const char hexDigits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+static const char levelLetters[] = { '-', 'E', 'W', 'I', 'D' };
+
+static const char* moduleName(uint32_t module) {
+    switch (module) {
+        case XBEE_LOG_MODULE_CORE:      return "xb ";
+        case XBEE_LOG_MODULE_API:       return "api";
+        case XBEE_LOG_MODULE_LR:        return "lr ";
+        case XBEE_LOG_MODULE_CELLULAR:  return "cel";
+        case XBEE_LOG_MODULE_3RF:       return "3rf";
+        default:                        return "app";
+    }
+}
+
+/**
+ * @brief Writes the "W api: " prefix and returns its length.
+ */
+static size_t writePrefix(char* line, uint8_t level, uint32_t module) {
+    const char* name = moduleName(module);
+    line[0] = level < sizeof(levelLetters) ? levelLetters[level] : '?';
+    line[1] = ' ';
+    memcpy(&line[2], name, 3);
+    line[5] = ':';
+    line[6] = ' ';
+    return LOG_PREFIX_LEN;
+}
+
+/**
+ * @brief Appends one finished line to the ring, or counts it as dropped.
+ */
+static void pushLine(const char* line, size_t len) {
+    LOG_LOCK();
+    uint32_t head = ringHead;
+    uint32_t used = head - LOG_LOAD(ringTail);
+    if (len > XBEE_LOG_BUFFER_SIZE - used) {
+        dropped++;
+        LOG_UNLOCK();
+        return;
+    }
+
+    uint32_t start = head & LOG_MASK;
+    size_t first = XBEE_LOG_BUFFER_SIZE - start;
+    if (first > len) first = len;
+    memcpy(&ring[start], line, first);
+    memcpy(ring, line + first, len - first);
+    LOG_STORE(ringHead, head + (uint32_t)len);
+    LOG_UNLOCK();
+}
+
+/**
+ * @brief Terminates a line that may have been cut short at XBEE_LOG_LINE_MAX.
+ */
+static size_t finishLine(char* line, size_t len, bool truncated) {
+    if (truncated) {
+        memcpy(&line[XBEE_LOG_LINE_MAX - 5], "...\n", 4);
+        return XBEE_LOG_LINE_MAX - 1;
+    }
+    if (len == 0 || line[len - 1] != '\n') line[len++] = '\n';
+    return len;
+}
+
+/**
+ * @brief Formats one log line; used through the XBEE_LOG_* macros.
+ *
+ * A missing trailing newline is added so every call produces one line.
+ */
+void xbeeLogPrintf(uint8_t level, uint32_t module, const char* format, ...) {
+    char line[XBEE_LOG_LINE_MAX];
+    size_t len = writePrefix(line, level, module);
+    va_list args;
+
+    va_start(args, format);
+    int n = vsnprintf(&line[len], XBEE_LOG_LINE_MAX - len - 1, format, args);
+    va_end(args);
+    if (n < 0) return;
+
+    bool truncated = (size_t)n >= XBEE_LOG_LINE_MAX - len - 1;
+    len += truncated ? XBEE_LOG_LINE_MAX - len - 2 : (size_t)n;
+    pushLine(line, finishLine(line, len, truncated));
+}
+
+/**
+ * @brief Logs a byte buffer as "prefix7E 00 04 ..." on one line.
+ *
+ * Bytes that do not fit in XBEE_LOG_LINE_MAX are replaced by "...".
+ */
+void xbeeLogHex(uint8_t level, uint32_t module, const char* prefix, const uint8_t* data, size_t len) {
+    char line[XBEE_LOG_LINE_MAX];
+    size_t pos = writePrefix(line, level, module);
+    size_t prefixLen = prefix ? strlen(prefix) : 0;
+    const size_t limit = XBEE_LOG_LINE_MAX - 1;    // Room for the newline
+    bool truncated = false;
+
+    if (prefixLen > limit - pos) prefixLen = limit - pos;
+    memcpy(&line[pos], prefix, prefixLen);
+    pos += prefixLen;
+
+    for (size_t i = 0; i < len; i++) {
+        if (pos + 3 > limit) {
+            truncated = true;
+            break;
+        }
+        line[pos++] = hexDigits[data[i] >> 4];
+        line[pos++] = hexDigits[data[i] & 0x0F];
+        line[pos++] = ' ';
+    }
+    if (len && !truncated) pos--;    // Drop the trailing space
+    pushLine(line, finishLine(line, pos, truncated));
+}
+
+/**
+ * @brief Logs a byte buffer as text, with non-printable bytes shown as '.'.
+ */
+void xbeeLogText(uint8_t level, uint32_t module, const char* prefix, const uint8_t* data, size_t len) {
+    char line[XBEE_LOG_LINE_MAX];
+    size_t pos = writePrefix(line, level, module);
+    size_t prefixLen = prefix ? strlen(prefix) : 0;
+    const size_t limit = XBEE_LOG_LINE_MAX - 1;
+    bool truncated = false;
+
+    if (prefixLen > limit - pos) prefixLen = limit - pos;
+    memcpy(&line[pos], prefix, prefixLen);
+    pos += prefixLen;
+
+    for (size_t i = 0; i < len; i++) {
+        if (pos + 1 > limit) {
+            truncated = true;
+            break;
+        }
+        line[pos++] = (data[i] >= 32 && data[i] <= 126) ? (char)data[i] : '.';
+    }
+    pushLine(line, finishLine(line, pos, truncated));
+}
+
+/**
+ * @brief Sets the most verbose level logged at runtime (XBEE_LOG_LEVEL_*).
+ *
+ * Levels above XBEE_LOG_MAX_LEVEL stay compiled out regardless.
+ */
+void XBeeLogSetLevel(uint8_t level) {
+    xbeeLogLevel = level;
+}
+
+/**
+ * @brief Selects the modules that are logged (XBEE_LOG_MODULE_* bits).
+ */
+void XBeeLogSetModules(uint32_t mask) {
+    xbeeLogModules = mask;
+}
+
+/**
+ * @brief Sets where XBeeLogDrain() writes; NULL keeps text buffered.
+ */
+void XBeeLogSetSink(XBeeLogSink sink) {
+    logSink = sink;
+}
+
+/**
+ * @brief Writes buffered log text to the sink.
+ *
+ * Called with XBEE_LOG_DRAIN_BUDGET from XBeeProcess(); applications that
+ * drain from a dedicated thread set the budget to 0 and call this instead.
+ * Only one thread may drain at a time.
+ *
+ * @param[in] maxBytes Upper bound on bytes written, 0 for no limit.
+ *
+ * @return size_t Number of bytes handed to the sink.
+ */
+size_t XBeeLogDrain(size_t maxBytes) {
+    if (!logSink) return 0;
+
+    uint32_t lost = dropped;
+    if (lost) {
+        char note[48];
+        int n = snprintf(note, sizeof(note), "W log: %lu lines dropped\n", (unsigned long)lost);
+        if (n > 0) logSink(note, (size_t)n < sizeof(note) ? (size_t)n : sizeof(note) - 1);
+        LOG_LOCK();
+        dropped -= lost;
+        LOG_UNLOCK();
+    }
+
+    uint32_t tail = ringTail;
+    uint32_t available = LOG_LOAD(ringHead) - tail;
+    if (maxBytes && available > maxBytes) available = (uint32_t)maxBytes;
+
+    size_t written = 0;
+    while (written < available) {
+        uint32_t start = (tail + (uint32_t)written) & LOG_MASK;
+        size_t chunk = XBEE_LOG_BUFFER_SIZE - start;
+        if (chunk > available - written) chunk = available - written;
+        logSink(&ring[start], chunk);
+        written += chunk;
+    }
+    LOG_STORE(ringTail, tail + (uint32_t)written);
+    return written;
+}
+
+/**
+ * @brief Returns the number of buffered bytes not yet drained.
+ */
+size_t XBeeLogPending(void) {
+    return LOG_LOAD(ringHead) - LOG_LOAD(ringTail);
+}
+
+/**
+ * @brief Returns the number of lines dropped since the last drain because the ring was full.
+ */
+uint32_t XBeeLogDropped(void) {
+    return dropped;
+}
+
+/**
+ * @brief Discards buffered text and restores the default level, modules and sink.
+ */
+void XBeeLogReset(void) {
+    LOG_LOCK();
+    ringHead = 0;
+    ringTail = 0;
+    dropped = 0;
+    LOG_UNLOCK();
+    xbeeLogLevel = XBEE_LOG_DEFAULT_LEVEL;
+    xbeeLogModules = XBEE_LOG_DEFAULT_MODULES;
+    logSink = NULL;
+}
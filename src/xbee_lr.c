@@ -32,6 +32,7 @@
  * @contact felix.galindo@digi.com
  */
 
+ #define XBEE_LOG_MODULE XBEE_LOG_MODULE_LR
  #include "xbee_lr.h"
  #include "xbee_api_frames.h"
  #include <stdlib.h>
@@ -50,29 +51,19 @@
   * Join Status, determining whether the module is currently connected to the LoRaWAN network. 
   * It returns true if the module is connected (i.e., has joined the network) and false otherwise. 
   * The function also handles the communication with the module and provides debug output in case 
-  * of communication errors.
+  * of communication errors. The answer is recorded as the network state read by XBeeConnected().
   * 
   * @param[in] self Pointer to the XBee instance.
   * 
   * @return bool Returns true if the XBee LR module is connected to the network, otherwise false.
   */
  bool XBeeLRConnected(XBee* self) {
-     // Implement logic to check XBeeLR network connection
-     uint8_t response = 0;
-     uint8_t responseLength;
-     int status;
- 
-     // Send the AT_JS command to query the Join Status
-     status = apiSendAtCommandAndGetResponse(self, AT_JS, NULL, 0, &response, &responseLength, 5000, sizeof(response));
+     uint32_t joined = 0;
  
-     if (status == API_SEND_SUCCESS) {
-         // Print the received reponse
-         // XBEEDebugPrint("ATJS Resp: %u \n", response);
-         // XBEEDebugPrint("Join Status: %s \n", response ? "Joined" : "Not Joined");
-     } else {
-         XBEEDebugPrint("Failed to receive AT_JS response, error code: %d\n", status);
-     }
-     return response;  
+     // Query the Join Status; a failed query leaves the recorded state alone
+     if (!XBeeAtGet(self, AT_JS, &joined)) return false;
+     xbeeLinkStateSet(self, joined ? XBEE_LINK_UP : XBEE_LINK_DOWN);
+     return joined != 0;
  }
  
  /**
@@ -113,7 +104,7 @@
      if (status == API_SEND_SUCCESS) {
          apiHandleFrame(self,frame);
      } else if (status != API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER) {
-         XBEEDebugPrint("Error receiving frame.\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Error receiving frame.\n");
      }
  }
  
@@ -141,10 +132,14 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
     }
 
     // Start the timeout timer
-    uint32_t startTime = portMillis();
+    uint32_t startTime = self->htable->PortMillis();
+    XBEE_TRACE_START(self, traceStart);
 
     // Delay until CONNECTION_TIMEOUT_MS time has elapsed
-    while ((portMillis() - startTime) < CONNECTION_TIMEOUT_MS) {}
+    while ((self->htable->PortMillis() - startTime) < CONNECTION_TIMEOUT_MS) {
+        self->htable->PortDelay(10);
+    }
+    XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_JOIN, 0);
 
     XBEEDebugPrint("Checking Join Status...\n");
 
@@ -154,8 +149,8 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
         return true; // Successfully joined
     }
 
-    portDelay(500); // Delay between checks
-    XBEEDebugPrint("Failed to Join\n");
+    self->htable->PortDelay(500); // Delay between checks
+    XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to Join\n");
     return false; // Timeout reached without successful join
 }
  
@@ -192,7 +187,11 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
  uint8_t XBeeLRSendPacket(XBee* self, const void* data) {
      // Prepare and send the API frame
      XBeeLRPacket_t *packet = (XBeeLRPacket_t*) data;
-     uint8_t frame_data[128];  // Adjust size as needed
+     uint8_t frame_data[XBEE_LR_TX_FRAME_SIZE];
+     if (packet->payloadSize > sizeof(frame_data) - 3) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Payload of %u bytes exceeds XBEE_LR_TX_FRAME_SIZE.\n", packet->payloadSize);
+         return false;
+     }
      packet->frameId = self->frameIdCntr;
      frame_data[0] = self->frameIdCntr;
      frame_data[1] = packet->port;
@@ -206,16 +205,20 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
      }
  
      // Block and wait for the XBEE_API_TYPE_TX_STATUS frame
-     uint32_t startTime = portMillis();  // Get the current time in milliseconds
+     uint32_t startTime = self->htable->PortMillis();  // Get the current time in milliseconds
+     XBEE_TRACE_START(self, traceStart);
  
      self->txStatusReceived = false;  // Reset the status flag before waiting
  
-     while ((portMillis() - startTime) < SEND_DATA_TIMEOUT_MS) {
+     while ((self->htable->PortMillis() - startTime) < SEND_DATA_TIMEOUT_MS) {
          // Process incoming frames using XBeeLRProcess
          XBeeLRProcess(self);
  
          // Check if the status frame was received
          if (self->txStatusReceived) {
+             XBEE_STATS_HIST(self, txStatusLatency, self->htable->PortMillis() - startTime);
+             XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_TX_STATUS, packet->frameId);
+
              // Return the delivery status
              if(self->deliveryStatus){
                  XBEEDebugPrint("TX Delivery Status 0x%02X\n", self->deliveryStatus );
@@ -224,11 +227,13 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
          }
  
          // Add a small delay here to avoid busy-waiting
-         portDelay(10);  // Delay for 10 ms
+         self->htable->PortDelay(10);  // Delay for 10 ms
      }
  
      // Timeout reached without receiving the expected frame
-     XBEEDebugPrint("Failed to receive TX Request Status frame\n");
+     XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to receive TX Request Status frame\n");
+     XBEE_STATS_INC(self, txStatusTimeouts);
+     XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_WAIT_TX_STATUS, packet->frameId);
      return 0xFF;  // Indicate failure or timeout
  }
  
@@ -259,26 +264,19 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the AppEUI was successfully set, otherwise false.
   */
  bool XBeeLRSetAppEUI(XBee* self, const char* value) {
-     uint8_t response[17];
-     uint8_t responseLength;
      uint8_t param[8];
      
      if (!value || strlen(value) != 16) {
-         XBEEDebugPrint("Invalid App EUI length\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid App EUI length\n");
          return false;
      }
      
      if (asciiToHexArray(value, param, sizeof(param)) < 0) {
-         XBEEDebugPrint("Failed to convert App EUI\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to convert App EUI\n");
          return false;
      }
      
-     int status = apiSendAtCommandAndGetResponse(self, AT_AE, param, sizeof(param), response, &responseLength, 5000, sizeof(response));
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set App EUI\n");
-         return false;
-     }
-     return true;
+     return XBeeAtSetBytes(self, AT_AE, param, sizeof(param));
  }
  
  /**
@@ -295,26 +293,19 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the AppKey was successfully set, otherwise false.
   */
  bool XBeeLRSetAppKey(XBee* self, const char* value) {
-     uint8_t response[33];
-     uint8_t responseLength;
      uint8_t param[16];
      
      if (!value || strlen(value) != 32) {
-         XBEEDebugPrint("Invalid App Key length %d\n", strlen(value));
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid App Key length %u\n", (unsigned)(value ? strlen(value) : 0));
          return false;
      }
      
      if (asciiToHexArray(value, param, sizeof(param)) < 0) {
-         XBEEDebugPrint("Failed to convert App Key\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to convert App Key\n");
          return false;
      }
      
-     int status = apiSendAtCommandAndGetResponse(self, AT_AK, param, sizeof(param), response, &responseLength, 5000, sizeof(response));
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set App Key\n");
-         return false;
-     }
-     return true;
+     return XBeeAtSetBytes(self, AT_AK, param, sizeof(param));
  }
  
  /**
@@ -332,26 +323,19 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the NwkKey was successfully set, otherwise false.
   */
  bool XBeeLRSetNwkKey(XBee* self, const char* value) {
-     uint8_t response[33];
-     uint8_t responseLength;
      uint8_t param[16];
      
      if (!value || strlen(value) != 32) {
-         XBEEDebugPrint("Invalid Nwk Key length %d\n", strlen(value));
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid Nwk Key length %u\n", (unsigned)(value ? strlen(value) : 0));
          return false;
      }
      
      if (asciiToHexArray(value, param, sizeof(param)) < 0) {
-         XBEEDebugPrint("Failed to convert Nwk Key\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to convert Nwk Key\n");
          return false;
      }
      
-     int status = apiSendAtCommandAndGetResponse(self, AT_NK, param, sizeof(param), response, &responseLength, 5000, sizeof(response));
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Nwk Key\n");
-         return false;
-     }
-     return true;
+     return XBeeAtSetBytes(self, AT_NK, param, sizeof(param));
  }
  
  /**
@@ -369,14 +353,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Class was successfully set, otherwise false.
   */
  bool XBeeLRSetClass(XBee* self, const char value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     int status = apiSendAtCommandAndGetResponse(self, AT_LC, (const uint8_t *) &value, 1, response, &responseLength, 5000, sizeof(response));
-     if(status != API_SEND_SUCCESS){
-         XBEEDebugPrint("Failed to set Class\n");
-         return false;
-     }
-     return true;
+     return XBeeAtSet(self, AT_LC, (uint8_t)value);
  }
  
  /**
@@ -388,17 +365,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Activation Mode was successfully set, otherwise false.
   */
  bool XBeeLRSetActivationMode(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_AM, &value, 1, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Activation Mode\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_AM, value);
  }
  
  /**
@@ -410,17 +377,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the ADR was successfully set, otherwise false.
   */
  bool XBeeLRSetADR(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_AD, &value, 1, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set ADR\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_AD, value);
  }
  
  /**
@@ -432,17 +389,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the DataRate was successfully set, otherwise false.
   */
  bool XBeeLRSetDataRate(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_DR, &value, 1, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set DataRate\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_DR, value);
  }
  
  /**
@@ -454,17 +401,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Region was successfully set, otherwise false.
   */
  bool XBeeLRSetRegion(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_LR, &value, 1, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Region\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_LR, value);
  }
  
  /**
@@ -476,17 +413,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Duty Cycle was successfully set, otherwise false.
   */
  bool XBeeLRSetDutyCycle(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_DC, &value, 1, response, &responseLength, 5000,sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Duty Cycle\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_DC, value);
  }
  
  // /**
@@ -521,18 +448,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Join RX1 Delay was successfully set, otherwise false.
   */
  bool XBeeLRSetJoinRX1Delay(XBee* self, const uint32_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_J1,(const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Join RX1 Delay\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_J1, value);
  }
  
  /**
@@ -544,18 +460,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Join RX2 Delay was successfully set, otherwise false.
   */
  bool XBeeLRSetJoinRX2Delay(XBee* self, const uint32_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_J2, (const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Join RX2 Delay\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_J2, value);
  }
  
  /**
@@ -567,18 +472,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the RX1 Delay was successfully set, otherwise false.
   */
  bool XBeeLRSetRX1Delay(XBee* self, const uint32_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_D1, (const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set RX1 Delay\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_D1, value);
  }
  
  /**
@@ -590,18 +484,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the RX2 Delay was successfully set, otherwise false.
   */
  bool XBeeLRSetRX2Delay(XBee* self, const uint32_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_D2, (const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set RX2 Delay\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_D2, value);
  }
  
  /**
@@ -613,18 +496,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the RX2 Data Rate was successfully set, otherwise false.
   */
  bool XBeeLRSetRX2DataRate(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self,AT_XD, (const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set RX2 Data Rate\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_XD, value);
  }
  
  /**
@@ -636,18 +508,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the RX2 Frequency was successfully set, otherwise false.
   */
  bool XBeeLRSetRX2Frequency(XBee* self, const uint32_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_XF, (const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set RX2 Frequency\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_XF, value);
  }
  
  /**
@@ -659,18 +520,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Transmit Power was successfully set, otherwise false.
   */
  bool XBeeLRSetTransmitPower(XBee* self, const uint8_t value) {
-     uint8_t response[33];
-     uint8_t responseLength;
-     uint8_t paramLength = sizeof(value);
- 
-     int status = apiSendAtCommandAndGetResponse(self, AT_PO, (const uint8_t*)&value, paramLength, response, &responseLength, 5000, sizeof(response));
- 
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Transmit Power\n");
-         return false;
-     }
- 
-     return true;
+     return XBeeAtSet(self, AT_PO, value);
  }
  
  /**
@@ -698,10 +548,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
      // Send the AT_DE command to query the DevEUI
      uint8_t rawResponse[8]; // DevEUI is 8 bytes in binary
      uint8_t responseLength;
-     int status = apiSendAtCommandAndGetResponse(self, AT_DE, NULL, 0, rawResponse, &responseLength, 5000, sizeof(rawResponse));
- 
-     if (status != API_SEND_SUCCESS || responseLength != 8) {
-         XBEEDebugPrint("Failed to receive valid AT_DE response, error code: %d\n", status);
+     if (!XBeeAtGetBytes(self, AT_DE, rawResponse, &responseLength, sizeof(rawResponse))) {
          return false;
      }
  
@@ -727,29 +574,114 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
   * @return bool Returns true if the Channels Mask was successfully set; otherwise, false.
   */
  bool XBeeLRSetChannelsMask(XBee* self, const char* value) {
-     uint8_t response[33];
-     uint8_t responseLength;
      uint8_t param[16]; // Maximum LoRaWAN channel mask size
-     size_t paramLength = strlen(value) / 2;
      
-     if (!value || strlen(value) % 2 != 0 || paramLength > sizeof(param)) {
-         XBEEDebugPrint("Invalid Channels Mask length\n");
+     if (!value || strlen(value) % 2 != 0 || strlen(value) / 2 > sizeof(param)) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid Channels Mask length\n");
          return false;
      }
      
+     uint8_t paramLength = (uint8_t)(strlen(value) / 2);
      if (asciiToHexArray(value, param, paramLength) < 0) {
-         XBEEDebugPrint("Failed to convert Channels Mask\n");
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Failed to convert Channels Mask\n");
          return false;
      }
      
-     int status = apiSendAtCommandAndGetResponse(self, AT_CM, param, paramLength, response, &responseLength, 5000, sizeof(response));
-     if (status != API_SEND_SUCCESS) {
-         XBEEDebugPrint("Failed to set Channels Mask\n");
+     return XBeeAtSetBytes(self, AT_CM, param, paramLength);
+ }
+ 
+ 
+ /**
+  * @brief Converts a hex string setting to bytes for XBeeLRConfigure().
+  *
+  * @param[in]  value   Hex string; an empty or odd length string is rejected.
+  * @param[in]  size    Exact byte length required, or the maximum if `variable` is set.
+  * @param[out] param   Receives the bytes.
+  * @param[out] length  Receives the number of bytes.
+  *
+  * @return bool True if the string was valid, otherwise false.
+  */
+ static bool lrHexSetting(const char* value, uint8_t size, bool variable, uint8_t* param, uint8_t* length) {
+     size_t chars = strlen(value);
+ 
+     if (chars == 0 || chars % 2 != 0 || (variable ? chars / 2 > size : chars / 2 != size)) {
          return false;
      }
-     return true;
+     *length = (uint8_t)(chars / 2);
+     return asciiToHexArray(value, param, *length) >= 0;
  }
  
+ /**
+  * @brief Brings the module's LoRaWAN settings to an XBeeLRConfig_t.
+  *
+  * Called through XBeeConfigure(). The settings are handed to
+  * XBeeShadowSync(), so on a module that is already configured this costs
+  * one pipelined read and no writes; otherwise only the differing settings
+  * are written, followed by a single WR and AC.
+  *
+  * @param[in] self Pointer to the XBee instance.
+  * @param[in] config Pointer to a valid XBeeLRConfig_t structure.
+  *
+  * @return bool Returns true if the module now has the requested settings, otherwise false.
+  */
+ bool XBeeLRConfigure(XBee* self, const void* config) {
+     const XBeeLRConfig_t* cfg = (const XBeeLRConfig_t*)config;
+     XBeeShadowParam_t params[10];
+     uint8_t appEUI[8], appKey[16], nwkKey[16], channelsMask[16];
+     uint8_t length;
+     uint8_t count = 0;
+ 
+     if (!self || !cfg) return false;
+ 
+     if (cfg->appEUI) {
+         if (!lrHexSetting(cfg->appEUI, sizeof(appEUI), false, appEUI, &length)) {
+             XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid App EUI\n");
+             return false;
+         }
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_BYTES(AT_AE, appEUI, length);
+     }
+     if (cfg->appKey) {
+         if (!lrHexSetting(cfg->appKey, sizeof(appKey), false, appKey, &length)) {
+             XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid App Key\n");
+             return false;
+         }
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_BYTES(AT_AK, appKey, length);
+     }
+     if (cfg->nwkKey) {
+         if (!lrHexSetting(cfg->nwkKey, sizeof(nwkKey), false, nwkKey, &length)) {
+             XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid Network Key\n");
+             return false;
+         }
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_BYTES(AT_NK, nwkKey, length);
+     }
+     if (cfg->channelsMask) {
+         if (!lrHexSetting(cfg->channelsMask, sizeof(channelsMask), true, channelsMask, &length)) {
+             XBEE_LOG_WARN(XBEE_LOG_MODULE, "Invalid Channels Mask\n");
+             return false;
+         }
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_BYTES(AT_CM, channelsMask, length);
+     }
+     if (cfg->lorawanClass) {
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_LC, (uint8_t)cfg->lorawanClass);
+     }
+     if (cfg->fields & XBEE_LR_CONFIG_REGION) {
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_LR, cfg->region);
+     }
+     if (cfg->fields & XBEE_LR_CONFIG_ACTIVATION) {
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_AM, cfg->activationMode);
+     }
+     if (cfg->fields & XBEE_LR_CONFIG_ADR) {
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_AD, cfg->adr);
+     }
+     if (cfg->fields & XBEE_LR_CONFIG_DATA_RATE) {
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_DR, cfg->dataRate);
+     }
+     if (cfg->fields & XBEE_LR_CONFIG_API_OPTIONS) {
+         params[count++] = (XBeeShadowParam_t)XBEE_SHADOW_UINT(AT_AO, cfg->apiOptions);
+     }
+ 
+     return XBeeShadowSync(self, params, count, NULL);
+ }
  
  // XBeeLR private functions
  
@@ -792,11 +724,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
  
      XBeeLRPacket_t packet = {0}; // Allocate on the stack and zero-initialize
  
-     APIFrameDebugPrint("RX Packet Data: ");
-     for (int i = 0; i < frame->length; i++) {
-         APIFrameDebugPrint("0x%02X ", frame->data[i]);
-     }
-     APIFrameDebugPrint("\n");
+     XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE, "RX Packet Data: ", frame->data, frame->length);
  
      if (frame->type == XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET) {
          packet.port = frame->data[1];
@@ -807,6 +735,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
          packet.counter = frame->data[5] << 24 | frame->data[6] << 16 | frame->data[7] << 8 | frame->data[8];
          packet.payloadSize = frame->length - 10;
          packet.payload = &(frame->data[10]); // Point directly to the payload in the frame data
+         XBEE_STATS_LINK(self, packet.rssi, packet.snr);
      } else {
          packet.port = frame->data[1];
          packet.payloadSize = frame->length - 2;
@@ -814,7 +743,9 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
      }
  
      if (self->ctable->OnReceiveCallback) {
+         XBEE_TRACE_START(self, traceStart);
          self->ctable->OnReceiveCallback(self, &packet); // Pass the address of the stack variable
+         XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_RECEIVE);
      }
  }
  
@@ -828,11 +759,7 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
  
      XBeeLRPacket_t packet = {0}; // Allocate on the stack and zero-initialize
  
-     APIFrameDebugPrint("Received Transmit Status Frame: ");
-     for (int i = 1; i < frame->length; i++) {
-         APIFrameDebugPrint("0x%02X ", frame->data[i]);
-     }
-     APIFrameDebugPrint("\n");
+     XBEE_LOG_HEX(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE, "Received Transmit Status Frame: ", &frame->data[1], frame->length - 1);
  
      packet.frameId = frame->data[1];
      packet.status = frame->data[2];
@@ -851,7 +778,9 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
      self->txStatusReceived = true;
  
      if (self->ctable->OnSendCallback) {
+         XBEE_TRACE_START(self, traceStart);
          self->ctable->OnSendCallback(self, &packet); // Pass the address of the stack variable
+         XBEE_TRACE_SPAN(self, traceStart, XBEE_TRACE_EVENT_CALLBACK, XBEE_TRACE_CALLBACK_SEND);
      }
  
  }
@@ -869,31 +798,63 @@ bool XBeeLRConnect(XBee* self, bool blocking) {
      .connected = XBeeLRConnected,
      .handleRxPacketFrame = XBeeLRHandleRxPacket,
      .handleTransmitStatusFrame = XBeeLRHandleTransmitStatus,
+     .configure = XBeeLRConfigure,
  };
  
+ /**
+  * @brief Constructs an XBeeLR instance in storage provided by the caller.
+  * 
+  * This function clears `storage` and initializes it with the provided callback
+  * table (`cTable`) and handler table (`hTable`). The function sets up the virtual
+  * table (`vtable`) for XBee LR-specific operations and the frame pool held in the
+  * instance. The storage is usually a static `XBeeLR`, so the instance takes no heap
+  * and its footprint is `sizeof(XBeeLR)`, fixed at build time by config.h.
+  * 
+  * @param[out] storage Memory for the instance; must outlive its use.
+  * @param[in] cTable Pointer to the callback table containing function pointers for handling XBee events.
+  * @param[in] hTable Pointer to the handler table containing platform-specific function implementations.
+  * 
+  * @return XBeeLR* `storage`, or NULL if `storage` is NULL.
+  */
+ XBeeLR* XBeeLRInitStatic(XBeeLR* storage, const XBeeCTable* cTable, const XBeeHTable* hTable) {
+     if (!storage) return NULL;
+     memset(storage, 0, sizeof(*storage));
+     storage->base.vtable = &XBeeLRVTable;
+     storage->base.htable = hTable;
+     storage->base.ctable = cTable;
+     storage->base.framePool = storage->framePool;
+     storage->base.framePoolSize = sizeof(storage->framePool);
+     storage->base.maxFrameDataSize = XBEE_LR_MAX_FRAME_DATA_SIZE;
+     storage->base.atModule = AT_MODULE_COMMON;
+#if XBEE_AT_TIMEOUT_ADAPTIVE
+     xbeeTimeoutReset(&storage->base.atTimeouts);
+#endif
+     return storage;
+ }
+ 
+ #if !XBEE_NO_HEAP
  /**
   * @brief Constructor for creating an XBeeLR instance.
   * 
   * This function allocates memory for a new XBeeLR instance and initializes it 
-  * with the provided callback table (`cTable`) and handler table (`hTable`). 
-  * The function sets up the virtual table (`vtable`) for XBee LR-specific operations 
-  * and assigns the callback and handler tables to the instance. The newly created 
-  * instance is then returned to the caller.
+  * with XBeeLRInitStatic(). Not available in XBEE_NO_HEAP builds.
   * 
   * @param[in] cTable Pointer to the callback table containing function pointers for handling XBee events.
   * @param[in] hTable Pointer to the handler table containing platform-specific function implementations.
   * 
-  * @return XBeeLR* Pointer to the newly created XBeeLR instance.
+  * @return XBeeLR* Pointer to the newly created XBeeLR instance, or NULL if the allocation failed.
   */
  XBeeLR* XBeeLRCreate(const XBeeCTable* cTable, const XBeeHTable* hTable) {
      XBeeLR* instance = (XBeeLR*)malloc(sizeof(XBeeLR));
-     instance->base.vtable = &XBeeLRVTable;
-     instance->base.htable = hTable;
-     instance->base.ctable = cTable;
-     return instance;
+     if (!instance) {
+         XBEE_LOG_WARN(XBEE_LOG_MODULE, "Unable to allocate an XBeeLR instance.\n");
+         return NULL;
+     }
+     return XBeeLRInitStatic(instance, cTable, hTable);
  }
  
  void XBeeLRDestroy(XBeeLR* self) {
      free(self);
  }
+ #endif
  
\ No newline at end of file
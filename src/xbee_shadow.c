@@ -0,0 +1,273 @@
+/**
+ * @file xbee_shadow.c
+ * @brief Host-side shadow of XBee module parameters.
+ *
+ * This file implements the per-instance parameter shadow declared in
+ * xbee_shadow.h: the pipelined read that fills it, the diff against a
+ * desired configuration, and the accessors declared in xbee.h.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_shadow.h"
+#include "xbee.h"
+#include "xbee_api_frames.h"
+#include <string.h>
+
+#if XBEE_SHADOW_ENABLED
+
+/**
+ * @brief Forgets all tracked parameters; used by XBeeInit().
+ */
+void xbeeShadowReset(XBeeShadow_t* shadow) {
+    shadow->count = 0;
+}
+
+/**
+ * @brief Marks every tracked value unknown, e.g. after the module was reset.
+ */
+void xbeeShadowInvalidate(XBeeShadow_t* shadow) {
+    for (uint8_t i = 0; i < shadow->count; i++) {
+        shadow->entries[i].length = 0;
+    }
+}
+
+/**
+ * @brief Returns the entry tracking `command`, or NULL if it is not tracked.
+ */
+XBeeShadowEntry_t* xbeeShadowFind(XBeeShadow_t* shadow, at_command_t command) {
+    for (uint8_t i = 0; i < shadow->count; i++) {
+        if (shadow->entries[i].command == (uint8_t)command) {
+            return &shadow->entries[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Starts tracking `command` with an unknown value.
+ *
+ * @return XBeeShadowEntry_t* The existing or new entry, or NULL if the shadow is full.
+ */
+XBeeShadowEntry_t* xbeeShadowTrack(XBeeShadow_t* shadow, at_command_t command) {
+    XBeeShadowEntry_t* entry = xbeeShadowFind(shadow, command);
+
+    if (entry || shadow->count >= XBEE_SHADOW_MAX_PARAMS) {
+        return entry;
+    }
+    entry = &shadow->entries[shadow->count++];
+    entry->command = (uint8_t)command;
+    entry->length = 0;
+    return entry;
+}
+
+/**
+ * @brief Records a value read from or accepted by the module.
+ *
+ * Values of parameters that are not tracked are ignored, so the plain
+ * XBeeAtSet()/XBeeAtGet() paths cost one short search.
+ */
+void xbeeShadowStore(XBeeShadow_t* shadow, at_command_t command, const uint8_t* value, uint8_t length) {
+    XBeeShadowEntry_t* entry = xbeeShadowFind(shadow, command);
+
+    if (!entry) return;
+    if (length > XBEE_SHADOW_VALUE_MAX) {
+        entry->length = 0;
+        return;
+    }
+    memcpy(entry->value, value, length);
+    entry->length = length;
+}
+
+/**
+ * @brief Reads the tracked parameters whose value is unknown, several queries at a time.
+ *
+ * Up to XBEE_SHADOW_PIPELINE_DEPTH queries are in flight. Responses are
+ * matched to their entry by command, so their order does not matter, and
+ * other frames received meanwhile are dispatched as usual. Parameters that
+ * are not answered in time stay unknown and are written by the caller.
+ */
+static void shadowLoad(XBee* self, const XBeeShadowParam_t* params, uint8_t count) {
+    XBeeShadowEntry_t* queue[XBEE_SHADOW_MAX_PARAMS];
+    bool answered[XBEE_SHADOW_MAX_PARAMS] = {false};
+    uint8_t queued = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const at_command_info_t* info = atCommandInfo(params[i].command);
+        XBeeShadowEntry_t* entry = xbeeShadowTrack(&self->shadow, params[i].command);
+        if (!info || !entry || entry->length || (info->flags & AT_FLAG_WRITE_ONLY)) continue;
+
+        bool duplicate = false;
+        for (uint8_t j = 0; j < queued; j++) {
+            duplicate |= queue[j] == entry;
+        }
+        if (!duplicate) queue[queued++] = entry;
+    }
+
+    uint8_t sent = 0;
+    uint8_t inFlight = 0;
+    uint32_t lastActivity = self->htable->PortMillis();
+    uint32_t timeout = 0;
+
+    while (sent < queued || inFlight) {
+        while (sent < queued && inFlight < XBEE_SHADOW_PIPELINE_DEPTH) {
+            // Queries answered back to back: allow for every response still due on the wire
+            at_command_t command = (at_command_t)queue[sent]->command;
+            timeout = XBeeAtTimeout(self, command, (uint16_t)(XBEE_AT_REQUEST_WIRE_BYTES +
+                                    (inFlight + 1) * (XBEE_AT_RESPONSE_WIRE_BYTES + XBEE_SHADOW_VALUE_MAX)));
+            apiSendAtCommand(self, command, NULL, 0);
+            XBEE_STATS_INC(self, atCommands);
+            sent++;
+            inFlight++;
+            lastActivity = self->htable->PortMillis();
+        }
+
+        uint32_t idle = self->htable->PortMillis() - lastActivity;
+        if (idle >= timeout) {
+            XBEE_LOG_WARN(XBEE_LOG_MODULE, "Shadow read: %u queries unanswered\n", (unsigned)inFlight);
+            XBEE_STATS_INC(self, atTimeouts);
+            return;
+        }
+
+        // Wait for the next frame no longer than the time left for the responses
+        xbee_api_frame_t frame;
+        if (apiReceiveApiFrameWithin(self, &frame, timeout - idle) != API_RECEIVE_SUCCESS) continue;
+
+        uint8_t slot = sent;
+        at_command_t responded;
+        if (frame.type == XBEE_API_TYPE_AT_RESPONSE && frame.length >= 5 &&
+            atCommandFromString(self->atModule, (const char*)&frame.data[2], &responded)) {
+            for (slot = 0; slot < sent; slot++) {
+                if (!answered[slot] && atCommandForModule(self->atModule, (at_command_t)queue[slot]->command) == responded) break;
+            }
+        }
+        if (slot == sent) {
+            apiHandleFrame(self, frame);
+            continue;
+        }
+        at_command_t command = (at_command_t)queue[slot]->command;
+
+        answered[slot] = true;
+        inFlight--;
+        lastActivity = self->htable->PortMillis();
+        if (frame.data[4] == 0) {
+            xbeeShadowStore(&self->shadow, command, &frame.data[5], (uint8_t)(frame.length - 5));
+        } else {
+            XBEE_STATS_INC(self, atErrors);
+        }
+    }
+}
+
+/**
+ * @brief True if the shadow holds `param`'s desired value.
+ *
+ * Integers are compared by value, so a module that answers with fewer bytes
+ * than the metadata width still matches.
+ */
+static bool shadowMatches(XBee* self, const at_command_info_t* info, const XBeeShadowParam_t* param) {
+    const XBeeShadowEntry_t* entry = xbeeShadowFind(&self->shadow, param->command);
+
+    if (!entry || entry->length == 0) return false;
+    if (info->type == AT_TYPE_UINT && !param->data) {
+        if (entry->length > 4) return false;
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < entry->length; i++) {
+            value = (value << 8) | entry->value[i];
+        }
+        return value == param->value;
+    }
+    return entry->length == param->length && memcmp(entry->value, param->data, param->length) == 0;
+}
+
+#endif // XBEE_SHADOW_ENABLED
+
+/**
+ * @brief Brings module parameters to the desired values with as few writes as possible.
+ *
+ * Parameters whose value is unknown are read first with pipelined queries.
+ * Only parameters that differ from the shadow are then written, and a
+ * single WR and AC follow if any of them changed. Write-only parameters,
+ * such as LoRaWAN keys, cannot be read back: they are written once after
+ * every boot or reset and do not by themselves cause a flash write.
+ * Without XBEE_SHADOW_ENABLED every parameter is written.
+ *
+ * @param[in]  self    Pointer to the XBee instance.
+ * @param[in]  params  Desired parameter values.
+ * @param[in]  count   Number of entries in `params`.
+ * @param[out] changed Receives the number of readable parameters that were written; may be NULL.
+ *
+ * @return bool True if every parameter now has its desired value, otherwise false.
+ */
+bool XBeeShadowSync(XBee* self, const XBeeShadowParam_t* params, uint8_t count, uint8_t* changed) {
+    uint8_t written = 0;
+    bool ok = true;
+
+    if (changed) *changed = 0;
+    if (!self || (count && !params)) return false;
+
+#if XBEE_SHADOW_ENABLED
+    shadowLoad(self, params, count);
+#endif
+
+    for (uint8_t i = 0; i < count; i++) {
+        const XBeeShadowParam_t* param = &params[i];
+        const at_command_info_t* info = atCommandInfo(param->command);
+
+#if XBEE_SHADOW_ENABLED
+        if (info && shadowMatches(self, info, param)) continue;
+#endif
+        bool set = param->data ? XBeeAtSetBytes(self, param->command, param->data, param->length)
+                               : XBeeAtSet(self, param->command, param->value);
+        if (!set) {
+            ok = false;
+            continue;
+        }
+        if (!(info->flags & AT_FLAG_WRITE_ONLY)) written++;
+    }
+
+    if (written) {
+        ok = XBeeWriteConfig(self) && XBeeApplyChanges(self) && ok;
+    }
+    if (changed) *changed = written;
+    return ok;
+}
+
+/**
+ * @brief Marks every shadowed value unknown so the next sync reads it again.
+ *
+ * The library does this itself on resets; call it after the module was
+ * configured by other means, such as XCTU.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ */
+void XBeeShadowInvalidate(XBee* self) {
+#if XBEE_SHADOW_ENABLED
+    if (!self) return;
+    xbeeShadowInvalidate(&self->shadow);
+#else
+    (void)self;
+#endif
+}
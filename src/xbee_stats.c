@@ -0,0 +1,244 @@
+/**
+ * @file xbee_stats.c
+ * @brief Per-instance counters and latency histograms for the XBee library.
+ *
+ * This file implements the recording helpers used by the API frame layer
+ * and the snapshot accessors declared in xbee_stats.h and xbee.h. Frame
+ * types map to counter slots through a 256-entry table so recording a frame
+ * is one table lookup and two increments.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_stats.h"
+#include "xbee.h"
+#include "xbee_api_frames.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Frame type of each counter slot; slot 0 is "other".
+ */
+static const uint8_t slotFrameType[XBEE_STATS_FRAME_TYPE_SLOTS] = {
+    0x00,
+    XBEE_API_TYPE_AT_COMMAND,
+    XBEE_API_TYPE_TX_REQUEST,
+    XBEE_API_TYPE_LR_JOIN_REQUEST,
+    XBEE_API_TYPE_REMOTE_AT_COMMAND,
+    XBEE_API_TYPE_CELLULAR_TX_IPV4,
+    XBEE_API_TYPE_CELLULAR_SOCKET_CREATE,
+    XBEE_API_TYPE_CELLULAR_SOCKET_OPTION,
+    XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT,
+    XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE,
+    XBEE_API_TYPE_CELLULAR_SOCKET_SEND,
+    XBEE_API_TYPE_CELLULAR_SOCKET_SEND_TO,
+    XBEE_API_TYPE_CELLULAR_SOCKET_BIND,
+    XBEE_API_TYPE_LR_TX_REQUEST,
+    XBEE_API_TYPE_AT_RESPONSE,
+    XBEE_API_TYPE_TX_STATUS,
+    XBEE_API_TYPE_MODEM_STATUS,
+    XBEE_API_TYPE_IO_SAMPLE_RX_INDICATOR,
+    XBEE_API_TYPE_3RF_RX_PACKET,
+    XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET,
+    XBEE_API_TYPE_IO_DATA_SAMPLE_RX,
+    XBEE_API_TYPE_REMOTE_AT_RESPONSE,
+    XBEE_API_TYPE_CELLULAR_RX_IPV4,
+    XBEE_API_TYPE_CELLULAR_SOCKET_CREATE_RESPONSE,
+    XBEE_API_TYPE_CELLULAR_SOCKET_OPTION_RESPONSE,
+    XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT_RESPONSE,
+    XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE_RESPONSE,
+    XBEE_API_TYPE_CELLULAR_SOCKET_RX,
+    XBEE_API_TYPE_CELLULAR_SOCKET_STATUS,
+    XBEE_API_TYPE_LR_RX_PACKET,
+    XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET,
+    XBEE_API_TYPE_LR_EXPLICIT_TX_STATUS,
+};
+
+/**
+ * @brief Counter slot of each frame type, the inverse of slotFrameType.
+ */
+static const uint8_t frameTypeSlot[256] = {
+    [XBEE_API_TYPE_AT_COMMAND] = 1,
+    [XBEE_API_TYPE_TX_REQUEST] = 2,
+    [XBEE_API_TYPE_LR_JOIN_REQUEST] = 3,
+    [XBEE_API_TYPE_REMOTE_AT_COMMAND] = 4,
+    [XBEE_API_TYPE_CELLULAR_TX_IPV4] = 5,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_CREATE] = 6,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_OPTION] = 7,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT] = 8,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE] = 9,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_SEND] = 10,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_SEND_TO] = 11,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_BIND] = 12,
+    [XBEE_API_TYPE_LR_TX_REQUEST] = 13,
+    [XBEE_API_TYPE_AT_RESPONSE] = 14,
+    [XBEE_API_TYPE_TX_STATUS] = 15,
+    [XBEE_API_TYPE_MODEM_STATUS] = 16,
+    [XBEE_API_TYPE_IO_SAMPLE_RX_INDICATOR] = 17,
+    [XBEE_API_TYPE_3RF_RX_PACKET] = 18,
+    [XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET] = 19,
+    [XBEE_API_TYPE_IO_DATA_SAMPLE_RX] = 20,
+    [XBEE_API_TYPE_REMOTE_AT_RESPONSE] = 21,
+    [XBEE_API_TYPE_CELLULAR_RX_IPV4] = 22,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_CREATE_RESPONSE] = 23,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_OPTION_RESPONSE] = 24,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT_RESPONSE] = 25,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE_RESPONSE] = 26,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_RX] = 27,
+    [XBEE_API_TYPE_CELLULAR_SOCKET_STATUS] = 28,
+    [XBEE_API_TYPE_LR_RX_PACKET] = 29,
+    [XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET] = 30,
+    [XBEE_API_TYPE_LR_EXPLICIT_TX_STATUS] = 31,
+};
+
+/**
+ * @brief Returns the counter slot for a frame type (0 for types without their own slot).
+ */
+uint8_t XBeeStatsFrameTypeSlot(uint8_t frameType) {
+    return frameTypeSlot[frameType];
+}
+
+/**
+ * @brief Returns the frame type counted in a slot (0x00 for the "other" slot).
+ */
+uint8_t XBeeStatsSlotFrameType(uint8_t slot) {
+    return slot < XBEE_STATS_FRAME_TYPE_SLOTS ? slotFrameType[slot] : 0;
+}
+
+/**
+ * @brief Returns the upper bound, in ms, of the bucket holding the given percentile.
+ *
+ * @param[in] hist Histogram to query.
+ * @param[in] percent Percentile, 0-100.
+ *
+ * @return uint32_t Bucket upper bound (exclusive) in ms, capped at the largest sample; 0 if empty.
+ */
+uint32_t XBeeStatsHistPercentile(const XBeeStatsHist_t* hist, uint8_t percent) {
+    if (hist->count == 0) return 0;
+
+    uint32_t rank = (uint32_t)(((uint64_t)hist->count * (percent > 100 ? 100 : percent) + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < XBEE_STATS_HIST_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint32_t upper = b == 0 ? 0 : (1UL << b);
+            return (b == XBEE_STATS_HIST_BUCKETS - 1 || upper > hist->maxMs) ? hist->maxMs : upper;
+        }
+    }
+    return hist->maxMs;
+}
+
+#if XBEE_STATS_ENABLED
+
+/**
+ * @brief Zeroes everything but the sequence counter, which readers may be watching.
+ */
+void xbeeStatsReset(XBeeStats_t* stats) {
+    const size_t start = offsetof(XBeeStats_t, txFrames);
+    memset((uint8_t*)stats + start, 0, sizeof(*stats) - start);
+}
+
+void xbeeStatsRecordTx(XBeeStats_t* stats, uint8_t frameType, uint16_t wireBytes) {
+    uint8_t slot = frameTypeSlot[frameType];
+    stats->txFrames[slot]++;
+    stats->txBytes[slot] += wireBytes;
+}
+
+/**
+ * @brief Records one apiReceiveApiFrame() result; frame counters are only updated on success.
+ */
+void xbeeStatsRecordRx(XBeeStats_t* stats, int status, uint8_t frameType, uint16_t wireBytes) {
+    uint32_t index = (uint32_t)(-status);
+    if (index < XBEE_STATS_RX_STATUS_COUNT) stats->rxStatus[index]++;
+    if (status == API_RECEIVE_SUCCESS) {
+        uint8_t slot = frameTypeSlot[frameType];
+        stats->rxFrames[slot]++;
+        stats->rxBytes[slot] += wireBytes;
+    }
+}
+
+void xbeeStatsHistAdd(XBeeStatsHist_t* hist, uint32_t ms) {
+    uint8_t bucket = 0;
+#if defined(__GNUC__)
+    if (ms) bucket = (uint8_t)(32 - __builtin_clz(ms));
+#else
+    for (uint32_t v = ms; v; v >>= 1) bucket++;
+#endif
+    if (bucket >= XBEE_STATS_HIST_BUCKETS) bucket = XBEE_STATS_HIST_BUCKETS - 1;
+
+    hist->buckets[bucket]++;
+    hist->count++;
+    hist->sumMs += ms;
+    if (ms > hist->maxMs) hist->maxMs = ms;
+}
+
+#endif // XBEE_STATS_ENABLED
+
+/**
+ * @brief Copies the instance's counters and histograms.
+ *
+ * Safe to call from any thread. The copy is retried while the thread that
+ * drives the instance is in the middle of an update, so every snapshot is
+ * consistent and the writer never waits for a reader.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[out] out Snapshot destination.
+ *
+ * @return bool False if stats are compiled out (XBEE_STATS_ENABLED is 0) or a pointer is NULL.
+ */
+bool XBeeGetStats(XBee* self, XBeeStats_t* out) {
+    if (!self || !out) return false;
+#if XBEE_STATS_ENABLED
+    for (;;) {
+#if defined(__GNUC__)
+        uint32_t before = __atomic_load_n(&self->stats.seq, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+        memcpy(out, &self->stats, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&self->stats.seq, __ATOMIC_RELAXED) == before) break;
+#else
+        uint32_t before = *(volatile uint32_t*)&self->stats.seq;
+        if (before & 1) continue;
+        memcpy(out, &self->stats, sizeof(*out));
+        if (*(volatile uint32_t*)&self->stats.seq == before) break;
+#endif
+    }
+    return true;
+#else
+    memset(out, 0, sizeof(*out));
+    return false;
+#endif
+}
+
+/**
+ * @brief Zeroes the instance's counters and histograms.
+ */
+void XBeeResetStats(XBee* self) {
+    if (!self) return;
+    XBEE_STATS_RESET(self);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file xbee_timeout.c
+ * @brief Adaptive AT response timeouts learned from observed round trips.
+ *
+ * This file implements the per-class round-trip estimator declared in
+ * xbee_timeout.h and the UART wire time used to scale timeouts by baud
+ * rate and frame length.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_timeout.h"
+
+static const uint32_t classDefaults[AT_LATENCY_COUNT] = {
+    [AT_LATENCY_REGISTER] = XBEE_AT_TIMEOUT_REGISTER_MS,
+    [AT_LATENCY_APPLY] = XBEE_AT_TIMEOUT_APPLY_MS,
+    [AT_LATENCY_FLASH] = XBEE_AT_TIMEOUT_FLASH_MS,
+};
+
+static uint32_t clampTimeout(uint32_t ms) {
+    if (ms < XBEE_AT_TIMEOUT_FLOOR_MS) return XBEE_AT_TIMEOUT_FLOOR_MS;
+    if (ms > XBEE_AT_TIMEOUT_CEILING_MS) return XBEE_AT_TIMEOUT_CEILING_MS;
+    return ms;
+}
+
+/**
+ * @brief Forgets all samples; every class returns to its configured default.
+ */
+void xbeeTimeoutReset(XBeeTimeouts_t* timeouts) {
+    for (uint8_t i = 0; i < AT_LATENCY_COUNT; i++) {
+        timeouts->classes[i].srtt8 = 0;
+        timeouts->classes[i].rttvar4 = 0;
+        timeouts->classes[i].rtoMs = classDefaults[i];
+        timeouts->classes[i].samples = 0;
+    }
+}
+
+/**
+ * @brief Returns the timeout of a class that has not been sampled yet.
+ *
+ * Until the first round trip is measured the class default is a lower
+ * bound, so an instance whose estimator was never reset (all zeros) still
+ * waits as long as atCommandTimeout() would; backoff may raise it further.
+ */
+static uint32_t unsampledTimeout(const XBeeTimeoutClass_t* c, uint8_t latency) {
+    return c->rtoMs > classDefaults[latency] ? c->rtoMs : classDefaults[latency];
+}
+
+/**
+ * @brief Returns the current timeout of a latency class, without wire time.
+ */
+uint32_t xbeeTimeoutGet(const XBeeTimeouts_t* timeouts, uint8_t latency) {
+    if (latency >= AT_LATENCY_COUNT) latency = AT_LATENCY_FLASH;
+    const XBeeTimeoutClass_t* c = &timeouts->classes[latency];
+    return c->samples ? c->rtoMs : unsampledTimeout(c, latency);
+}
+
+/**
+ * @brief Adds a round trip, with wire time already removed, to a class estimate.
+ *
+ * Uses the integer form of Jacobson's algorithm: gains of 1/8 for the mean
+ * and 1/4 for the deviation.
+ */
+void xbeeTimeoutSample(XBeeTimeouts_t* timeouts, uint8_t latency, uint32_t rttMs) {
+    if (latency >= AT_LATENCY_COUNT) return;
+    XBeeTimeoutClass_t* c = &timeouts->classes[latency];
+
+    if (c->samples == 0) {
+        c->srtt8 = rttMs << 3;
+        c->rttvar4 = rttMs << 1;    // rttvar = rtt / 2
+    } else {
+        int32_t err = (int32_t)rttMs - (int32_t)(c->srtt8 >> 3);
+        c->srtt8 = (uint32_t)((int32_t)c->srtt8 + err);
+        if (err < 0) err = -err;
+        c->rttvar4 = (uint32_t)((int32_t)c->rttvar4 + err - (int32_t)(c->rttvar4 >> 2));
+    }
+    c->samples++;
+    c->rtoMs = clampTimeout((c->srtt8 >> 3) + c->rttvar4);
+}
+
+/**
+ * @brief Doubles a class timeout after the module failed to answer in time.
+ */
+void xbeeTimeoutBackoff(XBeeTimeouts_t* timeouts, uint8_t latency) {
+    if (latency >= AT_LATENCY_COUNT) return;
+    XBeeTimeoutClass_t* c = &timeouts->classes[latency];
+    uint32_t rto = c->samples ? c->rtoMs : unsampledTimeout(c, latency);
+    c->rtoMs = clampTimeout(rto > XBEE_AT_TIMEOUT_CEILING_MS / 2 ? XBEE_AT_TIMEOUT_CEILING_MS : rto * 2);
+}
+
+/**
+ * @brief Returns how long `bytes` take on a UART at `baudRate` with 8N1 framing, rounded up.
+ *
+ * A baud rate of 0, as on an instance that was never initialized, is taken as 9600.
+ */
+uint32_t xbeeWireTimeMs(uint32_t baudRate, uint32_t bytes) {
+    if (baudRate == 0) baudRate = 9600;
+    return (uint32_t)(((uint64_t)bytes * 10 * 1000 + baudRate - 1) / baudRate);
+}
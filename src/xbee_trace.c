@@ -0,0 +1,222 @@
+/**
+ * @file xbee_trace.c
+ * @brief Binary event tracing for latency investigations.
+ *
+ * This file implements the single-writer event ring declared in
+ * xbee_trace.h, its lock-free snapshot and dump format, and the per-instance
+ * accessors declared in xbee.h.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_trace.h"
+#include "xbee.h"
+#include <string.h>
+
+#define TRACE_MASK (XBEE_TRACE_RING_SIZE - 1)
+
+#if defined(__GNUC__)
+#define TRACE_LOAD_HEAD(ring)           __atomic_load_n(&(ring)->head, __ATOMIC_ACQUIRE)
+#define TRACE_STORE_HEAD(ring, value)   __atomic_store_n(&(ring)->head, (value), __ATOMIC_RELEASE)
+#else
+#define TRACE_LOAD_HEAD(ring)           ((ring)->head)
+#define TRACE_STORE_HEAD(ring, value)   ((ring)->head = (value))
+#endif
+
+static void putLe16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void putLe32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Clears the ring, its instance ID and its clock.
+ */
+void XBeeTraceRingReset(XBeeTraceRing_t* ring) {
+    memset(ring, 0, sizeof(*ring));
+}
+
+/**
+ * @brief Appends one span, overwriting the oldest event when the ring is full.
+ *
+ * Must only be called from the thread that owns the ring.
+ */
+void XBeeTraceRingRecord(XBeeTraceRing_t* ring, uint32_t tsUs, uint32_t durUs, uint8_t event, uint16_t arg) {
+    uint32_t head = ring->head;
+    XBeeTraceEvent_t* e = &ring->events[head & TRACE_MASK];
+    e->tsUs = tsUs;
+    e->durUs = durUs;
+    e->event = event;
+    e->reserved = 0;
+    e->arg = arg;
+    TRACE_STORE_HEAD(ring, head + 1);
+}
+
+/**
+ * @brief Copies the newest events, oldest first, without stopping the writer.
+ *
+ * At most XBEE_TRACE_RING_SIZE - 1 events are returned: the slot of the
+ * oldest one is always the next to be written, and keeping it out means any
+ * overwrite during the copy shows up as an advanced head. Events the writer
+ * may have overwritten while they were being copied are discarded, so every
+ * returned event is intact.
+ *
+ * @param[in] ring Ring to read.
+ * @param[out] out Destination array.
+ * @param[in] maxEvents Capacity of `out`.
+ * @param[out] lost Optional; receives the number of recorded events not returned.
+ *
+ * @return size_t Number of events copied.
+ */
+size_t XBeeTraceRingSnapshot(const XBeeTraceRing_t* ring, XBeeTraceEvent_t* out, size_t maxEvents, uint32_t* lost) {
+    uint32_t end = TRACE_LOAD_HEAD(ring);
+    uint32_t count = end < XBEE_TRACE_RING_SIZE - 1 ? end : XBEE_TRACE_RING_SIZE - 1;
+    if (count > maxEvents) count = (uint32_t)maxEvents;
+    uint32_t begin = end - count;
+
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = ring->events[(begin + i) & TRACE_MASK];
+    }
+
+#if defined(__GNUC__)
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+    // Indices at or below (head - size) were rewritten, or are being rewritten, during the copy
+    uint32_t after = TRACE_LOAD_HEAD(ring);
+    uint32_t skip = 0;
+    if (after - begin >= XBEE_TRACE_RING_SIZE) {
+        skip = after - begin - XBEE_TRACE_RING_SIZE + 1;
+        if (skip > count) skip = count;
+        memmove(out, out + skip, (count - skip) * sizeof(*out));
+    }
+
+    if (lost) *lost = end - (count - skip);
+    return count - skip;
+}
+
+/**
+ * @brief Serializes a snapshot of the ring for tools/xbee_trace.
+ *
+ * Layout (little endian): "XBTR", version u8, event size u8, instance ID u16,
+ * total recorded u32, lost u32, event count u32, then per event ts u32,
+ * duration u32, event u8, reserved u8, arg u16.
+ *
+ * @param[in] ring Ring to dump.
+ * @param[out] buf Destination buffer.
+ * @param[in] size Size of `buf`; events that do not fit are counted as lost.
+ *
+ * @return size_t Bytes written, or 0 if `buf` cannot hold the header.
+ */
+size_t XBeeTraceRingDump(const XBeeTraceRing_t* ring, uint8_t* buf, size_t size) {
+    XBeeTraceEvent_t events[XBEE_TRACE_RING_SIZE];
+    uint32_t lost = 0;
+
+    if (!buf || size < XBEE_TRACE_DUMP_HEADER_SIZE) return 0;
+
+    size_t fit = (size - XBEE_TRACE_DUMP_HEADER_SIZE) / XBEE_TRACE_DUMP_EVENT_SIZE;
+    size_t count = XBeeTraceRingSnapshot(ring, events, XBEE_TRACE_RING_SIZE, &lost);
+    size_t first = 0;
+    if (count > fit) {
+        first = count - fit;
+        lost += (uint32_t)first;
+    }
+
+    memcpy(buf, XBEE_TRACE_DUMP_MAGIC, 4);
+    buf[4] = XBEE_TRACE_DUMP_VERSION;
+    buf[5] = XBEE_TRACE_DUMP_EVENT_SIZE;
+    putLe16(&buf[6], ring->instanceId);
+    putLe32(&buf[8], lost + (uint32_t)(count - first));
+    putLe32(&buf[12], lost);
+    putLe32(&buf[16], (uint32_t)(count - first));
+
+    uint8_t* p = buf + XBEE_TRACE_DUMP_HEADER_SIZE;
+    for (size_t i = first; i < count; i++) {
+        putLe32(&p[0], events[i].tsUs);
+        putLe32(&p[4], events[i].durUs);
+        p[8] = events[i].event;
+        p[9] = 0;
+        putLe16(&p[10], events[i].arg);
+        p += XBEE_TRACE_DUMP_EVENT_SIZE;
+    }
+    return (size_t)(p - buf);
+}
+
+#if XBEE_TRACE_ENABLED
+
+/**
+ * @brief Returns the trace timestamp for an instance in microseconds.
+ */
+uint32_t xbeeTraceNow(const XBee* self) {
+    if (self->trace.clockUs) return self->trace.clockUs();
+    return self->htable->PortMillis() * 1000UL;
+}
+
+#endif // XBEE_TRACE_ENABLED
+
+/**
+ * @brief Labels an instance's trace and selects its clock.
+ *
+ * Call after XBeeInit(), which clears the ring. Without a microsecond clock
+ * timestamps come from PortMillis() and have millisecond resolution.
+ *
+ * @param[in] self Pointer to the XBee instance.
+ * @param[in] instanceId Identifier written to dumps; the converter shows each ID as its own process.
+ * @param[in] clockUs Optional free-running microsecond clock, or NULL.
+ */
+void XBeeTraceConfigure(XBee* self, uint16_t instanceId, uint32_t (*clockUs)(void)) {
+#if XBEE_TRACE_ENABLED
+    if (!self) return;
+    self->trace.instanceId = instanceId;
+    self->trace.clockUs = clockUs;
+#else
+    (void)self;
+    (void)instanceId;
+    (void)clockUs;
+#endif
+}
+
+/**
+ * @brief Serializes an instance's trace ring, see XBeeTraceRingDump().
+ *
+ * @return size_t Bytes written; 0 when tracing is compiled out.
+ */
+size_t XBeeTraceDump(XBee* self, uint8_t* buf, size_t size) {
+#if XBEE_TRACE_ENABLED
+    if (!self) return 0;
+    return XBeeTraceRingDump(&self->trace, buf, size);
+#else
+    (void)self;
+    (void)buf;
+    (void)size;
+    return 0;
+#endif
+}
@@ -0,0 +1,191 @@
+#include "unity.h"
+#include "port_capture.h"
+#include "port_replay.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define CAPTURE_PATH "test_port_capture.xbcap"
+
+// ==== TEST OBJECTS ====
+
+static const XBeeHTable captureHTable = {
+    .PortUartRead  = portCaptureUartRead,
+    .PortUartWrite = portCaptureUartWrite,
+    .PortMillis    = portCaptureMillis,
+    .PortFlushRx   = portCaptureFlushRx,
+    .PortUartInit  = portCaptureUartInit,
+    .PortDelay     = portCaptureDelay,
+};
+
+static const XBeeHTable replayHTable = {
+    .PortUartRead  = portReplayUartRead,
+    .PortUartWrite = portReplayUartWrite,
+    .PortMillis    = portReplayMillis,
+    .PortFlushRx   = portReplayFlushRx,
+    .PortUartInit  = portReplayUartInit,
+    .PortDelay     = portReplayDelay,
+};
+
+static const XBeeCTable emptyCTable = {0};
+
+// Answers every AT query with a two byte value after 40 ms
+static void replyToAtCommands(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    const uint8_t value[] = { 0x12, 0x34 };
+    portVClockScheduleAtResponse(40, data, len, 0x00, value, sizeof(value));
+}
+
+// Runs two AT queries through an LR instance on the given HAL
+static void runAtSession(const XBeeHTable* hal, uint8_t results[2][2]) {
+    XBeeLR* lr = XBeeLRCreate(&emptyCTable, hal);
+    uint8_t len = 0;
+    XBeeInit((XBee*)lr, 9600, NULL);
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          results[0], &len, 5000, 2));
+    hal->PortDelay(250);
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)lr, AT_HV, NULL, 0,
+                          results[1], &len, 5000, 2));
+    free(lr);
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+}
+
+void tearDown(void) {
+    portCaptureStop();
+    portReplayClose();
+    remove(CAPTURE_PATH);
+}
+
+// ==== CAPTURE ====
+
+void test_capture_records_timestamped_chunks_in_order(void) {
+    const uint8_t tx[] = { 0x7E, 0x00, 0x01 };
+    const uint8_t rx[] = { 0xAA, 0xBB };
+    uint8_t buf[4];
+    PortCaptureReader_t reader;
+    PortCaptureRecord_t record;
+
+    portVClockAdvance(1000);
+    TEST_ASSERT_TRUE(portCaptureStart(&portVClockHTable, CAPTURE_PATH));
+    portCaptureDelay(5);
+    portCaptureUartWrite(tx, sizeof(tx));
+    portVClockScheduleRx(20, rx, sizeof(rx));
+    portCaptureDelay(20);
+    TEST_ASSERT_EQUAL_INT(2, portCaptureUartRead(buf, sizeof(buf)));
+    portCaptureStop();
+
+    TEST_ASSERT_TRUE(portCaptureReaderOpen(&reader, CAPTURE_PATH));
+    TEST_ASSERT_TRUE(portCaptureReaderNext(&reader, &record));
+    TEST_ASSERT_EQUAL_UINT8(PORT_CAPTURE_DIR_TX, record.dir);
+    TEST_ASSERT_EQUAL_UINT32(5, record.timestampMs);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(tx), record.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tx, record.data, sizeof(tx));
+
+    TEST_ASSERT_TRUE(portCaptureReaderNext(&reader, &record));
+    TEST_ASSERT_EQUAL_UINT8(PORT_CAPTURE_DIR_RX, record.dir);
+    TEST_ASSERT_EQUAL_UINT32(25, record.timestampMs);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(rx, record.data, sizeof(rx));
+
+    TEST_ASSERT_FALSE(portCaptureReaderNext(&reader, &record));
+    portCaptureReaderClose(&reader);
+}
+
+void test_capture_merges_same_direction_chunks_within_a_millisecond(void) {
+    const uint8_t bytes[] = { 1, 2, 3 };
+    PortCaptureReader_t reader;
+    PortCaptureRecord_t record;
+
+    TEST_ASSERT_TRUE(portCaptureStart(&portVClockHTable, CAPTURE_PATH));
+    portCaptureUartWrite(&bytes[0], 1);
+    portCaptureUartWrite(&bytes[1], 2);
+    portCaptureDelay(1);
+    portCaptureUartWrite(&bytes[0], 1);
+    portCaptureStop();
+
+    TEST_ASSERT_TRUE(portCaptureReaderOpen(&reader, CAPTURE_PATH));
+    TEST_ASSERT_TRUE(portCaptureReaderNext(&reader, &record));
+    TEST_ASSERT_EQUAL_UINT16(3, record.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes, record.data, 3);
+    TEST_ASSERT_TRUE(portCaptureReaderNext(&reader, &record));
+    TEST_ASSERT_EQUAL_UINT16(1, record.length);
+    TEST_ASSERT_EQUAL_UINT32(1, record.timestampMs);
+    TEST_ASSERT_FALSE(portCaptureReaderNext(&reader, &record));
+    portCaptureReaderClose(&reader);
+}
+
+void test_capture_reader_rejects_non_capture_file(void) {
+    PortCaptureReader_t reader;
+    FILE* f = fopen(CAPTURE_PATH, "wb");
+    fputs("not a capture", f);
+    fclose(f);
+    TEST_ASSERT_FALSE(portCaptureReaderOpen(&reader, CAPTURE_PATH));
+}
+
+// ==== REPLAY ====
+
+void test_replay_reproduces_captured_session(void) {
+    uint8_t live[2][2];
+    uint8_t replayed[2][2];
+
+    portVClockSetWriteHook(replyToAtCommands, NULL);
+    TEST_ASSERT_TRUE(portCaptureStart(&portVClockHTable, CAPTURE_PATH));
+    runAtSession(&captureHTable, live);
+    portCaptureStop();
+    uint32_t liveDuration = portVClockNow();
+
+    TEST_ASSERT_TRUE(portReplayOpen(CAPTURE_PATH));
+    runAtSession(&replayHTable, replayed);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(live, replayed, sizeof(live));
+    TEST_ASSERT_EQUAL_HEX8(0x12, replayed[1][0]);
+    TEST_ASSERT_TRUE(portReplayDone());
+    TEST_ASSERT_EQUAL_UINT32(0, portReplayTxMismatches());
+    TEST_ASSERT_EQUAL_UINT32(liveDuration, portReplayMillis());
+}
+
+void test_replay_holds_responses_until_request_is_written(void) {
+    const uint8_t tx[] = { 0x01, 0x02 };
+    const uint8_t rx[] = { 0x03 };
+    uint8_t buf[2];
+
+    TEST_ASSERT_TRUE(portCaptureStart(&portVClockHTable, CAPTURE_PATH));
+    portCaptureUartWrite(tx, sizeof(tx));
+    portVClockScheduleRx(30, rx, sizeof(rx));
+    portCaptureDelay(30);
+    portCaptureUartRead(buf, sizeof(buf));
+    portCaptureStop();
+
+    TEST_ASSERT_TRUE(portReplayOpen(CAPTURE_PATH));
+    portReplayDelay(500);
+    TEST_ASSERT_EQUAL_INT(0, portReplayUartRead(buf, sizeof(buf)));
+
+    portReplayUartWrite(tx, sizeof(tx));
+    portReplayDelay(29);
+    TEST_ASSERT_EQUAL_INT(0, portReplayUartRead(buf, sizeof(buf)));
+    portReplayDelay(1);
+    TEST_ASSERT_EQUAL_INT(1, portReplayUartRead(buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(portReplayDone());
+}
+
+void test_replay_counts_tx_mismatches(void) {
+    const uint8_t tx[] = { 0x01, 0x02, 0x03 };
+    const uint8_t other[] = { 0x01, 0xFF, 0x03, 0x04 };
+
+    TEST_ASSERT_TRUE(portCaptureStart(&portVClockHTable, CAPTURE_PATH));
+    portCaptureUartWrite(tx, sizeof(tx));
+    portCaptureStop();
+
+    TEST_ASSERT_TRUE(portReplayOpen(CAPTURE_PATH));
+    portReplayUartWrite(other, sizeof(other));
+    TEST_ASSERT_EQUAL_UINT32(2, portReplayTxMismatches());
+}
@@ -0,0 +1,184 @@
+#include "unity.h"
+#include "port_fault.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeHTable faultHTable = {
+    .PortUartRead  = portFaultUartRead,
+    .PortUartWrite = portFaultUartWrite,
+    .PortMillis    = portFaultMillis,
+    .PortFlushRx   = portFaultFlushRx,
+    .PortUartInit  = portFaultUartInit,
+    .PortDelay     = portFaultDelay,
+};
+
+static const XBeeCTable emptyCTable = {0};
+static const uint8_t modemStatus[] = { XBEE_API_TYPE_MODEM_STATUS, 0x00 };
+static const uint8_t bytes[] = { 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80 };
+
+static void startFaults(const PortFaultConfig_t* config) {
+    portFaultStart(&portVClockHTable, config);
+}
+
+static int readAll(uint8_t* buf, int size) {
+    int total = 0;
+    for (int i = 0; i < 64 && total < size; i++) {
+        total += portFaultUartRead(buf + total, size - total);
+    }
+    return total;
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+}
+
+void tearDown(void) {}
+
+// ==== BYTE FAULTS ====
+
+void test_fault_shim_is_transparent_with_zero_rates(void) {
+    PortFaultConfig_t config = {0};
+    PortFaultStats_t stats;
+    uint8_t buf[16];
+    startFaults(&config);
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+
+    TEST_ASSERT_EQUAL_INT(sizeof(bytes), readAll(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes, buf, sizeof(bytes));
+    portFaultGetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.faults);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(bytes), stats.bytesOut);
+}
+
+void test_fault_bit_flip_changes_exactly_one_bit_per_byte(void) {
+    PortFaultConfig_t config = { .seed = 7, .bitFlipPpm = PORT_FAULT_PPM };
+    uint8_t buf[16];
+    startFaults(&config);
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+
+    TEST_ASSERT_EQUAL_INT(sizeof(bytes), readAll(buf, sizeof(buf)));
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        uint8_t diff = buf[i] ^ bytes[i];
+        TEST_ASSERT_TRUE(diff != 0 && (diff & (diff - 1)) == 0);
+    }
+}
+
+void test_fault_drop_and_duplicate_change_stream_length(void) {
+    PortFaultConfig_t drop = { .dropPpm = PORT_FAULT_PPM };
+    PortFaultConfig_t duplicate = { .duplicatePpm = PORT_FAULT_PPM };
+    PortFaultStats_t stats;
+    uint8_t buf[32];
+
+    startFaults(&drop);
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(0, readAll(buf, sizeof(buf)));
+    portFaultGetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(bytes), stats.drops);
+
+    startFaults(&duplicate);
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(2 * sizeof(bytes), readAll(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(bytes[0], buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(bytes[0], buf[1]);
+}
+
+void test_fault_garbage_is_inserted_before_each_byte(void) {
+    PortFaultConfig_t config = { .garbagePpm = PORT_FAULT_PPM };
+    uint8_t buf[32];
+    startFaults(&config);
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+
+    TEST_ASSERT_EQUAL_INT(2 * sizeof(bytes), readAll(buf, sizeof(buf)));
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        TEST_ASSERT_EQUAL_HEX8(bytes[i], buf[2 * i + 1]);
+    }
+}
+
+void test_fault_delay_holds_bytes_until_release_time(void) {
+    PortFaultConfig_t config = { .delayPpm = PORT_FAULT_PPM, .delayMs = 100 };
+    uint8_t buf[16];
+    startFaults(&config);
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+
+    TEST_ASSERT_EQUAL_INT(0, portFaultUartRead(buf, sizeof(buf)));
+    portVClockDelay(99);
+    TEST_ASSERT_EQUAL_INT(0, portFaultUartRead(buf, sizeof(buf)));
+    portVClockDelay(1);
+    TEST_ASSERT_TRUE(portFaultUartRead(buf, sizeof(buf)) > 0);
+    TEST_ASSERT_EQUAL_HEX8(bytes[0], buf[0]);
+}
+
+// ==== FRAME FAULTS AND RECOVERY ====
+
+void test_fault_truncate_cuts_every_frame_short(void) {
+    PortFaultConfig_t config = { .seed = 3, .truncatePpm = PORT_FAULT_PPM };
+    PortFaultStats_t stats;
+    uint8_t buf[64];
+    startFaults(&config);
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+
+    int n = readAll(buf, sizeof(buf));
+    portFaultGetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.framesIn);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.truncations);
+    TEST_ASSERT_TRUE(n < 2 * (int)(sizeof(modemStatus) + 4));
+    TEST_ASSERT_TRUE(n >= 2 * 3);
+}
+
+void test_apiReceiveApiFrame_resyncs_on_next_delimiter_after_corrupt_delimiter(void) {
+    PortFaultConfig_t flip = { .seed = 11, .bitFlipPpm = PORT_FAULT_PPM };
+    PortFaultConfig_t clean = {0};
+    PortFaultStats_t stats;
+    xbee_api_frame_t frame;
+    XBeeLR* lr = XBeeLRCreate(&emptyCTable, &faultHTable);
+    portFaultStart(&portVClockHTable, &clean);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+    portVClockScheduleFrame(10, modemStatus, sizeof(modemStatus));
+
+    // Only the first delimiter is corrupted
+    startFaults(&flip);
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_INVALID_START_DELIMITER, apiReceiveApiFrame((XBee*)lr, &frame));
+    portFaultGetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.bitFlips);
+    startFaults(&clean);
+
+    // The rest of the first frame is discarded one byte per call
+    int errors = 0;
+    while (apiReceiveApiFrame((XBee*)lr, &frame) != API_RECEIVE_SUCCESS && errors < 16) {
+        errors++;
+    }
+    TEST_ASSERT_EQUAL_INT(sizeof(modemStatus) + 3, errors);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_API_TYPE_MODEM_STATUS, frame.type);
+    free(lr);
+}
+
+void test_apiReceiveApiFrame_loses_no_frames_to_short_delays(void) {
+    PortFaultConfig_t config = { .seed = 5, .delayPpm = 50000, .delayMs = 50 };
+    PortFaultStats_t stats;
+    xbee_api_frame_t frame;
+    XBeeLR* lr = XBeeLRCreate(&emptyCTable, &faultHTable);
+    int received = 0;
+    startFaults(&config);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    for (int i = 0; i < 20; i++) {
+        portVClockScheduleFrame(10 * i, modemStatus, sizeof(modemStatus));
+    }
+
+    for (int i = 0; i < 20; i++) {
+        if (apiReceiveApiFrame((XBee*)lr, &frame) == API_RECEIVE_SUCCESS) received++;
+    }
+    portFaultGetStats(&stats);
+    TEST_ASSERT_TRUE(stats.delays > 0);
+    TEST_ASSERT_EQUAL_INT(20, received);
+    free(lr);
+}
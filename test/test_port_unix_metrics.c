@@ -0,0 +1,139 @@
+#include "unity.h"
+#include "port_unix_metrics.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+static const uint8_t modemStatus[] = { XBEE_API_TYPE_MODEM_STATUS, 0x00 };
+
+static XBeeLR* lr;
+static char* text;
+static size_t textLen;
+
+static void scrape(void) {
+    free(text);
+    text = NULL;
+    FILE* out = open_memstream(&text, &textLen);
+    portUnixMetricsWrite(out);
+    fclose(out);
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    text = NULL;
+}
+
+void tearDown(void) {
+    portUnixMetricsStop();
+    portUnixMetricsUnregister((XBee*)lr);
+    free(lr);
+    free(text);
+    text = NULL;
+}
+
+// ==== TEXT FORMAT ====
+
+void test_metrics_export_frame_counters_by_type(void) {
+    xbee_api_frame_t frame;
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+    apiReceiveApiFrame((XBee*)lr, &frame);
+    TEST_ASSERT_TRUE(portUnixMetricsRegister((XBee*)lr, "gw\"1"));
+
+    scrape();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE xbee_rx_frames_total counter\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_rx_frames_total{instance=\"gw\\\"1\",type=\"0x8A\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_rx_bytes_total{instance=\"gw\\\"1\",type=\"0x8A\"} 6\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_rx_results_total{instance=\"gw\\\"1\",result=\"success\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_at_timeouts_total{instance=\"gw\\\"1\"} 0\n"));
+    // No RSSI has been reported yet
+    TEST_ASSERT_NULL(strstr(text, "xbee_link_rssi_dbm{"));
+}
+
+void test_metrics_export_histograms_in_seconds(void) {
+    portUnixMetricsRegister((XBee*)lr, "gw");
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+    XBeeProcess((XBee*)lr);
+
+    scrape();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE xbee_process_loop_seconds histogram\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_process_loop_seconds_bucket{instance=\"gw\",le=\"+Inf\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_process_loop_seconds_count{instance=\"gw\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_at_round_trip_seconds_bucket{instance=\"gw\",le=\"0.002\"} 0\n"));
+}
+
+void test_metrics_export_at_responses_by_command(void) {
+    const uint8_t resp[] = { XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x00, 0x10, 0x10 };
+    xbee_api_frame_t frame;
+    portUnixMetricsRegister((XBee*)lr, "gw");
+    portVClockScheduleFrame(0, resp, sizeof(resp));
+    apiReceiveApiFrame((XBee*)lr, &frame);
+
+    scrape();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE xbee_at_responses_total counter\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "xbee_at_responses_total{instance=\"gw\",command=\"VR\"} 1\n"));
+    TEST_ASSERT_NULL(strstr(text, "command=\"SL\""));
+}
+
+void test_metrics_unregistered_instances_are_not_exported(void) {
+    portUnixMetricsRegister((XBee*)lr, "gw");
+    portUnixMetricsUnregister((XBee*)lr);
+
+    scrape();
+    TEST_ASSERT_NULL(strstr(text, "instance=\"gw\""));
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE xbee_tx_errors_total counter\n"));
+}
+
+// ==== HTTP SERVER ====
+
+void test_metrics_served_over_unix_socket(void) {
+    char path[64];
+    char response[8192];
+    size_t received = 0;
+    snprintf(path, sizeof(path), "/tmp/xbee_metrics_test_%d.sock", (int)getpid());
+    char address[80];
+    snprintf(address, sizeof(address), "unix:%s", path);
+
+    portUnixMetricsRegister((XBee*)lr, "gw");
+    TEST_ASSERT_TRUE(portUnixMetricsStart(address));
+    TEST_ASSERT_FALSE(portUnixMetricsStart(address));
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, path);
+    TEST_ASSERT_EQUAL_INT(0, connect(fd, (struct sockaddr*)&addr, sizeof(addr)));
+    const char request[] = "GET /metrics HTTP/1.0\r\n\r\n";
+    TEST_ASSERT_EQUAL_INT((int)sizeof(request) - 1, (int)send(fd, request, sizeof(request) - 1, 0));
+    for (;;) {
+        ssize_t n = recv(fd, response + received, sizeof(response) - 1 - received, 0);
+        if (n <= 0) break;
+        received += (size_t)n;
+    }
+    response[received] = '\0';
+    close(fd);
+
+    TEST_ASSERT_EQUAL_MEMORY("HTTP/1.0 200 OK\r\n", response, 17);
+    TEST_ASSERT_NOT_NULL(strstr(response, "text/plain; version=0.0.4"));
+    TEST_ASSERT_NOT_NULL(strstr(response, "xbee_at_commands_total{instance=\"gw\"} 0\n"));
+
+    portUnixMetricsStop();
+    TEST_ASSERT_NOT_EQUAL(0, access(path, F_OK));
+}
+
+void test_metrics_reject_bad_addresses(void) {
+    TEST_ASSERT_FALSE(portUnixMetricsStart("not-a-port"));
+    TEST_ASSERT_FALSE(portUnixMetricsStart("127.0.0.1:0"));
+    TEST_ASSERT_FALSE(portUnixMetricsStart("localhost:9464"));
+}
@@ -0,0 +1,180 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+static XBeeLR* lr;
+
+// Replies to every ATJS query with "joined" after 50 ms of module latency
+static void replyJoined(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    const uint8_t joined = 0x01;
+    if (len >= 8 && data[5] == 'J' && data[6] == 'S') {
+        portVClockScheduleAtResponse(50, data, len, 0x00, &joined, 1);
+    }
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+}
+
+void tearDown(void) {
+    free(lr);
+}
+
+// ==== CLOCK AND SCRIPTING ====
+
+void test_vclock_starts_at_zero_and_advances_only_on_delay(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockMillis());
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockMillis());
+    portVClockDelay(25);
+    TEST_ASSERT_EQUAL_UINT32(25, portVClockMillis());
+    portVClockAdvance(1000);
+    TEST_ASSERT_EQUAL_UINT32(1025, portVClockNow());
+}
+
+void test_vclock_rx_is_not_readable_before_due(void) {
+    const uint8_t bytes[] = { 0x11, 0x22, 0x33 };
+    uint8_t buf[8];
+    TEST_ASSERT_TRUE(portVClockScheduleRx(100, bytes, sizeof(bytes)));
+
+    TEST_ASSERT_EQUAL_INT(0, portVClockUartRead(buf, sizeof(buf)));
+    portVClockDelay(99);
+    TEST_ASSERT_EQUAL_INT(0, portVClockUartRead(buf, sizeof(buf)));
+    portVClockDelay(1);
+    TEST_ASSERT_EQUAL_INT(3, portVClockUartRead(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes, buf, sizeof(bytes));
+    TEST_ASSERT_EQUAL_size_t(0, portVClockPendingRx());
+}
+
+void test_vclock_rx_chunks_are_delivered_in_due_order(void) {
+    const uint8_t late[] = { 0xBB };
+    const uint8_t early[] = { 0xAA };
+    const uint8_t same[] = { 0xCC };
+    uint8_t buf[4] = {0};
+    portVClockScheduleRx(20, late, 1);
+    portVClockScheduleRx(10, early, 1);
+    portVClockScheduleRx(20, same, 1);
+
+    portVClockDelay(20);
+    TEST_ASSERT_EQUAL_INT(3, portVClockUartRead(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0xAA, buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xBB, buf[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xCC, buf[2]);
+}
+
+void test_vclock_partial_reads_resume_mid_chunk(void) {
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5 };
+    uint8_t buf[5];
+    portVClockScheduleRx(0, bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(2, portVClockUartRead(buf, 2));
+    TEST_ASSERT_EQUAL_INT(3, portVClockUartRead(&buf[2], 3));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes, buf, sizeof(bytes));
+}
+
+void test_vclock_flush_keeps_future_bytes(void) {
+    const uint8_t now[] = { 0x01 };
+    const uint8_t later[] = { 0x02 };
+    uint8_t buf[2];
+    portVClockScheduleRx(0, now, 1);
+    portVClockScheduleRx(500, later, 1);
+
+    portVClockFlushRx();
+    TEST_ASSERT_EQUAL_size_t(1, portVClockPendingRx());
+    portVClockDelay(500);
+    TEST_ASSERT_EQUAL_INT(1, portVClockUartRead(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0x02, buf[0]);
+}
+
+void test_vclock_schedule_frame_adds_header_and_checksum(void) {
+    const uint8_t data[] = { 0x88, 0x01, 'V', 'R', 0x00, 0x12 };
+    const uint8_t expected[] = { 0x7E, 0x00, 0x06, 0x88, 0x01, 'V', 'R', 0x00, 0x12, 0xBC };
+    uint8_t buf[sizeof(expected)];
+    portVClockScheduleFrame(0, data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(sizeof(expected), portVClockUartRead(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(expected));
+}
+
+void test_vclock_at_response_echoes_frame_id_and_command(void) {
+    const uint8_t request[] = { 0x7E, 0x00, 0x04, 0x08, 0x01, 'V', 'R', 0x4E };
+    const uint8_t value = 0x12;
+    const uint8_t expected[] = { 0x7E, 0x00, 0x06, 0x88, 0x01, 'V', 'R', 0x00, 0x12, 0xBC };
+    uint8_t buf[sizeof(expected)];
+
+    TEST_ASSERT_TRUE(portVClockScheduleAtResponse(0, request, sizeof(request), 0x00, &value, 1));
+    TEST_ASSERT_EQUAL_INT(sizeof(expected), portVClockUartRead(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(expected));
+
+    // Anything but a local AT command is left for the caller
+    const uint8_t txRequest[] = { 0x7E, 0x00, 0x04, 0x10, 0x01, 'V', 'R', 0x00 };
+    TEST_ASSERT_FALSE(portVClockScheduleAtResponse(0, txRequest, sizeof(txRequest), 0x00, NULL, 0));
+    TEST_ASSERT_EQUAL_size_t(0, portVClockPendingRx());
+}
+
+void test_vclock_captures_writes(void) {
+    const uint8_t bytes[] = { 0x7E, 0x00 };
+    TEST_ASSERT_EQUAL_INT(2, portVClockUartWrite(bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_size_t(2, portVClockTxLength());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes, portVClockTxData(), 2);
+    portVClockTxClear();
+    TEST_ASSERT_EQUAL_size_t(0, portVClockTxLength());
+}
+
+// ==== LIBRARY TIMEOUT PATHS ====
+
+void test_apiReceiveApiFrame_times_out_after_virtual_read_timeout(void) {
+    xbee_api_frame_t frame;
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER, apiReceiveApiFrame((XBee*)lr, &frame));
+    TEST_ASSERT_GREATER_OR_EQUAL(UART_READ_TIMEOUT_MS, portVClockNow());
+    TEST_ASSERT_LESS_THAN(UART_READ_TIMEOUT_MS + 10, portVClockNow());
+}
+
+void test_apiSendAtCommandAndGetResponse_receives_scripted_reply(void) {
+    const uint8_t resp[] = { XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x00, 0x10, 0x10 };
+    uint8_t value[4];
+    uint8_t valueLen = 0;
+    portVClockScheduleFrame(30, resp, sizeof(resp));
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          value, &valueLen, 5000, sizeof(value)));
+    TEST_ASSERT_EQUAL_UINT8(2, valueLen);
+    TEST_ASSERT_EQUAL_HEX8(0x10, value[0]);
+    TEST_ASSERT_LESS_THAN(100, portVClockNow());
+}
+
+void test_XBeeLRSendPacket_times_out_without_tx_status(void) {
+    uint8_t payload[] = { 0xC0, 0xFF, 0xEE };
+    XBeeLRPacket_t packet = { .payload = payload, .payloadSize = sizeof(payload), .port = 2 };
+
+    TEST_ASSERT_EQUAL_HEX8(0xFF, XBeeLRSendPacket((XBee*)lr, &packet));
+    TEST_ASSERT_GREATER_OR_EQUAL(SEND_DATA_TIMEOUT_MS, portVClockNow());
+}
+
+void test_XBeeLRSendPacket_returns_scripted_delivery_status(void) {
+    uint8_t payload[] = { 0xC0, 0xFF, 0xEE };
+    XBeeLRPacket_t packet = { .payload = payload, .payloadSize = sizeof(payload), .port = 2 };
+    const uint8_t status[] = { XBEE_API_TYPE_TX_STATUS, 0x01, XBEE_DELIVERY_STATUS_NO_ACK };
+    portVClockScheduleFrame(1500, status, sizeof(status));
+
+    TEST_ASSERT_EQUAL_HEX8(XBEE_DELIVERY_STATUS_NO_ACK, XBeeLRSendPacket((XBee*)lr, &packet));
+    TEST_ASSERT_LESS_THAN(SEND_DATA_TIMEOUT_MS, portVClockNow());
+}
+
+void test_XBeeLRConnect_waits_virtual_join_window_then_checks_status(void) {
+    portVClockSetWriteHook(replyJoined, NULL);
+
+    TEST_ASSERT_TRUE(XBeeConnect((XBee*)lr, true));
+    TEST_ASSERT_GREATER_OR_EQUAL(CONNECTION_TIMEOUT_MS, portVClockNow());
+}
@@ -90,10 +90,16 @@ static XBeeVTable mockVTable = {
     .configure = MockConfigure
 };
 
+static const XBeeHTable mockHTable = {
+    .PortMillis = portMillis,
+    .PortDelay = portDelay,
+};
+
 static XBee xbee;
 
 void setUp(void) {
     xbee.vtable = &mockVTable;
+    xbee.htable = &mockHTable;
     xbee.frameIdCntr = 0;
 
     mockInitCalled = false;
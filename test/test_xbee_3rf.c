@@ -0,0 +1,831 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_3rf.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static void onReceive(XBee* self, void* data);
+static void onSend(XBee* self, void* data);
+
+static const XBeeCTable callbackCTable = {
+    .OnReceiveCallback = onReceive,
+    .OnSendCallback = onSend,
+};
+
+#define NODE_A 0x0013A20041000001ULL
+#define NODE_B 0x0013A20041000002ULL
+#define NODE_C 0x0013A20041000003ULL
+#define MAX_RECORDS 16
+
+typedef struct {
+    uint8_t frameId;
+    uint64_t address64;
+    uint8_t status;
+    uint8_t retries;
+} SendRecord_t;
+
+static XBee3RF* rf;
+
+// Scripted module
+static bool answerTx;           // Reply to TX requests with a status
+static bool legacyStatus;       // 0x89 instead of 0x8B, as 802.15.4 firmware does
+static uint32_t statusLatencyMs;
+static uint8_t statusCode;
+static uint8_t association;
+static uint8_t lastRequest[64];
+static uint16_t lastRequestLength;
+static bool digiMesh;           // Ends node discovery with an empty response
+static int ndRequests;
+static uint8_t lastRoute[64];   // Last Create Source Route frame
+static uint16_t lastRouteLength;
+static int routesSent;
+
+// Scripted remote nodes, indexed by the low byte of their address
+#define REMOTE_NODES 32
+#define REMOTE_BASE 0x0013A20041000100ULL
+typedef struct {
+    uint8_t silentAttempts;     // Requests ignored before answering
+    uint8_t wrongSource;        // Requests answered from another address first
+    uint8_t status;
+    uint8_t seen;
+} RemoteNode_t;
+static RemoteNode_t remote[REMOTE_NODES];
+static uint32_t remoteRequestTimes[64];
+static int remoteRequests;
+static uint8_t lastRemote[64];
+static uint16_t lastRemoteLength;
+
+// What the host saw
+static SendRecord_t sent[MAX_RECORDS];         // Frame ID and destination of each TX request
+static int sentCount;
+static SendRecord_t completed[MAX_RECORDS];    // OnSendCallback reports
+static int completedCount;
+static XBee3RFPacket_t received;
+static uint8_t receivedPayload[32];
+static int receives;
+
+static void scheduleStatus(uint32_t delayMs, uint8_t frameId, uint8_t status) {
+    if (legacyStatus) {
+        const uint8_t frame[] = { XBEE_API_TYPE_TX_STATUS, frameId, status };
+        portVClockScheduleFrame(delayMs, frame, sizeof(frame));
+    } else {
+        const uint8_t frame[] = { XBEE_API_TYPE_3RF_EXTENDED_TX_STATUS, frameId, 0x12, 0x34, 2, status, 0x00 };
+        portVClockScheduleFrame(delayMs, frame, sizeof(frame));
+    }
+}
+
+static void scheduleNode(uint32_t delayMs, uint8_t frameId, uint64_t address64, uint16_t address16, const char* ni) {
+    uint8_t frame[48] = { XBEE_API_TYPE_AT_RESPONSE, frameId, 'N', 'D', 0x00, address16 >> 8, address16 & 0xFF };
+    uint16_t length = 7;
+
+    for (int i = 7; i >= 0; i--) frame[length++] = (uint8_t)(address64 >> (8 * i));
+    memcpy(&frame[length], ni, strlen(ni) + 1);
+    length += strlen(ni) + 1;
+    // Parent, device type, status, profile and manufacturer
+    const uint8_t tail[] = { 0xFF, 0xFE, 0x01, 0x00, 0xC1, 0x05, 0x10, 0x1E };
+    memcpy(&frame[length], tail, sizeof(tail));
+    portVClockScheduleFrame(delayMs, frame, length + sizeof(tail));
+}
+
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    if (len >= 8 && data[3] == XBEE_API_TYPE_AT_COMMAND && data[5] == 'L' && data[6] == 'D') {
+        const uint8_t timeout[] = { 0x00, 0x3C };  // 6 s
+        portVClockScheduleAtResponse(1, data, len, 0x00, timeout, sizeof(timeout));
+        return;
+    }
+    if (len >= 8 && data[3] == XBEE_API_TYPE_AT_COMMAND && data[5] == 'N' && data[6] == 'D') {
+        ndRequests++;
+        scheduleNode(200, data[4], NODE_A, 0x1A2B, "sensor-a");
+        scheduleNode(1500, data[4], NODE_B, 0x3C4D, "sensor-b");
+        if (digiMesh) {
+            portVClockScheduleAtResponse(2000, data, len, 0x00, NULL, 0);
+        }
+        return;
+    }
+    if (len >= 8 && data[3] == XBEE_API_TYPE_AT_COMMAND && data[5] == 'I' && data[6] == 'S') {
+        // DIO4 high of DIO1 and DIO4, AD2 = 0x200
+        const uint8_t sample[] = { 0x01, 0x00, 0x12, 0x04, 0x00, 0x10, 0x02, 0x00 };
+        portVClockScheduleAtResponse(1, data, len, 0x00, sample, sizeof(sample));
+        return;
+    }
+    if (len >= 8 && data[3] == XBEE_API_TYPE_AT_COMMAND) {
+        // Queries get a one-byte value, sets a bare OK
+        portVClockScheduleAtResponse(1, data, len, 0x00, &association, len == 8 ? 1 : 0);
+        return;
+    }
+    if (len >= 18 && data[3] == XBEE_API_TYPE_3RF_REMOTE_AT_COMMAND) {
+        lastRemoteLength = len < sizeof(lastRemote) ? len : sizeof(lastRemote);
+        memcpy(lastRemote, data, lastRemoteLength);
+        if (remoteRequests < 64) remoteRequestTimes[remoteRequests] = portVClockNow();
+        remoteRequests++;
+
+        RemoteNode_t* node = &remote[data[12] % REMOTE_NODES];
+        uint8_t attempt = node->seen++;
+        if (attempt < node->silentAttempts) return;
+        // Frame ID, source, command, status and a two-byte value
+        uint8_t resp[] = { XBEE_API_TYPE_3RF_REMOTE_AT_RESPONSE, data[4], 0, 0, 0, 0, 0, 0, 0, 0,
+                           0x12, 0x34, data[16], data[17], node->status, 0xAB, data[12] };
+        memcpy(&resp[2], &data[5], 8);
+        if (attempt < node->silentAttempts + node->wrongSource) resp[9] ^= 0x80;
+        portVClockScheduleFrame(100, resp, sizeof(resp));
+        return;
+    }
+    if (len >= 4 && data[3] == XBEE_API_TYPE_3RF_CREATE_SOURCE_ROUTE) {
+        lastRouteLength = len < sizeof(lastRoute) ? len : sizeof(lastRoute);
+        memcpy(lastRoute, data, lastRouteLength);
+        routesSent++;
+        return;
+    }
+    if (len < 18 || data[3] != XBEE_API_TYPE_TX_REQUEST) return;
+
+    lastRequestLength = len < sizeof(lastRequest) ? len : sizeof(lastRequest);
+    memcpy(lastRequest, data, lastRequestLength);
+    if (sentCount < MAX_RECORDS) {
+        uint64_t address64 = 0;
+        for (int i = 0; i < 8; i++) address64 = address64 << 8 | data[5 + i];
+        sent[sentCount++] = (SendRecord_t){ .frameId = data[4], .address64 = address64 };
+    }
+    if (answerTx) scheduleStatus(statusLatencyMs, data[4], statusCode);
+}
+
+static void onSend(XBee* self, void* data) {
+    (void)self;
+    XBee3RFPacket_t* packet = (XBee3RFPacket_t*)data;
+    if (completedCount < MAX_RECORDS) {
+        completed[completedCount++] = (SendRecord_t){ packet->frameId, packet->address64, packet->status, packet->retries };
+    }
+}
+
+static void onReceive(XBee* self, void* data) {
+    (void)self;
+    received = *(XBee3RFPacket_t*)data;
+    memcpy(receivedPayload, received.payload, received.payloadSize < sizeof(receivedPayload) ? received.payloadSize : sizeof(receivedPayload));
+    receives++;
+}
+
+static XBee3RFPacket_t packetTo(uint64_t address64, uint8_t* payload, uint16_t size) {
+    return (XBee3RFPacket_t){ .address64 = address64, .address16 = XBEE_3RF_ADDRESS16_UNKNOWN,
+                              .payload = payload, .payloadSize = size };
+}
+
+static const SendRecord_t* completionFor(uint8_t frameId) {
+    for (int i = 0; i < completedCount; i++) {
+        if (completed[i].frameId == frameId) return &completed[i];
+    }
+    return NULL;
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    answerTx = true;
+    legacyStatus = false;
+    statusLatencyMs = 20;
+    statusCode = XBEE_3RF_DELIVERY_SUCCESS;
+    association = 0;
+    digiMesh = false;
+    ndRequests = 0;
+    routesSent = 0;
+    remoteRequests = 0;
+    memset(remote, 0, sizeof(remote));
+    sentCount = 0;
+    completedCount = 0;
+    receives = 0;
+
+    rf = XBee3RFCreate(&callbackCTable, &portVClockHTable);
+    XBeeInit((XBee*)rf, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    XBee3RFDestroy(rf);
+}
+
+// ==== SEND ====
+
+void test_3rf_send_packet_writes_addressed_request(void) {
+    uint8_t payload[] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+    packet.options = XBEE_3RF_TX_OPT_DISABLE_ROUTE_DISCOVERY;
+    packet.radius = 3;
+
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBeeSendPacket((XBee*)rf, &packet));
+
+    const uint8_t expected[] = { XBEE_API_TYPE_TX_REQUEST, packet.frameId,
+                                 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x00, 0x01, 0xFF, 0xFE,
+                                 3, XBEE_3RF_TX_OPT_DISABLE_ROUTE_DISCOVERY, 0xDE, 0xAD, 0xBE, 0xEF };
+    TEST_ASSERT_EQUAL_UINT16(sizeof(expected) + 4, lastRequestLength);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, &lastRequest[3], sizeof(expected));
+
+    TEST_ASSERT_EQUAL_INT(1, completedCount);
+    TEST_ASSERT_EQUAL_HEX8(packet.frameId, completed[0].frameId);
+    TEST_ASSERT_TRUE(completed[0].address64 == NODE_A);
+    TEST_ASSERT_EQUAL_UINT8(2, completed[0].retries);
+    TEST_ASSERT_EQUAL_UINT8(0, XBee3RFInFlight((XBee*)rf));
+}
+
+void test_3rf_send_packet_returns_legacy_tx_status(void) {
+    uint8_t payload[] = { 0x01 };
+    XBee3RFPacket_t packet = packetTo(NODE_B, payload, sizeof(payload));
+    legacyStatus = true;
+    statusCode = 0x01;  // No ACK
+
+    TEST_ASSERT_EQUAL_HEX8(0x01, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_HEX8(0x01, packet.status);
+    TEST_ASSERT_TRUE(completed[0].address64 == NODE_B);
+}
+
+void test_3rf_send_rejects_oversized_payload(void) {
+    static uint8_t payload[XBEE_3RF_TX_FRAME_SIZE];
+    XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+
+    TEST_ASSERT_FALSE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_TIMEOUT, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_INT(0, sentCount);
+}
+
+// ==== TRANSMIT WINDOW ====
+
+void test_3rf_window_matches_out_of_order_statuses(void) {
+    uint8_t payload[] = { 0x55 };
+    answerTx = false;
+
+    for (int i = 0; i < XBEE_3RF_TX_WINDOW_PER_DEST; i++) {
+        XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+        TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    }
+    XBee3RFPacket_t other = packetTo(NODE_B, payload, sizeof(payload));
+    TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &other));
+
+    // Nothing was waited for
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockNow());
+    TEST_ASSERT_EQUAL_UINT8(XBEE_3RF_TX_WINDOW_PER_DEST + 1, XBee3RFInFlight((XBee*)rf));
+
+    // Statuses come back last frame first, each with its own code
+    for (int i = sentCount - 1; i >= 0; i--) {
+        scheduleStatus((uint32_t)(sentCount - i), sent[i].frameId, (uint8_t)(0x20 + i));
+    }
+    XBee3RFFlush((XBee*)rf);
+
+    TEST_ASSERT_EQUAL_INT(sentCount, completedCount);
+    for (int i = 0; i < sentCount; i++) {
+        const SendRecord_t* done = completionFor(sent[i].frameId);
+        TEST_ASSERT_NOT_NULL(done);
+        TEST_ASSERT_TRUE(done->address64 == sent[i].address64);
+        TEST_ASSERT_EQUAL_HEX8(0x20 + i, done->status);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, XBee3RFInFlight((XBee*)rf));
+}
+
+void test_3rf_window_waits_only_for_a_full_destination(void) {
+    uint8_t payload[] = { 0x55 };
+    statusLatencyMs = 50;
+
+    for (int i = 0; i < XBEE_3RF_TX_WINDOW_PER_DEST; i++) {
+        XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+        TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    }
+    XBee3RFPacket_t other = packetTo(NODE_B, payload, sizeof(payload));
+    TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &other));
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockNow());
+
+    // One more to the full destination waits for its first status
+    XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+    TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    TEST_ASSERT_TRUE(portVClockNow() >= statusLatencyMs);
+    TEST_ASSERT_NOT_NULL(completionFor(sent[0].frameId));
+
+    XBee3RFFlush((XBee*)rf);
+    TEST_ASSERT_EQUAL_INT(XBEE_3RF_TX_WINDOW_PER_DEST + 2, completedCount);
+}
+
+void test_3rf_window_tells_16_bit_destinations_apart(void) {
+    uint8_t payload[] = { 0x55 };
+    answerTx = false;
+
+    for (int i = 0; i < XBEE_3RF_TX_WINDOW_PER_DEST; i++) {
+        XBee3RFPacket_t packet = packetTo(XBEE_3RF_ADDRESS64_UNKNOWN, payload, sizeof(payload));
+        packet.address16 = 0x1A2B;
+        TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    }
+    XBee3RFPacket_t other = packetTo(XBEE_3RF_ADDRESS64_UNKNOWN, payload, sizeof(payload));
+    other.address16 = 0x3C4D;
+    TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &other));
+
+    // Another 16-bit address is another destination, so nothing was waited for
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockNow());
+    TEST_ASSERT_EQUAL_UINT8(XBEE_3RF_TX_WINDOW_PER_DEST + 1, XBee3RFInFlight((XBee*)rf));
+}
+
+void test_3rf_frame_without_status_times_out(void) {
+    uint8_t payload[] = { 0x55 };
+    XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+    answerTx = false;
+
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_TIMEOUT, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_TRUE(portVClockNow() >= XBEE_3RF_TX_STATUS_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_UINT8(0, XBee3RFInFlight((XBee*)rf));
+    TEST_ASSERT_EQUAL_INT(1, completedCount);
+
+    XBeeStats_t stats;
+    XBeeGetStats((XBee*)rf, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txStatusTimeouts);
+
+    // A status arriving after the timeout is not reported again
+    scheduleStatus(0, packet.frameId, XBEE_3RF_DELIVERY_SUCCESS);
+    XBeeProcess((XBee*)rf);
+    TEST_ASSERT_EQUAL_INT(1, completedCount);
+}
+
+void test_3rf_frame_ids_skip_frames_in_flight(void) {
+    uint8_t payload[] = { 0x55 };
+    answerTx = false;
+    rf->base.frameIdCntr = 254;
+
+    for (int i = 0; i < 3; i++) {
+        XBee3RFPacket_t packet = packetTo(i ? NODE_B : NODE_A, payload, sizeof(payload));
+        TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    }
+    TEST_ASSERT_EQUAL_HEX8(254, sent[0].frameId);
+    TEST_ASSERT_EQUAL_HEX8(255, sent[1].frameId);
+    TEST_ASSERT_EQUAL_HEX8(1, sent[2].frameId);
+
+    // Wrapped back onto frames still awaiting a status
+    rf->base.frameIdCntr = 254;
+    XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+    TEST_ASSERT_TRUE(XBee3RFSendPacketAsync((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_HEX8(2, packet.frameId);
+}
+
+// ==== RECEIVE ====
+
+void test_3rf_receives_rx_packet(void) {
+    const uint8_t frame[] = { XBEE_API_TYPE_3RF_RX_PACKET, 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x00, 0x02,
+                              0x7A, 0x31, 0x01, 'h', 'i' };
+    portVClockScheduleFrame(0, frame, sizeof(frame));
+
+    XBeeProcess((XBee*)rf);
+    TEST_ASSERT_EQUAL_INT(1, receives);
+    TEST_ASSERT_TRUE(received.address64 == NODE_B);
+    TEST_ASSERT_EQUAL_HEX16(0x7A31, received.address16);
+    TEST_ASSERT_EQUAL_HEX8(0x01, received.options);
+    TEST_ASSERT_EQUAL_UINT16(2, received.payloadSize);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("hi", receivedPayload, 2);
+}
+
+void test_3rf_receives_explicit_rx_packet(void) {
+    const uint8_t frame[] = { XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET, 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x00, 0x01,
+                              0x00, 0x00, 0xE8, 0xE6, 0x00, 0x11, 0xC1, 0x05, 0x02, 0x42 };
+    portVClockScheduleFrame(0, frame, sizeof(frame));
+
+    XBeeProcess((XBee*)rf);
+    TEST_ASSERT_EQUAL_INT(1, receives);
+    TEST_ASSERT_TRUE(received.address64 == NODE_A);
+    TEST_ASSERT_EQUAL_HEX8(0xE8, received.sourceEndpoint);
+    TEST_ASSERT_EQUAL_HEX8(0xE6, received.destinationEndpoint);
+    TEST_ASSERT_EQUAL_HEX16(0x0011, received.clusterId);
+    TEST_ASSERT_EQUAL_HEX16(0xC105, received.profileId);
+    TEST_ASSERT_EQUAL_HEX8(0x02, received.options);
+    TEST_ASSERT_EQUAL_UINT16(1, received.payloadSize);
+    TEST_ASSERT_EQUAL_HEX8(0x42, receivedPayload[0]);
+}
+
+// ==== NETWORK ====
+
+void test_3rf_connected_follows_association_indication(void) {
+    association = 0xFF;     // Scanning
+    TEST_ASSERT_FALSE(XBee3RFConnected((XBee*)rf));
+    TEST_ASSERT_EQUAL_INT(XBEE_LINK_DOWN, rf->base.linkState);
+
+    association = 0x00;
+    XBeeCacheInvalidate((XBee*)rf);
+    TEST_ASSERT_TRUE(XBee3RFConnected((XBee*)rf));
+    TEST_ASSERT_EQUAL_INT(XBEE_LINK_UP, rf->base.linkState);
+}
+
+void test_3rf_link_comes_back_after_a_reset(void) {
+    const uint8_t reset[] = { XBEE_API_TYPE_MODEM_STATUS, XBEE_MODEM_STATUS_HARDWARE_RESET };
+
+    association = 0x00;
+    TEST_ASSERT_TRUE(XBeeConnected((XBee*)rf));
+
+    // DigiMesh and 802.15.4 modules send no joined status after restarting
+    portVClockScheduleFrame(0, reset, sizeof(reset));
+    XBeeProcess((XBee*)rf);
+    portVClockTxClear();
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)rf));
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockTxLength());   // Not asked again before the poll interval
+
+    portVClockAdvance(XBEE_3RF_LINK_POLL_MS);
+    TEST_ASSERT_TRUE(XBeeConnected((XBee*)rf));
+    TEST_ASSERT_EQUAL_INT(XBEE_LINK_UP, rf->base.linkState);
+
+    // The same after a reset the host asked for
+    TEST_ASSERT_TRUE(XBeeSoftReset((XBee*)rf));
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)rf));
+    portVClockAdvance(XBEE_3RF_LINK_POLL_MS);
+    TEST_ASSERT_TRUE(XBeeConnected((XBee*)rf));
+}
+
+void test_3rf_destination_endpoint_is_set_and_read_by_name(void) {
+    uint32_t endpoint = 0;
+    association = 0xE8;
+
+    // The module answers "DE", which must match AT_DE_RF rather than the LoRaWAN AT_DE
+    TEST_ASSERT_TRUE(XBeeAtSet((XBee*)rf, AT_DE_RF, 0xE8));
+    TEST_ASSERT_TRUE(XBeeAtGet((XBee*)rf, AT_DE_RF, &endpoint));
+    TEST_ASSERT_EQUAL_UINT32(0xE8, endpoint);
+
+    // Responses are routed to the XBee 3 RF command, also when the request was the generic AT_WR
+    uint8_t value[1];
+    uint8_t valueLength = 0;
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)rf, AT_WR, NULL, 0, value,
+                                                                           &valueLength, 1000, sizeof(value)));
+    XBeeStats_t stats;
+    TEST_ASSERT_TRUE(XBeeGetStats((XBee*)rf, &stats));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.atResponses[AT_DE_RF]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.atResponses[AT_DE]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atResponses[AT_WR_RF]);
+}
+
+// ==== NODE CACHE ====
+
+static uint16_t lastRequestAddress16(void) {
+    return (uint16_t)(lastRequest[13] << 8 | lastRequest[14]);
+}
+
+static void receiveFrom(uint64_t address64, uint16_t address16) {
+    uint8_t frame[] = { XBEE_API_TYPE_3RF_RX_PACKET, 0, 0, 0, 0, 0, 0, 0, 0,
+                        address16 >> 8, address16 & 0xFF, 0x01, 0x42 };
+    for (int i = 0; i < 8; i++) frame[1 + i] = (uint8_t)(address64 >> (56 - 8 * i));
+    portVClockScheduleFrame(0, frame, sizeof(frame));
+    XBeeProcess((XBee*)rf);
+}
+
+void test_3rf_discovery_fills_node_cache_for_sends(void) {
+    uint8_t payload[] = { 0x55 };
+    uint16_t found = 0;
+
+    TEST_ASSERT_TRUE(XBee3RFDiscoverNodes((XBee*)rf, &found));
+    TEST_ASSERT_EQUAL_UINT16(2, found);
+    TEST_ASSERT_EQUAL_INT(1, ndRequests);
+    // Zigbee sends no closing response, so the whole discovery time is waited
+    TEST_ASSERT_TRUE(portVClockNow() >= 6000 + XBEE_3RF_DISCOVERY_GUARD_MS);
+
+    const XBee3RFNode_t* node = XBee3RFNodeLookup((XBee*)rf, NODE_B);
+    TEST_ASSERT_NOT_NULL(node);
+    TEST_ASSERT_EQUAL_HEX16(0x3C4D, node->address16);
+    TEST_ASSERT_EQUAL_STRING("sensor-b", node->nodeIdentifier);
+    TEST_ASSERT_TRUE(XBee3RFNodeFind((XBee*)rf, "sensor-a")->address64 == NODE_A);
+    TEST_ASSERT_NULL(XBee3RFNodeFind((XBee*)rf, "sensor-c"));
+
+    // The send carries the cached address, the caller's packet is left alone
+    XBee3RFPacket_t packet = packetTo(NODE_A, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_HEX16(0x1A2B, lastRequestAddress16());
+    TEST_ASSERT_EQUAL_HEX16(XBEE_3RF_ADDRESS16_UNKNOWN, packet.address16);
+
+    // Nodes not in the cache are still resolved by the module
+    packet = packetTo(NODE_C, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_HEX16(XBEE_3RF_ADDRESS16_UNKNOWN, lastRequestAddress16());
+}
+
+void test_3rf_discovery_ends_on_closing_response(void) {
+    uint16_t found = 0;
+    digiMesh = true;
+
+    TEST_ASSERT_TRUE(XBee3RFDiscoverNodes((XBee*)rf, &found));
+    TEST_ASSERT_EQUAL_UINT16(2, found);
+    TEST_ASSERT_TRUE(portVClockNow() < 6000);
+}
+
+void test_3rf_node_cache_follows_received_frames_and_statuses(void) {
+    uint8_t payload[] = { 0x55 };
+
+    receiveFrom(NODE_C, 0x5E6F);
+    TEST_ASSERT_EQUAL_HEX16(0x5E6F, XBee3RFNodeLookup((XBee*)rf, NODE_C)->address16);
+    TEST_ASSERT_EQUAL_STRING("", XBee3RFNodeLookup((XBee*)rf, NODE_C)->nodeIdentifier);
+
+    // DigiMesh sources carry no 16-bit address and are not cached
+    receiveFrom(NODE_B, XBEE_3RF_ADDRESS16_UNKNOWN);
+    TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, NODE_B));
+
+    // Nor is the placeholder of a unicast sent by 16-bit address
+    XBee3RFPacket_t byAddress16 = packetTo(XBEE_3RF_ADDRESS64_UNKNOWN, payload, sizeof(payload));
+    byAddress16.address16 = 0x1234;
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &byAddress16));
+    TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, XBEE_3RF_ADDRESS64_UNKNOWN));
+
+    // The module delivered to another address: take the one it reported
+    XBee3RFPacket_t packet = packetTo(NODE_C, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_HEX16(0x5E6F, lastRequestAddress16());
+    TEST_ASSERT_EQUAL_HEX16(0x1234, XBee3RFNodeLookup((XBee*)rf, NODE_C)->address16);
+
+    // An address that no longer leads to the node is forgotten
+    statusCode = XBEE_3RF_DELIVERY_ADDRESS_NOT_FOUND;
+    packet = packetTo(NODE_C, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_ADDRESS_NOT_FOUND, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, NODE_C));
+
+    // Entries expire unless refreshed
+    receiveFrom(NODE_C, 0x5E6F);
+    portVClockAdvance(XBEE_3RF_NODE_TTL_MS - 1);
+    TEST_ASSERT_NOT_NULL(XBee3RFNodeLookup((XBee*)rf, NODE_C));
+    portVClockAdvance(1);
+    TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, NODE_C));
+}
+
+void test_3rf_node_cache_evicts_oldest_and_keeps_probe_runs_intact(void) {
+    const uint64_t base = 0x0013A20041000100ULL;
+
+    // Fill the table, one node per millisecond
+    for (int i = 0; i < XBEE_3RF_NODE_CACHE_SIZE; i++) {
+        receiveFrom(base + (uint64_t)i, (uint16_t)(0x100 + i));
+        portVClockAdvance(1);
+    }
+    for (int i = 0; i < XBEE_3RF_NODE_CACHE_SIZE; i++) {
+        const XBee3RFNode_t* node = XBee3RFNodeLookup((XBee*)rf, base + (uint64_t)i);
+        TEST_ASSERT_NOT_NULL(node);
+        TEST_ASSERT_EQUAL_HEX16(0x100 + i, node->address16);
+    }
+
+    // One more node takes the least recently refreshed entry
+    receiveFrom(base + XBEE_3RF_NODE_CACHE_SIZE, 0x0FFF);
+    TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, base));
+    TEST_ASSERT_EQUAL_HEX16(0x0FFF, XBee3RFNodeLookup((XBee*)rf, base + XBEE_3RF_NODE_CACHE_SIZE)->address16);
+
+    // Let the older half expire; removing it must not hide the younger half
+    portVClockAdvance(XBEE_3RF_NODE_TTL_MS - XBEE_3RF_NODE_CACHE_SIZE / 2 - 1);
+    for (int i = 1; i < XBEE_3RF_NODE_CACHE_SIZE / 2; i++) {
+        TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, base + (uint64_t)i));
+    }
+    for (int i = XBEE_3RF_NODE_CACHE_SIZE / 2; i <= XBEE_3RF_NODE_CACHE_SIZE; i++) {
+        TEST_ASSERT_NOT_NULL(XBee3RFNodeLookup((XBee*)rf, base + (uint64_t)i));
+    }
+
+    XBee3RFNodeCacheClear((XBee*)rf);
+    TEST_ASSERT_NULL(XBee3RFNodeLookup((XBee*)rf, base + XBEE_3RF_NODE_CACHE_SIZE));
+}
+
+// ==== SOURCE ROUTES ====
+
+#define ROUTE_RECORD_FRAME_MAX (13 + 2 * (XBEE_3RF_ROUTE_MAX_HOPS + 1))
+
+void test_3rf_route_record_sets_source_route_for_sends(void) {
+    uint8_t payload[] = { 0x55 };
+    const uint8_t record[] = { XBEE_API_TYPE_3RF_ROUTE_RECORD, 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x00, 0x03,
+                               0x5E, 0x6F, 0x01, 2, 0xEE, 0xFF, 0xCC, 0xDD };
+    portVClockScheduleFrame(0, record, sizeof(record));
+    XBeeProcess((XBee*)rf);
+
+    const XBee3RFNode_t* node = XBee3RFNodeLookup((XBee*)rf, NODE_C);
+    TEST_ASSERT_NOT_NULL(node);
+    TEST_ASSERT_EQUAL_HEX16(0x5E6F, node->address16);
+    TEST_ASSERT_EQUAL_UINT8(2, node->routeHops);
+
+    // The route goes to the module ahead of the frame, hops in the order reported
+    XBee3RFPacket_t packet = packetTo(NODE_C, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    const uint8_t expected[] = { XBEE_API_TYPE_3RF_CREATE_SOURCE_ROUTE, 0x00,
+                                 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x00, 0x03, 0x5E, 0x6F,
+                                 0x00, 2, 0xEE, 0xFF, 0xCC, 0xDD };
+    TEST_ASSERT_EQUAL_INT(1, routesSent);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(expected) + 4, lastRouteLength);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, &lastRoute[3], sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX16(0x5E6F, lastRequestAddress16());
+
+    // Every unicast to the node carries the route, other nodes get none
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_INT(2, routesSent);
+    packet = packetTo(NODE_A, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_INT(2, routesSent);
+
+    // A route that no longer works is dropped with the node
+    statusCode = XBEE_3RF_DELIVERY_ROUTE_NOT_FOUND;
+    packet = packetTo(NODE_C, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_ROUTE_NOT_FOUND, XBee3RFSendPacket((XBee*)rf, &packet));
+    statusCode = XBEE_3RF_DELIVERY_SUCCESS;
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_INT(3, routesSent);
+    TEST_ASSERT_EQUAL_HEX16(XBEE_3RF_ADDRESS16_UNKNOWN, lastRequestAddress16());
+}
+
+void test_3rf_route_record_keeps_discovered_details(void) {
+    uint8_t record[ROUTE_RECORD_FRAME_MAX] = { XBEE_API_TYPE_3RF_ROUTE_RECORD, 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x00, 0x01,
+                                               0x1A, 0x2B, 0x01, 0 };
+    TEST_ASSERT_TRUE(XBee3RFDiscoverNodes((XBee*)rf, NULL));
+
+    // A neighbor: no hops in between
+    portVClockScheduleFrame(0, record, 13);
+    XBeeProcess((XBee*)rf);
+    const XBee3RFNode_t* node = XBee3RFNodeLookup((XBee*)rf, NODE_A);
+    TEST_ASSERT_EQUAL_UINT8(0, node->routeHops);
+    TEST_ASSERT_EQUAL_STRING("sensor-a", node->nodeIdentifier);
+
+    // Longer than the cache keeps: the last route stands
+    record[12] = XBEE_3RF_ROUTE_MAX_HOPS + 1;
+    portVClockScheduleFrame(0, record, 13 + 2 * (XBEE_3RF_ROUTE_MAX_HOPS + 1));
+    XBeeProcess((XBee*)rf);
+    TEST_ASSERT_EQUAL_UINT8(0, XBee3RFNodeLookup((XBee*)rf, NODE_A)->routeHops);
+
+    // Nodes learned without a route record send no route
+    uint8_t payload[] = { 0x55 };
+    XBee3RFPacket_t packet = packetTo(NODE_B, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_DELIVERY_SUCCESS, XBee3RFSendPacket((XBee*)rf, &packet));
+    TEST_ASSERT_EQUAL_INT(0, routesSent);
+}
+
+// ==== REMOTE AT ====
+
+void test_3rf_remote_at_fans_out_and_retries_stragglers(void) {
+    XBee3RFRemoteAtResult_t results[20];
+    for (int i = 0; i < 20; i++) results[i].address64 = REMOTE_BASE + (uint64_t)i;
+    remote[3].silentAttempts = 1;
+    remote[5].status = XBEE_3RF_REMOTE_AT_INVALID_COMMAND;
+    remote[7].silentAttempts = XBEE_3RF_REMOTE_AT_ATTEMPTS;
+    remote[9].wrongSource = 1;
+
+    TEST_ASSERT_EQUAL_UINT16(18, XBee3RFRemoteAtCommand((XBee*)rf, AT_DB, NULL, 0, 0, results, 20));
+
+    // The window was filled at once and never exceeded
+    int atStart = 0;
+    for (int i = 0; i < remoteRequests; i++) atStart += remoteRequestTimes[i] == 0;
+    TEST_ASSERT_EQUAL_INT(XBEE_3RF_REMOTE_AT_WINDOW, atStart);
+
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_REMOTE_AT_OK, results[0].status);
+    TEST_ASSERT_EQUAL_UINT8(1, results[0].attempts);
+    TEST_ASSERT_EQUAL_UINT8(2, results[0].length);
+    TEST_ASSERT_EQUAL_HEX8(0xAB, results[0].value[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x13, results[19].value[1]);
+
+    // A straggler and a response from the wrong node are retried
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_REMOTE_AT_OK, results[3].status);
+    TEST_ASSERT_EQUAL_UINT8(2, results[3].attempts);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_REMOTE_AT_OK, results[9].status);
+    TEST_ASSERT_EQUAL_UINT8(2, results[9].attempts);
+
+    // An error is final, silence runs out of attempts
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_REMOTE_AT_INVALID_COMMAND, results[5].status);
+    TEST_ASSERT_EQUAL_UINT8(1, results[5].attempts);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_3RF_REMOTE_AT_TIMEOUT, results[7].status);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_3RF_REMOTE_AT_ATTEMPTS, results[7].attempts);
+    TEST_ASSERT_EQUAL_INT(20 + 2 + XBEE_3RF_REMOTE_AT_ATTEMPTS - 1, remoteRequests);
+
+    // Answers teach the node cache their 16-bit address
+    TEST_ASSERT_EQUAL_HEX16(0x1234, XBee3RFNodeLookup((XBee*)rf, REMOTE_BASE + 1)->address16);
+}
+
+void test_3rf_remote_at_writes_addressed_request(void) {
+    const uint8_t identifier[] = { 'n', 'o', 'd', 'e' };
+    XBee3RFRemoteAtResult_t result = { .address64 = REMOTE_BASE + 2 };
+    receiveFrom(REMOTE_BASE + 2, 0x4455);
+
+    TEST_ASSERT_EQUAL_UINT16(1, XBee3RFRemoteAtCommand((XBee*)rf, AT_NI, identifier, sizeof(identifier),
+                                                       XBEE_3RF_REMOTE_AT_APPLY, &result, 1));
+
+    const uint8_t expected[] = { XBEE_API_TYPE_3RF_REMOTE_AT_COMMAND, lastRemote[4],
+                                 0x00, 0x13, 0xA2, 0x00, 0x41, 0x00, 0x01, 0x02, 0x44, 0x55,
+                                 XBEE_3RF_REMOTE_AT_APPLY, 'N', 'I', 'n', 'o', 'd', 'e' };
+    TEST_ASSERT_EQUAL_UINT16(sizeof(expected) + 4, lastRemoteLength);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, &lastRemote[3], sizeof(expected));
+    TEST_ASSERT_NOT_EQUAL(0, lastRemote[4]);
+    TEST_ASSERT_EQUAL_UINT8(1, result.attempts);
+}
+
+// ==== IO SAMPLES ====
+
+// Digital DIO0 and DIO10, analog AD0 and the supply voltage, all following `value`
+static void receiveSample(uint64_t address64, uint16_t value) {
+    uint8_t frame[] = { XBEE_API_TYPE_IO_DATA_SAMPLE_RX, 0, 0, 0, 0, 0, 0, 0, 0, 0x12, 0x34, 0x01,
+                        0x01, 0x04, 0x01, XBEE_3RF_IO_ANALOG_SUPPLY_BIT | 0x01, 0x04, value & 0x01,
+                        value >> 8, value & 0xFF, 0x0C, 0xE4 };
+    for (int i = 0; i < 8; i++) frame[1 + i] = (uint8_t)(address64 >> (56 - 8 * i));
+    portVClockScheduleFrame(0, frame, sizeof(frame));
+    XBeeProcess((XBee*)rf);
+}
+
+static const XBee3RFIoSource_t* ioSource(uint64_t address64) {
+    for (int i = 0; i < XBEE_3RF_IO_SOURCES; i++) {
+        if (rf->ioSources[i].address64 == address64) return &rf->ioSources[i];
+    }
+    return NULL;
+}
+
+void test_3rf_io_decode_keeps_stored_channels_in_order(void) {
+    // DIO3 and DIO9 sampled, AD1, AD5 and supply; AD5 has no slot
+    const uint8_t set[] = { 0x01, 0x02, 0x08, 0x80 | 0x20 | 0x02, 0x02, 0x08,
+                            0x01, 0x11, 0x03, 0x33, 0x0B, 0xB8 };
+    XBee3RFIoSample_t sample;
+
+    TEST_ASSERT_TRUE(XBee3RFIoDecode(set, sizeof(set), &sample));
+    TEST_ASSERT_EQUAL_HEX16(0x0208, sample.digitalMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0208, sample.digital);
+    TEST_ASSERT_EQUAL_HEX8(0x82, sample.analogMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, sample.analog[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0111, sample.analog[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x0BB8, sample.analog[XBEE_3RF_IO_SUPPLY]);
+
+    // One byte short, no samples, and no digital levels are all rejected
+    TEST_ASSERT_FALSE(XBee3RFIoDecode(set, sizeof(set) - 1, &sample));
+    const uint8_t empty[] = { 0x00, 0x00, 0x00, 0x01, 0x01, 0x00 };
+    TEST_ASSERT_FALSE(XBee3RFIoDecode(empty, sizeof(empty), &sample));
+    const uint8_t analogOnly[] = { 0x01, 0x00, 0x00, 0x01, 0x03, 0xFF };
+    TEST_ASSERT_TRUE(XBee3RFIoDecode(analogOnly, sizeof(analogOnly), &sample));
+    TEST_ASSERT_EQUAL_HEX16(0x03FF, sample.analog[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, sample.digitalMask);
+}
+
+void test_3rf_io_unpacks_digital_lines_and_converts_readings(void) {
+    const XBee3RFIoSample_t sample = { .digitalMask = 0x8412, .digital = 0x0410 };
+    uint8_t pins[16];
+    uint8_t levels[16];
+
+    TEST_ASSERT_EQUAL_UINT8(4, XBee3RFIoUnpackDigital(&sample, pins, levels));
+    const uint8_t expectedPins[] = { 1, 4, 10, 15 };
+    const uint8_t expectedLevels[] = { 0, 1, 1, 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedPins, pins, 4);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedLevels, levels, 4);
+
+    uint16_t readings[] = { 0, 1, 512, 1023 };
+    XBee3RFIoToMillivolts(readings, readings, 4, 2500);
+    const uint16_t expectedMv[] = { 0, 2, 1251, 2500 };
+    for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_UINT16(expectedMv[i], readings[i]);
+}
+
+void test_3rf_io_samples_fill_ring_and_read_across_wrap(void) {
+    XBee3RFIoSample_t samples[XBEE_3RF_IO_RING_SIZE + 4];
+    uint64_t sources[XBEE_3RF_IO_SOURCES];
+
+    // Three more samples than the ring holds drop the three oldest
+    for (uint16_t i = 0; i < XBEE_3RF_IO_RING_SIZE + 3; i++) {
+        receiveSample(NODE_A, i);
+        portVClockAdvance(10);
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, XBee3RFIoSources((XBee*)rf, sources, XBEE_3RF_IO_SOURCES));
+    TEST_ASSERT_TRUE(sources[0] == NODE_A);
+    TEST_ASSERT_EQUAL_UINT16(3, ioSource(NODE_A)->overruns);
+    // The sample also refreshes the sender's node cache entry
+    TEST_ASSERT_EQUAL_HEX16(0x1234, XBee3RFNodeLookup((XBee*)rf, NODE_A)->address16);
+
+    TEST_ASSERT_EQUAL_UINT16(2, XBee3RFIoRead((XBee*)rf, NODE_A, samples, 2));
+    TEST_ASSERT_EQUAL_UINT16(3, samples[0].analog[0]);
+    TEST_ASSERT_EQUAL_UINT16(4, samples[1].analog[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0401, samples[0].digitalMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0401, samples[0].digital);
+    TEST_ASSERT_EQUAL_HEX16(0x0400, samples[1].digital);
+    TEST_ASSERT_EQUAL_HEX16(0x0CE4, samples[1].analog[XBEE_3RF_IO_SUPPLY]);
+
+    // The rest, plus two more, come back in order across the end of the ring
+    receiveSample(NODE_A, 100);
+    receiveSample(NODE_A, 101);
+    uint16_t count = XBee3RFIoRead((XBee*)rf, NODE_A, samples, XBEE_3RF_IO_RING_SIZE + 4);
+    TEST_ASSERT_EQUAL_UINT16(XBEE_3RF_IO_RING_SIZE, count);
+    for (uint16_t i = 0; i < count - 2; i++) {
+        TEST_ASSERT_EQUAL_UINT16(5 + i, samples[i].analog[0]);
+        TEST_ASSERT_TRUE(samples[i + 1].receivedAt > samples[i].receivedAt);
+    }
+    TEST_ASSERT_EQUAL_UINT16(100, samples[count - 2].analog[0]);
+    TEST_ASSERT_EQUAL_UINT16(101, samples[count - 1].analog[0]);
+
+    TEST_ASSERT_EQUAL_UINT16(0, XBee3RFIoRead((XBee*)rf, NODE_A, samples, 1));
+    TEST_ASSERT_EQUAL_UINT8(0, XBee3RFIoSources((XBee*)rf, sources, XBEE_3RF_IO_SOURCES));
+    TEST_ASSERT_EQUAL_UINT16(0, XBee3RFIoRead((XBee*)rf, NODE_B, samples, 1));
+}
+
+void test_3rf_io_new_source_takes_least_recently_updated_ring(void) {
+    XBee3RFIoSample_t sample;
+
+    for (uint8_t i = 0; i < XBEE_3RF_IO_SOURCES; i++) {
+        receiveSample(REMOTE_BASE + i, i);
+        portVClockAdvance(100);
+    }
+    receiveSample(REMOTE_BASE, 50);
+    receiveSample(NODE_A, 60);
+
+    TEST_ASSERT_NULL(ioSource(REMOTE_BASE + 1));
+    TEST_ASSERT_EQUAL_UINT16(1, XBee3RFIoRead((XBee*)rf, NODE_A, &sample, 1));
+    TEST_ASSERT_EQUAL_UINT16(60, sample.analog[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, ioSource(REMOTE_BASE)->head - ioSource(REMOTE_BASE)->tail);
+    TEST_ASSERT_NOT_NULL(ioSource(REMOTE_BASE + 2));
+}
+
+void test_3rf_io_sample_now_decodes_local_sample(void) {
+    XBee3RFIoSample_t sample;
+
+    TEST_ASSERT_TRUE(XBee3RFIoSampleNow((XBee*)rf, &sample));
+    TEST_ASSERT_EQUAL_HEX16(0x0012, sample.digitalMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0010, sample.digital);
+    TEST_ASSERT_EQUAL_HEX8(0x04, sample.analogMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0200, sample.analog[2]);
+}
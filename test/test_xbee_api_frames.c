@@ -83,9 +83,14 @@ static XBeeHTable mock_hTable = {
     .PortDelay     = mock_delay,
 };
 
+static uint8_t mock_frame_pool[2 * 64];
+
 static XBee mock_xbee = {
     .htable = &mock_hTable,
-    .frameIdCntr = 1
+    .frameIdCntr = 1,
+    .framePool = mock_frame_pool,
+    .framePoolSize = sizeof(mock_frame_pool),
+    .maxFrameDataSize = 64
 };
 
 // ==== TEST SETUP ====
@@ -146,7 +151,7 @@ void test_apiSendAtCommandAndGetResponse_simulated(void) {
 
 void test_xbeeHandleAtResponse_should_print(void) {
     xbee_api_frame_t frame = {
-        .data = {0x00, 0x01, 'V', 'R', 0x00, 0x12},
+        .data = (uint8_t[]){0x00, 0x01, 'V', 'R', 0x00, 0x12},
         .length = 6,
         .type = XBEE_API_TYPE_AT_RESPONSE
     };
@@ -155,7 +160,7 @@ void test_xbeeHandleAtResponse_should_print(void) {
 
 void test_xbeeHandleModemStatus_should_print(void) {
     xbee_api_frame_t frame = {
-        .data = {0x00, 0x06},
+        .data = (uint8_t[]){0x00, 0x06},
         .length = 2,
         .type = XBEE_API_TYPE_MODEM_STATUS
     };
@@ -165,7 +170,7 @@ void test_xbeeHandleModemStatus_should_print(void) {
 void test_apiHandleFrame_calls_correct_handler(void) {
     xbee_api_frame_t frame = {
         .type = XBEE_API_TYPE_MODEM_STATUS,
-        .data = {0x00, 0x06},
+        .data = (uint8_t[]){0x00, 0x06},
         .length = 2
     };
     apiHandleFrame(&mock_xbee, frame);
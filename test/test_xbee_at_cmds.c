@@ -1,6 +1,117 @@
 #include "unity.h"
 #include "xbee_at_cmds.c"
+#include <string.h>
 
 void setUp(void) {}
 void tearDown(void) {}
 
+// ==== NAME LOOKUP ====
+
+void test_atCommandFromString_round_trips_every_command(void) {
+    for (int command = AT_; command < AT_COMMAND_COUNT; command++) {
+        at_command_t found = AT_COMMAND_COUNT;
+        const char* name = atCommandToString((at_command_t)command);
+        TEST_ASSERT_NOT_NULL(name);
+        TEST_ASSERT_EQUAL_size_t(2, strlen(name));
+        TEST_ASSERT_TRUE_MESSAGE(atCommandFromString(AT_MODULE_COMMON, name, &found), name);
+        // Module specific commands map back to the common command they share their name with
+        if (command == AT_DE_RF || command == AT_WR_RF || command == AT_RI_CELL) {
+            TEST_ASSERT_EQUAL_STRING(name, atCommandToString(found));
+            TEST_ASSERT_NOT_EQUAL(command, (int)found);
+        } else {
+            TEST_ASSERT_EQUAL_INT(command, found);
+        }
+    }
+}
+
+void test_atCommandFromString_picks_the_module_specific_command(void) {
+    at_command_t found;
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_3RF, "DE", &found));
+    TEST_ASSERT_EQUAL_INT(AT_DE_RF, found);
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_3RF, "WR", &found));
+    TEST_ASSERT_EQUAL_INT(AT_WR_RF, found);
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_3RF, "RI", &found));
+    TEST_ASSERT_EQUAL_INT(AT_RI, found);
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_CELLULAR, "RI", &found));
+    TEST_ASSERT_EQUAL_INT(AT_RI_CELL, found);
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_CELLULAR, "DE", &found));
+    TEST_ASSERT_EQUAL_INT(AT_DE, found);
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_3RF, "VR", &found));
+    TEST_ASSERT_EQUAL_INT(AT_VR, found);
+
+    // Requests resolve the same way, so a generic AT_WR is answered by "WR" on either module
+    TEST_ASSERT_EQUAL_INT(AT_WR_RF, atCommandForModule(AT_MODULE_3RF, AT_WR));
+    TEST_ASSERT_EQUAL_INT(AT_WR, atCommandForModule(AT_MODULE_COMMON, AT_WR_RF));
+    TEST_ASSERT_EQUAL_INT(AT_DE_RF, atCommandForModule(AT_MODULE_3RF, AT_DE_RF));
+    TEST_ASSERT_EQUAL_INT(AT_COMMAND_COUNT, atCommandForModule(AT_MODULE_3RF, AT_COMMAND_COUNT));
+}
+
+void test_atCommand_module_specific_commands_keep_their_own_value(void) {
+    at_command_t found;
+    TEST_ASSERT_NOT_EQUAL(AT_DE, AT_DE_RF);
+    TEST_ASSERT_NOT_EQUAL(AT_WR, AT_WR_RF);
+    TEST_ASSERT_NOT_EQUAL(AT_RI, AT_RI_CELL);
+    TEST_ASSERT_EQUAL_STRING("RI", atCommandToString(AT_RI_CELL));
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_COMMON, "DE", &found));
+    TEST_ASSERT_EQUAL_INT(AT_DE, found);
+
+    // The XBee 3 RF Destination Endpoint is a writable byte, the LoRaWAN DevEUI a fixed 8
+    const at_command_info_t* endpoint = atCommandInfo(AT_DE_RF);
+    TEST_ASSERT_NOT_NULL(endpoint);
+    TEST_ASSERT_EQUAL_UINT8(AT_TYPE_UINT, endpoint->type);
+    TEST_ASSERT_EQUAL_UINT8(1, endpoint->width);
+    TEST_ASSERT_EQUAL_UINT8(0, endpoint->flags);
+    TEST_ASSERT_EQUAL_UINT8(8, atCommandInfo(AT_DE)->width);
+    TEST_ASSERT_TRUE(atCommandInfo(AT_DE)->flags & AT_FLAG_READ_ONLY);
+}
+
+void test_atCommandFromString_rejects_unknown_names(void) {
+    const uint8_t response[] = { 'V', 'R', 0x00 };
+    TEST_ASSERT_TRUE(atCommandFromString(AT_MODULE_COMMON, (const char*)response, NULL));
+    TEST_ASSERT_FALSE(atCommandFromString(AT_MODULE_COMMON, "ZZ", NULL));
+    TEST_ASSERT_FALSE(atCommandFromString(AT_MODULE_COMMON, "vr", NULL));
+    TEST_ASSERT_FALSE(atCommandFromString(AT_MODULE_COMMON, "V", NULL));
+    TEST_ASSERT_FALSE(atCommandFromString(AT_MODULE_COMMON, "\xFF\xFF", NULL));
+    TEST_ASSERT_FALSE(atCommandFromString(AT_MODULE_3RF, NULL, NULL));
+    TEST_ASSERT_NULL(atCommandToString(AT_COMMAND_COUNT));
+}
+
+// ==== METADATA TABLE ====
+
+void test_atCommandInfo_describes_typed_commands(void) {
+    const at_command_info_t* xf = atCommandInfo(AT_XF);
+    TEST_ASSERT_NOT_NULL(xf);
+    TEST_ASSERT_EQUAL_STRING("XF", xf->name);
+    TEST_ASSERT_EQUAL_UINT8(AT_TYPE_UINT, xf->type);
+    TEST_ASSERT_EQUAL_UINT8(4, xf->width);
+
+    const at_command_info_t* lc = atCommandInfo(AT_LC);
+    TEST_ASSERT_EQUAL_UINT32('A', lc->min);
+    TEST_ASSERT_EQUAL_UINT32('C', lc->max);
+
+    TEST_ASSERT_EQUAL_UINT8(AT_FLAG_WRITE_ONLY, atCommandInfo(AT_AK)->flags);
+    TEST_ASSERT_EQUAL_UINT8(AT_TYPE_NONE, atCommandInfo(AT_WR)->type);
+}
+
+void test_atCommandInfo_names_match_atCommandToString(void) {
+    for (int command = AT_; command < AT_COMMAND_COUNT; command++) {
+        const at_command_info_t* info = atCommandInfo((at_command_t)command);
+        if (info) {
+            TEST_ASSERT_EQUAL_STRING(atCommandToString((at_command_t)command), info->name);
+        }
+    }
+}
+
+void test_atCommandInfo_returns_null_without_entry(void) {
+    TEST_ASSERT_NULL(atCommandInfo(AT_));
+    TEST_ASSERT_NULL(atCommandInfo(AT_RP));
+    TEST_ASSERT_NULL(atCommandInfo(AT_COMMAND_COUNT));
+}
+
+void test_atCommandTimeout_follows_latency_class(void) {
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_REGISTER_MS, atCommandTimeout(AT_XF));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_APPLY_MS, atCommandTimeout(AT_AC));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLASH_MS, atCommandTimeout(AT_WR));
+    // Commands without metadata wait the longest
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLASH_MS, atCommandTimeout(AT_RP));
+}
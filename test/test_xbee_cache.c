@@ -0,0 +1,184 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee_cache.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static void onReceive(XBee* self, void* data);
+
+static const XBeeCTable callbackCTable = {
+    .OnReceiveCallback = onReceive,
+};
+
+#define MODULE_LATENCY_MS 20
+
+static const uint8_t modemStatusJoined[] = { XBEE_API_TYPE_MODEM_STATUS, 0x02 };
+static const uint8_t rxPacket[] = { XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET, 0x02, 0xB5, 0x07, 0x13,
+                                    0x00, 0x00, 0x00, 0x01, 0x00, 'h', 'i' };
+
+static XBeeLR* lr;
+static int queries;
+static uint8_t joinStatus;
+static bool packetDuringQuery;
+static int nestedReads;
+static bool nestedConnected;
+
+// Answers queries of a few read-only registers after MODULE_LATENCY_MS
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    if (len < 8 || data[3] != XBEE_API_TYPE_AT_COMMAND) return;
+
+    uint8_t value[4];
+    uint16_t valueLength = 0;
+    uint8_t status = 0x00;
+    queries++;
+
+    if (data[5] == 'S' && (data[6] == 'H' || data[6] == 'L')) {
+        const uint8_t half[4] = { 0x00, 0x13, 0xA2, data[6] };
+        memcpy(value, half, sizeof(half));
+        valueLength = sizeof(half);
+    } else if (data[5] == 'J' && data[6] == 'S') {
+        value[valueLength++] = joinStatus;
+    } else if (data[5] == 'D' && data[6] == 'B') {
+        value[valueLength++] = 75;
+    } else {
+        status = 0x02;
+    }
+
+    if (packetDuringQuery) {
+        portVClockScheduleFrame(MODULE_LATENCY_MS / 2, rxPacket, sizeof(rxPacket));
+    }
+    portVClockScheduleAtResponse(MODULE_LATENCY_MS, data, len, status, value, valueLength);
+}
+
+static void onReceive(XBee* self, void* data) {
+    (void)data;
+    if (!packetDuringQuery) return;
+    nestedReads++;
+    nestedConnected = XBeeLRConnected(self);
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    queries = 0;
+    joinStatus = 0;
+    packetDuringQuery = false;
+    nestedReads = 0;
+    nestedConnected = false;
+
+    lr = XBeeLRCreate(&callbackCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    free(lr);
+}
+
+// ==== STATIC VALUES ====
+
+void test_cache_serial_number_is_read_once(void) {
+    uint64_t first = 0;
+    uint64_t second = 0;
+
+    TEST_ASSERT_TRUE(XBeeGetSerialNumber((XBee*)lr, &first));
+    TEST_ASSERT_EQUAL_INT(2, queries);
+    TEST_ASSERT_TRUE(XBeeGetSerialNumber((XBee*)lr, &second));
+    TEST_ASSERT_EQUAL_INT(2, queries);
+    TEST_ASSERT_TRUE(first == second);
+    TEST_ASSERT_TRUE(first == 0x0013A2480013A24CULL);
+
+    XBeeStats_t stats;
+    XBeeGetStats((XBee*)lr, &stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.atCacheHits);
+}
+
+void test_cache_static_values_survive_modem_status_but_not_reset(void) {
+    uint64_t serial;
+    XBeeGetSerialNumber((XBee*)lr, &serial);
+
+    portVClockScheduleFrame(0, modemStatusJoined, sizeof(modemStatusJoined));
+    XBeeProcess((XBee*)lr);
+    XBeeGetSerialNumber((XBee*)lr, &serial);
+    TEST_ASSERT_EQUAL_INT(2, queries);
+
+    XBeeSoftRestart((XBee*)lr);
+    queries = 0;
+    XBeeGetSerialNumber((XBee*)lr, &serial);
+    TEST_ASSERT_EQUAL_INT(2, queries);
+}
+
+// ==== VOLATILE VALUES ====
+
+// XBeeConnected() reads the state kept from modem status frames; XBeeLRConnected() polls JS
+
+void test_cache_status_expires_after_ttl(void) {
+    XBeeLRConnected((XBee*)lr);
+    XBeeLRConnected((XBee*)lr);
+    TEST_ASSERT_EQUAL_INT(1, queries);
+
+    portVClockAdvance(XBEE_CACHE_TTL_STATUS_MS);
+    XBeeLRConnected((XBee*)lr);
+    TEST_ASSERT_EQUAL_INT(2, queries);
+}
+
+void test_cache_status_is_dropped_by_modem_status(void) {
+    TEST_ASSERT_FALSE(XBeeLRConnected((XBee*)lr));
+
+    joinStatus = 1;
+    portVClockScheduleFrame(0, modemStatusJoined, sizeof(modemStatusJoined));
+    XBeeProcess((XBee*)lr);
+
+    TEST_ASSERT_TRUE(XBeeLRConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(2, queries);
+}
+
+void test_cache_link_quality_is_dropped_by_received_packet(void) {
+    int8_t rssi = 0;
+    TEST_ASSERT_TRUE(XBeeGetLastRssi((XBee*)lr, &rssi));
+    TEST_ASSERT_TRUE(XBeeGetLastRssi((XBee*)lr, &rssi));
+    TEST_ASSERT_EQUAL_INT(1, queries);
+
+    portVClockScheduleFrame(0, rxPacket, sizeof(rxPacket));
+    XBeeProcess((XBee*)lr);
+    TEST_ASSERT_TRUE(XBeeGetLastRssi((XBee*)lr, &rssi));
+    TEST_ASSERT_EQUAL_INT(2, queries);
+    TEST_ASSERT_EQUAL_INT8(-75, rssi);
+}
+
+// ==== IN-FLIGHT QUERIES ====
+
+void test_cache_nested_read_shares_pending_query(void) {
+    packetDuringQuery = true;
+
+    // The callback runs while JS is pending and has no value yet: it fails without a second query
+    TEST_ASSERT_FALSE(XBeeLRConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, nestedReads);
+    TEST_ASSERT_FALSE(nestedConnected);
+    TEST_ASSERT_EQUAL_INT(1, queries);
+
+    // Once a value is known the nested read gets it
+    joinStatus = 1;
+    portVClockAdvance(XBEE_CACHE_TTL_STATUS_MS);
+    TEST_ASSERT_TRUE(XBeeLRConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(2, nestedReads);
+    TEST_ASSERT_FALSE(nestedConnected);
+    TEST_ASSERT_EQUAL_INT(2, queries);
+}
+
+void test_cache_invalidate_forces_new_query(void) {
+    uint32_t value;
+    TEST_ASSERT_TRUE(XBeeAtGet((XBee*)lr, AT_SH, &value));
+    XBeeCacheInvalidate((XBee*)lr);
+    TEST_ASSERT_TRUE(XBeeAtGet((XBee*)lr, AT_SH, &value));
+    TEST_ASSERT_EQUAL_INT(2, queries);
+}
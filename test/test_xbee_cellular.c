@@ -54,9 +54,9 @@ void test_XBeeCellularInit_should_return_true_when_uart_init_succeeds(void) {
 void test_XBeeCellularConnected_should_return_true_when_AI_is_zero(void) {
     uint8_t dummyResponse = 0;
     uint8_t dummyResponseLength = 1;
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(
-        self, AT_AI, NULL, 0, &dummyResponse, &dummyResponseLength, 5000, sizeof(dummyResponse), API_SEND_SUCCESS
-    );
+    apiSendAtCommandAndGetResponse_ExpectAnyArgsAndReturn(API_SEND_SUCCESS);
+    apiSendAtCommandAndGetResponse_ReturnArrayThruPtr_responseBuffer(&dummyResponse, 1);
+    apiSendAtCommandAndGetResponse_ReturnThruPtr_responseLength(&dummyResponseLength);
     TEST_ASSERT_TRUE(XBeeCellularConnected(self));
 }
 
@@ -108,7 +108,7 @@ void test_XBeeCellularSocketCreate_should_return_socket_id_on_success(void) {
     uint8_t socketId;
     xbee_api_frame_t response = {
         .type = XBEE_API_TYPE_CELLULAR_SOCKET_CREATE_RESPONSE,
-        .data = {0, 1, 0x12, 0x00}
+        .data = (uint8_t[]){0, 1, 0x12, 0x00}
     };
 
     apiSendFrame_ExpectAndReturn(self, XBEE_API_TYPE_CELLULAR_SOCKET_CREATE, NULL, 2, API_SEND_SUCCESS);
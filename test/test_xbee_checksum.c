@@ -0,0 +1,114 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_checksum.h"
+#include "xbee_escape.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+// Past the point where the word kernel folds its lanes on 64-bit hosts
+#define PATTERN_SIZE 4200
+
+static uint8_t pattern[PATTERN_SIZE + 16];
+static XBeeLR* lr;
+
+static uint8_t referenceSum(uint8_t sum, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) sum += data[i];
+    return sum;
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    // Mostly 0xFF so that any lost carry or lane overflow shows up in the sum
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (i % 13) ? 0xFF : (uint8_t)(i * 31);
+    }
+    portVClockReset();
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+}
+
+void tearDown(void) {
+    free(lr);
+}
+
+// ==== KERNELS ====
+
+void test_checksum_matches_bytewise_sum_for_every_length_and_alignment(void) {
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t length = 0; length <= 300; length++) {
+            TEST_ASSERT_EQUAL_HEX8(referenceSum(0x5A, &pattern[offset], length),
+                                   xbeeChecksumAdd(0x5A, &pattern[offset], length));
+        }
+    }
+    TEST_ASSERT_EQUAL_HEX8(referenceSum(0, pattern, PATTERN_SIZE), xbeeChecksumAdd(0, pattern, PATTERN_SIZE));
+}
+
+void test_checksum_copy_copies_and_sums(void) {
+    static uint8_t out[PATTERN_SIZE + 16];
+
+    for (size_t offset = 0; offset < 16; offset += 3) {
+        memset(out, 0, sizeof(out));
+        TEST_ASSERT_EQUAL_HEX8(referenceSum(0, &pattern[offset], PATTERN_SIZE),
+                               xbeeChecksumCopy(0, &out[1], &pattern[offset], PATTERN_SIZE));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(&pattern[offset], &out[1], PATTERN_SIZE);
+        TEST_ASSERT_EQUAL_HEX8(0, out[PATTERN_SIZE + 1]);
+    }
+}
+
+void test_checksum_copy_compacts_in_place(void) {
+    static uint8_t buf[PATTERN_SIZE + 16];
+
+    memcpy(buf, pattern, sizeof(buf));
+    TEST_ASSERT_EQUAL_HEX8(referenceSum(0, &pattern[5], 1000), xbeeChecksumCopy(0, buf, &buf[5], 1000));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&pattern[5], buf, 1000);
+}
+
+void test_unescape_sums_what_it_keeps(void) {
+    uint8_t wire[] = { 0x01, XBEE_ESCAPE, XBEE_ESCAPE ^ XBEE_ESCAPE_XOR, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09 };
+    bool escaped = false;
+    uint8_t sum = 0;
+
+    int length = xbeeUnescape(wire, sizeof(wire), &escaped, &sum);
+    TEST_ASSERT_EQUAL_INT(sizeof(wire) - 1, length);
+    TEST_ASSERT_EQUAL_HEX8(referenceSum(0, wire, (size_t)length), sum);
+}
+
+// ==== FRAMES ====
+
+void test_checksum_of_sent_frame_closes_to_ff(void) {
+    portVClockTxClear();
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, pattern, 200));
+
+    const uint8_t* wire = portVClockTxData();
+    TEST_ASSERT_EQUAL_UINT32(205, portVClockTxLength());
+    TEST_ASSERT_EQUAL_HEX8(0xFF, referenceSum(0, &wire[3], 202));
+}
+
+void test_received_frame_checksum_is_verified_across_pieces(void) {
+    uint8_t frame[XBEE_LR_MAX_FRAME_DATA_SIZE + 4] = { XBEE_START_DELIMITER, XBEE_LR_MAX_FRAME_DATA_SIZE >> 8,
+                                                       XBEE_LR_MAX_FRAME_DATA_SIZE & 0xFF, XBEE_API_TYPE_LR_RX_PACKET };
+    xbee_api_frame_t received;
+
+    memcpy(&frame[4], pattern, XBEE_LR_MAX_FRAME_DATA_SIZE - 1);
+    frame[sizeof(frame) - 1] = 0xFF - referenceSum(0, &frame[3], XBEE_LR_MAX_FRAME_DATA_SIZE);
+
+    // Split off the start delimiter, length, some of the data and the checksum
+    portVClockScheduleRx(0, frame, 1);
+    portVClockScheduleRx(1, &frame[1], 100);
+    portVClockScheduleRx(2, &frame[101], sizeof(frame) - 102);
+    portVClockScheduleRx(3, &frame[sizeof(frame) - 1], 1);
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &received));
+    TEST_ASSERT_EQUAL_UINT16(XBEE_LR_MAX_FRAME_DATA_SIZE, received.length);
+
+    frame[150] ^= 0x01;
+    portVClockScheduleRx(0, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_INVALID_CHECKSUM, apiReceiveApiFrame((XBee*)lr, &received));
+}
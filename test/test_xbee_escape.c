@@ -0,0 +1,233 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_escape.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+static const uint8_t specials[] = { XBEE_START_DELIMITER, XBEE_ESCAPE, XBEE_XON, XBEE_XOFF };
+
+static XBeeLR* lr;
+static uint8_t apStatus;
+
+// Answers ATAP with apStatus, in the framing in use before the change
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    if (len < 8 || data[5] != 'A' || data[6] != 'P') return;
+    portVClockScheduleAtResponse(1, data, len, apStatus, NULL, 0);
+}
+
+/**
+ * Builds the unescaped API frame for `data` (frame type included).
+ */
+static uint16_t buildFrame(uint8_t* out, const uint8_t* data, uint16_t len) {
+    uint8_t sum = 0;
+    out[0] = XBEE_START_DELIMITER;
+    out[1] = len >> 8;
+    out[2] = len & 0xFF;
+    for (uint16_t i = 0; i < len; i++) {
+        out[3 + i] = data[i];
+        sum += data[i];
+    }
+    out[3 + len] = 0xFF - sum;
+    return len + 4;
+}
+
+/**
+ * Escapes a frame built by buildFrame() the way a module in ATAP=2 sends it.
+ */
+static uint16_t escapeFrame(uint8_t* out, const uint8_t* frame, uint16_t len) {
+    size_t consumed;
+    out[0] = frame[0];
+    return (uint16_t)(1 + xbeeEscape(&out[1], 2 * len, &frame[1], len - 1, &consumed));
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    apStatus = 0;
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    free(lr);
+}
+
+// ==== CODEC ====
+
+void test_escape_scan_finds_special_at_every_offset(void) {
+    uint8_t data[40];
+
+    for (size_t s = 0; s < sizeof(specials); s++) {
+        for (size_t pos = 0; pos < sizeof(data); pos++) {
+            memset(data, 0x12, sizeof(data));   // Neighbour of XON/XOFF that needs no escape
+            data[pos] = specials[s];
+            TEST_ASSERT_EQUAL_UINT32(pos, xbeeEscapeScan(data, sizeof(data)));
+            TEST_ASSERT_EQUAL_UINT32(pos, xbeeEscapeScan(data, pos));
+        }
+    }
+}
+
+void test_escape_round_trips_every_byte_value(void) {
+    uint8_t in[256];
+    uint8_t wire[512];
+    size_t consumed;
+
+    for (int i = 0; i < 256; i++) in[i] = (uint8_t)i;
+    size_t wireLength = xbeeEscape(wire, sizeof(wire), in, sizeof(in), &consumed);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(in), consumed);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(in) + sizeof(specials), wireLength);
+    for (size_t i = 0; i < wireLength; i++) {
+        TEST_ASSERT_TRUE(wire[i] != XBEE_START_DELIMITER && wire[i] != XBEE_XON && wire[i] != XBEE_XOFF);
+    }
+
+    bool escaped = false;
+    TEST_ASSERT_EQUAL_INT(sizeof(in), xbeeUnescape(wire, wireLength, &escaped, NULL));
+    TEST_ASSERT_FALSE(escaped);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, wire, sizeof(in));
+}
+
+void test_escape_into_small_buffer_never_splits_a_pair(void) {
+    const uint8_t in[] = { 0x01, 0x02, XBEE_ESCAPE, 0x03 };
+    uint8_t out[3];
+    size_t consumed;
+
+    TEST_ASSERT_EQUAL_UINT32(2, xbeeEscape(out, sizeof(out), in, sizeof(in), &consumed));
+    TEST_ASSERT_EQUAL_UINT32(2, consumed);
+
+    TEST_ASSERT_EQUAL_UINT32(3, xbeeEscape(out, sizeof(out), &in[2], 2, &consumed));
+    TEST_ASSERT_EQUAL_UINT32(2, consumed);
+    const uint8_t expected[] = { XBEE_ESCAPE, XBEE_ESCAPE ^ XBEE_ESCAPE_XOR, 0x03 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, sizeof(expected));
+}
+
+void test_unescape_carries_escape_across_pieces(void) {
+    uint8_t first[] = { 0x01, XBEE_ESCAPE };
+    uint8_t second[] = { XBEE_START_DELIMITER ^ XBEE_ESCAPE_XOR, 0x02 };
+    bool escaped = false;
+
+    TEST_ASSERT_EQUAL_INT(1, xbeeUnescape(first, sizeof(first), &escaped, NULL));
+    TEST_ASSERT_TRUE(escaped);
+    TEST_ASSERT_EQUAL_INT(2, xbeeUnescape(second, sizeof(second), &escaped, NULL));
+    TEST_ASSERT_FALSE(escaped);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_START_DELIMITER, second[0]);
+
+    uint8_t cut[] = { 0x01, XBEE_START_DELIMITER, 0x00 };
+    TEST_ASSERT_EQUAL_INT(-2, xbeeUnescape(cut, sizeof(cut), &escaped, NULL));
+}
+
+// ==== ESCAPED FRAMING ====
+
+void test_escaped_mode_escapes_sent_frames(void) {
+    uint8_t payload[150];
+    uint8_t expected[160];
+    uint8_t decoded[400];
+
+    TEST_ASSERT_TRUE(XBeeSetApiEnable((XBee*)lr, XBEE_API_MODE_ESCAPED));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_API_MODE_ESCAPED, lr->base.apiMode);
+    portVClockTxClear();
+
+    // Long enough to be escaped in several pieces, with specials on the piece boundaries
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = specials[i % sizeof(specials)];
+    }
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, payload, sizeof(payload)));
+
+    uint8_t data[1 + sizeof(payload)] = { XBEE_API_TYPE_LR_TX_REQUEST };
+    memcpy(&data[1], payload, sizeof(payload));
+    uint16_t expectedLength = buildFrame(expected, data, sizeof(data));
+
+    const uint8_t* wire = portVClockTxData();
+    size_t wireLength = portVClockTxLength();
+    size_t escapes = 0;
+    for (uint16_t i = 1; i < expectedLength; i++) {
+        escapes += xbeeEscapeNeeded(expected[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(expectedLength + escapes, wireLength);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_START_DELIMITER, wire[0]);
+
+    bool escaped = false;
+    memcpy(decoded, &wire[1], wireLength - 1);
+    TEST_ASSERT_EQUAL_INT(expectedLength - 1, xbeeUnescape(decoded, wireLength - 1, &escaped, NULL));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&expected[1], decoded, expectedLength - 1);
+}
+
+void test_rejected_api_mode_keeps_previous_framing(void) {
+    apStatus = 1;   // ERROR
+    TEST_ASSERT_FALSE(XBeeSetApiEnable((XBee*)lr, XBEE_API_MODE_ESCAPED));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_API_MODE_DEFAULT, lr->base.apiMode);
+
+    // A module that does not answer leaves the framing alone too
+    portVClockSetWriteHook(NULL, NULL);
+    TEST_ASSERT_FALSE(XBeeSetApiEnable((XBee*)lr, XBEE_API_MODE_ESCAPED));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_API_MODE_DEFAULT, lr->base.apiMode);
+}
+
+void test_escaped_mode_unescapes_received_frames(void) {
+    const uint8_t data[] = { XBEE_API_TYPE_MODEM_STATUS, XBEE_XON, XBEE_START_DELIMITER, XBEE_ESCAPE, XBEE_XOFF };
+    uint8_t frame[16];
+    uint8_t wire[32];
+    xbee_api_frame_t received;
+
+    TEST_ASSERT_TRUE(XBeeSetApiEnable((XBee*)lr, XBEE_API_MODE_ESCAPED));
+    uint16_t wireLength = escapeFrame(wire, frame, buildFrame(frame, data, sizeof(data)));
+
+    // Delivered in two reads, the second starting with an escaped byte
+    uint16_t split = 5;
+    TEST_ASSERT_EQUAL_HEX8(XBEE_ESCAPE, wire[split - 1]);
+    portVClockScheduleRx(0, wire, split);
+    portVClockScheduleRx(1, &wire[split], wireLength - split);
+
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &received));
+    TEST_ASSERT_EQUAL_UINT16(sizeof(data), received.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, received.data, sizeof(data));
+}
+
+void test_escaped_mode_reports_frame_cut_by_start_delimiter(void) {
+    const uint8_t data[] = { XBEE_API_TYPE_MODEM_STATUS, XBEE_MODEM_STATUS_JOINED };
+    uint8_t frame[8];
+    uint8_t wire[16];
+    xbee_api_frame_t received;
+
+    TEST_ASSERT_TRUE(XBeeSetApiEnable((XBee*)lr, XBEE_API_MODE_ESCAPED));
+
+    // The module restarted after sending the first bytes of a longer frame,
+    // and the whole next frame arrives in the same read as the cut one
+    wire[0] = XBEE_START_DELIMITER;
+    wire[1] = 0x00;
+    wire[2] = 0x0C;
+    wire[3] = XBEE_API_TYPE_LR_RX_PACKET;
+    uint16_t wireLength = 4 + escapeFrame(&wire[4], frame, buildFrame(frame, data, sizeof(data)));
+    portVClockScheduleRx(0, wire, wireLength);
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_FRAME_ABORTED, apiReceiveApiFrame((XBee*)lr, &received));
+
+    // Parsing resumes at the delimiter that cut the frame
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &received));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_API_TYPE_MODEM_STATUS, received.type);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(data), received.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, received.data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER, apiReceiveApiFrame((XBee*)lr, &received));
+
+    XBeeStats_t stats;
+    XBeeGetStats((XBee*)lr, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxStatus[-API_RECEIVE_ERROR_FRAME_ABORTED]);
+}
+
+void test_unescaped_mode_sends_special_bytes_as_is(void) {
+    const uint8_t payload[] = { XBEE_START_DELIMITER, XBEE_XON };
+
+    portVClockTxClear();
+    apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(payload) + 5, portVClockTxLength());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, &portVClockTxData()[4], sizeof(payload));
+}
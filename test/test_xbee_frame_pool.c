@@ -0,0 +1,144 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static void onReceive(XBee* self, void* data);
+
+static const XBeeCTable callbackCTable = {
+    .OnReceiveCallback = onReceive,
+};
+
+#define MODULE_LATENCY_MS 5
+#define NESTED_PAYLOAD 198      // 200-byte frames, two fit in the default LR pool and three do not
+
+static XBeeLR* lr;
+static int receives;
+static int nestLevels;          // How many more levels the receive callback recurses into XBeeProcess()
+static bool queryInCallback;
+static bool payloadIntact;
+
+// Answers every AT query with a 4-byte value
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    const uint8_t value[] = { 0x00, 0x00, 0x10, 0x0B };
+    portVClockScheduleAtResponse(MODULE_LATENCY_MS, data, len, 0x00, value, sizeof(value));
+}
+
+static uint8_t payloadByte(uint16_t i) {
+    return (uint8_t)(i * 5 + 1);
+}
+
+static void scheduleRxPacket(uint32_t delayMs, uint16_t payloadSize) {
+    uint8_t frame[XBEE_LR_MAX_FRAME_DATA_SIZE + 8] = { XBEE_API_TYPE_LR_RX_PACKET, 2 };
+    for (uint16_t i = 0; i < payloadSize; i++) frame[2 + i] = payloadByte(i);
+    portVClockScheduleFrame(delayMs, frame, 2 + payloadSize);
+}
+
+static bool payloadMatches(const XBeeLRPacket_t* packet) {
+    for (uint16_t i = 0; i < packet->payloadSize; i++) {
+        if (packet->payload[i] != payloadByte(i)) return false;
+    }
+    return true;
+}
+
+static void onReceive(XBee* self, void* data) {
+    XBeeLRPacket_t* packet = (XBeeLRPacket_t*)data;
+    receives++;
+
+    if (queryInCallback) {
+        uint32_t version;
+        TEST_ASSERT_TRUE(XBeeGetFirmwareVersion(self, &version));
+        TEST_ASSERT_EQUAL_HEX32(0x100B, version);
+    }
+    if (nestLevels > 0) {
+        nestLevels--;
+        XBeeProcess(self);
+    }
+    payloadIntact = payloadIntact && payloadMatches(packet);
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    receives = 0;
+    nestLevels = 0;
+    queryInCallback = false;
+    payloadIntact = true;
+
+    lr = XBeeLRCreate(&callbackCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    free(lr);
+}
+
+// ==== STORAGE ====
+
+void test_frame_pool_frame_structure_holds_no_data(void) {
+    TEST_ASSERT_TRUE(sizeof(xbee_api_frame_t) <= 4 * sizeof(void*));
+    TEST_ASSERT_EQUAL_UINT16(XBEE_LR_MAX_FRAME_DATA_SIZE, lr->base.maxFrameDataSize);
+    TEST_ASSERT_EQUAL_UINT16(XBEE_LR_FRAME_POOL_SIZE, lr->base.framePoolSize);
+}
+
+void test_frame_pool_receives_into_the_free_space(void) {
+    xbee_api_frame_t frame;
+
+    scheduleRxPacket(0, 16);
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &frame));
+    TEST_ASSERT_EQUAL_PTR(lr->framePool, frame.data);
+    TEST_ASSERT_EQUAL_UINT16(18, frame.length);
+    TEST_ASSERT_EQUAL_HEX8(payloadByte(15), frame.data[17]);
+    TEST_ASSERT_EQUAL_UINT16(0, lr->base.framePoolTop);
+}
+
+void test_frame_pool_rejects_frames_over_the_subclass_limit(void) {
+    uint8_t big[XBEE_LR_MAX_FRAME_DATA_SIZE + 1] = { XBEE_API_TYPE_LR_RX_PACKET, 2 };
+    xbee_api_frame_t frame;
+
+    portVClockScheduleFrame(0, big, sizeof(big));
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_FRAME_TOO_LARGE, apiReceiveApiFrame((XBee*)lr, &frame));
+
+    // The largest frame the subclass takes still fits
+    portVClockFlushRx();
+    portVClockScheduleFrame(0, big, sizeof(big) - 1);
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &frame));
+}
+
+// ==== DISPATCH ====
+
+void test_frame_pool_keeps_dispatched_frame_across_nested_at_wait(void) {
+    queryInCallback = true;
+    scheduleRxPacket(0, 120);
+
+    XBeeProcess((XBee*)lr);
+    TEST_ASSERT_EQUAL_INT(1, receives);
+    TEST_ASSERT_TRUE(payloadIntact);
+    TEST_ASSERT_EQUAL_UINT16(0, lr->base.framePoolTop);
+}
+
+void test_frame_pool_nests_until_full(void) {
+    nestLevels = 2;
+    scheduleRxPacket(0, NESTED_PAYLOAD);
+    scheduleRxPacket(1, NESTED_PAYLOAD);
+    scheduleRxPacket(2, NESTED_PAYLOAD);
+
+    XBeeProcess((XBee*)lr);
+    TEST_ASSERT_EQUAL_INT(2, receives);
+    TEST_ASSERT_TRUE(payloadIntact);
+    TEST_ASSERT_EQUAL_UINT16(0, lr->base.framePoolTop);
+
+    XBeeStats_t stats;
+    XBeeGetStats((XBee*)lr, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxStatus[-API_RECEIVE_ERROR_FRAME_TOO_LARGE]);
+}
@@ -0,0 +1,167 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static void onConnect(XBee* self);
+static void onDisconnect(XBee* self);
+
+static const XBeeCTable callbackCTable = {
+    .OnConnectCallback = onConnect,
+    .OnDisconnectCallback = onDisconnect,
+};
+
+#define MODULE_LATENCY_MS 20
+
+static XBeeLR* lr;
+static bool moduleAlive;
+static uint8_t joinStatus;
+static int queries;
+static int connects;
+static int disconnects;
+
+// Answers JS with joinStatus and SH/SL with a fixed serial number
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    if (!moduleAlive || len < 8 || data[3] != XBEE_API_TYPE_AT_COMMAND) return;
+
+    uint8_t value[4];
+    uint16_t valueLength = 0;
+    uint8_t status = 0x00;
+    queries++;
+
+    if (data[5] == 'J' && data[6] == 'S') {
+        value[valueLength++] = joinStatus;
+    } else if (data[5] == 'S') {
+        memset(value, 0x11, sizeof(value));
+        valueLength = sizeof(value);
+    } else {
+        status = 0x02;
+    }
+    portVClockScheduleAtResponse(MODULE_LATENCY_MS, data, len, status, value, valueLength);
+}
+
+static void onConnect(XBee* self) {
+    (void)self;
+    connects++;
+}
+
+static void onDisconnect(XBee* self) {
+    (void)self;
+    disconnects++;
+}
+
+static void receiveModemStatus(uint8_t status) {
+    const uint8_t frame[] = { XBEE_API_TYPE_MODEM_STATUS, status };
+    portVClockScheduleFrame(0, frame, sizeof(frame));
+    XBeeProcess((XBee*)lr);
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    moduleAlive = true;
+    joinStatus = 0;
+    queries = connects = disconnects = 0;
+
+    lr = XBeeLRCreate(&callbackCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    free(lr);
+}
+
+// ==== UNKNOWN STATE ====
+
+void test_link_state_unknown_is_resolved_by_one_query(void) {
+    joinStatus = 1;
+
+    TEST_ASSERT_EQUAL_UINT8(XBEE_LINK_UNKNOWN, lr->base.linkState);
+    TEST_ASSERT_TRUE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, connects);
+
+    // Later calls read the recorded state
+    for (int i = 0; i < 10; i++) {
+        portVClockAdvance(XBEE_CACHE_TTL_STATUS_MS);
+        TEST_ASSERT_TRUE(XBeeConnected((XBee*)lr));
+    }
+    TEST_ASSERT_EQUAL_INT(1, queries);
+}
+
+void test_link_state_failed_query_stays_unknown(void) {
+    moduleAlive = false;
+
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_LINK_UNKNOWN, lr->base.linkState);
+
+    moduleAlive = true;
+    joinStatus = 1;
+    TEST_ASSERT_TRUE(XBeeConnected((XBee*)lr));
+}
+
+// ==== MODEM STATUS ====
+
+void test_link_state_follows_joined_and_left(void) {
+    receiveModemStatus(XBEE_MODEM_STATUS_JOINED);
+    TEST_ASSERT_TRUE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, connects);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_MODEM_STATUS_JOINED, lr->base.modemStatus);
+
+    // A repeated report is not a transition
+    receiveModemStatus(XBEE_MODEM_STATUS_JOINED);
+    TEST_ASSERT_EQUAL_INT(1, connects);
+
+    receiveModemStatus(XBEE_MODEM_STATUS_LEFT);
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, disconnects);
+    TEST_ASSERT_EQUAL_INT(0, queries);
+}
+
+void test_link_state_down_on_unknown_first_report_does_not_call_disconnect(void) {
+    receiveModemStatus(XBEE_MODEM_STATUS_LEFT);
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(0, disconnects);
+    TEST_ASSERT_EQUAL_INT(0, queries);
+}
+
+void test_link_state_watchdog_reset_takes_link_down_and_clears_cache(void) {
+    uint64_t serial;
+    receiveModemStatus(XBEE_MODEM_STATUS_JOINED);
+    XBeeGetSerialNumber((XBee*)lr, &serial);
+    TEST_ASSERT_EQUAL_INT(2, queries);
+
+    receiveModemStatus(XBEE_MODEM_STATUS_WATCHDOG_RESET);
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, disconnects);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_MODEM_STATUS_WATCHDOG_RESET, lr->base.modemStatus);
+
+    XBeeGetSerialNumber((XBee*)lr, &serial);
+    TEST_ASSERT_EQUAL_INT(4, queries);
+}
+
+void test_link_state_host_reset_takes_link_down(void) {
+    receiveModemStatus(XBEE_MODEM_STATUS_JOINED);
+    XBeeSoftRestart((XBee*)lr);
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, disconnects);
+}
+
+void test_link_state_explicit_poll_reports_transitions(void) {
+    receiveModemStatus(XBEE_MODEM_STATUS_JOINED);
+
+    // The network dropped the device without a modem status reaching the host
+    joinStatus = 0;
+    TEST_ASSERT_FALSE(XBeeLRConnected((XBee*)lr));
+    TEST_ASSERT_FALSE(XBeeConnected((XBee*)lr));
+    TEST_ASSERT_EQUAL_INT(1, disconnects);
+}
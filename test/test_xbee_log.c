@@ -0,0 +1,134 @@
+#include "unity.h"
+#include "xbee_log.h"
+#include <string.h>
+
+// ==== CAPTURE SINK ====
+
+static char captured[4 * XBEE_LOG_BUFFER_SIZE];
+static size_t capturedLen;
+static int sinkCalls;
+
+static void captureSink(const char* text, size_t len) {
+    memcpy(&captured[capturedLen], text, len);
+    capturedLen += len;
+    captured[capturedLen] = '\0';
+    sinkCalls++;
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    XBeeLogReset();
+    XBeeLogSetLevel(XBEE_LOG_LEVEL_DEBUG);
+    XBeeLogSetModules(XBEE_LOG_MODULE_ALL);
+    XBeeLogSetSink(captureSink);
+    capturedLen = 0;
+    captured[0] = '\0';
+    sinkCalls = 0;
+}
+
+void tearDown(void) {
+    XBeeLogReset();
+}
+
+// ==== FORMATTING ====
+
+void test_log_formats_prefix_and_adds_newline(void) {
+    xbeeLogPrintf(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_API, "timeout after %d ms", 5);
+    xbeeLogPrintf(XBEE_LOG_LEVEL_ERROR, XBEE_LOG_MODULE_LR, "join failed\n");
+
+    XBeeLogDrain(0);
+    TEST_ASSERT_EQUAL_STRING("W api: timeout after 5 ms\nE lr : join failed\n", captured);
+}
+
+void test_log_hex_dump_is_one_line(void) {
+    const uint8_t frame[] = { 0x7E, 0x00, 0x04, 0x08, 0x01, 0x56, 0x52, 0x4E };
+
+    xbeeLogHex(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_API, "TX: ", frame, sizeof(frame));
+    xbeeLogText(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_CELLULAR, "ASCII: ", frame, sizeof(frame));
+
+    XBeeLogDrain(0);
+    TEST_ASSERT_EQUAL_STRING("D api: TX: 7E 00 04 08 01 56 52 4E\nD cel: ASCII: ~....VRN\n", captured);
+}
+
+void test_log_truncates_long_lines(void) {
+    uint8_t data[XBEE_LOG_LINE_MAX];
+    memset(data, 0xAB, sizeof(data));
+
+    xbeeLogHex(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_API, "", data, sizeof(data));
+    XBeeLogDrain(0);
+
+    TEST_ASSERT_EQUAL_size_t(XBEE_LOG_LINE_MAX - 1, capturedLen);
+    TEST_ASSERT_EQUAL_STRING("...\n", &captured[capturedLen - 4]);
+    TEST_ASSERT_EQUAL_MEMORY("D api: AB AB ", captured, 13);
+}
+
+// ==== FILTERING ====
+
+void test_log_filters_by_level_and_module(void) {
+    XBeeLogSetLevel(XBEE_LOG_LEVEL_WARN);
+    XBeeLogSetModules(XBEE_LOG_MODULE_LR);
+
+    XBEE_LOG(XBEE_LOG_LEVEL_DEBUG, XBEE_LOG_MODULE_LR, "verbose");
+    XBEE_LOG(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_API, "other module");
+    XBEE_LOG(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_LR, "kept");
+
+    XBeeLogDrain(0);
+    TEST_ASSERT_EQUAL_STRING("W lr : kept\n", captured);
+}
+
+void test_log_statements_above_max_level_are_compiled_out(void) {
+    int evaluated = 0;
+
+    XBEE_LOG_WARN(XBEE_LOG_MODULE_CORE, "%d", ++evaluated);
+    XBEE_LOG_DEBUG(XBEE_LOG_MODULE_CORE, "%d", ++evaluated);
+
+    TEST_ASSERT_EQUAL_INT(XBEE_LOG_MAX_LEVEL >= XBEE_LOG_LEVEL_DEBUG ? 2 : 1, evaluated);
+}
+
+// ==== BUFFERING AND DRAIN ====
+
+void test_log_buffers_until_drained(void) {
+    XBeeLogSetSink(NULL);
+    xbeeLogPrintf(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_CORE, "buffered");
+
+    TEST_ASSERT_EQUAL_size_t(16, XBeeLogPending());
+    TEST_ASSERT_EQUAL_size_t(0, XBeeLogDrain(0));
+    TEST_ASSERT_EQUAL_INT(0, sinkCalls);
+
+    XBeeLogSetSink(captureSink);
+    TEST_ASSERT_EQUAL_size_t(16, XBeeLogDrain(0));
+    TEST_ASSERT_EQUAL_size_t(0, XBeeLogPending());
+    TEST_ASSERT_EQUAL_STRING("W xb : buffered\n", captured);
+}
+
+void test_log_drain_respects_budget_and_wraps(void) {
+    // Leave the ring positions near the end so the next line wraps
+    for (int i = 0; i < XBEE_LOG_BUFFER_SIZE / 16 - 1; i++) {
+        xbeeLogPrintf(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_CORE, "buffered");
+    }
+    xbeeLogPrintf(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_CORE, "pad");
+    XBeeLogDrain(0);
+    capturedLen = 0;
+    sinkCalls = 0;
+
+    xbeeLogPrintf(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_CORE, "wrapped");
+    TEST_ASSERT_EQUAL_size_t(3, XBeeLogDrain(3));
+    TEST_ASSERT_EQUAL_size_t(12, XBeeLogDrain(0));
+    TEST_ASSERT_EQUAL_STRING("W xb : wrapped\n", captured);
+    TEST_ASSERT_EQUAL_INT(3, sinkCalls);
+}
+
+void test_log_counts_dropped_lines_when_full(void) {
+    XBeeLogSetSink(NULL);
+    for (int i = 0; i < XBEE_LOG_BUFFER_SIZE / 16 + 3; i++) {
+        xbeeLogPrintf(XBEE_LOG_LEVEL_WARN, XBEE_LOG_MODULE_CORE, "buffered");
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, XBeeLogDropped());
+
+    XBeeLogSetSink(captureSink);
+    XBeeLogDrain(0);
+    TEST_ASSERT_EQUAL_UINT32(0, XBeeLogDropped());
+    TEST_ASSERT_EQUAL_MEMORY("W log: 3 lines dropped\n", captured, 23);
+    TEST_ASSERT_EQUAL_size_t(23 + XBEE_LOG_BUFFER_SIZE, capturedLen);
+}
@@ -3,13 +3,16 @@
 #include "mock_xbee_api_frames.h"
 #include "mock_port.h"
 #include "xbee_at_cmds.h"
+#include "xbee_timeout.h"
 #include <string.h>
 #include <stdlib.h>
 
 // --- GLOBAL TEST OBJECTS AND CALLBACK STUBS ---
 
-static XBee mockXbee;
+static XBeeLR mockXbeeLR;
+static XBee* self = (XBee*)&mockXbeeLR;
 static XBeeHTable htable;
+static XBeeCTable ctable;
 
 // Stub callbacks
 static void dummyDelay(uint32_t ms) { (void)ms; }
@@ -26,6 +29,12 @@ static void onReceive(XBee* self, void* data) {
     callbackInvoked = true;
 }
 
+// Timeout of a register-class set on a fresh instance at 9600 baud: class default plus wire time
+static uint32_t registerSetTimeout(uint16_t paramLength) {
+    return XBEE_AT_TIMEOUT_REGISTER_MS +
+           xbeeWireTimeMs(9600, XBEE_AT_REQUEST_WIRE_BYTES + paramLength + XBEE_AT_RESPONSE_WIRE_BYTES);
+}
+
 static int mockUartInit(uint32_t baud, void* dev) {
     TEST_ASSERT_EQUAL_UINT32(9600, baud);
     TEST_ASSERT_NULL(dev);
@@ -37,7 +46,9 @@ static int mockUartInit(uint32_t baud, void* dev) {
 void setUp(void) {
     htable.PortMillis = dummyMillis;
     htable.PortDelay = dummyDelay;
-    mockXbee.htable = &htable;
+    htable.PortUartInit = mockUartInit;
+    XBeeLRInitStatic(&mockXbeeLR, &ctable, &htable);
+    TEST_ASSERT_TRUE(XBeeInit(self, 9600, NULL));
 }
 
 void tearDown(void) {}
@@ -45,65 +56,73 @@ void tearDown(void) {}
 // --- TEST CASES ---
 
 void test_XBeeLRInit_should_return_true_on_uart_success(void) {
-    htable.PortUartInit = mockUartInit;
-    TEST_ASSERT_TRUE(XBeeLRInit(&mockXbee, 9600, NULL));
+    TEST_ASSERT_TRUE(XBeeLRInit(self, 9600, NULL));
 }
 
 void test_XBeeLRConnected_should_return_true_when_response_is_1(void) {
     uint8_t resp[] = {1};
     uint8_t len = 1;
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(&mockXbee, AT_AI, NULL, 0, resp, &len, 5000, 33, API_SEND_SUCCESS);
-    TEST_ASSERT_TRUE(XBeeLRConnected(&mockXbee));
+    apiSendAtCommandAndGetResponse_ExpectAnyArgsAndReturn(API_SEND_SUCCESS);
+    apiSendAtCommandAndGetResponse_ReturnArrayThruPtr_responseBuffer(resp, sizeof(resp));
+    apiSendAtCommandAndGetResponse_ReturnThruPtr_responseLength(&len);
+    TEST_ASSERT_TRUE(XBeeLRConnected(self));
 }
 
 void test_XBeeLRConnected_should_return_false_on_error(void) {
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(&mockXbee, AT_AI, NULL, 0, NULL, NULL, 5000, 33, -1);
-    TEST_ASSERT_FALSE(XBeeLRConnected(&mockXbee));
+    apiSendAtCommandAndGetResponse_ExpectAnyArgsAndReturn(-1);
+    TEST_ASSERT_FALSE(XBeeLRConnected(self));
 }
 
 void test_XBeeLRSetAppKey_should_pass_on_valid_input(void) {
     const char *key = "00112233445566778899AABBCCDDEEFF";
-    uint8_t response[1] = {0};
-    uint8_t len = 1;
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(NULL, AT_AK, NULL, 16, response, &len, 5000, 33, API_SEND_SUCCESS);
-    TEST_ASSERT_TRUE(XBeeLRSetAppKey(NULL, key));
+    const uint8_t param[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                             0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    uint8_t len = 0;
+    apiSendAtCommandAndGetResponse_ExpectAndReturn(self, AT_AK, param, 16, NULL, &len, registerSetTimeout(16), 0, API_SEND_SUCCESS);
+    TEST_ASSERT_TRUE(XBeeLRSetAppKey(self, key));
 }
 
 void test_XBeeLRSetJoinRX1Delay_should_succeed_with_valid_value(void) {
     uint32_t delay = 5000;
-    uint8_t response[2] = {0};
-    uint8_t len = 1;
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(NULL, AT_J1, NULL, 2, response, &len, 5000, 33, API_SEND_SUCCESS);
-    TEST_ASSERT_TRUE(XBeeLRSetJoinRX1Delay(NULL, delay));
+    const uint8_t param[] = {0x00, 0x00, 0x13, 0x88};
+    uint8_t len = 0;
+    apiSendAtCommandAndGetResponse_ExpectAndReturn(self, AT_J1, param, 4, NULL, &len, registerSetTimeout(4), 0, API_SEND_SUCCESS);
+    TEST_ASSERT_TRUE(XBeeLRSetJoinRX1Delay(self, delay));
 }
 
-void test_XBeeLRSetRX2Frequency_should_succeed(void) {
+void test_XBeeLRSetRX2Frequency_should_send_big_endian(void) {
     uint32_t freq = 869525000;
-    uint8_t response[4] = {0};
-    uint8_t len = 1;
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(NULL, AT_XF, NULL, 4, response, &len, 5000, 33, API_SEND_SUCCESS);
-    TEST_ASSERT_TRUE(XBeeLRSetRX2Frequency(NULL, freq));
+    const uint8_t param[] = {0x33, 0xD3, 0xE6, 0x08};
+    uint8_t len = 0;
+    apiSendAtCommandAndGetResponse_ExpectAndReturn(self, AT_XF, param, 4, NULL, &len, registerSetTimeout(4), 0, API_SEND_SUCCESS);
+    TEST_ASSERT_TRUE(XBeeLRSetRX2Frequency(self, freq));
 }
 
 void test_XBeeLRSetAppEUI_should_return_true_for_valid_input(void) {
     const char* appEUI = "A1B2C3D4E5F60708";
-    uint8_t response[17] = {0};
+    const uint8_t param[] = {0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6, 0x07, 0x08};
     uint8_t respLen = 0;
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(&mockXbee, AT_AE, NULL, 8, response, &respLen, 5000, 17, API_SEND_SUCCESS);
-    TEST_ASSERT_TRUE(XBeeLRSetAppEUI(&mockXbee, appEUI));
+    apiSendAtCommandAndGetResponse_ExpectAndReturn(self, AT_AE, param, 8, NULL, &respLen, registerSetTimeout(8), 0, API_SEND_SUCCESS);
+    TEST_ASSERT_TRUE(XBeeLRSetAppEUI(self, appEUI));
 }
 
 void test_XBeeLRSetAppEUI_should_return_false_for_invalid_input(void) {
     const char* appEUI = "BADLENGTH";
-    TEST_ASSERT_FALSE(XBeeLRSetAppEUI(&mockXbee, appEUI));
+    TEST_ASSERT_FALSE(XBeeLRSetAppEUI(self, appEUI));
 }
 
 void test_XBeeLRSetClass_should_send_AT_LC_command(void) {
-    uint8_t response[4];
     uint8_t responseLength = 0;
     char classVal = 'A';
-    apiSendAtCommandAndGetResponse_ExpectAndReturn(&mockXbee, AT_LC, (const uint8_t*)&classVal, 1, response, &responseLength, 5000, sizeof(response), API_SEND_SUCCESS);
-    TEST_ASSERT_TRUE(XBeeLRSetClass(&mockXbee, classVal));
+    apiSendAtCommandAndGetResponse_ExpectAndReturn(self, AT_LC, (const uint8_t*)&classVal, 1, NULL, &responseLength, registerSetTimeout(1), 0, API_SEND_SUCCESS);
+    TEST_ASSERT_TRUE(XBeeLRSetClass(self, classVal));
+}
+
+void test_XBeeLR_setters_should_reject_out_of_range_values_without_sending(void) {
+    // No apiSendAtCommandAndGetResponse call is expected
+    TEST_ASSERT_FALSE(XBeeLRSetClass(self, 'D'));
+    TEST_ASSERT_FALSE(XBeeLRSetDataRate(self, 16));
+    TEST_ASSERT_FALSE(XBeeLRSetADR(self, 2));
 }
 
 void test_XBeeLRSendPacket_should_send_and_wait_for_tx_status(void) {
@@ -113,12 +132,12 @@ void test_XBeeLRSendPacket_should_send_and_wait_for_tx_status(void) {
         .port = 1,
         .ack = 0
     };
-    mockXbee.frameIdCntr = 1;
-    mockXbee.txStatusReceived = true;
-    mockXbee.deliveryStatus = 0x00;
+    self->frameIdCntr = 1;
+    self->txStatusReceived = true;
+    self->deliveryStatus = 0x00;
 
-    apiSendFrame_ExpectAndReturn(&mockXbee, XBEE_API_TYPE_LR_TX_REQUEST, NULL, 5, API_SEND_SUCCESS);
-    TEST_ASSERT_EQUAL_UINT8(0x00, XBeeLRSendPacket(&mockXbee, &packet));
+    apiSendFrame_ExpectAndReturn(self, XBEE_API_TYPE_LR_TX_REQUEST, NULL, 5, API_SEND_SUCCESS);
+    TEST_ASSERT_EQUAL_UINT8(0x00, XBeeLRSendPacket(self, &packet));
 }
 
 // void test_XBeeLRHandleTransmitStatus_should_parse_and_set_flags(void) {
@@ -127,10 +146,10 @@ void test_XBeeLRSendPacket_should_send_and_wait_for_tx_status(void) {
 //         .length = 3,
 //         .data = {0x00, 0x01, 0x00}
 //     };
-//     mockXbee.ctable = NULL;
-//     XBeeLRHandleTransmitStatus(&mockXbee, &frame);
-//     TEST_ASSERT_TRUE(mockXbee.txStatusReceived);
-//     TEST_ASSERT_EQUAL_UINT8(0x00, mockXbee.deliveryStatus);
+//     self->ctable = NULL;
+//     XBeeLRHandleTransmitStatus(self, &frame);
+//     TEST_ASSERT_TRUE(self->txStatusReceived);
+//     TEST_ASSERT_EQUAL_UINT8(0x00, self->deliveryStatus);
 // }
 
 // void test_XBeeLRHandleRxPacket_should_invoke_receive_callback(void) {
@@ -141,8 +160,8 @@ void test_XBeeLRSendPacket_should_send_and_wait_for_tx_status(void) {
 //     };
 //     callbackInvoked = false;
 //     XBeeCTable ctable = {.OnReceiveCallback = onReceive};
-//     mockXbee.ctable = &ctable;
-//     XBeeLRHandleRxPacket(&mockXbee, &frame);
+//     self->ctable = &ctable;
+//     XBeeLRHandleRxPacket(self, &frame);
 //     TEST_ASSERT_TRUE(callbackInvoked);
 // }
 
@@ -154,7 +173,7 @@ void test_XBeeLRSendPacket_should_send_and_wait_for_tx_status(void) {
 //     RUN_TEST(test_XBeeLRConnected_should_return_false_on_error);
 //     RUN_TEST(test_XBeeLRSetAppKey_should_pass_on_valid_input);
 //     RUN_TEST(test_XBeeLRSetJoinRX1Delay_should_succeed_with_valid_value);
-//     RUN_TEST(test_XBeeLRSetRX2Frequency_should_succeed);
+//     RUN_TEST(test_XBeeLRSetRX2Frequency_should_send_big_endian);
 //     RUN_TEST(test_XBeeLRSetAppEUI_should_return_true_for_valid_input);
 //     RUN_TEST(test_XBeeLRSetAppEUI_should_return_false_for_invalid_input);
 //     RUN_TEST(test_XBeeLRSetClass_should_send_AT_LC_command);
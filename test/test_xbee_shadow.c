@@ -0,0 +1,234 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee_shadow.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+#define MODULE_LATENCY_MS 20
+
+// Simulated module registers, answered from the vclock write hook
+typedef struct {
+    char name[3];
+    uint8_t value[16];
+    uint8_t length;
+} Register_t;
+
+static Register_t registers[8];
+static int queries;
+static int sets;
+static int writes;
+static int applies;
+static bool silentQueries;      // Queries go unanswered, as on a module that dropped them
+static uint32_t firstSetMs;
+static XBeeLR* lr;
+
+static Register_t* findRegister(const uint8_t* name) {
+    for (size_t i = 0; i < sizeof(registers) / sizeof(registers[0]); i++) {
+        if (registers[i].name[0] == name[0] && registers[i].name[1] == name[1]) return &registers[i];
+    }
+    return NULL;
+}
+
+static void setRegister(size_t index, const char* name, const uint8_t* value, uint8_t length) {
+    memcpy(registers[index].name, name, 3);
+    memcpy(registers[index].value, value, length);
+    registers[index].length = length;
+}
+
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    if (len < 8 || data[3] != XBEE_API_TYPE_AT_COMMAND) return;
+
+    uint16_t paramLength = (uint16_t)(((data[1] << 8) | data[2]) - 4);
+    const uint8_t* value = NULL;
+    uint16_t valueLength = 0;
+    uint8_t status = 0x00;
+    Register_t* reg = findRegister(&data[5]);
+
+    if (data[5] == 'W' && data[6] == 'R') {
+        writes++;
+    } else if (data[5] == 'A' && data[6] == 'C') {
+        applies++;
+    } else if (paramLength) {
+        if (!sets++) firstSetMs = portVClockNow();
+        if (reg) {
+            memcpy(reg->value, &data[7], paramLength);
+            reg->length = (uint8_t)paramLength;
+        } else {
+            status = 0x02;
+        }
+    } else {
+        queries++;
+        if (silentQueries) return;
+        if (reg) {
+            value = reg->value;
+            valueLength = reg->length;
+        } else {
+            status = 0x02;    // Invalid command
+        }
+    }
+    portVClockScheduleAtResponse(MODULE_LATENCY_MS, data, len, status, value, valueLength);
+}
+
+static const uint8_t appEui[8] = { 0x9E, 0x11, 0x77, 0xBD, 0x6B, 0x1D, 0xF4, 0x1E };
+static const uint8_t appKey[16] = { 0xCD, 0x32 };
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    const uint8_t region = 8;
+    const uint8_t lorawanClass = 'C';
+    const uint8_t adr = 1;
+    const uint8_t rx2Frequency[4] = { 0x36, 0x3F, 0x06, 0x20 };
+
+    portVClockReset();
+    memset(registers, 0, sizeof(registers));
+    setRegister(0, "AE", appEui, sizeof(appEui));
+    setRegister(1, "LR", &region, 1);
+    setRegister(2, "LC", &lorawanClass, 1);
+    setRegister(3, "AD", &adr, 1);
+    setRegister(4, "XF", rx2Frequency, sizeof(rx2Frequency));
+    setRegister(5, "AK", appKey, sizeof(appKey));
+    queries = sets = writes = applies = 0;
+    silentQueries = false;
+    firstSetMs = 0;
+
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    free(lr);
+}
+
+static const XBeeShadowParam_t desired[] = {
+    XBEE_SHADOW_BYTES(AT_AE, appEui, sizeof(appEui)),
+    XBEE_SHADOW_UINT(AT_LR, 8),
+    XBEE_SHADOW_UINT(AT_LC, 'C'),
+    XBEE_SHADOW_UINT(AT_AD, 1),
+    XBEE_SHADOW_UINT(AT_XF, 910100000),
+};
+
+// ==== SYNC ====
+
+void test_shadow_sync_skips_matching_parameters(void) {
+    uint8_t changed = 99;
+
+    TEST_ASSERT_TRUE(XBeeShadowSync((XBee*)lr, desired, 5, &changed));
+    TEST_ASSERT_EQUAL_UINT8(0, changed);
+    TEST_ASSERT_EQUAL_INT(5, queries);
+    TEST_ASSERT_EQUAL_INT(0, sets);
+    TEST_ASSERT_EQUAL_INT(0, writes);
+    TEST_ASSERT_EQUAL_INT(0, applies);
+}
+
+void test_shadow_sync_pipelines_queries(void) {
+    XBeeShadowSync((XBee*)lr, desired, 5, NULL);
+
+    // Five queries four at a time take two module round trips, not five
+    TEST_ASSERT_LESS_THAN_UINT32(3 * MODULE_LATENCY_MS, portVClockNow());
+}
+
+void test_shadow_sync_writes_only_differences_then_commits_once(void) {
+    const uint8_t region = 1;
+    const uint8_t lorawanClass = 'A';
+    uint8_t changed = 0;
+    setRegister(1, "LR", &region, 1);
+    setRegister(2, "LC", &lorawanClass, 1);
+
+    TEST_ASSERT_TRUE(XBeeShadowSync((XBee*)lr, desired, 5, &changed));
+    TEST_ASSERT_EQUAL_UINT8(2, changed);
+    TEST_ASSERT_EQUAL_INT(2, sets);
+    TEST_ASSERT_EQUAL_INT(1, writes);
+    TEST_ASSERT_EQUAL_INT(1, applies);
+    TEST_ASSERT_EQUAL_UINT8(8, registers[1].value[0]);
+    TEST_ASSERT_EQUAL_UINT8('C', registers[2].value[0]);
+}
+
+void test_shadow_sync_writes_write_only_once_without_commit(void) {
+    const XBeeShadowParam_t key[] = { XBEE_SHADOW_BYTES(AT_AK, appKey, sizeof(appKey)) };
+    uint8_t changed = 99;
+
+    TEST_ASSERT_TRUE(XBeeShadowSync((XBee*)lr, key, 1, &changed));
+    TEST_ASSERT_EQUAL_UINT8(0, changed);
+    TEST_ASSERT_EQUAL_INT(0, queries);
+    TEST_ASSERT_EQUAL_INT(1, sets);
+    TEST_ASSERT_EQUAL_INT(0, writes);
+
+    TEST_ASSERT_TRUE(XBeeShadowSync((XBee*)lr, key, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(1, sets);
+}
+
+void test_shadow_is_reused_until_invalidated(void) {
+    XBeeShadowSync((XBee*)lr, desired, 5, NULL);
+    XBeeShadowSync((XBee*)lr, desired, 5, NULL);
+    TEST_ASSERT_EQUAL_INT(5, queries);
+
+    // A value set directly keeps the shadow coherent
+    TEST_ASSERT_TRUE(XBeeAtSet((XBee*)lr, AT_LR, 2));
+    TEST_ASSERT_TRUE(XBeeShadowSync((XBee*)lr, desired, 5, NULL));
+    TEST_ASSERT_EQUAL_INT(5, queries);
+    TEST_ASSERT_EQUAL_INT(2, sets);
+
+    XBeeShadowInvalidate((XBee*)lr);
+    XBeeShadowSync((XBee*)lr, desired, 5, NULL);
+    TEST_ASSERT_EQUAL_INT(10, queries);
+}
+
+void test_shadow_sync_tries_to_write_unreadable_parameters(void) {
+    memset(&registers[4], 0, sizeof(registers[4]));    // Module without ATXF
+
+    // The failed query leaves XF unknown, so it is written, and the rejected write fails the sync
+    TEST_ASSERT_FALSE(XBeeShadowSync((XBee*)lr, desired, 5, NULL));
+    TEST_ASSERT_EQUAL_INT(5, queries);
+    TEST_ASSERT_EQUAL_INT(1, sets);
+    TEST_ASSERT_EQUAL_INT(0, writes);
+}
+
+void test_shadow_sync_gives_up_on_unanswered_queries_within_their_timeout(void) {
+    silentQueries = true;
+
+    // The unknown parameters are then written; the wait must not run on to the idle read timeout
+    XBeeShadowSync((XBee*)lr, desired, 5, NULL);
+    TEST_ASSERT_EQUAL_INT(XBEE_SHADOW_PIPELINE_DEPTH, queries);
+    TEST_ASSERT_EQUAL_INT(5, sets);
+    TEST_ASSERT_GREATER_OR_EQUAL(XBEE_AT_TIMEOUT_REGISTER_MS, firstSetMs);
+    TEST_ASSERT_LESS_THAN(UART_READ_TIMEOUT_MS, firstSetMs);
+}
+
+// ==== XBEE LR CONFIGURE ====
+
+void test_lr_configure_writes_differing_settings(void) {
+    const uint8_t adr = 0;
+    setRegister(3, "AD", &adr, 1);
+    const XBeeLRConfig_t config = {
+        .appEUI = "9E1177BD6B1DF41E",
+        .lorawanClass = 'C',
+        .fields = XBEE_LR_CONFIG_REGION | XBEE_LR_CONFIG_ADR,
+        .region = 8,
+        .adr = 1,
+    };
+
+    TEST_ASSERT_TRUE(XBeeConfigure((XBee*)lr, &config));
+    TEST_ASSERT_EQUAL_INT(4, queries);
+    TEST_ASSERT_EQUAL_INT(1, sets);
+    TEST_ASSERT_EQUAL_INT(1, writes);
+    TEST_ASSERT_EQUAL_UINT8(1, registers[3].value[0]);
+}
+
+void test_lr_configure_rejects_bad_hex_without_sending(void) {
+    const XBeeLRConfig_t config = { .appKey = "CD32" };
+
+    TEST_ASSERT_FALSE(XBeeConfigure((XBee*)lr, &config));
+    TEST_ASSERT_EQUAL_size_t(0, portVClockTxLength());
+}
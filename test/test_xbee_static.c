@@ -0,0 +1,89 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee.h"
+#include <string.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+static XBeeLR storage;
+static XBeeLR* lr;
+
+// Answers every AT query with a 4-byte value
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    const uint8_t value[] = { 0x00, 0x00, 0x10, 0x0B };
+    portVClockScheduleAtResponse(5, data, len, 0x00, value, sizeof(value));
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    memset(&storage, 0xA5, sizeof(storage));   // Whatever the storage held before
+    lr = XBeeLRInitStatic(&storage, &vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+}
+
+// ==== CONSTRUCTION ====
+
+void test_static_init_uses_the_given_storage(void) {
+    TEST_ASSERT_EQUAL_PTR(&storage, lr);
+    TEST_ASSERT_EQUAL_PTR(storage.framePool, storage.base.framePool);
+    TEST_ASSERT_EQUAL_UINT16(XBEE_LR_FRAME_POOL_SIZE, storage.base.framePoolSize);
+    TEST_ASSERT_EQUAL_UINT16(0, storage.base.framePoolTop);
+    TEST_ASSERT_EQUAL_PTR(&portVClockHTable, storage.base.htable);
+    TEST_ASSERT_NULL(XBeeLRInitStatic(NULL, &vclockCTable, &portVClockHTable));
+}
+
+void test_static_instance_runs_at_commands(void) {
+    uint32_t version = 0;
+    TEST_ASSERT_TRUE(XBeeGetFirmwareVersion((XBee*)lr, &version));
+    TEST_ASSERT_EQUAL_HEX32(0x100B, version);
+
+    XBeeStats_t stats;
+    XBeeGetStats((XBee*)lr, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atCommands);
+}
+
+// ==== BUFFER LIMITS ====
+
+void test_static_send_frame_refuses_frames_over_the_tx_buffer(void) {
+    static const uint8_t data[XBEE_TX_FRAME_BUFFER_SIZE] = {0};
+
+    portVClockTxClear();
+    TEST_ASSERT_EQUAL_INT(API_SEND_ERROR_FRAME_TOO_LARGE,
+                          apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, data, XBEE_TX_FRAME_BUFFER_SIZE - 4));
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockTxLength());
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS,
+                          apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, data, XBEE_TX_FRAME_BUFFER_SIZE - 5));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_TX_FRAME_BUFFER_SIZE, portVClockTxLength());
+}
+
+void test_static_at_command_refuses_parameters_over_the_limit(void) {
+    static const uint8_t param[XBEE_AT_PARAM_MAX_SIZE + 1] = {0};
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_ERROR_FRAME_TOO_LARGE,
+                          apiSendAtCommand((XBee*)lr, AT_NI, param, sizeof(param)));
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS,
+                          apiSendAtCommand((XBee*)lr, AT_NI, param, sizeof(param) - 1));
+}
+
+void test_static_lr_send_refuses_payloads_over_the_frame_buffer(void) {
+    static uint8_t payload[XBEE_LR_TX_FRAME_SIZE];
+    XBeeLRPacket_t packet = { .port = 2, .payload = payload, .payloadSize = XBEE_LR_TX_FRAME_SIZE - 2 };
+
+    portVClockTxClear();
+    TEST_ASSERT_FALSE(XBeeSendPacket((XBee*)lr, &packet));
+    TEST_ASSERT_EQUAL_UINT32(0, portVClockTxLength());
+}
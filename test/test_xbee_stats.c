@@ -0,0 +1,225 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee_stats.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+static const uint8_t modemStatus[] = { XBEE_API_TYPE_MODEM_STATUS, 0x00 };
+
+static XBeeLR* lr;
+static XBeeStats_t stats;
+
+static void snapshot(void) {
+    TEST_ASSERT_TRUE(XBeeGetStats((XBee*)lr, &stats));
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+}
+
+void tearDown(void) {
+    free(lr);
+}
+
+// ==== FRAME COUNTERS ====
+
+void test_stats_are_zero_after_init(void) {
+    XBeeStats_t zero;
+    memset(&zero, 0, sizeof(zero));
+    snapshot();
+    TEST_ASSERT_EQUAL_MEMORY(&zero, &stats, sizeof(stats));
+}
+
+void test_stats_count_sent_frames_and_wire_bytes_by_type(void) {
+    const uint8_t data[] = { 0x01, 0x02, 0x03 };
+    apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, data, sizeof(data));
+    apiSendFrame((XBee*)lr, XBEE_API_TYPE_LR_TX_REQUEST, data, sizeof(data));
+
+    snapshot();
+    uint8_t slot = XBeeStatsFrameTypeSlot(XBEE_API_TYPE_LR_TX_REQUEST);
+    TEST_ASSERT_NOT_EQUAL(0, slot);
+    TEST_ASSERT_EQUAL_HEX8(XBEE_API_TYPE_LR_TX_REQUEST, XBeeStatsSlotFrameType(slot));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.txFrames[slot]);
+    TEST_ASSERT_EQUAL_UINT32(portVClockTxLength(), stats.txBytes[slot]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.txErrors);
+}
+
+void test_stats_count_received_frames_and_receive_errors(void) {
+    const uint8_t badChecksum[] = { 0x7E, 0x00, 0x02, XBEE_API_TYPE_MODEM_STATUS, 0x00, 0x00 };
+    xbee_api_frame_t frame;
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+    portVClockScheduleRx(0, badChecksum, sizeof(badChecksum));
+
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &frame));
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_INVALID_CHECKSUM, apiReceiveApiFrame((XBee*)lr, &frame));
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER, apiReceiveApiFrame((XBee*)lr, &frame));
+
+    snapshot();
+    uint8_t slot = XBeeStatsFrameTypeSlot(XBEE_API_TYPE_MODEM_STATUS);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxFrames[slot]);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(modemStatus) + 4, stats.rxBytes[slot]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxStatus[-API_RECEIVE_SUCCESS]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxStatus[-API_RECEIVE_ERROR_INVALID_CHECKSUM]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxStatus[-API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER]);
+}
+
+void test_stats_unknown_frame_types_share_the_other_slot(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, XBeeStatsFrameTypeSlot(0xEE));
+    TEST_ASSERT_EQUAL_HEX8(0x00, XBeeStatsSlotFrameType(0));
+    TEST_ASSERT_EQUAL_HEX8(0x00, XBeeStatsSlotFrameType(XBEE_STATS_FRAME_TYPE_SLOTS));
+}
+
+// ==== AT COMMANDS AND LATENCY ====
+
+void test_stats_record_at_round_trip_time(void) {
+    const uint8_t resp[] = { XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x00, 0x10, 0x10 };
+    uint8_t value[4];
+    uint8_t valueLen = 0;
+    portVClockScheduleFrame(30, resp, sizeof(resp));
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          value, &valueLen, 5000, sizeof(value)));
+
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atCommands);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.atErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atRoundTrip.count);
+    TEST_ASSERT_GREATER_OR_EQUAL(29, stats.atRoundTrip.maxMs);    // Timed from the end of the send
+    TEST_ASSERT_LESS_THAN(100, stats.atRoundTrip.maxMs);
+}
+
+void test_stats_count_at_errors_and_timeouts(void) {
+    const uint8_t error[] = { XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x01 };
+    uint8_t value[4];
+    uint8_t valueLen = 0;
+    portVClockScheduleFrame(10, error, sizeof(error));
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_AT_CMD_ERROR, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          value, &valueLen, 5000, sizeof(value)));
+    TEST_ASSERT_EQUAL_INT(API_SEND_AT_CMD_RESONSE_TIMEOUT, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          value, &valueLen, 500, sizeof(value)));
+
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.atCommands);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atTimeouts);
+}
+
+void test_stats_count_at_responses_by_command(void) {
+    const uint8_t stale[] = { XBEE_API_TYPE_AT_RESPONSE, 0x07, 'S', 'L', 0x00, 0x01, 0x02, 0x03, 0x04 };
+    const uint8_t resp[] = { XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x00, 0x10, 0x10 };
+    uint8_t value[4];
+    uint8_t valueLen = 0;
+    portVClockScheduleFrame(10, stale, sizeof(stale));
+    portVClockScheduleFrame(20, resp, sizeof(resp));
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          value, &valueLen, 5000, sizeof(value)));
+
+    // The late answer to an earlier query is attributed to its own command
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atResponses[AT_VR]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.atResponses[AT_SL]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.atResponses[AT_]);
+}
+
+void test_stats_record_tx_status_latency_and_timeouts(void) {
+    uint8_t payload[] = { 0xC0, 0xFF, 0xEE };
+    XBeeLRPacket_t packet = { .payload = payload, .payloadSize = sizeof(payload), .port = 2 };
+    const uint8_t status[] = { XBEE_API_TYPE_TX_STATUS, 0x01, XBEE_DELIVERY_STATUS_SUCCESS };
+    portVClockScheduleFrame(1500, status, sizeof(status));
+
+    XBeeLRSendPacket((XBee*)lr, &packet);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, XBeeLRSendPacket((XBee*)lr, &packet));
+
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txStatusLatency.count);
+    TEST_ASSERT_GREATER_OR_EQUAL(1499, stats.txStatusLatency.maxMs);    // Timed from the end of the send
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txStatusTimeouts);
+}
+
+void test_stats_histogram_percentiles_use_bucket_upper_bounds(void) {
+    XBeeStatsHist_t hist;
+    memset(&hist, 0, sizeof(hist));
+    TEST_ASSERT_EQUAL_UINT32(0, XBeeStatsHistPercentile(&hist, 50));
+
+    for (int i = 0; i < 90; i++) xbeeStatsHistAdd(&hist, 3);
+    for (int i = 0; i < 10; i++) xbeeStatsHistAdd(&hist, 700);
+
+    TEST_ASSERT_EQUAL_UINT32(100, hist.count);
+    TEST_ASSERT_EQUAL_UINT32(4, XBeeStatsHistPercentile(&hist, 50));
+    TEST_ASSERT_EQUAL_UINT32(4, XBeeStatsHistPercentile(&hist, 90));
+    TEST_ASSERT_EQUAL_UINT32(700, XBeeStatsHistPercentile(&hist, 99));
+    TEST_ASSERT_EQUAL_UINT32(700, hist.maxMs);
+}
+
+void test_stats_reset_clears_everything(void) {
+    portVClockScheduleFrame(0, modemStatus, sizeof(modemStatus));
+    XBeeProcess((XBee*)lr);
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.processLoop.count);
+
+    XBeeResetStats((XBee*)lr);
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.processLoop.count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rxStatus[0]);
+}
+
+// ==== LINK QUALITY ====
+
+void test_stats_record_rssi_and_snr_of_received_packets(void) {
+    const uint8_t explicitRx[] = { XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET, 0x02, 0xB5, 0x07, 0x13,
+                                   0x00, 0x00, 0x00, 0x01, 0x00, 'h', 'i' };
+    portVClockScheduleFrame(0, explicitRx, sizeof(explicitRx));
+    XBeeProcess((XBee*)lr);
+
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.linkSamples);
+    TEST_ASSERT_EQUAL_INT8(-75, stats.lastRssi);
+    TEST_ASSERT_EQUAL_INT8(7, stats.lastSnr);
+}
+
+// ==== CONCURRENT SNAPSHOTS ====
+
+static volatile int writerDone;
+
+static void* histogramWriter(void* arg) {
+    XBee* self = (XBee*)arg;
+    for (uint32_t i = 0; i < 200000; i++) {
+        XBEE_STATS_HIST(self, atRoundTrip, i & 1023);
+    }
+    writerDone = 1;
+    return NULL;
+}
+
+void test_stats_snapshots_taken_during_updates_are_consistent(void) {
+    pthread_t writer;
+    uint32_t snapshots = 0;
+    writerDone = 0;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&writer, NULL, histogramWriter, lr));
+
+    while (!writerDone || snapshots == 0) {
+        uint32_t total = 0;
+        snapshot();
+        for (int b = 0; b < XBEE_STATS_HIST_BUCKETS; b++) total += stats.atRoundTrip.buckets[b];
+        TEST_ASSERT_EQUAL_UINT32(stats.atRoundTrip.count, total);
+        TEST_ASSERT_EQUAL_UINT32(0, stats.seq & 1);
+        snapshots++;
+    }
+    pthread_join(writer, NULL);
+
+    snapshot();
+    TEST_ASSERT_EQUAL_UINT32(200000, stats.atRoundTrip.count);
+}
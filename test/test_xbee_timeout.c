@@ -0,0 +1,156 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee_timeout.h"
+#include "xbee_escape.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+#define MODULE_LATENCY_MS 20
+
+static XBeeTimeouts_t timeouts;
+static XBeeLR* lr;
+static bool moduleAlive;
+
+// Answers every AT query with a one-byte value after MODULE_LATENCY_MS, or not at all
+static void fakeModule(const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    const uint8_t value = 0x01;
+    if (moduleAlive) portVClockScheduleAtResponse(MODULE_LATENCY_MS, data, len, 0x00, &value, 1);
+}
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    xbeeTimeoutReset(&timeouts);
+
+    portVClockReset();
+    moduleAlive = true;
+    lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockSetWriteHook(fakeModule, NULL);
+}
+
+void tearDown(void) {
+    portVClockSetWriteHook(NULL, NULL);
+    free(lr);
+}
+
+// ==== ESTIMATOR ====
+
+void test_timeout_starts_at_class_defaults(void) {
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_REGISTER_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_REGISTER));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_APPLY_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_APPLY));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLASH_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_FLASH));
+}
+
+void test_timeout_first_sample_is_three_round_trips(void) {
+    // srtt = rtt, rttvar = rtt / 2, timeout = srtt + 4 * rttvar
+    xbeeTimeoutSample(&timeouts, AT_LATENCY_FLASH, 400);
+    TEST_ASSERT_EQUAL_UINT32(1200, xbeeTimeoutGet(&timeouts, AT_LATENCY_FLASH));
+
+    // Fast classes are held at the floor
+    xbeeTimeoutSample(&timeouts, AT_LATENCY_REGISTER, 5);
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLOOR_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_REGISTER));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_APPLY_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_APPLY));
+}
+
+void test_timeout_converges_on_steady_round_trips(void) {
+    for (int i = 0; i < 40; i++) {
+        xbeeTimeoutSample(&timeouts, AT_LATENCY_FLASH, 400);
+    }
+    // The deviation decays towards zero, leaving the round trip itself
+    uint32_t timeout = xbeeTimeoutGet(&timeouts, AT_LATENCY_FLASH);
+    TEST_ASSERT_GREATER_OR_EQUAL(400, timeout);
+    TEST_ASSERT_LESS_THAN(420, timeout);
+}
+
+void test_timeout_backoff_doubles_up_to_ceiling(void) {
+    xbeeTimeoutSample(&timeouts, AT_LATENCY_FLASH, 400);
+    xbeeTimeoutBackoff(&timeouts, AT_LATENCY_FLASH);
+    TEST_ASSERT_EQUAL_UINT32(2400, xbeeTimeoutGet(&timeouts, AT_LATENCY_FLASH));
+
+    for (int i = 0; i < 8; i++) {
+        xbeeTimeoutBackoff(&timeouts, AT_LATENCY_FLASH);
+    }
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_CEILING_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_FLASH));
+
+    // The next answer brings the estimate back
+    xbeeTimeoutSample(&timeouts, AT_LATENCY_FLASH, 400);
+    TEST_ASSERT_LESS_THAN(XBEE_AT_TIMEOUT_CEILING_MS, xbeeTimeoutGet(&timeouts, AT_LATENCY_FLASH));
+}
+
+void test_timeout_never_reset_falls_back_to_class_defaults(void) {
+    XBeeTimeouts_t zeroed;
+    memset(&zeroed, 0, sizeof(zeroed));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_REGISTER_MS, xbeeTimeoutGet(&zeroed, AT_LATENCY_REGISTER));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLASH_MS, xbeeTimeoutGet(&zeroed, AT_LATENCY_FLASH));
+
+    // Backoff builds on the default, not on the empty estimate
+    xbeeTimeoutBackoff(&zeroed, AT_LATENCY_REGISTER);
+    TEST_ASSERT_EQUAL_UINT32(2 * XBEE_AT_TIMEOUT_REGISTER_MS, xbeeTimeoutGet(&zeroed, AT_LATENCY_REGISTER));
+}
+
+void test_wire_time_scales_with_baud_rate_and_length(void) {
+    TEST_ASSERT_EQUAL_UINT32(2, xbeeWireTimeMs(9600, 1));
+    TEST_ASSERT_EQUAL_UINT32(27, xbeeWireTimeMs(9600, 25));
+    TEST_ASSERT_EQUAL_UINT32(3, xbeeWireTimeMs(115200, 25));
+    TEST_ASSERT_EQUAL_UINT32(xbeeWireTimeMs(9600, 25), xbeeWireTimeMs(0, 25));
+}
+
+// ==== XBEE INSTANCE ====
+
+void test_at_timeout_adds_wire_time(void) {
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_REGISTER_MS + 27, XBeeAtTimeout((XBee*)lr, AT_VR, 25));
+
+    XBeeInit((XBee*)lr, 115200, NULL);
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_REGISTER_MS + 3, XBeeAtTimeout((XBee*)lr, AT_VR, 25));
+}
+
+void test_at_timeout_before_init_uses_class_defaults(void) {
+    XBeeLR* fresh = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    TEST_ASSERT_NOT_NULL(fresh);
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_REGISTER_MS + xbeeWireTimeMs(9600, 25), XBeeAtTimeout((XBee*)fresh, AT_VR, 25));
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLASH_MS, XBeeAtTimeout((XBee*)fresh, AT_WR, 0));
+    free(fresh);
+}
+
+void test_at_timeout_learned_from_answers_cuts_dead_module_wait(void) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(XBeeAtGet((XBee*)lr, AT_PL, &value));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, value);
+    TEST_ASSERT_LESS_THAN(XBEE_AT_TIMEOUT_REGISTER_MS, XBeeAtTimeout((XBee*)lr, AT_PL, 0));
+
+    // A module that stopped answering is given up on well before the default timeout
+    moduleAlive = false;
+    uint32_t start = portVClockNow();
+    TEST_ASSERT_FALSE(XBeeAtGet((XBee*)lr, AT_PL, &value));
+    TEST_ASSERT_LESS_THAN(XBEE_AT_TIMEOUT_REGISTER_MS / 2, portVClockNow() - start);
+
+    // Other classes keep their own estimate
+    TEST_ASSERT_EQUAL_UINT32(XBEE_AT_TIMEOUT_FLASH_MS, XBeeAtTimeout((XBee*)lr, AT_WR, 0));
+}
+
+void test_frame_survives_mid_frame_pause_within_read_timeout(void) {
+    // AT response to VR with a one-byte value, split after the length
+    uint8_t frame[] = { XBEE_START_DELIMITER, 0x00, 0x06, XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x00, 0x01, 0x00 };
+    uint8_t sum = 0;
+    for (size_t i = 3; i < sizeof(frame) - 1; i++) sum += frame[i];
+    frame[sizeof(frame) - 1] = 0xFF - sum;
+    xbee_api_frame_t received;
+
+    // The default slack keeps the old inter-byte wait, so a driver that stalls mid-frame still delivers it
+    portVClockScheduleRx(0, frame, 3);
+    portVClockScheduleRx(UART_READ_TIMEOUT_MS / 2, &frame[3], sizeof(frame) - 3);
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &received));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_API_TYPE_AT_RESPONSE, received.type);
+}
@@ -0,0 +1,139 @@
+#include "unity.h"
+#include "port_vclock.h"
+#include "xbee_lr.h"
+#include "xbee_api_frames.h"
+#include "xbee_at_cmds.h"
+#include "xbee_trace.h"
+#include "xbee.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ==== TEST OBJECTS ====
+
+static const XBeeCTable vclockCTable = {0};
+
+static XBeeTraceRing_t ring;
+static XBeeTraceEvent_t events[XBEE_TRACE_RING_SIZE];
+
+// ==== TEST SETUP ====
+
+void setUp(void) {
+    portVClockReset();
+    XBeeTraceRingReset(&ring);
+}
+
+void tearDown(void) {}
+
+// ==== RING ====
+
+void test_trace_ring_snapshot_returns_events_oldest_first(void) {
+    uint32_t lost = 99;
+    XBeeTraceRingRecord(&ring, 100, 5, XBEE_TRACE_EVENT_RX_FRAME, 0x88);
+    XBeeTraceRingRecord(&ring, 200, 7, XBEE_TRACE_EVENT_TX_FRAME, 0x08);
+
+    TEST_ASSERT_EQUAL_size_t(2, XBeeTraceRingSnapshot(&ring, events, XBEE_TRACE_RING_SIZE, &lost));
+    TEST_ASSERT_EQUAL_UINT32(0, lost);
+    TEST_ASSERT_EQUAL_UINT32(100, events[0].tsUs);
+    TEST_ASSERT_EQUAL_UINT32(5, events[0].durUs);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_EVENT_RX_FRAME, events[0].event);
+    TEST_ASSERT_EQUAL_HEX16(0x08, events[1].arg);
+}
+
+void test_trace_ring_overwrites_oldest_when_full(void) {
+    uint32_t lost;
+    for (uint32_t i = 0; i < XBEE_TRACE_RING_SIZE + 10; i++) {
+        XBeeTraceRingRecord(&ring, i, 0, XBEE_TRACE_EVENT_PROCESS, 0);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(XBEE_TRACE_RING_SIZE - 1, XBeeTraceRingSnapshot(&ring, events, XBEE_TRACE_RING_SIZE, &lost));
+    TEST_ASSERT_EQUAL_UINT32(11, lost);
+    TEST_ASSERT_EQUAL_UINT32(11, events[0].tsUs);
+    TEST_ASSERT_EQUAL_UINT32(XBEE_TRACE_RING_SIZE + 9, events[XBEE_TRACE_RING_SIZE - 2].tsUs);
+}
+
+void test_trace_ring_snapshot_keeps_newest_when_output_is_small(void) {
+    uint32_t lost;
+    for (uint32_t i = 0; i < 5; i++) {
+        XBeeTraceRingRecord(&ring, i, 0, XBEE_TRACE_EVENT_PROCESS, 0);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(2, XBeeTraceRingSnapshot(&ring, events, 2, &lost));
+    TEST_ASSERT_EQUAL_UINT32(3, lost);
+    TEST_ASSERT_EQUAL_UINT32(3, events[0].tsUs);
+    TEST_ASSERT_EQUAL_UINT32(4, events[1].tsUs);
+}
+
+void test_trace_ring_dump_layout(void) {
+    uint8_t buf[XBEE_TRACE_DUMP_HEADER_SIZE + 2 * XBEE_TRACE_DUMP_EVENT_SIZE];
+    const uint8_t expectedEvent[] = { 0x78, 0x56, 0x34, 0x12, 0x10, 0x00, 0x00, 0x00, 0x02, 0x00, 0x08, 0x01 };
+    ring.instanceId = 0x0102;
+    XBeeTraceRingRecord(&ring, 1, 1, XBEE_TRACE_EVENT_PROCESS, 0);
+    XBeeTraceRingRecord(&ring, 0x12345678, 0x10, XBEE_TRACE_EVENT_TX_FRAME, 0x0108);
+
+    TEST_ASSERT_EQUAL_size_t(0, XBeeTraceRingDump(&ring, buf, XBEE_TRACE_DUMP_HEADER_SIZE - 1));
+    // Room for one event: the oldest is counted as lost
+    TEST_ASSERT_EQUAL_size_t(XBEE_TRACE_DUMP_HEADER_SIZE + XBEE_TRACE_DUMP_EVENT_SIZE,
+                             XBeeTraceRingDump(&ring, buf, XBEE_TRACE_DUMP_HEADER_SIZE + XBEE_TRACE_DUMP_EVENT_SIZE));
+    TEST_ASSERT_EQUAL_MEMORY(XBEE_TRACE_DUMP_MAGIC, buf, 4);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_DUMP_VERSION, buf[4]);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_DUMP_EVENT_SIZE, buf[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, buf[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, buf[7]);
+    TEST_ASSERT_EQUAL_UINT8(2, buf[8]);
+    TEST_ASSERT_EQUAL_UINT8(1, buf[12]);
+    TEST_ASSERT_EQUAL_UINT8(1, buf[16]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedEvent, &buf[XBEE_TRACE_DUMP_HEADER_SIZE], sizeof(expectedEvent));
+}
+
+// ==== LIBRARY TRACE POINTS ====
+// project.yml builds the tests with XBEE_TRACE_ENABLED=1
+
+static size_t traceOf(XBee* self) {
+    return XBeeTraceRingSnapshot(&self->trace, events, XBEE_TRACE_RING_SIZE, NULL);
+}
+
+void test_trace_records_rx_frame_from_start_delimiter(void) {
+    const uint8_t modemStatus[] = { XBEE_API_TYPE_MODEM_STATUS, 0x00 };
+    xbee_api_frame_t frame;
+    XBeeLR* lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    portVClockScheduleFrame(300, modemStatus, sizeof(modemStatus));
+
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_SUCCESS, apiReceiveApiFrame((XBee*)lr, &frame));
+    TEST_ASSERT_EQUAL_INT(API_RECEIVE_ERROR_TIMEOUT_START_DELIMITER, apiReceiveApiFrame((XBee*)lr, &frame));
+
+    // The idle wait before the frame and the timed out call are not traced
+    TEST_ASSERT_EQUAL_size_t(1, traceOf((XBee*)lr));
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_EVENT_RX_FRAME, events[0].event);
+    TEST_ASSERT_UINT32_WITHIN(1000, 300500, events[0].tsUs);
+    TEST_ASSERT_EQUAL_HEX16(XBEE_API_TYPE_MODEM_STATUS, events[0].arg);
+    free(lr);
+}
+
+void test_trace_records_tx_frames_and_at_wait(void) {
+    const uint8_t resp[] = { XBEE_API_TYPE_AT_RESPONSE, 0x01, 'V', 'R', 0x00, 0x10, 0x10 };
+    uint8_t value[4];
+    uint8_t valueLen = 0;
+    XBeeLR* lr = XBeeLRCreate(&vclockCTable, &portVClockHTable);
+    XBeeInit((XBee*)lr, 9600, NULL);
+    XBeeTraceConfigure((XBee*)lr, 7, NULL);
+    portVClockScheduleFrame(40, resp, sizeof(resp));
+
+    TEST_ASSERT_EQUAL_INT(API_SEND_SUCCESS, apiSendAtCommandAndGetResponse((XBee*)lr, AT_VR, NULL, 0,
+                          value, &valueLen, 5000, sizeof(value)));
+
+    size_t n = traceOf((XBee*)lr);
+    TEST_ASSERT_EQUAL_size_t(3, n);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_EVENT_TX_FRAME, events[0].event);
+    TEST_ASSERT_EQUAL_HEX16(XBEE_API_TYPE_AT_COMMAND, events[0].arg);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_EVENT_RX_FRAME, events[1].event);
+    TEST_ASSERT_EQUAL_UINT8(XBEE_TRACE_EVENT_WAIT_AT, events[2].event);
+    TEST_ASSERT_EQUAL_UINT16(AT_VR, events[2].arg);
+    TEST_ASSERT_EQUAL_UINT32(0, events[2].tsUs);
+    TEST_ASSERT_GREATER_OR_EQUAL(40000, events[2].durUs);
+
+    uint8_t buf[64];
+    TEST_ASSERT_TRUE(XBeeTraceDump((XBee*)lr, buf, sizeof(buf)) > XBEE_TRACE_DUMP_HEADER_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(7, buf[6]);
+    free(lr);
+}
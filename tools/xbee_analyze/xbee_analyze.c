@@ -0,0 +1,434 @@
+/**
+ * @file xbee_analyze.c
+ * @brief Offline analyzer for UART captures written by the port_capture shim.
+ *
+ * Usage example:
+ *   ./build/xbee_analyze field.xbcap
+ *   ./build/xbee_analyze --frames --json report.json field.xbcap
+ *
+ * The TX and RX byte streams are reassembled into API frames (API mode 1)
+ * and summarized: frame counts and sizes per type, inter-arrival times,
+ * checksum and framing errors, and AT command response latencies matched
+ * on frame ID.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "port_capture.h"
+#include "xbee_api_frames.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#define ANALYZE_MAX_FRAME 1024
+#define ANALYZE_MAX_AT_CMDS 128
+#define XBEE_API_TYPE_AT_COMMAND_QUEUE 0x09    ///< Queued AT command; not used by the library but seen in captures
+
+typedef enum {
+    PARSE_DELIMITER,
+    PARSE_LENGTH_MSB,
+    PARSE_LENGTH_LSB,
+    PARSE_DATA,
+    PARSE_CHECKSUM
+} ParseState_t;
+
+/**
+ * @brief Growable array of millisecond samples used for percentiles.
+ */
+typedef struct {
+    uint32_t* values;
+    size_t count;
+    size_t capacity;
+} Samples_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t bytes;
+    uint16_t minLength;
+    uint16_t maxLength;
+} TypeStats_t;
+
+/**
+ * @brief Per-direction frame reassembly state and statistics.
+ */
+typedef struct {
+    const char* name;
+    ParseState_t state;
+    uint16_t length;
+    uint16_t received;
+    uint8_t sum;
+    uint8_t data[ANALYZE_MAX_FRAME];
+    uint32_t frameStartMs;
+
+    uint64_t bytes;
+    uint32_t frames;
+    uint32_t checksumErrors;
+    uint32_t oversizeErrors;
+    uint32_t discardedBytes;
+    bool haveLastFrame;
+    uint32_t lastFrameMs;
+    Samples_t interArrival;
+    TypeStats_t types[256];
+} Stream_t;
+
+typedef struct {
+    char cmd[3];
+    uint32_t errors;
+    Samples_t latency;
+} AtStats_t;
+
+typedef struct {
+    bool pending;
+    char cmd[3];
+    uint32_t sentMs;
+} PendingAt_t;
+
+static Stream_t streams[2] = { { .name = "tx" }, { .name = "rx" } };
+static AtStats_t atStats[ANALYZE_MAX_AT_CMDS];
+static size_t atStatsCount;
+static PendingAt_t pendingAt[256];
+static uint32_t unmatchedAtResponses;
+static bool dumpFrames;
+
+static void samplesAdd(Samples_t* s, uint32_t value) {
+    if (s->count == s->capacity) {
+        size_t capacity = s->capacity ? s->capacity * 2 : 64;
+        uint32_t* grown = (uint32_t*)realloc(s->values, capacity * sizeof(uint32_t));
+        if (!grown) return;
+        s->values = grown;
+        s->capacity = capacity;
+    }
+    s->values[s->count++] = value;
+}
+
+static int compareU32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the nearest-rank percentile; the samples must be sorted.
+ */
+static uint32_t samplesPercentile(const Samples_t* s, double pct) {
+    if (s->count == 0) return 0;
+    size_t rank = (size_t)(pct / 100.0 * (double)(s->count - 1) + 0.5);
+    return s->values[rank];
+}
+
+static double samplesMean(const Samples_t* s) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < s->count; i++) sum += s->values[i];
+    return s->count ? (double)sum / (double)s->count : 0.0;
+}
+
+static const char* frameTypeName(uint8_t type) {
+    switch (type) {
+        case XBEE_API_TYPE_AT_COMMAND:                      return "AT Command";
+        case XBEE_API_TYPE_AT_COMMAND_QUEUE:                return "AT Command Queue";
+        case XBEE_API_TYPE_TX_REQUEST:                      return "TX Request";
+        case XBEE_API_TYPE_LR_JOIN_REQUEST:                 return "LR Join Request";
+        case XBEE_API_TYPE_REMOTE_AT_COMMAND:               return "Remote AT Command";
+        case XBEE_API_TYPE_3RF_CREATE_SOURCE_ROUTE:         return "Create Source Route";
+        case XBEE_API_TYPE_CELLULAR_TX_IPV4:                return "TX IPv4";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_CREATE:          return "Socket Create";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_OPTION:          return "Socket Option";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT:         return "Socket Connect";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE:           return "Socket Close";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_SEND:            return "Socket Send";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_SEND_TO:         return "Socket Send To";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_BIND:            return "Socket Bind";
+        case XBEE_API_TYPE_LR_TX_REQUEST:                   return "LR TX Request";
+        case XBEE_API_TYPE_AT_RESPONSE:                     return "AT Response";
+        case XBEE_API_TYPE_TX_STATUS:                       return "TX Status";
+        case XBEE_API_TYPE_MODEM_STATUS:                    return "Modem Status";
+        case XBEE_API_TYPE_IO_SAMPLE_RX_INDICATOR:          return "IO Sample Indicator";
+        case XBEE_API_TYPE_3RF_RX_PACKET:                   return "RX Packet";
+        case XBEE_API_TYPE_3RF_RX_EXPLICIT_PACKET:          return "RX Explicit Packet";
+        case XBEE_API_TYPE_3RF_EXTENDED_TX_STATUS:          return "Extended TX Status";
+        case XBEE_API_TYPE_3RF_ROUTE_RECORD:                return "Route Record";
+        case XBEE_API_TYPE_IO_DATA_SAMPLE_RX:               return "IO Data Sample";
+        case XBEE_API_TYPE_REMOTE_AT_RESPONSE:              return "Remote AT Response";
+        case XBEE_API_TYPE_CELLULAR_RX_IPV4:                return "RX IPv4";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_CREATE_RESPONSE: return "Socket Create Response";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_OPTION_RESPONSE: return "Socket Option Response";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_CONNECT_RESPONSE: return "Socket Connect Response";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_CLOSE_RESPONSE:  return "Socket Close Response";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_BIND_RESPONSE:   return "Socket Bind Response";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_RX:              return "Socket RX";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_RX_FROM:         return "Socket RX From";
+        case XBEE_API_TYPE_CELLULAR_SOCKET_STATUS:          return "Socket Status";
+        case XBEE_API_TYPE_LR_RX_PACKET:                    return "LR RX Packet";
+        case XBEE_API_TYPE_LR_EXPLICIT_RX_PACKET:           return "LR Explicit RX Packet";
+        case XBEE_API_TYPE_LR_EXPLICIT_TX_STATUS:           return "LR Explicit TX Status";
+        default:                                            return "Unknown";
+    }
+}
+
+static AtStats_t* atStatsFor(const char* cmd) {
+    for (size_t i = 0; i < atStatsCount; i++) {
+        if (memcmp(atStats[i].cmd, cmd, 2) == 0) return &atStats[i];
+    }
+    if (atStatsCount == ANALYZE_MAX_AT_CMDS) return NULL;
+    AtStats_t* s = &atStats[atStatsCount++];
+    memcpy(s->cmd, cmd, 2);
+    s->cmd[2] = '\0';
+    return s;
+}
+
+/**
+ * @brief Accounts for one complete, checksum-valid frame.
+ */
+static void handleFrame(int dir, Stream_t* st, const uint8_t* data, uint16_t length, uint32_t ts) {
+    uint8_t type = data[0];
+    TypeStats_t* t = &st->types[type];
+
+    st->frames++;
+    if (t->count == 0 || length < t->minLength) t->minLength = length;
+    if (length > t->maxLength) t->maxLength = length;
+    t->count++;
+    t->bytes += length;
+
+    if (st->haveLastFrame) samplesAdd(&st->interArrival, ts - st->lastFrameMs);
+    st->haveLastFrame = true;
+    st->lastFrameMs = ts;
+
+    if (dumpFrames) {
+        printf("%10u ms  %s  0x%02X %-24s len=%-4u", ts, st->name, type, frameTypeName(type), length);
+        for (uint16_t i = 1; i < length && i < 17; i++) printf(" %02X", data[i]);
+        printf("%s\n", length > 17 ? " ..." : "");
+    }
+
+    if (dir == PORT_CAPTURE_DIR_TX && (type == XBEE_API_TYPE_AT_COMMAND || type == XBEE_API_TYPE_AT_COMMAND_QUEUE) &&
+        length >= 4 && data[1] != 0) {
+        PendingAt_t* p = &pendingAt[data[1]];
+        p->pending = true;
+        p->cmd[0] = (char)data[2];
+        p->cmd[1] = (char)data[3];
+        p->sentMs = ts;
+    } else if (dir == PORT_CAPTURE_DIR_RX && type == XBEE_API_TYPE_AT_RESPONSE && length >= 5) {
+        PendingAt_t* p = &pendingAt[data[1]];
+        if (!p->pending || p->cmd[0] != (char)data[2] || p->cmd[1] != (char)data[3]) {
+            unmatchedAtResponses++;
+            return;
+        }
+        p->pending = false;
+        AtStats_t* s = atStatsFor(p->cmd);
+        if (!s) return;
+        samplesAdd(&s->latency, ts - p->sentMs);
+        if (data[4] != 0) s->errors++;
+    }
+}
+
+/**
+ * @brief Feeds captured bytes through the frame reassembly state machine.
+ */
+static void feedStream(int dir, const uint8_t* bytes, uint16_t len, uint32_t ts) {
+    Stream_t* st = &streams[dir];
+    st->bytes += len;
+
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t b = bytes[i];
+        switch (st->state) {
+            case PARSE_DELIMITER:
+                if (b == 0x7E) {
+                    st->state = PARSE_LENGTH_MSB;
+                    st->frameStartMs = ts;
+                } else {
+                    st->discardedBytes++;
+                }
+                break;
+            case PARSE_LENGTH_MSB:
+                st->length = (uint16_t)(b << 8);
+                st->state = PARSE_LENGTH_LSB;
+                break;
+            case PARSE_LENGTH_LSB:
+                st->length |= b;
+                st->received = 0;
+                st->sum = 0;
+                if (st->length == 0 || st->length > ANALYZE_MAX_FRAME) {
+                    st->oversizeErrors++;
+                    st->state = PARSE_DELIMITER;
+                } else {
+                    st->state = PARSE_DATA;
+                }
+                break;
+            case PARSE_DATA:
+                st->data[st->received++] = b;
+                st->sum += b;
+                if (st->received == st->length) st->state = PARSE_CHECKSUM;
+                break;
+            case PARSE_CHECKSUM:
+                if ((uint8_t)(st->sum + b) == 0xFF) {
+                    handleFrame(dir, st, st->data, st->length, st->frameStartMs);
+                } else {
+                    st->checksumErrors++;
+                    if (dumpFrames) {
+                        printf("%10u ms  %s  checksum error (type 0x%02X, len %u)\n",
+                               st->frameStartMs, st->name, st->data[0], st->length);
+                    }
+                }
+                st->state = PARSE_DELIMITER;
+                break;
+        }
+    }
+}
+
+static void printReport(const char* path, uint32_t durationMs) {
+    printf("Capture: %s (%.3f s)\n\n", path, durationMs / 1000.0);
+
+    for (int dir = 0; dir < 2; dir++) {
+        Stream_t* st = &streams[dir];
+        printf("%s: %llu bytes, %u frames, %u checksum errors, %u length errors, %u discarded bytes\n",
+               dir == PORT_CAPTURE_DIR_TX ? "TX (host -> module)" : "RX (module -> host)",
+               (unsigned long long)st->bytes, st->frames, st->checksumErrors, st->oversizeErrors,
+               st->discardedBytes);
+        if (st->interArrival.count > 0) {
+            printf("  inter-arrival ms: mean %.1f  p50 %u  p99 %u  max %u\n",
+                   samplesMean(&st->interArrival), samplesPercentile(&st->interArrival, 50),
+                   samplesPercentile(&st->interArrival, 99),
+                   st->interArrival.values[st->interArrival.count - 1]);
+        }
+        printf("  %-6s %-26s %8s %8s %8s %8s\n", "type", "name", "count", "min", "avg", "max");
+        for (int type = 0; type < 256; type++) {
+            TypeStats_t* t = &st->types[type];
+            if (t->count == 0) continue;
+            printf("  0x%02X   %-26s %8u %8u %8.1f %8u\n", type, frameTypeName((uint8_t)type), t->count,
+                   t->minLength, (double)t->bytes / t->count, t->maxLength);
+        }
+        printf("\n");
+    }
+
+    printf("AT command latency (ms), %u unmatched responses\n", unmatchedAtResponses);
+    printf("  %-4s %8s %8s %8s %8s %8s %8s\n", "cmd", "count", "errors", "mean", "p50", "p99", "max");
+    for (size_t i = 0; i < atStatsCount; i++) {
+        AtStats_t* s = &atStats[i];
+        if (s->latency.count == 0) continue;
+        printf("  %-4s %8zu %8u %8.1f %8u %8u %8u\n", s->cmd, s->latency.count, s->errors,
+               samplesMean(&s->latency), samplesPercentile(&s->latency, 50),
+               samplesPercentile(&s->latency, 99), s->latency.values[s->latency.count - 1]);
+    }
+}
+
+static bool writeJson(const char* out, const char* path, uint32_t durationMs) {
+    FILE* f = fopen(out, "w");
+    if (!f) return false;
+
+    fprintf(f, "{\n  \"capture\": \"%s\",\n  \"duration_ms\": %u,\n", path, durationMs);
+    for (int dir = 0; dir < 2; dir++) {
+        Stream_t* st = &streams[dir];
+        bool first = true;
+        fprintf(f, "  \"%s\": {\n    \"bytes\": %llu, \"frames\": %u, \"checksum_errors\": %u, "
+                   "\"length_errors\": %u, \"discarded_bytes\": %u,\n",
+                st->name, (unsigned long long)st->bytes, st->frames, st->checksumErrors,
+                st->oversizeErrors, st->discardedBytes);
+        fprintf(f, "    \"inter_arrival_ms\": {\"p50\": %u, \"p99\": %u},\n    \"types\": {",
+                samplesPercentile(&st->interArrival, 50), samplesPercentile(&st->interArrival, 99));
+        for (int type = 0; type < 256; type++) {
+            TypeStats_t* t = &st->types[type];
+            if (t->count == 0) continue;
+            fprintf(f, "%s\n      \"0x%02X\": {\"count\": %u, \"min\": %u, \"max\": %u, \"bytes\": %llu}",
+                    first ? "" : ",", type, t->count, t->minLength, t->maxLength, (unsigned long long)t->bytes);
+            first = false;
+        }
+        fprintf(f, "\n    }\n  },\n");
+    }
+    fprintf(f, "  \"at_latency_ms\": {");
+    for (size_t i = 0; i < atStatsCount; i++) {
+        AtStats_t* s = &atStats[i];
+        fprintf(f, "%s\n    \"%s\": {\"count\": %zu, \"errors\": %u, \"p50\": %u, \"p99\": %u}",
+                i ? "," : "", s->cmd, s->latency.count, s->errors, samplesPercentile(&s->latency, 50),
+                samplesPercentile(&s->latency, 99));
+    }
+    fprintf(f, "\n  },\n  \"unmatched_at_responses\": %u\n}\n", unmatchedAtResponses);
+    fclose(f);
+    return true;
+}
+
+static void usage(const char* prog) {
+    printf("Usage: %s [options] CAPTURE\n"
+           "  --frames               Print every decoded frame\n"
+           "  --json PATH            Also write the summary as JSON\n", prog);
+}
+
+int main(int argc, char** argv) {
+    static const struct option options[] = {
+        { "frames", no_argument, NULL, 'f' },
+        { "json", required_argument, NULL, 'j' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char* jsonPath = NULL;
+    PortCaptureReader_t reader;
+    PortCaptureRecord_t record;
+    uint32_t durationMs = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "fj:h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'f': dumpFrames = true; break;
+            case 'j': jsonPath = optarg; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!portCaptureReaderOpen(&reader, argv[optind])) {
+        fprintf(stderr, "Cannot read capture %s\n", argv[optind]);
+        return 1;
+    }
+    while (portCaptureReaderNext(&reader, &record)) {
+        if (record.dir > PORT_CAPTURE_DIR_RX) continue;
+        feedStream(record.dir, record.data, record.length, record.timestampMs);
+        durationMs = record.timestampMs;
+    }
+    if (reader.pos != reader.size) {
+        fprintf(stderr, "Warning: capture truncated at offset %zu\n", reader.pos);
+    }
+    portCaptureReaderClose(&reader);
+
+    for (int dir = 0; dir < 2; dir++) {
+        Samples_t* s = &streams[dir].interArrival;
+        qsort(s->values, s->count, sizeof(uint32_t), compareU32);
+    }
+    for (size_t i = 0; i < atStatsCount; i++) {
+        qsort(atStats[i].latency.values, atStats[i].latency.count, sizeof(uint32_t), compareU32);
+    }
+
+    if (dumpFrames) printf("\n");
+    printReport(argv[optind], durationMs);
+    if (jsonPath && !writeJson(jsonPath, argv[optind], durationMs)) {
+        fprintf(stderr, "Cannot write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,818 @@
+/**
+ * @file xbee_sim.c
+ * @brief Implementation of the host-side XBee module simulator engine.
+ *
+ * This file contains the frame parser, the simulated AT register file and the
+ * LR and Cellular personalities. Every response is placed on a time ordered
+ * schedule and then released to the host byte by byte at the configured baud
+ * rate, so round trips measured against the simulator include realistic UART
+ * serialization on top of the configured module and radio latencies.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_sim.h"
+#include <string.h>
+
+// Frame types understood or produced by the simulator
+#define SIM_API_AT_COMMAND           0x08
+#define SIM_API_LR_JOIN_REQUEST      0x14
+#define SIM_API_CELL_TX_IPV4         0x20
+#define SIM_API_SOCKET_CREATE        0x40
+#define SIM_API_SOCKET_OPTION        0x41
+#define SIM_API_SOCKET_CONNECT       0x42
+#define SIM_API_SOCKET_CLOSE         0x43
+#define SIM_API_SOCKET_SEND          0x44
+#define SIM_API_SOCKET_SEND_TO       0x45
+#define SIM_API_SOCKET_BIND          0x46
+#define SIM_API_LR_TX_REQUEST        0x50
+#define SIM_API_AT_RESPONSE          0x88
+#define SIM_API_TX_STATUS            0x89
+#define SIM_API_MODEM_STATUS         0x8A
+#define SIM_API_CELL_RX_IPV4         0xB0
+#define SIM_API_SOCKET_CREATE_RESP   0xC0
+#define SIM_API_SOCKET_OPTION_RESP   0xC1
+#define SIM_API_SOCKET_CONNECT_RESP  0xC2
+#define SIM_API_SOCKET_CLOSE_RESP    0xC3
+#define SIM_API_SOCKET_BIND_RESP     0xC6
+#define SIM_API_SOCKET_RX            0xCD
+#define SIM_API_SOCKET_RX_FROM       0xCE
+#define SIM_API_SOCKET_STATUS        0xCF
+#define SIM_API_LR_RX_PACKET         0xD0
+#define SIM_API_LR_EXPLICIT_RX       0xD1
+#define SIM_API_LR_EXPLICIT_TX_STAT  0xD2
+
+// Modem status codes
+#define SIM_MODEM_HW_RESET           0x00
+#define SIM_MODEM_JOINED             0x02
+
+// Status codes
+#define SIM_AT_STATUS_OK             0x00
+#define SIM_AT_STATUS_ERROR          0x01
+#define SIM_AT_STATUS_INVALID_CMD    0x02
+#define SIM_TX_SUCCESS               0x00
+#define SIM_TX_NO_ACK                0x01
+#define SIM_TX_NOT_JOINED            0x22
+#define SIM_TX_INVALID_SOCKET        0x20
+#define SIM_SOCKET_STATUS_CONNECTED  0x00
+#define SIM_SOCKET_STATUS_FAILED     0x02
+#define SIM_SOCKET_STATUS_CLOSED     0x0C
+#define SIM_SOCKET_RESULT_ERROR      0x01
+
+#define SIM_RESET_DELAY_MS 100
+
+enum {
+    SIM_RX_WAIT_DELIMITER = 0,
+    SIM_RX_LENGTH_MSB,
+    SIM_RX_LENGTH_LSB,
+    SIM_RX_DATA,
+    SIM_RX_CHECKSUM
+};
+
+/**
+ * @brief xorshift32 step used for jitter and loss decisions.
+ */
+static uint32_t simRandom(XBeeSim* sim) {
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+/**
+ * @brief Returns true when the loss model drops the current over-the-air exchange.
+ */
+static bool simLost(XBeeSim* sim) {
+    if (sim->config.lossPercent == 0) return false;
+    if ((simRandom(sim) % 100) < sim->config.lossPercent) {
+        sim->stats.framesLost++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Converts a latency in milliseconds plus configured jitter to a due time.
+ */
+static uint64_t simDue(XBeeSim* sim, uint64_t nowUs, uint32_t latencyMs) {
+    uint64_t delayUs = (uint64_t)latencyMs * 1000;
+    if (sim->config.jitterMs) {
+        delayUs += simRandom(sim) % ((uint64_t)sim->config.jitterMs * 1000 + 1);
+    }
+    return nowUs + delayUs;
+}
+
+/**
+ * @brief Inserts a frame into the time ordered schedule.
+ *
+ * Frames with equal due times keep their submission order, so a response that
+ * the firmware always sends before a status frame keeps that order here too.
+ *
+ * @return bool False if the schedule is full or the frame is too large.
+ */
+static bool simSchedule(XBeeSim* sim, uint64_t dueUs, xbee_sim_effect_t effect,
+                        const uint8_t* data, uint16_t len) {
+    if (sim->pendingCount >= XBEE_SIM_MAX_PENDING || len > XBEE_SIM_MAX_FRAME_DATA_SIZE || len == 0) {
+        sim->stats.overflows++;
+        return false;
+    }
+
+    uint8_t pos = sim->pendingCount;
+    while (pos > 0 && sim->pending[pos - 1].dueUs > dueUs) {
+        sim->pending[pos] = sim->pending[pos - 1];
+        pos--;
+    }
+
+    XBeeSimPending_t* p = &sim->pending[pos];
+    p->dueUs = dueUs;
+    p->effect = effect;
+    p->length = len;
+    memcpy(p->data, data, len);
+    sim->pendingCount++;
+    return true;
+}
+
+/**
+ * @brief Looks up an AT parameter in the register file.
+ */
+static XBeeSimParam_t* simFindParam(XBeeSim* sim, const char* cmd) {
+    for (uint8_t i = 0; i < sim->paramCount; i++) {
+        if (sim->params[i].cmd[0] == cmd[0] && sim->params[i].cmd[1] == cmd[1]) {
+            return &sim->params[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Creates or updates an AT parameter in the register file.
+ *
+ * @param[in] sim Pointer to the simulator instance.
+ * @param[in] cmd Two character AT command.
+ * @param[in] value Raw parameter value as it appears in API frames.
+ * @param[in] len Length of the value in bytes.
+ *
+ * @return bool True if the value was stored.
+ */
+bool XBeeSimSetParam(XBeeSim* sim, const char* cmd, const uint8_t* value, uint8_t len) {
+    if (len > XBEE_SIM_MAX_PARAM_SIZE) return false;
+
+    XBeeSimParam_t* p = simFindParam(sim, cmd);
+    if (!p) {
+        if (sim->paramCount >= XBEE_SIM_MAX_PARAMS) return false;
+        p = &sim->params[sim->paramCount++];
+        p->cmd[0] = cmd[0];
+        p->cmd[1] = cmd[1];
+    }
+    p->length = len;
+    if (len) memcpy(p->value, value, len);
+    return true;
+}
+
+/**
+ * @brief Reads an AT parameter from the register file.
+ *
+ * @return const XBeeSimParam_t* The parameter, or NULL if the module does not know it.
+ */
+const XBeeSimParam_t* XBeeSimGetParam(const XBeeSim* sim, const char* cmd) {
+    return simFindParam((XBeeSim*)sim, cmd);
+}
+
+static void simSetParamU8(XBeeSim* sim, const char* cmd, uint8_t value) {
+    XBeeSimSetParam(sim, cmd, &value, 1);
+}
+
+static void simSetParamU32(XBeeSim* sim, const char* cmd, uint32_t value) {
+    uint8_t be[4] = { value >> 24, value >> 16, value >> 8, value };
+    XBeeSimSetParam(sim, cmd, be, 4);
+}
+
+/**
+ * @brief Loads factory defaults for the configured personality.
+ */
+static void simLoadDefaults(XBeeSim* sim) {
+    uint32_t serialLow = 0x40A0B000u | (sim->config.seed & 0xFFF);
+
+    sim->paramCount = 0;
+    simSetParamU8(sim, "AP", 1);
+    simSetParamU8(sim, "AO", 0);
+    simSetParamU8(sim, "BD", 3);
+    simSetParamU8(sim, "DB", 0x28);
+    simSetParamU32(sim, "SH", 0x0013A200);
+    simSetParamU32(sim, "SL", serialLow);
+    XBeeSimSetParam(sim, "HV", (const uint8_t[]){0x4A, 0x40}, 2);
+
+    if (sim->config.mode == XBEE_SIM_MODE_LR) {
+        const uint8_t devEui[8] = { 0x00, 0x13, 0xA2, 0x00,
+                                    serialLow >> 24, serialLow >> 16, serialLow >> 8, serialLow };
+        simSetParamU32(sim, "VR", 0x00001010);
+        XBeeSimSetParam(sim, "DE", devEui, 8);
+        simSetParamU8(sim, "JS", 0);
+        simSetParamU8(sim, "LC", 'A');
+        simSetParamU8(sim, "LR", 0);
+        simSetParamU8(sim, "AD", 1);
+        simSetParamU8(sim, "DR", 0);
+        XBeeSimSetParam(sim, "LV", (const uint8_t*)"1.0.4", 5);
+    } else {
+        simSetParamU32(sim, "VR", 0x00011B18);
+        simSetParamU8(sim, "AI", 0x23);     // Connecting to the Internet
+        simSetParamU32(sim, "MY", 0);
+        XBeeSimSetParam(sim, "AN", NULL, 0);
+        simSetParamU8(sim, "CP", 0);
+    }
+}
+
+/**
+ * @brief Schedules the delayed join (LR) or attach (Cellular) completion.
+ */
+static void simScheduleJoin(XBeeSim* sim, uint64_t nowUs) {
+    const uint8_t status[2] = { SIM_API_MODEM_STATUS, SIM_MODEM_JOINED };
+    simSchedule(sim, simDue(sim, nowUs, sim->config.joinDelayMs), XBEE_SIM_EFFECT_JOINED, status, sizeof(status));
+}
+
+/**
+ * @brief Initializes a simulator instance.
+ *
+ * The cellular personality starts attaching immediately, like a module that
+ * has just been powered up with a SIM inserted. The LR personality waits for
+ * a join request frame.
+ *
+ * @param[in] sim Pointer to the simulator instance.
+ * @param[in] config Behaviour configuration, copied into the instance.
+ * @param[in] nowUs Current monotonic time in microseconds.
+ */
+void XBeeSimInit(XBeeSim* sim, const XBeeSimConfig_t* config, uint64_t nowUs) {
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->rng = config->seed ? config->seed : 0x2545F491u;
+    XBeeSimReset(sim, nowUs);
+}
+
+/**
+ * @brief Emulates a module power cycle.
+ *
+ * Clears network, socket and scheduling state, restores factory defaults and
+ * emits the hardware reset modem status once the module is back up.
+ *
+ * @param[in] sim Pointer to the simulator instance.
+ * @param[in] nowUs Current monotonic time in microseconds.
+ */
+void XBeeSimReset(XBeeSim* sim, uint64_t nowUs) {
+    sim->rxState = SIM_RX_WAIT_DELIMITER;
+    sim->joined = false;
+    sim->pendingCount = 0;
+    memset(sim->sockets, 0, sizeof(sim->sockets));
+    simLoadDefaults(sim);
+    sim->nextDownlinkUs = sim->config.rxIntervalMs ? nowUs + (uint64_t)sim->config.rxIntervalMs * 1000 : 0;
+
+    if (sim->config.mode == XBEE_SIM_MODE_CELLULAR) {
+        simScheduleJoin(sim, nowUs);
+    }
+}
+
+/**
+ * @brief Schedules an AT command response frame (0x88).
+ */
+static void simAtResponse(XBeeSim* sim, uint64_t nowUs, uint8_t frameId, const uint8_t* cmd,
+                          uint8_t status, const uint8_t* value, uint8_t len) {
+    uint8_t data[5 + XBEE_SIM_MAX_PARAM_SIZE];
+    data[0] = SIM_API_AT_RESPONSE;
+    data[1] = frameId;
+    data[2] = cmd[0];
+    data[3] = cmd[1];
+    data[4] = status;
+    if (len) memcpy(&data[5], value, len);
+
+    // Frame ID 0 asks the module not to respond
+    if (frameId != 0) {
+        simSchedule(sim, simDue(sim, nowUs, sim->config.latencyMs), XBEE_SIM_EFFECT_NONE, data, 5 + len);
+    }
+}
+
+/**
+ * @brief Handles a local AT command frame (0x08).
+ */
+static void simHandleAtCommand(XBeeSim* sim, const uint8_t* data, uint16_t len, uint64_t nowUs) {
+    if (len < 4) return;
+
+    uint8_t frameId = data[1];
+    const uint8_t* cmd = &data[2];
+    const uint8_t* param = &data[4];
+    uint16_t paramLen = len - 4;
+    char name[2] = { (char)cmd[0], (char)cmd[1] };
+
+    // Execution commands
+    if (!memcmp(name, "WR", 2) || !memcmp(name, "AC", 2) || !memcmp(name, "CN", 2) ||
+        !memcmp(name, "SD", 2) || !memcmp(name, "NR", 2)) {
+        simAtResponse(sim, nowUs, frameId, cmd, SIM_AT_STATUS_OK, NULL, 0);
+        return;
+    }
+
+    if (!memcmp(name, "RE", 2) || !memcmp(name, "FR", 2)) {
+        const uint8_t reset[2] = { SIM_API_MODEM_STATUS, SIM_MODEM_HW_RESET };
+        simAtResponse(sim, nowUs, frameId, cmd, SIM_AT_STATUS_OK, NULL, 0);
+        simSchedule(sim, simDue(sim, nowUs, sim->config.latencyMs + SIM_RESET_DELAY_MS),
+                    XBEE_SIM_EFFECT_RESET, reset, sizeof(reset));
+        return;
+    }
+
+    // Volatile read-only values
+    if (!memcmp(name, "DB", 2) && paramLen == 0) {
+        simSetParamU8(sim, "DB", 0x20 + (simRandom(sim) % 0x30));
+    }
+
+    XBeeSimParam_t* p = simFindParam(sim, name);
+    if (paramLen == 0) {
+        if (!p) {
+            simAtResponse(sim, nowUs, frameId, cmd, SIM_AT_STATUS_INVALID_CMD, NULL, 0);
+        } else {
+            simAtResponse(sim, nowUs, frameId, cmd, SIM_AT_STATUS_OK, p->value, p->length);
+        }
+        return;
+    }
+
+    if (!XBeeSimSetParam(sim, name, param, (uint8_t)(paramLen > 255 ? 255 : paramLen))) {
+        simAtResponse(sim, nowUs, frameId, cmd, SIM_AT_STATUS_ERROR, NULL, 0);
+        return;
+    }
+    simAtResponse(sim, nowUs, frameId, cmd, SIM_AT_STATUS_OK, NULL, 0);
+}
+
+/**
+ * @brief Schedules an LR transmit status, plain (0x89) or explicit (0xD2).
+ */
+static void simLrTxStatus(XBeeSim* sim, uint64_t dueUs, uint8_t frameId, uint8_t status) {
+    if (frameId == 0) return;
+
+    if (sim->config.explicitTxStatus) {
+        uint32_t counter = sim->uplinkCounter;
+        uint8_t data[10] = {
+            SIM_API_LR_EXPLICIT_TX_STAT, frameId, status,
+            0x00,                     // Data rate
+            (uint8_t)(simRandom(sim) % 8), // Channel
+            14,                       // Power
+            counter >> 24, counter >> 16, counter >> 8, counter
+        };
+        simSchedule(sim, dueUs, XBEE_SIM_EFFECT_NONE, data, sizeof(data));
+    } else {
+        uint8_t data[3] = { SIM_API_TX_STATUS, frameId, status };
+        simSchedule(sim, dueUs, XBEE_SIM_EFFECT_NONE, data, sizeof(data));
+    }
+}
+
+/**
+ * @brief Handles an LR uplink (0x50): frame ID, port, ack flag, payload.
+ */
+static void simHandleLrTx(XBeeSim* sim, const uint8_t* data, uint16_t len, uint64_t nowUs) {
+    if (len < 4) return;
+    uint8_t frameId = data[1];
+    uint64_t due = simDue(sim, nowUs, sim->config.radioLatencyMs);
+
+    if (!sim->joined) {
+        simLrTxStatus(sim, simDue(sim, nowUs, sim->config.latencyMs), frameId, SIM_TX_NOT_JOINED);
+        return;
+    }
+
+    sim->uplinkCounter++;
+    bool ack = data[3] & 0x01;
+    uint8_t status = SIM_TX_SUCCESS;
+    if (simLost(sim)) {
+        // An unacknowledged uplink is fire-and-forget; only confirmed traffic reports the loss
+        status = ack ? SIM_TX_NO_ACK : SIM_TX_SUCCESS;
+    }
+    simLrTxStatus(sim, due, frameId, status);
+}
+
+/**
+ * @brief Handles a cellular socket frame (0x40-0x46) or IPv4 transmit (0x20).
+ */
+static void simHandleCellular(XBeeSim* sim, const uint8_t* data, uint16_t len, uint64_t nowUs) {
+    uint8_t type = data[0];
+    uint8_t frameId = len > 1 ? data[1] : 0;
+    uint8_t socketId = len > 2 ? data[2] : 0xFF;
+    XBeeSimSocket_t* sock = socketId < XBEE_SIM_MAX_SOCKETS && sim->sockets[socketId].used ?
+                            &sim->sockets[socketId] : NULL;
+    uint64_t local = simDue(sim, nowUs, sim->config.latencyMs);
+    uint8_t out[XBEE_SIM_MAX_FRAME_DATA_SIZE];
+
+    switch (type) {
+        case SIM_API_SOCKET_CREATE: {
+            uint8_t id = 0;
+            while (id < XBEE_SIM_MAX_SOCKETS && sim->sockets[id].used) id++;
+            bool ok = id < XBEE_SIM_MAX_SOCKETS && len >= 3;
+            if (ok) {
+                memset(&sim->sockets[id], 0, sizeof(XBeeSimSocket_t));
+                sim->sockets[id].used = true;
+                sim->sockets[id].protocol = data[2];
+            }
+            uint8_t resp[4] = { SIM_API_SOCKET_CREATE_RESP, frameId, ok ? id : 0xFF,
+                                ok ? SIM_AT_STATUS_OK : SIM_SOCKET_RESULT_ERROR };
+            simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, resp, sizeof(resp));
+            break;
+        }
+
+        case SIM_API_SOCKET_OPTION: {
+            uint8_t option = len > 3 ? data[3] : 0;
+            uint8_t resp[5] = { SIM_API_SOCKET_OPTION_RESP, frameId, socketId, option,
+                                sock ? SIM_AT_STATUS_OK : SIM_SOCKET_RESULT_ERROR };
+            simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, resp, sizeof(resp));
+            break;
+        }
+
+        case SIM_API_SOCKET_CONNECT: {
+            bool ok = sock && sim->joined && len >= 6;
+            uint8_t resp[4] = { SIM_API_SOCKET_CONNECT_RESP, frameId, socketId,
+                                ok ? SIM_AT_STATUS_OK : SIM_SOCKET_RESULT_ERROR };
+            simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, resp, sizeof(resp));
+            if (!ok) break;
+
+            sock->remotePort = (uint16_t)(data[3] << 8 | data[4]);
+            if (data[5] == 0x00 && len >= 10) memcpy(sock->remoteIp, &data[6], 4);
+            sock->connected = !simLost(sim);
+            uint8_t status[3] = { SIM_API_SOCKET_STATUS, socketId,
+                                  sock->connected ? SIM_SOCKET_STATUS_CONNECTED : SIM_SOCKET_STATUS_FAILED };
+            simSchedule(sim, simDue(sim, nowUs, sim->config.radioLatencyMs), XBEE_SIM_EFFECT_NONE,
+                        status, sizeof(status));
+            break;
+        }
+
+        case SIM_API_SOCKET_CLOSE: {
+            uint8_t resp[4] = { SIM_API_SOCKET_CLOSE_RESP, frameId, socketId,
+                                sock ? SIM_AT_STATUS_OK : SIM_SOCKET_RESULT_ERROR };
+            simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, resp, sizeof(resp));
+            if (sock) {
+                uint8_t status[3] = { SIM_API_SOCKET_STATUS, socketId, SIM_SOCKET_STATUS_CLOSED };
+                simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, status, sizeof(status));
+                memset(sock, 0, sizeof(*sock));
+            }
+            break;
+        }
+
+        case SIM_API_SOCKET_BIND: {
+            bool ok = sock && len >= 5;
+            if (ok) sock->localPort = (uint16_t)(data[3] << 8 | data[4]);
+            uint8_t resp[4] = { SIM_API_SOCKET_BIND_RESP, frameId, socketId,
+                                ok ? SIM_AT_STATUS_OK : SIM_SOCKET_RESULT_ERROR };
+            simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, resp, sizeof(resp));
+            break;
+        }
+
+        case SIM_API_SOCKET_SEND:
+        case SIM_API_SOCKET_SEND_TO: {
+            uint16_t header = (type == SIM_API_SOCKET_SEND) ? 4 : 10;
+            bool ok = sock && len >= header && (type == SIM_API_SOCKET_SEND_TO || sock->connected);
+            uint64_t due = simDue(sim, nowUs, sim->config.radioLatencyMs);
+            bool lost = ok && simLost(sim);
+
+            if (frameId) {
+                uint8_t status[3] = { SIM_API_TX_STATUS, frameId,
+                                      ok ? SIM_TX_SUCCESS : SIM_TX_INVALID_SOCKET };
+                simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, status, sizeof(status));
+            }
+            if (!ok || lost || !sim->config.echo) break;
+
+            uint16_t payloadLen = len - header;
+            uint16_t n = 0;
+            if (type == SIM_API_SOCKET_SEND) {
+                out[n++] = SIM_API_SOCKET_RX;
+                out[n++] = 0x00;          // Frame ID
+                out[n++] = socketId;
+                out[n++] = 0x00;          // Status
+            } else {
+                out[n++] = SIM_API_SOCKET_RX_FROM;
+                out[n++] = 0x00;          // Frame ID
+                out[n++] = socketId;
+                memcpy(&out[n], &data[3], 4); n += 4;
+                out[n++] = data[7];
+                out[n++] = data[8];
+                out[n++] = 0x00;          // Status
+            }
+            if (n + payloadLen > sizeof(out)) payloadLen = sizeof(out) - n;
+            memcpy(&out[n], &data[header], payloadLen);
+            simSchedule(sim, due + (uint64_t)sim->config.radioLatencyMs * 1000, XBEE_SIM_EFFECT_NONE,
+                        out, n + payloadLen);
+            break;
+        }
+
+        case SIM_API_CELL_TX_IPV4: {
+            // Frame ID, IPv4, dest port, source port, protocol, options, payload
+            bool ok = sim->joined && len >= 12;
+            uint64_t due = simDue(sim, nowUs, sim->config.radioLatencyMs);
+            bool lost = ok && simLost(sim);
+            if (frameId) {
+                uint8_t status[3] = { SIM_API_TX_STATUS, frameId, ok ? SIM_TX_SUCCESS : SIM_TX_NOT_JOINED };
+                simSchedule(sim, local, XBEE_SIM_EFFECT_NONE, status, sizeof(status));
+            }
+            if (!ok || lost || !sim->config.echo) break;
+
+            uint16_t payloadLen = len - 12;
+            uint16_t n = 0;
+            out[n++] = SIM_API_CELL_RX_IPV4;
+            memcpy(&out[n], &data[2], 4); n += 4;   // Source address
+            out[n++] = data[8];  out[n++] = data[9]; // Destination port (our source port)
+            out[n++] = data[6];  out[n++] = data[7]; // Source port
+            out[n++] = data[10];                     // Protocol
+            out[n++] = 0x00;                         // Status
+            if (n + payloadLen > sizeof(out)) payloadLen = sizeof(out) - n;
+            memcpy(&out[n], &data[12], payloadLen);
+            simSchedule(sim, due + (uint64_t)sim->config.radioLatencyMs * 1000, XBEE_SIM_EFFECT_NONE,
+                        out, n + payloadLen);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Dispatches a validated host frame to the active personality.
+ */
+static void simHandleFrame(XBeeSim* sim, const uint8_t* data, uint16_t len, uint64_t nowUs) {
+    sim->stats.framesIn++;
+
+    if (data[0] == SIM_API_AT_COMMAND) {
+        simHandleAtCommand(sim, data, len, nowUs);
+        return;
+    }
+
+    if (sim->config.mode == XBEE_SIM_MODE_LR) {
+        if (data[0] == SIM_API_LR_JOIN_REQUEST) {
+            if (!sim->joined && !simLost(sim)) {
+                simScheduleJoin(sim, nowUs);
+            }
+        } else if (data[0] == SIM_API_LR_TX_REQUEST) {
+            simHandleLrTx(sim, data, len, nowUs);
+        }
+    } else {
+        simHandleCellular(sim, data, len, nowUs);
+    }
+}
+
+/**
+ * @brief Feeds bytes written by the host into the simulated module UART.
+ *
+ * @param[in] sim Pointer to the simulator instance.
+ * @param[in] data Bytes written by the host.
+ * @param[in] len Number of bytes.
+ * @param[in] nowUs Current monotonic time in microseconds.
+ */
+void XBeeSimInput(XBeeSim* sim, const uint8_t* data, size_t len, uint64_t nowUs) {
+    sim->stats.bytesIn += len;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t b = data[i];
+        switch (sim->rxState) {
+            case SIM_RX_WAIT_DELIMITER:
+                if (b == 0x7E) sim->rxState = SIM_RX_LENGTH_MSB;
+                break;
+            case SIM_RX_LENGTH_MSB:
+                sim->rxLength = (uint16_t)b << 8;
+                sim->rxState = SIM_RX_LENGTH_LSB;
+                break;
+            case SIM_RX_LENGTH_LSB:
+                sim->rxLength |= b;
+                sim->rxIndex = 0;
+                sim->rxSum = 0;
+                if (sim->rxLength == 0 || sim->rxLength > XBEE_SIM_MAX_FRAME_DATA_SIZE) {
+                    sim->stats.overflows++;
+                    sim->rxState = SIM_RX_WAIT_DELIMITER;
+                } else {
+                    sim->rxState = SIM_RX_DATA;
+                }
+                break;
+            case SIM_RX_DATA:
+                sim->rxData[sim->rxIndex++] = b;
+                sim->rxSum += b;
+                if (sim->rxIndex == sim->rxLength) sim->rxState = SIM_RX_CHECKSUM;
+                break;
+            case SIM_RX_CHECKSUM:
+                sim->rxState = SIM_RX_WAIT_DELIMITER;
+                if ((uint8_t)(sim->rxSum + b) == 0xFF) {
+                    simHandleFrame(sim, sim->rxData, sim->rxLength, nowUs);
+                } else {
+                    sim->stats.checksumErrors++;
+                }
+                break;
+            default:
+                sim->rxState = SIM_RX_WAIT_DELIMITER;
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Builds and schedules an unsolicited downlink for the active personality.
+ *
+ * @param[in] sim Pointer to the simulator instance.
+ * @param[in] portOrSocket LoRaWAN port (LR) or socket ID (Cellular).
+ * @param[in] payload Downlink payload.
+ * @param[in] len Payload length in bytes.
+ * @param[in] nowUs Current monotonic time in microseconds.
+ *
+ * @return bool True if the downlink was scheduled (it may still be lost).
+ */
+bool XBeeSimInjectDownlink(XBeeSim* sim, uint8_t portOrSocket, const uint8_t* payload,
+                           uint16_t len, uint64_t nowUs) {
+    uint8_t out[XBEE_SIM_MAX_FRAME_DATA_SIZE];
+    uint16_t n = 0;
+
+    if (!sim->joined) return false;
+    if (simLost(sim)) return true;
+
+    if (sim->config.mode == XBEE_SIM_MODE_LR) {
+        sim->downlinkCounter++;
+        if (sim->config.explicitRx) {
+            uint32_t c = sim->downlinkCounter;
+            out[n++] = SIM_API_LR_EXPLICIT_RX;
+            out[n++] = portOrSocket;
+            out[n++] = (uint8_t)(-(int)(40 + simRandom(sim) % 60)); // RSSI
+            out[n++] = (uint8_t)(simRandom(sim) % 12);              // SNR
+            out[n++] = 0x10;                                        // RX1 slot, DR0
+            out[n++] = c >> 24; out[n++] = c >> 16; out[n++] = c >> 8; out[n++] = c;
+            out[n++] = 0x00;                                        // Reserved
+        } else {
+            out[n++] = SIM_API_LR_RX_PACKET;
+            out[n++] = portOrSocket;
+        }
+    } else {
+        if (portOrSocket >= XBEE_SIM_MAX_SOCKETS || !sim->sockets[portOrSocket].used) return false;
+        out[n++] = SIM_API_SOCKET_RX;
+        out[n++] = 0x00;
+        out[n++] = portOrSocket;
+        out[n++] = 0x00;
+    }
+
+    if (n + len > sizeof(out)) len = sizeof(out) - n;
+    if (len) memcpy(&out[n], payload, len);
+    return simSchedule(sim, simDue(sim, nowUs, 0), XBEE_SIM_EFFECT_NONE, out, n + len);
+}
+
+/**
+ * @brief Generates the periodic downlink traffic configured with rxIntervalMs.
+ */
+static void simPeriodic(XBeeSim* sim, uint64_t nowUs) {
+    if (!sim->nextDownlinkUs || nowUs < sim->nextDownlinkUs) return;
+    sim->nextDownlinkUs = nowUs + (uint64_t)sim->config.rxIntervalMs * 1000;
+
+    uint8_t payload[XBEE_SIM_MAX_FRAME_DATA_SIZE];
+    uint16_t len = sim->config.rxPayloadSize;
+    if (len > sizeof(payload) - 16) len = sizeof(payload) - 16;
+    for (uint16_t i = 0; i < len; i++) payload[i] = (uint8_t)(sim->downlinkCounter + i);
+
+    if (sim->config.mode == XBEE_SIM_MODE_LR) {
+        XBeeSimInjectDownlink(sim, 2, payload, len, nowUs);
+    } else {
+        for (uint8_t id = 0; id < XBEE_SIM_MAX_SOCKETS; id++) {
+            if (sim->sockets[id].connected) {
+                XBeeSimInjectDownlink(sim, id, payload, len, nowUs);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Applies the side effect attached to a frame that has reached the wire.
+ */
+static void simApplyEffect(XBeeSim* sim, xbee_sim_effect_t effect, uint64_t nowUs) {
+    switch (effect) {
+        case XBEE_SIM_EFFECT_JOINED:
+            sim->joined = true;
+            simSetParamU8(sim, sim->config.mode == XBEE_SIM_MODE_LR ? "JS" : "AI",
+                          sim->config.mode == XBEE_SIM_MODE_LR ? 1 : 0);
+            if (sim->config.mode == XBEE_SIM_MODE_CELLULAR) simSetParamU32(sim, "MY", 0x0A400001);
+            break;
+        case XBEE_SIM_EFFECT_RESET: {
+            // Keep the reset notification that triggered us, drop everything else
+            XBeeSimConfig_t config = sim->config;
+            XBeeSimParam_t params[XBEE_SIM_MAX_PARAMS];
+            uint8_t paramCount = sim->paramCount;
+            memcpy(params, sim->params, sizeof(params));
+            XBeeSimReset(sim, nowUs);
+            sim->config = config;
+            // Settings survive a soft reset; volatile network state does not
+            memcpy(sim->params, params, sizeof(params));
+            sim->paramCount = paramCount;
+            simSetParamU8(sim, "JS", 0);
+            if (config.mode == XBEE_SIM_MODE_CELLULAR) simSetParamU8(sim, "AI", 0x23);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Moves due frames from the schedule onto the module->host wire.
+ */
+static void simFlushSchedule(XBeeSim* sim, uint64_t nowUs) {
+    while (sim->pendingCount > 0 && sim->pending[0].dueUs <= nowUs) {
+        XBeeSimPending_t* p = &sim->pending[0];
+        size_t wireLen = (size_t)p->length + 4;
+
+        if (sim->wireCount + wireLen > XBEE_SIM_WIRE_BUFFER_SIZE) {
+            // The host is not draining the UART; hold the frame back
+            break;
+        }
+
+        if (sim->wireCount == 0) {
+            sim->wireReadyUs = nowUs;
+        }
+
+        uint8_t header[3] = { 0x7E, (uint8_t)(p->length >> 8), (uint8_t)(p->length & 0xFF) };
+        uint8_t sum = 0;
+        size_t tail = (sim->wireHead + sim->wireCount) % XBEE_SIM_WIRE_BUFFER_SIZE;
+        for (int i = 0; i < 3; i++) {
+            sim->wire[tail] = header[i];
+            tail = (tail + 1) % XBEE_SIM_WIRE_BUFFER_SIZE;
+        }
+        for (uint16_t i = 0; i < p->length; i++) {
+            sim->wire[tail] = p->data[i];
+            sum += p->data[i];
+            tail = (tail + 1) % XBEE_SIM_WIRE_BUFFER_SIZE;
+        }
+        sim->wire[tail] = 0xFF - sum;
+        sim->wireCount += wireLen;
+        sim->stats.framesOut++;
+
+        xbee_sim_effect_t effect = p->effect;
+        sim->pendingCount--;
+        memmove(&sim->pending[0], &sim->pending[1], sim->pendingCount * sizeof(XBeeSimPending_t));
+        simApplyEffect(sim, effect, nowUs);
+    }
+}
+
+/**
+ * @brief Returns the bytes the module has shifted out to the host by nowUs.
+ *
+ * With a non-zero baud rate each byte takes 10 bit times (8N1) to leave the
+ * module, so large frames arrive progressively just like on a real UART.
+ *
+ * @param[in] sim Pointer to the simulator instance.
+ * @param[in] nowUs Current monotonic time in microseconds.
+ * @param[out] out Destination buffer.
+ * @param[in] maxLen Size of the destination buffer.
+ *
+ * @return size_t Number of bytes copied to out.
+ */
+size_t XBeeSimOutput(XBeeSim* sim, uint64_t nowUs, uint8_t* out, size_t maxLen) {
+    simPeriodic(sim, nowUs);
+    simFlushSchedule(sim, nowUs);
+
+    size_t n = 0;
+    uint64_t byteUs = sim->config.baudRate ? (10000000ull / sim->config.baudRate) : 0;
+
+    while (n < maxLen && sim->wireCount > 0) {
+        if (byteUs) {
+            if (sim->wireReadyUs + byteUs > nowUs) break;
+            sim->wireReadyUs += byteUs;
+        }
+        out[n++] = sim->wire[sim->wireHead];
+        sim->wireHead = (sim->wireHead + 1) % XBEE_SIM_WIRE_BUFFER_SIZE;
+        sim->wireCount--;
+    }
+
+    sim->stats.bytesOut += n;
+    return n;
+}
+
+/**
+ * @brief Returns the next time XBeeSimOutput() has something to do.
+ *
+ * @return uint64_t Monotonic time in microseconds, or UINT64_MAX when idle.
+ */
+uint64_t XBeeSimNextEventUs(const XBeeSim* sim) {
+    uint64_t next = UINT64_MAX;
+    uint64_t byteUs = sim->config.baudRate ? (10000000ull / sim->config.baudRate) : 0;
+
+    if (sim->wireCount > 0) next = sim->wireReadyUs + byteUs;
+    if (sim->pendingCount > 0 && sim->pending[0].dueUs < next) next = sim->pending[0].dueUs;
+    if (sim->nextDownlinkUs && sim->nextDownlinkUs < next) next = sim->nextDownlinkUs;
+    return next;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file xbee_sim.h
+ * @brief Host-side XBee module simulator for LR and Cellular API modes.
+ *
+ * This file defines the interface for a software model of an XBee LR and an
+ * XBee 3 Cellular module speaking the unescaped API frame protocol. The
+ * simulator engine is transport agnostic: bytes written by the host are fed
+ * in with XBeeSimInput() and the bytes the module would emit are pulled out
+ * with XBeeSimOutput(), both stamped with a monotonic time in microseconds.
+ * Responses are scheduled with configurable latency, jitter and loss and are
+ * released at the configured UART baud rate so protocol timing is realistic.
+ *
+ * The pty runner (XBeeSimPty*) attaches the engine to a Linux pseudo terminal
+ * so the library, through ports/port_unix.c, or any other firmware can talk to
+ * it exactly as it would to a real module on /dev/ttyUSBx.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#ifndef XBEE_SIM_H
+#define XBEE_SIM_H
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#define XBEE_SIM_MAX_FRAME_DATA_SIZE 1024  ///< Largest frame data (type + payload) accepted or emitted
+#define XBEE_SIM_MAX_PENDING 64            ///< Frames that can be scheduled but not yet on the wire
+#define XBEE_SIM_WIRE_BUFFER_SIZE 16384    ///< Bytes buffered on the module->host wire
+#define XBEE_SIM_MAX_PARAMS 48             ///< AT parameters held in the register file
+#define XBEE_SIM_MAX_PARAM_SIZE 32         ///< Largest AT parameter value
+#define XBEE_SIM_MAX_SOCKETS 8             ///< Cellular sockets
+
+/**
+ * @enum xbee_sim_mode_t
+ * @brief Module personality emulated by the simulator.
+ */
+typedef enum {
+    XBEE_SIM_MODE_LR = 0,       ///< XBee LR (LoRaWAN)
+    XBEE_SIM_MODE_CELLULAR      ///< XBee 3 Cellular (LTE-M/NB-IoT)
+} xbee_sim_mode_t;
+
+/**
+ * @struct XBeeSimConfig_t
+ * @brief Timing and behaviour knobs of a simulated module.
+ *
+ * All times are in milliseconds. A zero baud rate releases module output
+ * instantly, which is useful for pure protocol soak tests.
+ */
+typedef struct {
+    xbee_sim_mode_t mode;       ///< Module personality
+    uint32_t baudRate;          ///< UART baud rate used to pace module output (0 = unpaced)
+    uint32_t latencyMs;         ///< Local processing latency (AT responses, socket create/bind)
+    uint32_t radioLatencyMs;    ///< Over-the-air latency (TX status, socket connect, echo)
+    uint32_t jitterMs;          ///< Uniform random jitter added to every latency
+    uint8_t lossPercent;        ///< Probability (0-100) an over-the-air exchange is lost
+    uint32_t joinDelayMs;       ///< LoRaWAN join / cellular attach time
+    uint32_t rxIntervalMs;      ///< Period of unsolicited downlinks (0 = none)
+    uint16_t rxPayloadSize;     ///< Payload size of unsolicited downlinks
+    bool explicitRx;            ///< LR: emit 0xD1 explicit RX instead of 0xD0
+    bool explicitTxStatus;      ///< LR: emit 0xD2 explicit TX status instead of 0x89
+    bool echo;                  ///< Cellular: echo socket payloads back as received data
+    uint32_t seed;              ///< PRNG seed for jitter and loss (0 = fixed default)
+} XBeeSimConfig_t;
+
+/**
+ * @struct XBeeSimStats_t
+ * @brief Counters kept by the simulator for soak and benchmark reports.
+ */
+typedef struct {
+    uint32_t framesIn;          ///< Valid frames received from the host
+    uint32_t framesOut;         ///< Frames placed on the wire towards the host
+    uint32_t bytesIn;           ///< Raw bytes received from the host
+    uint32_t bytesOut;          ///< Raw bytes released towards the host
+    uint32_t checksumErrors;    ///< Host frames discarded for a bad checksum
+    uint32_t framesLost;        ///< Over-the-air exchanges dropped by the loss model
+    uint32_t overflows;         ///< Frames dropped because a queue was full
+} XBeeSimStats_t;
+
+/**
+ * @struct XBeeSimParam_t
+ * @brief One entry of the simulated AT register file.
+ */
+typedef struct {
+    char cmd[2];
+    uint8_t length;
+    uint8_t value[XBEE_SIM_MAX_PARAM_SIZE];
+} XBeeSimParam_t;
+
+/**
+ * @enum xbee_sim_effect_t
+ * @brief State change applied when a scheduled frame reaches the wire.
+ */
+typedef enum {
+    XBEE_SIM_EFFECT_NONE = 0,
+    XBEE_SIM_EFFECT_JOINED,     ///< LR joined / cellular attached
+    XBEE_SIM_EFFECT_RESET       ///< Module finished rebooting
+} xbee_sim_effect_t;
+
+/**
+ * @struct XBeeSimPending_t
+ * @brief A frame scheduled for transmission to the host.
+ */
+typedef struct {
+    uint64_t dueUs;
+    xbee_sim_effect_t effect;
+    uint16_t length;            ///< Frame data length (type + payload)
+    uint8_t data[XBEE_SIM_MAX_FRAME_DATA_SIZE];
+} XBeeSimPending_t;
+
+/**
+ * @struct XBeeSimSocket_t
+ * @brief State of one simulated cellular socket.
+ */
+typedef struct {
+    bool used;
+    bool connected;
+    uint8_t protocol;
+    uint16_t localPort;
+    uint16_t remotePort;
+    uint8_t remoteIp[4];
+} XBeeSimSocket_t;
+
+/**
+ * @struct XBeeSim
+ * @brief Simulated module instance.
+ *
+ * The structure is public so instances can be allocated statically; its
+ * members are private to xbee_sim.c.
+ */
+typedef struct {
+    XBeeSimConfig_t config;
+    XBeeSimStats_t stats;
+    uint32_t rng;
+
+    // Host -> module frame parser
+    uint8_t rxState;
+    uint16_t rxLength;
+    uint16_t rxIndex;
+    uint8_t rxSum;
+    uint8_t rxData[XBEE_SIM_MAX_FRAME_DATA_SIZE];
+
+    // Module state
+    bool joined;
+    uint64_t nextDownlinkUs;
+    uint32_t downlinkCounter;
+    uint32_t uplinkCounter;
+    XBeeSimParam_t params[XBEE_SIM_MAX_PARAMS];
+    uint8_t paramCount;
+    XBeeSimSocket_t sockets[XBEE_SIM_MAX_SOCKETS];
+
+    // Module -> host scheduling
+    XBeeSimPending_t pending[XBEE_SIM_MAX_PENDING];
+    uint8_t pendingCount;
+    uint8_t wire[XBEE_SIM_WIRE_BUFFER_SIZE];
+    size_t wireHead;
+    size_t wireCount;
+    uint64_t wireReadyUs;       ///< Time the next wire byte has been fully shifted out
+} XBeeSim;
+
+void XBeeSimInit(XBeeSim* sim, const XBeeSimConfig_t* config, uint64_t nowUs);
+void XBeeSimReset(XBeeSim* sim, uint64_t nowUs);
+void XBeeSimInput(XBeeSim* sim, const uint8_t* data, size_t len, uint64_t nowUs);
+size_t XBeeSimOutput(XBeeSim* sim, uint64_t nowUs, uint8_t* out, size_t maxLen);
+uint64_t XBeeSimNextEventUs(const XBeeSim* sim);
+bool XBeeSimInjectDownlink(XBeeSim* sim, uint8_t portOrSocket, const uint8_t* payload,
+                           uint16_t len, uint64_t nowUs);
+bool XBeeSimSetParam(XBeeSim* sim, const char* cmd, const uint8_t* value, uint8_t len);
+const XBeeSimParam_t* XBeeSimGetParam(const XBeeSim* sim, const char* cmd);
+
+/**
+ * @struct XBeeSimPty
+ * @brief Binds a simulator instance to the master side of a Linux pty.
+ */
+typedef struct {
+    XBeeSim sim;
+    int masterFd;
+    int slaveFd;                ///< Kept open so the slave's raw termios survive host re-opens
+    char slavePath[64];
+    volatile bool running;
+    pthread_t thread;           ///< Worker started by XBeeSimPtyStart()
+    bool threadStarted;
+    pthread_mutex_t lock;       ///< Serializes engine access between the worker and callers
+} XBeeSimPty;
+
+int XBeeSimPtyOpen(XBeeSimPty* pty, const XBeeSimConfig_t* config);
+int XBeeSimPtyRun(XBeeSimPty* pty);
+int XBeeSimPtyStart(XBeeSimPty* pty);
+void XBeeSimPtyStop(XBeeSimPty* pty);
+void XBeeSimPtyClose(XBeeSimPty* pty);
+bool XBeeSimPtyInjectDownlink(XBeeSimPty* pty, uint8_t portOrSocket, const uint8_t* payload, uint16_t len);
+void XBeeSimPtyGetStats(XBeeSimPty* pty, XBeeSimStats_t* stats);
+uint64_t XBeeSimNowUs(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // XBEE_SIM_H
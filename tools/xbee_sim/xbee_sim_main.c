@@ -0,0 +1,166 @@
+/**
+ * @file xbee_sim_main.c
+ * @brief Command line front end for the pty-backed XBee module simulator.
+ *
+ * Usage example:
+ *   ./build/xbee_sim --mode lr --baud 9600 --latency 5 --radio-latency 400 \
+ *                    --join-delay 2000 --rx-interval 5000 --link /tmp/ttyXBEE
+ *
+ * The slave pty path is printed on stdout; point the example applications or
+ * your own port layer at it (or at the --link symlink) instead of /dev/ttyUSBx.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+
+static XBeeSimPty simPty;
+
+static void handleSignal(int sig) {
+    (void)sig;
+    simPty.running = false;
+}
+
+static void usage(const char* prog) {
+    printf("Usage: %s [options]\n"
+           "  --mode lr|cellular     Module personality (default lr)\n"
+           "  --baud N               UART baud rate pacing module output, 0 = unpaced (default 9600)\n"
+           "  --latency MS           Local command latency (default 2)\n"
+           "  --radio-latency MS     Over-the-air latency (default 100)\n"
+           "  --jitter MS            Random jitter added to each latency (default 0)\n"
+           "  --loss PCT             Over-the-air loss probability 0-100 (default 0)\n"
+           "  --join-delay MS        Join / attach time (default 1000)\n"
+           "  --rx-interval MS       Unsolicited downlink period, 0 = off (default 0)\n"
+           "  --rx-size N            Unsolicited downlink payload size (default 16)\n"
+           "  --explicit-rx          LR: emit explicit RX (0xD1) frames\n"
+           "  --explicit-tx-status   LR: emit explicit TX status (0xD2) frames\n"
+           "  --no-echo              Cellular: do not echo socket payloads\n"
+           "  --seed N               PRNG seed for jitter and loss\n"
+           "  --link PATH            Create a symlink to the slave pty\n"
+           "  --stats                Print counters on exit\n", prog);
+}
+
+int main(int argc, char** argv) {
+    XBeeSimConfig_t config = {
+        .mode = XBEE_SIM_MODE_LR,
+        .baudRate = 9600,
+        .latencyMs = 2,
+        .radioLatencyMs = 100,
+        .joinDelayMs = 1000,
+        .rxPayloadSize = 16,
+        .echo = true,
+    };
+    const char* link = NULL;
+    bool printStats = false;
+
+    static const struct option options[] = {
+        { "mode",               required_argument, 0, 'm' },
+        { "baud",               required_argument, 0, 'b' },
+        { "latency",            required_argument, 0, 'l' },
+        { "radio-latency",      required_argument, 0, 'r' },
+        { "jitter",             required_argument, 0, 'j' },
+        { "loss",               required_argument, 0, 'p' },
+        { "join-delay",         required_argument, 0, 'J' },
+        { "rx-interval",        required_argument, 0, 'i' },
+        { "rx-size",            required_argument, 0, 's' },
+        { "explicit-rx",        no_argument,       0, 'x' },
+        { "explicit-tx-status", no_argument,       0, 'X' },
+        { "no-echo",            no_argument,       0, 'E' },
+        { "seed",               required_argument, 0, 'S' },
+        { "link",               required_argument, 0, 'L' },
+        { "stats",              no_argument,       0, 'T' },
+        { "help",               no_argument,       0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'm':
+                if (!strcmp(optarg, "lr")) config.mode = XBEE_SIM_MODE_LR;
+                else if (!strcmp(optarg, "cellular")) config.mode = XBEE_SIM_MODE_CELLULAR;
+                else { usage(argv[0]); return 1; }
+                break;
+            case 'b': config.baudRate = strtoul(optarg, NULL, 0); break;
+            case 'l': config.latencyMs = strtoul(optarg, NULL, 0); break;
+            case 'r': config.radioLatencyMs = strtoul(optarg, NULL, 0); break;
+            case 'j': config.jitterMs = strtoul(optarg, NULL, 0); break;
+            case 'p': config.lossPercent = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 'J': config.joinDelayMs = strtoul(optarg, NULL, 0); break;
+            case 'i': config.rxIntervalMs = strtoul(optarg, NULL, 0); break;
+            case 's': config.rxPayloadSize = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'x': config.explicitRx = true; break;
+            case 'X': config.explicitTxStatus = true; break;
+            case 'E': config.echo = false; break;
+            case 'S': config.seed = strtoul(optarg, NULL, 0); break;
+            case 'L': link = optarg; break;
+            case 'T': printStats = true; break;
+            case 'h':
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (config.lossPercent > 100) config.lossPercent = 100;
+
+    if (XBeeSimPtyOpen(&simPty, &config) != 0) {
+        perror("xbee_sim: unable to open pty");
+        return 1;
+    }
+
+    if (link) {
+        unlink(link);
+        if (symlink(simPty.slavePath, link) != 0) {
+            perror("xbee_sim: unable to create link");
+        }
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    printf("%s\n", simPty.slavePath);
+    fflush(stdout);
+
+    int rc = XBeeSimPtyRun(&simPty);
+
+    if (printStats) {
+        const XBeeSimStats_t* s = &simPty.sim.stats;
+        fprintf(stderr, "framesIn=%u framesOut=%u bytesIn=%u bytesOut=%u checksumErrors=%u "
+                "framesLost=%u overflows=%u\n", s->framesIn, s->framesOut, s->bytesIn,
+                s->bytesOut, s->checksumErrors, s->framesLost, s->overflows);
+    }
+
+    if (link) unlink(link);
+    XBeeSimPtyClose(&simPty);
+    return rc == 0 ? 0 : 1;
+}
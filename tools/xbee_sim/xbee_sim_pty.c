@@ -0,0 +1,217 @@
+/**
+ * @file xbee_sim_pty.c
+ * @brief Binds the XBee simulator engine to a Linux pseudo terminal.
+ *
+ * The master side of the pty is driven by a poll() loop that feeds host bytes
+ * into the engine and writes module output back as it becomes due. The slave
+ * side is put into raw mode and held open so the library's port_unix.c can
+ * open it by path like any serial device.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#define _GNU_SOURCE
+#include "xbee_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+
+#define SIM_PTY_IO_CHUNK 4096
+#define SIM_PTY_MAX_WAIT_MS 50
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in microseconds.
+ */
+uint64_t XBeeSimNowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Creates a pty pair and initializes the simulator behind it.
+ *
+ * @param[out] pty Runner instance to initialize.
+ * @param[in] config Simulator configuration.
+ *
+ * @return int 0 on success, -1 on failure with errno set.
+ */
+int XBeeSimPtyOpen(XBeeSimPty* pty, const XBeeSimConfig_t* config) {
+    memset(pty, 0, sizeof(*pty));
+    pty->masterFd = -1;
+    pty->slaveFd = -1;
+    pthread_mutex_init(&pty->lock, NULL);
+
+    pty->masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty->masterFd < 0) return -1;
+    if (grantpt(pty->masterFd) != 0 || unlockpt(pty->masterFd) != 0) goto fail;
+
+    const char* name = ptsname(pty->masterFd);
+    if (!name || strlen(name) >= sizeof(pty->slavePath)) goto fail;
+    strcpy(pty->slavePath, name);
+
+    // Hold the slave open in raw mode so line discipline never mangles frames
+    pty->slaveFd = open(pty->slavePath, O_RDWR | O_NOCTTY);
+    if (pty->slaveFd < 0) goto fail;
+
+    struct termios tty;
+    if (tcgetattr(pty->slaveFd, &tty) != 0) goto fail;
+    cfmakeraw(&tty);
+    if (tcsetattr(pty->slaveFd, TCSANOW, &tty) != 0) goto fail;
+
+    int flags = fcntl(pty->masterFd, F_GETFL);
+    fcntl(pty->masterFd, F_SETFL, flags | O_NONBLOCK);
+
+    XBeeSimInit(&pty->sim, config, XBeeSimNowUs());
+    return 0;
+
+fail:
+    XBeeSimPtyClose(pty);
+    return -1;
+}
+
+/**
+ * @brief Runs the simulator event loop until XBeeSimPtyStop() is called.
+ *
+ * @param[in] pty Opened runner instance.
+ *
+ * @return int 0 when stopped, -1 on an unrecoverable I/O error.
+ */
+int XBeeSimPtyRun(XBeeSimPty* pty) {
+    uint8_t buf[SIM_PTY_IO_CHUNK];
+    pty->running = true;
+
+    while (pty->running) {
+        uint64_t now = XBeeSimNowUs();
+        pthread_mutex_lock(&pty->lock);
+        uint64_t next = XBeeSimNextEventUs(&pty->sim);
+        pthread_mutex_unlock(&pty->lock);
+        int timeoutMs = SIM_PTY_MAX_WAIT_MS;
+        if (next != UINT64_MAX) {
+            timeoutMs = next <= now ? 0 : (int)((next - now + 999) / 1000);
+            if (timeoutMs > SIM_PTY_MAX_WAIT_MS) timeoutMs = SIM_PTY_MAX_WAIT_MS;
+        }
+
+        struct pollfd pfd = { .fd = pty->masterFd, .events = POLLIN };
+        int rc = poll(&pfd, 1, timeoutMs);
+        if (rc < 0 && errno != EINTR) return -1;
+
+        now = XBeeSimNowUs();
+        pthread_mutex_lock(&pty->lock);
+        if (rc > 0 && (pfd.revents & POLLIN)) {
+            ssize_t n;
+            while ((n = read(pty->masterFd, buf, sizeof(buf))) > 0) {
+                XBeeSimInput(&pty->sim, buf, (size_t)n, now);
+            }
+        }
+
+        size_t out = XBeeSimOutput(&pty->sim, now, buf, sizeof(buf));
+        pthread_mutex_unlock(&pty->lock);
+        size_t off = 0;
+        while (off < out) {
+            ssize_t w = write(pty->masterFd, buf + off, out - off);
+            if (w > 0) {
+                off += (size_t)w;
+            } else if (w < 0 && errno != EAGAIN && errno != EINTR) {
+                return -1;
+            } else {
+                struct pollfd wfd = { .fd = pty->masterFd, .events = POLLOUT };
+                poll(&wfd, 1, SIM_PTY_MAX_WAIT_MS);
+            }
+        }
+    }
+    return 0;
+}
+
+static void* simPtyThread(void* arg) {
+    XBeeSimPtyRun((XBeeSimPty*)arg);
+    return NULL;
+}
+
+/**
+ * @brief Runs the event loop on a background thread for in-process tests.
+ *
+ * @return int 0 on success, -1 if the thread could not be created.
+ */
+int XBeeSimPtyStart(XBeeSimPty* pty) {
+    pty->running = true;
+    if (pthread_create(&pty->thread, NULL, simPtyThread, pty) != 0) {
+        pty->running = false;
+        return -1;
+    }
+    pty->threadStarted = true;
+    return 0;
+}
+
+/**
+ * @brief Stops the event loop and joins the background thread if one was started.
+ */
+void XBeeSimPtyStop(XBeeSimPty* pty) {
+    pty->running = false;
+    if (pty->threadStarted) {
+        pthread_join(pty->thread, NULL);
+        pty->threadStarted = false;
+    }
+}
+
+/**
+ * @brief Stops the runner and releases both pty file descriptors.
+ */
+void XBeeSimPtyClose(XBeeSimPty* pty) {
+    XBeeSimPtyStop(pty);
+    if (pty->slaveFd >= 0) close(pty->slaveFd);
+    if (pty->masterFd >= 0) close(pty->masterFd);
+    pty->slaveFd = -1;
+    pty->masterFd = -1;
+    pthread_mutex_destroy(&pty->lock);
+}
+
+/**
+ * @brief Injects a downlink while the event loop may be running on another thread.
+ *
+ * @return bool Result of XBeeSimInjectDownlink().
+ */
+bool XBeeSimPtyInjectDownlink(XBeeSimPty* pty, uint8_t portOrSocket, const uint8_t* payload, uint16_t len) {
+    pthread_mutex_lock(&pty->lock);
+    bool ok = XBeeSimInjectDownlink(&pty->sim, portOrSocket, payload, len, XBeeSimNowUs());
+    pthread_mutex_unlock(&pty->lock);
+    return ok;
+}
+
+/**
+ * @brief Takes a consistent copy of the simulator counters.
+ */
+void XBeeSimPtyGetStats(XBeeSimPty* pty, XBeeSimStats_t* stats) {
+    pthread_mutex_lock(&pty->lock);
+    *stats = pty->sim.stats;
+    pthread_mutex_unlock(&pty->lock);
+}
@@ -0,0 +1,225 @@
+/**
+ * @file xbee_trace.c
+ * @brief Converts XBee trace ring dumps to Chrome trace event JSON.
+ *
+ * Usage example:
+ *   ./build/xbee_trace -o trace.json module0.xbtr module1.xbtr
+ *
+ * Each input is a buffer written by XBeeTraceDump(). Every dump becomes one
+ * process in the timeline (named after its instance ID and file), with
+ * frame I/O and dispatch on one track and blocking waits on another, so the
+ * output can be opened in chrome://tracing or ui.perfetto.dev and modules
+ * compared side by side. Timestamps are unwrapped from 32-bit microseconds.
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @license MIT
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author Felix Galindo
+ * @contact felix.galindo@digi.com
+ */
+
+#include "xbee_trace.h"
+#include "xbee_at_cmds.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <getopt.h>
+
+#define TRACK_IO 1      ///< Frame I/O, dispatch, callbacks and XBeeProcess()
+#define TRACK_WAIT 2    ///< Blocking waits
+
+static uint16_t getLe16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static const char* eventName(uint8_t event) {
+    switch (event) {
+        case XBEE_TRACE_EVENT_RX_FRAME:         return "rx_frame";
+        case XBEE_TRACE_EVENT_TX_FRAME:         return "tx_frame";
+        case XBEE_TRACE_EVENT_DISPATCH:         return "dispatch";
+        case XBEE_TRACE_EVENT_CALLBACK:         return "callback";
+        case XBEE_TRACE_EVENT_WAIT_AT:          return "wait_at";
+        case XBEE_TRACE_EVENT_WAIT_TX_STATUS:   return "wait_tx_status";
+        case XBEE_TRACE_EVENT_WAIT_JOIN:        return "wait_join";
+        case XBEE_TRACE_EVENT_WAIT_ATTACH:      return "wait_attach";
+        case XBEE_TRACE_EVENT_PROCESS:          return "process";
+        default:                                return "unknown";
+    }
+}
+
+static int eventTrack(uint8_t event) {
+    return event >= XBEE_TRACE_EVENT_WAIT_AT && event <= XBEE_TRACE_EVENT_WAIT_ATTACH ? TRACK_WAIT : TRACK_IO;
+}
+
+/**
+ * @brief Writes the "args" object decoding an event's argument.
+ */
+static void writeArgs(FILE* out, uint8_t event, uint16_t arg) {
+    switch (event) {
+        case XBEE_TRACE_EVENT_RX_FRAME:
+            fprintf(out, "{\"type\":\"0x%02X\",\"status\":%d}", arg & 0xFF, -(int)(arg >> 8));
+            break;
+        case XBEE_TRACE_EVENT_TX_FRAME:
+            fprintf(out, "{\"type\":\"0x%02X\",\"failed\":%s}", arg & 0xFF, (arg >> 8) ? "true" : "false");
+            break;
+        case XBEE_TRACE_EVENT_DISPATCH:
+            fprintf(out, "{\"type\":\"0x%02X\"}", arg & 0xFF);
+            break;
+        case XBEE_TRACE_EVENT_CALLBACK: {
+            static const char* const names[] = { "receive", "send", "connect", "disconnect" };
+            fprintf(out, "{\"callback\":\"%s\"}", arg < sizeof(names) / sizeof(names[0]) ? names[arg] : "??");
+            break;
+        }
+        case XBEE_TRACE_EVENT_WAIT_AT: {
+            const char* cmd = atCommandToString((at_command_t)arg);
+            fprintf(out, "{\"command\":\"%s\"}", cmd ? cmd : "??");
+            break;
+        }
+        case XBEE_TRACE_EVENT_WAIT_TX_STATUS:
+            fprintf(out, "{\"frame_id\":%u}", arg);
+            break;
+        default:
+            fprintf(out, "{\"arg\":%u}", arg);
+            break;
+    }
+}
+
+static uint8_t* readFile(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = length > 0 ? (uint8_t*)malloc((size_t)length) : NULL;
+    if (data && fread(data, 1, (size_t)length, f) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+/**
+ * @brief Appends one dump's events to the JSON array.
+ *
+ * @return bool False if the file is not a valid dump.
+ */
+static bool convertDump(FILE* out, const char* path, int pid, bool* first) {
+    size_t size;
+    uint8_t* data = readFile(path, &size);
+    if (!data || size < XBEE_TRACE_DUMP_HEADER_SIZE || memcmp(data, XBEE_TRACE_DUMP_MAGIC, 4) != 0 ||
+        data[4] != XBEE_TRACE_DUMP_VERSION || data[5] != XBEE_TRACE_DUMP_EVENT_SIZE) {
+        free(data);
+        return false;
+    }
+
+    uint16_t instanceId = getLe16(&data[6]);
+    uint32_t lost = getLe32(&data[12]);
+    uint32_t count = getLe32(&data[16]);
+    if (size < XBEE_TRACE_DUMP_HEADER_SIZE + (size_t)count * XBEE_TRACE_DUMP_EVENT_SIZE) {
+        fprintf(stderr, "Warning: %s truncated\n", path);
+        count = (uint32_t)((size - XBEE_TRACE_DUMP_HEADER_SIZE) / XBEE_TRACE_DUMP_EVENT_SIZE);
+    }
+
+    fprintf(out, "%s\n{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":\"xbee %u (%s)\"}}",
+            *first ? "" : ",", pid, instanceId, path);
+    fprintf(out, ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"io\"}}",
+            pid, TRACK_IO);
+    fprintf(out, ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"waits\"}}",
+            pid, TRACK_WAIT);
+    *first = false;
+
+    // Events are recorded when a span ends, so start times are close to but
+    // not strictly monotonic; unwrap each against the previous one
+    uint64_t previous = 0;
+    const uint8_t* p = data + XBEE_TRACE_DUMP_HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++, p += XBEE_TRACE_DUMP_EVENT_SIZE) {
+        uint32_t ts = getLe32(&p[0]);
+        uint64_t unwrapped = i == 0 ? ts : previous + (int64_t)(int32_t)(ts - (uint32_t)previous);
+        previous = unwrapped;
+
+        fprintf(out, ",\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"name\":\"%s\",\"ts\":%llu,\"dur\":%u,\"args\":",
+                pid, eventTrack(p[8]), eventName(p[8]), (unsigned long long)unwrapped, getLe32(&p[4]));
+        writeArgs(out, p[8], getLe16(&p[10]));
+        fputc('}', out);
+    }
+
+    if (lost) {
+        fprintf(stderr, "%s: %u events were overwritten before the dump\n", path, lost);
+    }
+    free(data);
+    return true;
+}
+
+static void usage(const char* prog) {
+    printf("Usage: %s [options] DUMP...\n"
+           "  --out PATH             Write JSON to PATH instead of stdout\n", prog);
+}
+
+int main(int argc, char** argv) {
+    static const struct option options[] = {
+        { "out", required_argument, NULL, 'o' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char* outPath = NULL;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "o:h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'o': outPath = optarg; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Cannot write %s\n", outPath);
+        return 1;
+    }
+
+    bool first = true;
+    int status = 0;
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (int i = optind; i < argc; i++) {
+        if (!convertDump(out, argv[i], i - optind + 1, &first)) {
+            fprintf(stderr, "Cannot read trace dump %s\n", argv[i]);
+            status = 1;
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout) fclose(out);
+    return status;
+}